@@ -0,0 +1,210 @@
+/*
+ * Format.c
+ *
+ *	Main implementation of the allocation-free numeric formatting
+ *	routines. Only integer and single precision math is used so no
+ *	printf or double precision library code is pulled into the image.
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Format.h"
+
+/* Powers of 10 used to scale fixed-point and float values */
+static const uint32_t POW10[FORMAT_MAX_PREC+1] = {
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+	1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+/*
+ *	----------------Format_Digits------------------
+ *	Local helper that writes the decimal digits of a value with an
+ *	optional sign, right justified to width, plus an optional
+ *	zero padded fraction part
+ *	Input: Output Buffer, Negative Flag, Integer Part, Fraction Part,
+ *				 Fraction Digits, Minimum Width
+ *	Output: Number of characters written
+ */
+static uint8_t Format_Digits(char* buf, uint8_t neg, uint32_t ipart, uint32_t fpart, uint8_t prec, uint8_t width){
+
+	char tmp[FORMAT_MAX_LEN];						//Digits are generated in reverse order
+	uint8_t n = 0;
+	uint8_t len = 0;
+	uint8_t i;
+
+	if(width > FORMAT_MAX_LEN)
+		width = FORMAT_MAX_LEN;
+
+	/* Fraction Digits (always exactly prec digits) */
+	for(i = 0; i < prec; i++){
+		tmp[n++] = '0' + (fpart % 10);
+		fpart /= 10;
+	}
+	if(prec)
+		tmp[n++] = '.';
+
+	/* Integer Digits (at least one) */
+	do{
+		tmp[n++] = '0' + (ipart % 10);
+		ipart /= 10;
+	}while(ipart);
+
+	if(neg)
+		tmp[n++] = '-';
+
+	/* Pad to the requested width */
+	while(n + len < width)
+		buf[len++] = ' ';
+
+	/* Reverse into the output buffer */
+	while(n)
+		buf[len++] = tmp[--n];
+
+	buf[len] = 0;
+	return len;
+}
+
+/*
+ *	------------------Format_Str-------------------
+ *	Copies a null terminated string into the buffer
+ *	Input: Output Buffer, String to Copy
+ *	Output: Number of characters written
+ */
+uint8_t Format_Str(char* buf, const char* str){
+	uint8_t len = 0;
+	while(str[len]){
+		buf[len] = str[len];
+		len++;
+	}
+	buf[len] = 0;
+	return len;
+}
+
+/*
+ *	------------------Format_UDec------------------
+ *	Formats an unsigned integer in decimal, right justified and
+ *	padded with spaces to the given width (0 = no padding)
+ *	Input: Output Buffer, Value, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_UDec(char* buf, uint32_t val, uint8_t width){
+	return Format_Digits(buf, 0, val, 0, 0, width);
+}
+
+/*
+ *	------------------Format_Dec-------------------
+ *	Formats a signed integer in decimal, right justified and
+ *	padded with spaces to the given width (0 = no padding)
+ *	Input: Output Buffer, Value, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Dec(char* buf, int32_t val, uint8_t width){
+
+	/* Negate in unsigned space so INT32_MIN is handled */
+	if(val < 0)
+		return Format_Digits(buf, 1, 0UL - (uint32_t)val, 0, 0, width);
+
+	return Format_Digits(buf, 0, (uint32_t)val, 0, 0, width);
+}
+
+/*
+ *	------------------Format_Hex-------------------
+ *	Formats an unsigned integer in lowercase hex. Zero padded to
+ *	the given number of digits like %0*x (0 = minimal digits like
+ *	%x), a value that needs more digits gets them
+ *	Input: Output Buffer, Value, Number of Digits
+ *	Output: Number of characters written
+ */
+uint8_t Format_Hex(char* buf, uint32_t val, uint8_t digits){
+
+	uint8_t len;
+	uint8_t i;
+	uint8_t need = 1;
+
+	/* Minimal number of digits, more only as zero padding (like %0*x) */
+	while(need < 8 && (val >> (need*4)))
+		need++;
+	if(digits > 8)
+		digits = 8;
+	if(digits < need)
+		digits = need;
+
+	/* Emit most significant nibble first */
+	len = digits;
+	for(i = 0; i < digits; i++){
+		buf[digits-1-i] = HEX_DIGITS[val & 0xF];
+		val >>= 4;
+	}
+	buf[len] = 0;
+	return len;
+}
+
+/*
+ *	-----------------Format_Fixed------------------
+ *	Formats a fixed-point value that has been scaled by 10^prec,
+ *	e.g. val = 1234, prec = 2 prints "12.34"
+ *	Input: Output Buffer, Scaled Value, Digits after Point, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Fixed(char* buf, int32_t val, uint8_t prec, uint8_t width){
+
+	uint32_t mag;
+	uint8_t neg = (val < 0);
+
+	if(prec > FORMAT_MAX_PREC)
+		prec = FORMAT_MAX_PREC;
+
+	mag = neg ? (0UL - (uint32_t)val) : (uint32_t)val;
+
+	return Format_Digits(buf, neg, mag / POW10[prec], mag % POW10[prec], prec, width);
+}
+
+/*
+ *	-----------------Format_Float------------------
+ *	Formats a float with a fixed number of decimals (like %.*f)
+ *	using single precision math only. Magnitudes beyond the
+ *	32-bit integer range are saturated.
+ *	Input: Output Buffer, Value, Digits after Point, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Float(char* buf, float val, uint8_t prec, uint8_t width){
+
+	uint8_t neg = 0;
+	uint32_t ipart, fpart;
+
+	if(prec > FORMAT_MAX_PREC)
+		prec = FORMAT_MAX_PREC;
+
+	/* NaN compares false with everything, print it as zero */
+	if(val != val)
+		val = 0.0f;
+
+	if(val < 0.0f){
+		neg = 1;
+		val = -val;
+	}
+
+	/* Saturate to what fits in 32 bits */
+	if(val >= 4294967040.0f)
+		val = 4294967040.0f;
+
+	/* Split into integer part and rounded fraction part */
+	ipart = (uint32_t)val;
+	fpart = (uint32_t)((val - (float)ipart) * (float)POW10[prec] + 0.5f);
+
+	/* Rounding may carry into the integer part */
+	if(fpart >= POW10[prec]){
+		fpart -= POW10[prec];
+		ipart++;
+	}
+
+	/* Avoid printing "-0.00" */
+	if(ipart == 0 && fpart == 0)
+		neg = 0;
+
+	return Format_Digits(buf, neg, ipart, fpart, prec, width);
+}
@@ -0,0 +1,87 @@
+/*
+ * Format.h
+ *
+ *	Provides allocation-free numeric formatting routines (decimal,
+ *	hex and fixed-point) used in place of sprintf for LCD and UART
+ *	output. Every routine writes into a caller supplied buffer, null
+ *	terminates it, and returns the number of characters written so
+ *	calls can be chained to build a line.
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+
+/* Largest output of a single routine (sign + 10 digits + '.' + 9 digits) */
+#define FORMAT_MAX_LEN				(22)
+
+/* Largest supported number of digits after the decimal point */
+#define FORMAT_MAX_PREC				(9)
+
+/*
+ *	------------------Format_Str-------------------
+ *	Copies a null terminated string into the buffer
+ *	Input: Output Buffer, String to Copy
+ *	Output: Number of characters written
+ */
+uint8_t Format_Str(char* buf, const char* str);
+
+/*
+ *	------------------Format_UDec------------------
+ *	Formats an unsigned integer in decimal, right justified and
+ *	padded with spaces to the given width (0 = no padding)
+ *	Input: Output Buffer, Value, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_UDec(char* buf, uint32_t val, uint8_t width);
+
+/*
+ *	------------------Format_Dec-------------------
+ *	Formats a signed integer in decimal, right justified and
+ *	padded with spaces to the given width (0 = no padding)
+ *	Input: Output Buffer, Value, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Dec(char* buf, int32_t val, uint8_t width);
+
+/*
+ *	------------------Format_Hex-------------------
+ *	Formats an unsigned integer in lowercase hex. Zero padded to
+ *	the given number of digits like %0*x (0 = minimal digits like
+ *	%x), a value that needs more digits gets them
+ *	Input: Output Buffer, Value, Number of Digits
+ *	Output: Number of characters written
+ */
+uint8_t Format_Hex(char* buf, uint32_t val, uint8_t digits);
+
+/*
+ *	-----------------Format_Fixed------------------
+ *	Formats a fixed-point value that has been scaled by 10^prec,
+ *	e.g. val = 1234, prec = 2 prints "12.34"
+ *	Input: Output Buffer, Scaled Value, Digits after Point, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Fixed(char* buf, int32_t val, uint8_t prec, uint8_t width);
+
+/*
+ *	-----------------Format_Float------------------
+ *	Formats a float with a fixed number of decimals (like %.*f)
+ *	using single precision math only. Magnitudes beyond the
+ *	32-bit integer range are saturated. It differs from %f in:
+ *		- a negative value that rounds to zero prints "0.00", not "-0.00"
+ *		- the last digit may be one off: halfway cases round up where
+ *		  %f rounds the exact binary value (ties to even), and once
+ *		  the fraction times 10^prec passes 2^24 (6 decimals above 32)
+ *		- NaN prints as zero
+ *	Host/format_bench.cpp counts each kind against snprintf
+ *	Input: Output Buffer, Value, Digits after Point, Minimum Width
+ *	Output: Number of characters written
+ */
+uint8_t Format_Float(char* buf, float val, uint8_t prec, uint8_t width);
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * baud_check.cpp
+ *
+ *	Checks the UART0.h divisor macros for every SYSCLK_HZ that
+ *	SysClock.h accepts (400 MHz over a whole divider, in whole MHz,
+ *	and the 16 MHz crystal) against the common baud rates:
+ *		- UART_BRD64 has to be the divisor closest to
+ *		  clock / (div * baud) in 1/64 steps, worked out with the
+ *		  32 bit unsigned long the target compiler uses
+ *		- IBRD has to be 1 to 0xFFFF
+ *		- the rate the divisor really gives, clock / (div * BRD64/64),
+ *		  has to be within UART0_BAUD_TOL_PPM for every pair UART0.h
+ *		  lets through, and the pairs it stops with #error have to be
+ *		  out of range or out of tolerance
+ *
+ *	Prints the IBRD/FBRD and error table and makes the exit code 1
+ *	on any failure. The UART0_HSE choice follows UART0.h: clock/8
+ *	sampling only once the rate no longer fits clock/16.
+ *
+ *	Build (from this folder):
+ *		g++ -O2 -std=c++17 -I.. baud_check.cpp -o baud_check
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "../UART0.h"
+}
+
+static const uint32_t Bauds[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000, 1500000,
+	2000000, 3000000, 5000000};
+
+/* One clock/baud pair as UART0.h works it out */
+struct Pair {
+	uint32_t clk, baud, div;
+	uint32_t brd64;
+	bool accepted;								//Passes the #error checks in UART0.h
+	double error_ppm;							//Of the rate the divisor really gives
+};
+
+/*
+ *	---------------------Evaluate----------------------
+ *	Local helper, the UART0.h macros and #error conditions for one pair
+ *	Input: Clock, Baud
+ *	Output: The pair
+ */
+static Pair Evaluate(uint32_t clk, uint32_t baud) {
+	Pair p;
+	uint32_t actual;
+
+	p.clk = clk;
+	p.baud = baud;
+	p.div = (baud > clk / 16) ? 8 : 16;
+	p.brd64 = UART_BRD64(clk, baud, p.div);					//uint32_t operands, as unsigned long on the target
+	actual = (p.brd64 != 0) ? UART_BAUD_ACTUAL(clk, p.brd64, p.div) : 0;
+
+	/* The #if conditions, evaluated by the preprocessor in 64 bits */
+	uint64_t diff = (actual > baud) ? actual - baud : baud - actual;
+	p.accepted = p.brd64 >= 64 && (p.brd64 >> 6) <= 0xFFFF && diff * 1000000ULL <= (uint64_t)baud * UART0_BAUD_TOL_PPM;
+	p.error_ppm = (p.brd64 != 0) ? ((double)clk * 64.0 / (p.div * (double)p.brd64) - baud) * 1e6 / baud : 1e6;
+	return p;
+}
+
+int main(void) {
+	std::vector<uint32_t> clocks;
+	uint32_t accepted = 0, rejected = 0, bad = 0;
+
+	for (uint32_t d = 5; d <= 128; d++) {
+		if (SYSCLK_PLL_HZ % d == 0 && (SYSCLK_PLL_HZ / d) % 1000000UL == 0)
+			clocks.push_back(SYSCLK_PLL_HZ / d);
+	}
+	if (std::find(clocks.begin(), clocks.end(), SYSCLK_XTAL_HZ) == clocks.end())
+		clocks.push_back(SYSCLK_XTAL_HZ);					//16 MHz is also 400 MHz / 25, same divisors
+
+	printf("tolerance %u ppm\n", (unsigned)UART0_BAUD_TOL_PPM);
+	printf("%9s %8s %4s %6s %5s %12s %10s\n", "clock", "baud", "div", "IBRD", "FBRD", "actual", "error ppm");
+	for (uint32_t clk : clocks) {
+		for (uint32_t baud : Bauds) {
+			Pair p = Evaluate(clk, baud);
+			double exact = 64.0 * clk / ((double)p.div * baud);
+			bool nearest = std::fabs((double)p.brd64 - exact) <= 0.5 + 1e-9;
+			bool in_tol = std::fabs(p.error_ppm) <= UART0_BAUD_TOL_PPM;
+			bool in_range = p.brd64 >= 64 && (p.brd64 >> 6) <= 0xFFFF;
+
+			if (!p.accepted) {
+				rejected++;
+				if (in_range && in_tol && nearest) {
+					printf("%9u %8u: rejected by UART0.h but %.0f ppm off\n", clk, baud, p.error_ppm);
+					bad++;
+				}
+				continue;
+			}
+			accepted++;
+			bool ok = nearest && in_tol && in_range;
+			printf("%9u %8u %4u %6u %5u %12.1f %10.0f%s\n", clk, baud, p.div, p.brd64 >> 6, p.brd64 & 0x3F,
+				(double)clk * 64.0 / (p.div * (double)p.brd64), p.error_ppm, ok ? "" : "  WRONG");
+			bad += !ok;
+		}
+	}
+
+	/* The build's own values */
+	Pair own = Evaluate(UART0_CLOCK_HZ, UART0_BAUD);
+	bool own_ok = own.brd64 >> 6 == UART0_IBRD && (own.brd64 & 0x3F) == UART0_FBRD && own.div == UART0_CLKDIV;
+	printf("this build: %lu Hz %lu baud, IBRD %lu FBRD %lu%s\n", (unsigned long)UART0_CLOCK_HZ, (unsigned long)UART0_BAUD,
+		(unsigned long)UART0_IBRD, (unsigned long)UART0_FBRD, own_ok ? "" : "  WRONG");
+	bad += !own_ok;
+
+	printf("%u pairs accepted, %u stopped by #error, %u wrong\n", accepted, rejected, bad);
+	return bad != 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * board_sim.hpp
+ *
+ *	Stand-in for the board when there is no hardware attached. Writes
+ *	the same init text, ASCII sample printout and binary sample frames
+ *	the firmware does, with made up but smooth sensor values, into a
+ *	file descriptor (usually the slave side of a PTY).
+ *
+ * Created on: November 22, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef BOARD_SIM_HPP_
+#define BOARD_SIM_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+extern "C" {
+#include "../Log.h"
+#include "../Telemetry.h"
+}
+
+struct SimConfig {
+	double rate_hz = 100.0;					//Samples per second, 0 = as fast as possible
+	uint32_t count = 0;							//Samples to send, 0 = until stopped
+	uint32_t ascii_every = 0;				//Every Nth sample is ASCII instead of binary, 0 = never
+	uint32_t clock_offset_us = 0;		//Device clock at the first sample
+	double drift_ppm = 0.0;					//Device clock rate error
+};
+
+class BoardSim {
+public:
+	explicit BoardSim(const SimConfig& cfg) : cfg_(cfg) {}
+
+	/* Next sample at device time t_us, in the firmware's units */
+	static TELEMETRY_SAMPLE_t make_sample(uint32_t t_us) {
+		TELEMETRY_SAMPLE_t s = {};
+		float t = t_us * 1e-6f;
+		s.Timestamp = t_us;
+		s.Channels = TLM_CH_ALL;
+		for (int i = 0; i < 3; i++) {
+			float ph = t * (1.0f + i) * 0.5f;
+			s.Accel_RAW[i] = (int16_t)(8192.0f * std::sin(ph));		//+-2g range, 16384 LSB/g
+			s.Gyro_RAW[i] = (int16_t)(1310.0f * std::cos(ph));		//+-250 deg/s range, 131 LSB/deg/s
+			s.Angle_cdeg[i] = (int16_t)(4500.0f * std::sin(ph));
+		}
+		s.RGBC_RAW[0] = (uint16_t)(2000 + 1000 * std::sin(t));
+		s.RGBC_RAW[1] = (uint16_t)(2000 + 1000 * std::sin(t + 2.1f));
+		s.RGBC_RAW[2] = (uint16_t)(2000 + 1000 * std::sin(t + 4.2f));
+		s.RGBC_RAW[3] = (uint16_t)(s.RGBC_RAW[0] + s.RGBC_RAW[1] + s.RGBC_RAW[2]);
+		s.Color = (uint8_t)((t_us / 1000000) % 4);
+		return s;
+	}
+
+	/* ModuleTest.c style printout of a sample */
+	static std::string ascii_sample(const TELEMETRY_SAMPLE_t& s) {
+		char buf[512];
+		snprintf(buf, sizeof(buf),
+			"X: %.6f\r\nY: %.6f\r\nZ: %.6f\r\n\r\n"
+			"Gyro Instance\r\nX: %.6f\r\nY: %.6f\r\nZ: %.6f\r\n\r\n"
+			"Angle Instance\r\nX: %.6f Y: %.6f Z: %.6fRED RAW: %x\r\nGREEN RAW: %x\r\nBLUE RAW: %x\r\n",
+			s.Accel_RAW[0] / 16384.0, s.Accel_RAW[1] / 16384.0, s.Accel_RAW[2] / 16384.0,
+			s.Gyro_RAW[0] / 131.0, s.Gyro_RAW[1] / 131.0, s.Gyro_RAW[2] / 131.0,
+			s.Angle_cdeg[0] / 100.0, s.Angle_cdeg[1] / 100.0, s.Angle_cdeg[2] / 100.0,
+			s.RGBC_RAW[0], s.RGBC_RAW[1], s.RGBC_RAW[2]);
+		return buf;
+	}
+
+	/*
+		Write samples to fd until count is reached or stop is set. Boards
+		given the same start time sample at the same true instants
+	*/
+	void run(int fd, const std::atomic<bool>& stop, std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now()) {
+		static const char init[] = "MPU6050 Initialized\r\nTCS34727 Power On\r\n";
+		write_all(fd, (const uint8_t*)init, sizeof(init) - 1);
+
+		//Deferred log records as Log_Flush sends them
+		static const uint8_t log_payload[] = {
+			LOG_START, 0, 1, 0, 0, 0, 0,
+				(uint8_t)LOG_TIMESTAMP_HZ, (uint8_t)(LOG_TIMESTAMP_HZ >> 8), (uint8_t)(LOG_TIMESTAMP_HZ >> 16), (uint8_t)(LOG_TIMESTAMP_HZ >> 24),
+			LOG_MPU6050_DETECTED, 0, 1, 0x40, 0x42, 0x0F, 0, 0x68, 0, 0, 0,
+			LOG_I2C_TX_ERROR, 0, 3, 0x80, 0x84, 0x1E, 0, 0x29, 0, 0, 0, 0x0F, 0, 0, 0, 0x02, 0, 0, 0
+		};
+		uint8_t log_frame[TLM_MAX_FRAME];
+		write_all(fd, log_frame, Telemetry_Pack(TLM_TYPE_LOG, 0, log_payload, sizeof(log_payload), log_frame));
+
+		uint16_t seq = 0;
+		for (uint32_t n = 0; !stop.load(std::memory_order_relaxed) && (cfg_.count == 0 || n < cfg_.count); n++) {
+			uint32_t t_us = cfg_.rate_hz > 0 ? (uint32_t)(n * 1e6 / cfg_.rate_hz) : n;
+			if (cfg_.rate_hz > 0)
+				std::this_thread::sleep_until(start + std::chrono::microseconds(t_us));
+
+			TELEMETRY_SAMPLE_t s = make_sample(t_us);
+			s.Timestamp = cfg_.clock_offset_us + (uint32_t)(t_us * (1.0 + cfg_.drift_ppm * 1e-6));
+			if (cfg_.ascii_every && n % cfg_.ascii_every == 0) {
+				std::string txt = ascii_sample(s);
+				write_all(fd, (const uint8_t*)txt.data(), txt.size());
+			} else {
+				uint8_t frame[TLM_MAX_FRAME];
+				uint32_t len = Telemetry_Encode_Sample(&s, seq++, frame);
+				write_all(fd, frame, len);
+			}
+		}
+	}
+
+private:
+	SimConfig cfg_;
+
+	static void write_all(int fd, const uint8_t* p, size_t n) {
+		while (n) {
+			ssize_t w = write(fd, p, n);
+			if (w <= 0)
+				return;
+			p += w;
+			n -= (size_t)w;
+		}
+	}
+};
+
+#endif
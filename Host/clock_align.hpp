@@ -0,0 +1,116 @@
+/*
+ * clock_align.hpp
+ *
+ *	Maps one board's device timestamps onto the host clock. Every
+ *	sample gives host_time - device_time = offset + transport delay,
+ *	and the delay is never negative, so the smallest value seen in a
+ *	window is the best offset estimate. The minimum of each one second
+ *	window is kept and a line is fitted through the last few of them
+ *	to follow the drift between the board crystal and the host.
+ *
+ * Created on: November 24, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef CLOCK_ALIGN_HPP_
+#define CLOCK_ALIGN_HPP_
+
+#include <cstdint>
+#include <deque>
+
+#define ALIGN_WINDOW_NS					(1000000000LL)		//Device time per minimum
+#define ALIGN_POINTS						(16)							//Window minima used in the fit
+
+class ClockAligner {
+public:
+	/* Feed one sample, returns its device time mapped to host time (ns) */
+	int64_t add(uint32_t device_us, int64_t host_ns) {
+		int64_t d = unwrap(device_us) * 1000;
+		int64_t off = host_ns - d;
+
+		if (!started_) {
+			started_ = true;
+			d_ref_ = d;
+			off_ref_ = off;
+			win_start_ = d;
+			win_min_ = off;
+			win_d_ = d;
+			run_min_ = off;
+		} else if (d - win_start_ >= ALIGN_WINDOW_NS) {
+			points_.push_back(Point{ (double)(win_d_ - d_ref_), (double)(win_min_ - off_ref_) });
+			if (points_.size() > ALIGN_POINTS)
+				points_.pop_front();
+			fit();
+			win_start_ = d;
+			win_min_ = off;
+			win_d_ = d;
+		} else if (off < win_min_) {
+			win_min_ = off;
+			win_d_ = d;
+		}
+		if (off < run_min_)
+			run_min_ = off;
+
+		int64_t t = d + offset_at(d);
+		if (t < last_t_)
+			t = last_t_;						//Keep each board's stream ordered while the fit moves
+		last_t_ = t;
+		return t;
+	}
+
+	/* Current estimate, host_ns = device_ns + offset */
+	int64_t offset_at(int64_t device_ns) const {
+		if (points_.size() < 2)
+			return run_min_;
+		return off_ref_ + (int64_t)(a_ + b_ * (double)(device_ns - d_ref_));
+	}
+
+	/* Board clock rate error relative to the host in ppm, 0 until fitted */
+	double drift_ppm() const {
+		return points_.size() < 2 ? 0.0 : -b_ * 1e6;	//A fast board clock shrinks the offset
+	}
+
+private:
+	struct Point {
+		double x;												//Device ns since d_ref_
+		double y;												//Offset ns relative to off_ref_
+	};
+
+	bool started_ = false;
+	uint32_t last_us_ = 0;
+	int64_t wrap_ = 0;
+	int64_t d_ref_ = 0, off_ref_ = 0;
+	int64_t win_start_ = 0, win_min_ = 0, win_d_ = 0;
+	int64_t run_min_ = 0;
+	int64_t last_t_ = INT64_MIN;
+	std::deque<Point> points_;
+	double a_ = 0.0, b_ = 0.0;
+
+	/* Extend the 32-bit microsecond counter, it wraps every 71 minutes */
+	int64_t unwrap(uint32_t us) {
+		if (started_ && us < last_us_ && last_us_ - us > 0x80000000UL)
+			wrap_ += 0x100000000LL;
+		last_us_ = us;
+		return wrap_ + us;
+	}
+
+	/* Least squares line through the window minima */
+	void fit() {
+		double n = (double)points_.size();
+		double sx = 0, sy = 0, sxx = 0, sxy = 0;
+		for (const Point& p : points_) {
+			sx += p.x;
+			sy += p.y;
+			sxx += p.x * p.x;
+			sxy += p.x * p.y;
+		}
+		double den = n * sxx - sx * sx;
+		if (points_.size() < 2 || den == 0.0)
+			return;
+		b_ = (n * sxy - sx * sy) / den;
+		a_ = (sy - b_ * sx) / n;
+	}
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * format_bench.cpp
+ *
+ *	Checks the output of ../Format.c against snprintf with the format
+ *	each routine stands in for, then times both with rdtsc on the
+ *	LCD and telemetry values the module tests print.
+ *
+ *		Format_UDec(v, w)			"%*u"
+ *		Format_Dec(v, w)			"%*d"
+ *		Format_Hex(v, d)			"%0*x", "%x" for d = 0
+ *		Format_Fixed(v, p, w)		"%*.*f" of v / 10^p, worked out in integers
+ *		Format_Float(v, p, w)		"%*.*f" of (double)v
+ *
+ *	The integer routines must match exactly. Format_Float is allowed
+ *	the differences Format.h documents, each one is counted by kind:
+ *	"-0" where a negative value rounds to zero (Format_Float drops
+ *	the sign), the last digit off by one where the single precision
+ *	fraction loses bits (large values, many decimals), and NaN and
+ *	saturated values. Anything else is a mismatch and makes the exit
+ *	code 1.
+ *
+ *	Host cycles are not Cortex-M4 cycles, but the ratio carries over
+ *	as it does for log_bench. Code size is a target figure: the
+ *	Keil .map "Image component sizes" lists Format.o, and with the
+ *	sprintf calls gone none of the c_w.l printf members (_printf_*,
+ *	__2sprintf, the double precision _fp_* helpers) are linked.
+ *
+ *	Build (from this folder, x86-64 Linux):
+ *		gcc -O2 -c ../Format.c -o Format.o
+ *		g++ -O2 -std=c++17 format_bench.cpp Format.o -o format_bench
+ *
+ *	Usage:
+ *		format_bench [values]
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <x86intrin.h>
+
+extern "C" {
+#include "../Format.h"
+}
+
+#define BENCH_BATCH					(64)
+#define BENCH_BATCHES				(20000)
+
+/* Kinds of Format_Float difference */
+enum { DIFF_NEG_ZERO, DIFF_LAST_DIGIT, DIFF_RANGE, DIFF_OTHER, DIFF_COUNT };
+static const char* const Diff_Names[DIFF_COUNT] = {"-0 printed as 0", "last digit +-1", "nan/saturated", "other"};
+
+static uint32_t Checked, Mismatch;
+static volatile uint32_t Sink;							//Keeps the timed calls
+static uint32_t Float_Diffs[DIFF_COUNT];
+
+/* Reproducible values, xorshift32 */
+static uint32_t Seed = 0x2545F491;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/*
+ *	--------------------Expect-------------------------
+ *	Local helper, one exact comparison
+ *	Input: Routine, Format.c output and length, snprintf output
+ *	Output: none
+ */
+static void Expect(const char* what, const char* got, uint8_t len, const char* want) {
+	Checked++;
+	if (strcmp(got, want) != 0 || len != strlen(want)) {
+		if (Mismatch++ < 10)
+			printf("  %s: \"%s\" (%u), snprintf \"%s\"\n", what, got, len, want);
+	}
+}
+
+/*
+ *	----------------Last_Digit_Off----------------------
+ *	Local helper
+ *	Input: Two outputs of the same width and decimals
+ *	Output: 1 if they are one unit of the last digit apart
+ */
+static int Last_Digit_Off(const char* a, const char* b) {
+	double x = atof(a), y = atof(b);
+	const char* dot = strchr(a, '.');
+	double unit = dot ? std::pow(10.0, -(double)strlen(dot + 1)) : 1.0;
+
+	return std::fabs(std::fabs(x - y) - unit) < unit / 2;
+}
+
+/*
+ *	--------------------Check_Float--------------------
+ *	Local helper, one Format_Float call sorted by kind of difference
+ *	Input: Value, Decimals, Width
+ *	Output: none
+ */
+static void Check_Float(float v, uint8_t prec, uint8_t width) {
+	char got[FORMAT_MAX_LEN + 1], want[64];
+	uint8_t len = Format_Float(got, v, prec, width);
+
+	snprintf(want, sizeof(want), "%*.*f", width, prec, (double)v);
+	Checked++;
+	if (strcmp(got, want) == 0 && len == strlen(want))
+		return;
+	if (v != v || std::fabs(v) >= 4294967040.0f)
+		Float_Diffs[DIFF_RANGE]++;
+	else if (want[strspn(want, " ")] == '-' && strchr(got, '-') == 0 && atof(want) == 0.0)
+		Float_Diffs[DIFF_NEG_ZERO]++;
+	else if (Last_Digit_Off(got, want))
+		Float_Diffs[DIFF_LAST_DIGIT]++;
+	else {
+		Float_Diffs[DIFF_OTHER]++;
+		if (Mismatch++ < 10)
+			printf("  Format_Float(%.9g, %u, %u): \"%s\", snprintf \"%s\"\n", (double)v, prec, width, got, want);
+	}
+}
+
+/*
+ *	--------------------Check_All----------------------
+ *	Local helper, every routine against snprintf
+ *	Input: Number of random values
+ *	Output: none
+ */
+static void Check_All(uint32_t values) {
+	static const uint32_t edges[] = {0, 1, 9, 10, 99, 100, 65535, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+	char got[FORMAT_MAX_LEN + 1], want[64];
+
+	for (uint32_t i = 0; i < values + sizeof(edges) / sizeof(edges[0]); i++) {
+		uint32_t u = (i < sizeof(edges) / sizeof(edges[0])) ? edges[i] : Next() >> (Next() % 32);
+		int32_t s = (int32_t)u;
+		uint8_t width = (uint8_t)(i % 12);
+		uint8_t digits = (uint8_t)(i % 9);
+		uint8_t prec = (uint8_t)(i % (FORMAT_MAX_PREC + 1));
+		uint8_t len;
+
+		len = Format_UDec(got, u, width);
+		snprintf(want, sizeof(want), "%*u", width, u);
+		Expect("Format_UDec", got, len, want);
+
+		len = Format_Dec(got, s, width);
+		snprintf(want, sizeof(want), "%*d", width, s);
+		Expect("Format_Dec", got, len, want);
+
+		len = Format_Hex(got, u, digits);
+		if (digits)
+			snprintf(want, sizeof(want), "%0*x", digits, u);
+		else
+			snprintf(want, sizeof(want), "%x", u);
+		Expect("Format_Hex", got, len, want);
+
+		/* Fixed point, the decimal string of v / 10^prec built from integers */
+		{
+			uint64_t mag = (s < 0) ? 0ULL - (int64_t)s : (uint64_t)s;
+			uint64_t p10 = 1;
+			char body[40];
+
+			for (uint8_t k = 0; k < prec; k++)
+				p10 *= 10;
+			if (prec)
+				snprintf(body, sizeof(body), "%s%llu.%0*llu", s < 0 ? "-" : "", (unsigned long long)(mag / p10), prec,
+					(unsigned long long)(mag % p10));
+			else
+				snprintf(body, sizeof(body), "%s%llu", s < 0 ? "-" : "", (unsigned long long)mag);
+			snprintf(want, sizeof(want), "%*s", width, body);
+			len = Format_Fixed(got, s, prec, width);
+			Expect("Format_Fixed", got, len, want);
+		}
+
+		/* Floats over the ranges the tests print: angles, g, deg/s, raw counts, and any bit pattern */
+		float f;
+		switch (i % 4) {
+			case 0: f = (float)((int32_t)Next() % 36000) / 100.0f; break;
+			case 1: f = (float)((int32_t)Next() % 2000000) / 1000000.0f; break;
+			case 2: f = (float)((int32_t)Next() % 50000000) / 1000.0f; break;
+			default: {
+				uint32_t bits = Next();
+				memcpy(&f, &bits, sizeof(f));
+				if (std::isinf(f))
+					f = 0.0f;
+			}
+		}
+		Check_Float(f, (uint8_t)(i % 7), width);
+	}
+
+	/* Signed zero and values that round to zero */
+	Check_Float(-0.0f, 2, 0);
+	Check_Float(-0.004f, 2, 0);
+	Check_Float(-0.0004f, 3, 6);
+	Check_Float(NAN, 2, 0);
+}
+
+/*
+ *	--------------------Bench--------------------------
+ *	Local helper, cycles per call of one Format.c routine next to
+ *	the snprintf doing the same
+ *	Input: Name, Two callables
+ *	Output: none
+ */
+template <typename A, typename B>
+static void Bench(const char* name, A format, B sprintf_path) {
+	static float vals[BENCH_BATCH];
+	uint64_t fmt_cycles = 0, spf_cycles = 0;
+	char buf[64];
+
+	for (int i = 0; i < BENCH_BATCH; i++)
+		vals[i] = (float)((int32_t)Next() % 36000) / 100.0f;
+	for (int b = 0; b < BENCH_BATCHES; b++) {
+		uint64_t t0 = __rdtsc();
+		for (int i = 0; i < BENCH_BATCH; i++)
+			Sink += format(buf, vals[i]);
+		uint64_t t1 = __rdtsc();
+		for (int i = 0; i < BENCH_BATCH; i++)
+			Sink += (uint32_t)sprintf_path(buf, vals[i]);
+		uint64_t t2 = __rdtsc();
+		fmt_cycles += t1 - t0;
+		spf_cycles += t2 - t1;
+	}
+
+	double calls = (double)BENCH_BATCH * BENCH_BATCHES;
+	printf("%-14s %7.1f TSC cycles/call, snprintf %7.1f, ratio %5.1fx\n", name, fmt_cycles / calls,
+		spf_cycles / calls, (double)spf_cycles / fmt_cycles);
+}
+
+int main(int argc, char** argv) {
+	uint32_t values = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+
+	Check_All(values);
+	printf("%u calls checked against snprintf\n", Checked);
+	for (int k = 0; k < DIFF_COUNT; k++)
+		printf("Format_Float %-16s %7u\n", Diff_Names[k], Float_Diffs[k]);
+	printf("%s\n", Mismatch ? "output differs from snprintf beyond Format.h" : "output matches snprintf within Format.h");
+
+	Bench("Format_Dec", [](char* b, float v) { return Format_Dec(b, (int32_t)v, 6); },
+		[](char* b, float v) { return snprintf(b, 64, "%6d", (int32_t)v); });
+	Bench("Format_Fixed", [](char* b, float v) { return Format_Fixed(b, (int32_t)(v * 100), 2, 7); },
+		[](char* b, float v) { return snprintf(b, 64, "%7.2f", (int32_t)(v * 100) / 100.0); });
+	Bench("Format_Float", [](char* b, float v) { return Format_Float(b, v, 2, 7); },
+		[](char* b, float v) { return snprintf(b, 64, "%7.2f", (double)v); });
+	Bench("Format_Hex", [](char* b, float v) { return Format_Hex(b, (uint32_t)v, 4); },
+		[](char* b, float v) { return snprintf(b, 64, "%04x", (uint32_t)v); });
+	return Mismatch != 0;
+}
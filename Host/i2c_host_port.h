@@ -0,0 +1,92 @@
+/*
+ * i2c_host_port.h
+ *
+ *	Forced include (-include) when ../I2C.c is built on the host.
+ *	Pulls in the real register header first, so the later include
+ *	in I2C.c is skipped, then points the I2C0 and setup registers at
+ *	a plain struct the simulation owns (Host/i2c_sim.cpp).
+ *
+ *	A write to I2C0_MCS always has RUN set, which reads back as
+ *	BUSY, so the driver waits in IDLE_WAIT (or on I2C0_Done once the
+ *	kernel runs) until the simulation runs the command from
+ *	Idle_Sleep (or Kernel_Sem_Pend) and stores the final status in MCS.
+ *	The bus pins and the module reset of I2C0_Recover call into the
+ *	simulation too, so it sees every SCL clock and the STOP.
+ *
+ *		gcc -c -include i2c_host_port.h -DPROFILE_ENABLE=0 -I.. ../I2C.c
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef I2C_HOST_PORT_H_
+#define I2C_HOST_PORT_H_
+
+#include <stdint.h>
+#include "../tm4c123gh6pm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Registers I2C.c touches, one field each */
+typedef struct{
+	uint32_t MSA, MCS, MDR, MTPR, MIMR, MICR, MCR;
+	uint32_t RCGCI2C, RCGC2, PRI2, EN0;
+	uint32_t PB_DEN, PB_AFSEL, PB_PCTL, PB_ODR, PB_AMSEL, PB_DIR;
+} I2C_HOST_REGS_t;
+
+extern I2C_HOST_REGS_t I2C_Host_Regs;
+
+void I2C_Host_Scl(uint8_t level);							//SCL driven as a GPIO
+void I2C_Host_Sda(uint8_t level);							//SDA driven as a GPIO
+uint8_t I2C_Host_Sda_In(void);								//SDA as the bus has it
+void I2C_Host_Reset(void);										//I2C0 module reset
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef I2C0_MSA_R
+#undef I2C0_MCS_R
+#undef I2C0_MDR_R
+#undef I2C0_MTPR_R
+#undef I2C0_MIMR_R
+#undef I2C0_MICR_R
+#undef I2C0_MCR_R
+#undef SYSCTL_RCGCI2C_R
+#undef SYSCTL_RCGC2_R
+#undef NVIC_PRI2_R
+#undef NVIC_EN0_R
+#undef GPIO_PORTB_DEN_R
+#undef GPIO_PORTB_AFSEL_R
+#undef GPIO_PORTB_PCTL_R
+#undef GPIO_PORTB_ODR_R
+#undef GPIO_PORTB_AMSEL_R
+#undef GPIO_PORTB_DIR_R
+
+#define I2C0_MSA_R						(I2C_Host_Regs.MSA)
+#define I2C0_MCS_R						(I2C_Host_Regs.MCS)
+#define I2C0_MDR_R						(I2C_Host_Regs.MDR)
+#define I2C0_MTPR_R						(I2C_Host_Regs.MTPR)
+#define I2C0_MIMR_R						(I2C_Host_Regs.MIMR)
+#define I2C0_MICR_R						(I2C_Host_Regs.MICR)
+#define I2C0_MCR_R						(I2C_Host_Regs.MCR)
+#define SYSCTL_RCGCI2C_R			(I2C_Host_Regs.RCGCI2C)
+#define SYSCTL_RCGC2_R				(I2C_Host_Regs.RCGC2)
+#define NVIC_PRI2_R						(I2C_Host_Regs.PRI2)
+#define NVIC_EN0_R						(I2C_Host_Regs.EN0)
+#define GPIO_PORTB_DEN_R			(I2C_Host_Regs.PB_DEN)
+#define GPIO_PORTB_AFSEL_R		(I2C_Host_Regs.PB_AFSEL)
+#define GPIO_PORTB_PCTL_R			(I2C_Host_Regs.PB_PCTL)
+#define GPIO_PORTB_ODR_R			(I2C_Host_Regs.PB_ODR)
+#define GPIO_PORTB_AMSEL_R		(I2C_Host_Regs.PB_AMSEL)
+#define GPIO_PORTB_DIR_R			(I2C_Host_Regs.PB_DIR)
+
+#define I2C0_SCL_OUT(level)		I2C_Host_Scl(level)
+#define I2C0_SDA_OUT(level)		I2C_Host_Sda(level)
+#define I2C0_SDA_IN()					I2C_Host_Sda_In()
+#define I2C0_MODULE_RESET()		I2C_Host_Reset()
+
+#endif
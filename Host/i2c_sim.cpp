@@ -0,0 +1,729 @@
+/*
+ * i2c_sim.cpp
+ *
+ *	Host simulation of I2C0 with the three devices of the full
+ *	system test on the bus (0x68 MPU6050, 0x29 TCS34727, 0x3F LCD
+ *	backpack). Builds ../I2C.c against a register model that runs
+ *	every MCS command byte by byte at the MTPR bit rate on the
+ *	Time.h virtual clock, then drives it with the I2C traffic of the
+ *	full system test plus writes to a missing device and injected
+ *	arbitration losses on the repeated START of a read.
+ *
+ *	The model counts transfers, bytes, NACKs, arbitration losses and
+ *	bus time per address on its own, from what it put on the wire,
+ *	and prints them next to the I2C0_Stats of I2C.c. Any difference
+ *	is reported and makes the exit code 1.
+ *
+ *	Every START is also checked against the SCL rate of its device
+ *	(0x68 and 0x29 at 400 kHz, the rest at 100 kHz), and the MTPR
+ *	speed table of I2C.h against rates worked out here in floating
+ *	point: never above the nominal rate, and the next faster TPR
+ *	would be. Build everything with -DSYSCLK_HZ=... to check the
+ *	table at another core clock.
+ *
+ *	Then it injects the faults the driver must survive, one read
+ *	each: a slave holding SDA low, a master stuck BUSY, a bus that
+ *	stays busy after the STOP, a missing device, and data that looks
+ *	like an error code. Every faulty read must end by its deadline
+ *	with the right error and no data, the recovery must clock SDA
+ *	free, send a STOP and reset the module, and the next read must
+ *	work. The first two run again with the kernel running, where the
+ *	read blocks on I2C0_Done instead of sleeping in IDLE_WAIT. A
+ *	failure also makes the exit code 1.
+ *
+ *	Last, the arbitration run: the kernel becomes two tasks, the
+ *	main program as the display task writing the LCD and a control
+ *	task reading the 12 IMU registers every 10 ms, which preempts
+ *	the LCD whenever its release comes up in a wait. Both block on
+ *	I2C0_Done for their transfers, IDLE_WAIT is an error here. It
+ *	measures how long each IMU sample waits for the bus (release to its
+ *	first START) while the LCD is flushed back to back: character
+ *	by character as LCD.c does, a whole frame in one burst, and the
+ *	same frame to 0x27, a backpack address missing from I2CTable.h
+ *	and so sent whole. The split ones must not wait longer than one
+ *	fragment on the wire.
+ *
+ *	Then a third task joins, CPU bound (SIM_CPU_BURST of work every
+ *	SIM_CPU_PERIOD, like the main loop formatting telemetry). Below
+ *	the LCD task it only gets the CPU while the others wait for the
+ *	wire, and the one fragment bound must still hold. Between the
+ *	two it preempts the LCD task while that holds the bus, and the
+ *	IMU waits out the whole burst: the lock has no inheritance, so
+ *	the bound must break here, or the model lost the third task.
+ *	I2C.h states the priority rule this shows.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		gcc -O2 -I.. -include i2c_host_port.h -DPROFILE_ENABLE=0 -c ../I2C.c -o I2C.o
+ *		g++ -O2 -std=c++17 i2c_sim.cpp Time.o I2C.o -o i2c_sim
+ *
+ *	Usage:
+ *		i2c_sim [passes]
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ucontext.h>
+
+extern "C" {
+#include "time_host_port.h"
+#include "i2c_host_port.h"
+#include "../I2C.h"
+#include "../Kernel.h"
+}
+
+#define SIM_MISSING_ADDR			(0x50)			//Nothing answers here
+#define SIM_MISSING_EVERY			(50)				//Passes between reads of it
+#define SIM_ARB_EVERY					(97)				//Repeated STARTs between injected arbitration losses
+#define SIM_SDA_HELD_CLOCKS		(5)					//Clocks the stuck slave needs to finish its byte
+#define SIM_NEVER							(0xFFFFFFFFFFFFFFFFULL)
+#define SIM_IMU_PERIOD				(10000 * SYSCLK_CYCLES_PER_US + 37)	//Task_IMU rate, drifts across the LCD writes
+#define SIM_ARB_SECONDS				(2)					//Per LCD pattern
+#define SIM_LCD_CHARS					(34)				//Two cursor moves and a 16x2 frame
+#define SIM_LCD_EXEC_US				(37)				//LCD_Hold after every character
+#define SIM_CPU_PERIOD				(20000 * SYSCLK_CYCLES_PER_US + 11)	//Third task release, drifts too
+#define SIM_CPU_BURST					(3000 * SYSCLK_CYCLES_PER_US)		//Its work per release
+#define SIM_CPU_STEP					(SYSCLK_CYCLES_PER_US)						//Preemption check while it runs
+
+/* Where the CPU bound third task sits */
+enum Cpu_Place { CPU_NONE, CPU_BELOW_LCD, CPU_ABOVE_LCD };
+
+/* Faults, armed for the next START */
+enum Fault { FAULT_NONE, FAULT_SDA_LOW, FAULT_MASTER_BUSY, FAULT_BUS_BUSY };
+
+/* One device on the bus, a register file behind a pointer set by the first byte written */
+struct Device {
+	uint8_t Addr;
+	uint8_t Regs[256];
+	uint8_t Ptr;
+};
+
+static Device Devices[] = {{0x68, {}, 0}, {0x29, {}, 0}, {0x3F, {}, 0}, {0x27, {}, 0}};
+
+/* What the model put on the wire, per address */
+struct Count {
+	uint8_t Addr;
+	uint32_t Transactions, Bytes, Nacks, Arb_Lost;
+	uint32_t Wrong_Speed;						//STARTs at another MTPR than the device's
+	uint64_t Busy_Cycles;
+};
+
+/* SCL rates of I2C_SPEED_TABLE, worked out on their own */
+struct Speed {
+	const char* Name;
+	double Hz;
+	uint32_t Lp_Hp;								//SCL_LP + SCL_HP
+	uint32_t Hs;
+};
+
+static const Speed Speeds[I2C_SPEED_COUNT] = {
+	{"standard", 100e3, 10, 0}, {"fast", 400e3, 10, 0}, {"fast plus", 1e6, 10, 0}, {"high speed", 3.33e6, 3, I2C_MTPR_HS}};
+
+static Count Counts[I2C_STATS_SLOTS];
+static uint8_t Counts_Used;
+
+/* Bus state between commands */
+static Device* Dev;							//Addressed device, 0 after a NACK
+static uint8_t Owned;						//START sent, no STOP yet
+static uint8_t First;						//Next written byte is the register pointer
+static uint64_t Started;				//Time of the START
+static uint32_t Repeats;				//Repeated STARTs so far, paces the injected losses
+
+/* Fault state, what I2C0_Recover did about it */
+static Fault Armed;							//Applied at the next START
+static uint8_t Hung;						//Master never finishes its command
+static uint8_t Stuck_Busy;			//Bus busy stays set after the STOP
+static uint8_t Sda_Held;				//Clocks until the slave lets go of SDA
+static uint8_t Scl = 1, Sda = 1;	//Levels driven as GPIO
+static uint32_t Clocks, Stops, Resets;
+
+/* Arbitration run, the main program is the display task writing the LCD */
+static ucontext_t Lcd_Ctx, Imu_Ctx;
+static uint8_t Imu_Stack[64 * 1024];
+static uint8_t Tasks_On;				//Kernel_Running
+static uint8_t Imu_Running;			//Control task has the CPU
+static uint8_t Imu_Blocked;			//Control task pends on the bus lock
+static uint64_t Imu_Release = SIM_NEVER;	//Next release while it sleeps
+static uint64_t Imu_Waiting = SIM_NEVER;	//Release of the sample whose first START is still due
+static uint64_t Imu_Max_Wait, Imu_Max_Sample;
+static uint32_t Imu_Samples;
+static uint32_t Task_Waits;			//Transfer waits that blocked the task on I2C0_Done
+static Cpu_Place Cpu_At;					//Third task, CPU_NONE outside its runs
+static uint64_t Cpu_Release = SIM_NEVER;	//Its next release
+static uint64_t Cpu_Left;				//Its work not done yet
+static uint32_t Cpu_Preempts;		//Times it took the CPU from the LCD task
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+I2C_HOST_REGS_t I2C_Host_Regs;
+
+long StartCritical(void) { return 0; }
+void EndCritical(long) {}
+void Time_Host_Tick(uint8_t) {}
+}
+
+/*
+ *	--------------------Preempt------------------------
+ *	Local helper, the control task takes the CPU from the LCD task
+ *	once its release has come, as the SysTick that wakes it would.
+ *	Returns when it sleeps or blocks
+ *	Input: none
+ *	Output: none
+ */
+static void Preempt(void) {
+	if (Tasks_On && !Imu_Running && !Imu_Blocked && Time_Host_Cycles >= Imu_Release) {
+		Imu_Running = 1;
+		swapcontext(&Lcd_Ctx, &Imu_Ctx);
+	}
+}
+
+/*
+ *	-------------------Cpu_Update----------------------
+ *	Local helper, adds the work of every third task release due
+ *	Input: none
+ *	Output: none
+ */
+static void Cpu_Update(void) {
+	while (Cpu_At != CPU_NONE && Time_Host_Cycles >= Cpu_Release) {
+		Cpu_Left += SIM_CPU_BURST;
+		Cpu_Release += SIM_CPU_PERIOD;
+	}
+}
+
+/*
+ *	---------------------Cpu_Run-----------------------
+ *	Local helper, the third task above the LCD task takes the CPU
+ *	from it and works until it has nothing left. The control task
+ *	still preempts it, and when that blocks on the bus lock the
+ *	third task goes on. Returns to the LCD task
+ *	Input: none
+ *	Output: none
+ */
+static void Cpu_Run(void) {
+	Cpu_Update();
+	if (Cpu_At != CPU_ABOVE_LCD || Imu_Running || Cpu_Left == 0)
+		return;
+	Cpu_Preempts++;
+	while (Cpu_Left) {
+		uint64_t step = Cpu_Left < SIM_CPU_STEP ? Cpu_Left : SIM_CPU_STEP;
+
+		Time_Host_Cycles += step;
+		Cpu_Left -= step;
+		Preempt();
+		Cpu_Update();
+	}
+}
+
+static uint8_t Sleep(void);
+
+/* Two task kernel of the arbitration run. The bus lock is pended
+   forever and only the control task may block on it. A transfer
+   wait (I2C0_Wait, with a timeout) blocks either task on I2C0_Done:
+   the core sleeps until the command ends and I2C0_Handler posts, the
+   other task only wants the bus, so it has nothing to run meanwhile */
+extern "C" {
+void I2C0_Handler(void);
+
+void Time_Host_Yield(void) {
+	Time_Host_Cycles++;
+	Preempt();
+	Cpu_Run();
+}
+
+uint8_t Kernel_Running(void) { return Tasks_On; }
+
+uint8_t Kernel_Sem_Pend(KERNEL_SEM_t* sem, uint32_t timeout_ms) {
+	if (sem->Count) {
+		sem->Count--;
+		return 1;
+	}
+	if (timeout_ms == 0)
+		return 0;
+	if (timeout_ms != KERNEL_WAIT_FOREVER) {
+		uint64_t from = Time_Host_Cycles;
+
+		Task_Waits++;
+		Cpu_Update();
+		uint8_t ended = Sleep();
+		/* The third task had the CPU while the wire ran */
+		Cpu_Left -= (Time_Host_Cycles - from < Cpu_Left) ? Time_Host_Cycles - from : Cpu_Left;
+		if (ended) {
+			I2C0_Handler();
+			if (!sem->Count) {
+				fprintf(stderr, "I2C0_Handler did not wake the waiting task\n");
+				exit(1);
+			}
+		}
+		Preempt();
+		Cpu_Run();
+		if (!sem->Count)
+			return 0;														//Timed out at the SysTick
+		sem->Count--;
+		return 1;
+	}
+	if (!Imu_Running) {
+		fprintf(stderr, "LCD task blocked on the bus\n");
+		exit(1);
+	}
+	sem->Waiting = 1;
+	Imu_Blocked = 1;
+	Imu_Running = 0;
+	swapcontext(&Imu_Ctx, &Lcd_Ctx);								//Back once posted, with the bus
+	return 1;
+}
+
+void Kernel_Sem_Post(KERNEL_SEM_t* sem) {
+	if (!sem->Waiting) {
+		sem->Count++;
+		return;
+	}
+	/* Handed to the control task, which runs first */
+	sem->Waiting = 0;
+	Imu_Blocked = 0;
+	Imu_Running = 1;
+	swapcontext(&Lcd_Ctx, &Imu_Ctx);
+}
+}
+
+/*
+ *	--------------------Bit_Cycles---------------------
+ *	Local helper
+ *	Input: none
+ *	Output: Core cycles of one SCL period at the MTPR setting
+ */
+static uint64_t Bit_Cycles(void) {
+	uint64_t period = (I2C_Host_Regs.MTPR & I2C_MTPR_HS) ? 2 * (2 + 1) : 2 * (6 + 4);
+
+	return period * ((I2C_Host_Regs.MTPR & I2C_MTPR_TPR_M) + 1);
+}
+
+/*
+ *	--------------------Speed_MTPR---------------------
+ *	Local helper, MTPR for a rate: the smallest TPR (at least 1)
+ *	whose rate is not above the nominal one
+ *	Input: Speed
+ *	Output: MTPR value
+ */
+static uint32_t Speed_MTPR(const Speed* sp) {
+	long tpr = (long)std::ceil(SYSCLK_HZ / (2.0 * sp->Lp_Hp * sp->Hz)) - 1;
+
+	return (uint32_t)(tpr < 1 ? 1 : tpr) | sp->Hs;
+}
+
+/*
+ *	--------------------Device_MTPR--------------------
+ *	Local helper
+ *	Input: Address
+ *	Output: MTPR every START to the address must run at
+ */
+static uint32_t Device_MTPR(uint8_t addr) {
+	return Speed_MTPR(&Speeds[(addr == 0x68 || addr == 0x29) ? 1 : 0]);
+}
+
+/*
+ *	--------------------Count_Of-----------------------
+ *	Local helper, same slot rules as I2C.c
+ *	Input: Address
+ *	Output: Model count of the address
+ */
+static Count* Count_Of(uint8_t addr) {
+	uint8_t i;
+
+	for (i = 0; i < Counts_Used && Counts[i].Addr != addr; i++);
+	if (i == Counts_Used) {
+		if (Counts_Used < I2C_STATS_SLOTS) {
+			Counts_Used++;
+			Counts[i].Addr = (i == I2C_STATS_SLOTS - 1) ? I2C_STATS_OTHER : addr;
+		} else {
+			i = I2C_STATS_SLOTS - 1;
+		}
+	}
+	return &Counts[i];
+}
+
+/*
+ *	--------------------Wire_Byte----------------------
+ *	Local helper, one data byte to or from the addressed device
+ *	Input: none
+ *	Output: none
+ */
+static void Wire_Byte(void) {
+	Time_Host_Cycles += 9 * Bit_Cycles();
+	if (I2C_Host_Regs.MSA & I2C0_RW_PIN) {
+		I2C_Host_Regs.MDR = Dev->Regs[Dev->Ptr++];
+	} else if (First) {
+		Dev->Ptr = (uint8_t)I2C_Host_Regs.MDR;
+		First = 0;
+	} else {
+		Dev->Regs[Dev->Ptr++] = (uint8_t)I2C_Host_Regs.MDR;
+	}
+}
+
+/*
+ *	--------------------Run_Command--------------------
+ *	Local helper, what the master does for one MCS write: an
+ *	optional (repeated) START with the address byte, one data
+ *	byte, an optional STOP. Leaves the final status in MCS
+ *	Input: MCS value written by I2C.c
+ *	Output: none
+ */
+static void Run_Command(uint32_t cmd) {
+	uint8_t addr = (uint8_t)(I2C_Host_Regs.MSA >> 1);
+	uint32_t status = 0;
+	Count* c = Count_Of(addr);
+	uint8_t i;
+
+	if ((cmd & I2C_MCS_START) && Armed != FAULT_NONE) {
+		Hung = (Armed != FAULT_BUS_BUSY);
+		Stuck_Busy = (Armed == FAULT_BUS_BUSY);
+		Sda_Held = (Armed == FAULT_SDA_LOW) ? SIM_SDA_HELD_CLOCKS : 0;
+		Armed = FAULT_NONE;
+	}
+	if (Hung)
+		return;
+
+	if (cmd & I2C_MCS_START) {
+		c->Bytes += 2;																//Address and the MDR byte
+		if (!Owned && addr == 0x68 && Imu_Waiting != SIM_NEVER) {
+			if (Time_Host_Cycles - Imu_Waiting > Imu_Max_Wait)
+				Imu_Max_Wait = Time_Host_Cycles - Imu_Waiting;
+			Imu_Waiting = SIM_NEVER;
+		}
+		if (!Owned) {
+			Started = Time_Host_Cycles;
+			c->Transactions++;
+			if (I2C_Host_Regs.MTPR != Device_MTPR(addr))
+				c->Wrong_Speed++;
+		} else if (++Repeats % SIM_ARB_EVERY == 0) {
+			/* Another master wins the repeated START and keeps the bus */
+			Time_Host_Cycles += 5 * Bit_Cycles();
+			c->Arb_Lost++;
+			c->Busy_Cycles += Time_Host_Cycles - Started;
+			Owned = 0;
+			I2C_Host_Regs.MCS = I2C_MCS_ERROR | I2C_MCS_ARBLST;
+			return;
+		}
+		Time_Host_Cycles += Bit_Cycles() + 9 * Bit_Cycles();
+		Owned = 1;
+		First = 1;
+		Dev = 0;
+		for (i = 0; i < sizeof(Devices) / sizeof(Devices[0]); i++)
+			if (Devices[i].Addr == addr)
+				Dev = &Devices[i];
+		if (Dev == 0) {
+			status = I2C_MCS_ERROR | I2C_MCS_ADRACK;
+			c->Nacks++;
+		}
+	} else {
+		c->Bytes++;
+	}
+
+	/* No data byte after a NACK, only the STOP */
+	if (Owned && Dev)
+		Wire_Byte();
+
+	if ((cmd & I2C_MCS_STOP) && Owned) {
+		Time_Host_Cycles += Bit_Cycles();
+		Owned = 0;
+		c->Busy_Cycles += Time_Host_Cycles - Started;
+	}
+	I2C_Host_Regs.MCS = status | ((Owned || Stuck_Busy) ? I2C_MCS_BUSBSY : 0);
+}
+
+/*
+ *	----------------------Sleep------------------------
+ *	Local helper, the core asleep until the running command ends,
+ *	or until the next SysTick if nothing ends it
+ *	Input: none
+ *	Output: 1 if the command ended
+ */
+static uint8_t Sleep(void) {
+	uint32_t cmd = I2C_Host_Regs.MCS;
+
+	if (!(cmd & I2C_MCS_RUN)) {
+		fprintf(stderr, "I2C.c sleeps with no command running\n");
+		exit(1);
+	}
+	if (Hung) {
+		Time_Host_Cycles = (Time_Host_Cycles / SYSCLK_CYCLES_PER_MS + 1) * SYSCLK_CYCLES_PER_MS;
+		return 0;
+	}
+	Run_Command(cmd);
+	return 1;
+}
+
+/* Target services I2C.c links against */
+extern "C" {
+void Idle_Sleep(void) {
+	if (Tasks_On) {
+		fprintf(stderr, "I2C.c sleeps in IDLE_WAIT with the kernel running\n");
+		exit(1);
+	}
+	Sleep();
+}
+
+void I2C_Host_Scl(uint8_t level) {
+	if (level && !Scl) {
+		Clocks++;
+		if (Sda_Held)
+			Sda_Held--;
+	}
+	Scl = level;
+}
+
+void I2C_Host_Sda(uint8_t level) {
+	if (level && !Sda && Scl && !Sda_Held)
+		Stops++;
+	Sda = level;
+}
+
+uint8_t I2C_Host_Sda_In(void) {
+	return Sda && !Sda_Held;
+}
+
+void I2C_Host_Reset(void) {
+	memset(&I2C_Host_Regs.MSA, 0, 7 * sizeof(uint32_t));			//Every I2C0 register
+	Hung = 0;
+	Stuck_Busy = 0;
+	Owned = 0;
+	Resets++;
+}
+}
+
+/*
+ *	--------------------Fault_Read---------------------
+ *	Local helper, one read of the MPU6050 WHO_AM_I with a fault
+ *	injected, then a clean read that must work again
+ *	Input: Fault, Name, Expected error, SCL clocks the recovery
+ *	needs to free SDA (the STOP adds one more)
+ *	Output: 1 if the driver handled it, 0 if not
+ */
+static int Fault_Read(Fault fault, const char* name, uint8_t expect, uint32_t clocks) {
+	uint32_t clocks_before = Clocks, stops_before = Stops, resets_before = Resets;
+	uint64_t start = Time_Host_Cycles, us;
+	uint8_t data = 0xAA, error, ok;
+
+	Armed = fault;
+	error = I2C0_Receive(0x68, 0x75, &data);
+	us = (Time_Host_Cycles - start) / SYSCLK_CYCLES_PER_US;
+	ok = error == expect && data == 0;
+	if (expect & I2C_ERR_TIMEOUT) {
+		/* Deadline, at most a tick late, then a recovery of a few SCL periods */
+		ok = ok && us <= I2C_TIMEOUT_US(4) + 1000 + 20 * I2C_RECOVER_HALF_US * 2;
+		ok = ok && Clocks - clocks_before == clocks + 1 && Stops - stops_before == 1 && Resets - resets_before == 1;
+	}
+	printf("%-14s error 0x%02x data 0x%02x %6llu us, recovery %u clocks %u stop %u reset", name, error, data,
+		(unsigned long long)us, Clocks - clocks_before, Stops - stops_before, Resets - resets_before);
+
+	error = I2C0_Receive(0x68, 0x75, &data);
+	ok = ok && error == 0 && data == 0x68;
+	printf(", next read 0x%02x%s\n", data, ok ? "" : "  FAILED");
+	return ok;
+}
+
+/*
+ *	--------------------Imu_Task-----------------------
+ *	Local helper, the control task of the arbitration run: one IMU
+ *	sample (Task_IMU reads 12 registers) per release, then sleep
+ *	Input: none
+ *	Output: none
+ */
+static void Imu_Task(void) {
+	uint8_t data;
+
+	for (;;) {
+		Imu_Waiting = Imu_Release;
+		for (int i = 0; i < 12; i++)
+			I2C0_Receive(0x68, 0x3B + i, &data);
+		if (Time_Host_Cycles - Imu_Release > Imu_Max_Sample)
+			Imu_Max_Sample = Time_Host_Cycles - Imu_Release;
+		Imu_Samples++;
+		Imu_Release += SIM_IMU_PERIOD;
+		Imu_Running = 0;
+		swapcontext(&Imu_Ctx, &Lcd_Ctx);
+	}
+}
+
+/*
+ *	-------------------Arbitrate-----------------------
+ *	Local helper, one LCD pattern flushed back to back for
+ *	SIM_ARB_SECONDS against the control task
+ *	Input: Name, LCD address, 1 for a burst per character as LCD.c
+ *	sends them, 0 for a whole frame per burst, where the CPU bound
+ *	third task runs
+ *	Output: 1 if no sample waited longer than one fragment of the
+ *	address (any time if it is sent whole), 0 if not. With the third
+ *	task above the LCD the other way round, it must break the bound
+ */
+static int Arbitrate(const char* name, uint8_t addr, int per_char, Cpu_Place cpu) {
+	static uint8_t frame[SIM_LCD_CHARS * 4];
+	uint32_t frag = I2C0_Device_Fragment(addr);
+	uint64_t bit = 2 * (6 + 4) * ((Speed_MTPR(&Speeds[0]) & I2C_MTPR_TPR_M) + 1);
+	uint64_t bound = (2 + 9 * (2 + frag)) * bit + 5 * SYSCLK_CYCLES_PER_US;	//START, bytes, STOP of one fragment
+	uint64_t end = Time_Host_Cycles + (uint64_t)SIM_ARB_SECONDS * SYSCLK_HZ;
+	int ok;
+
+	for (uint32_t i = 0; i < sizeof(frame); i++)
+		frame[i] = (uint8_t)(0x0D ^ i);
+	Imu_Max_Wait = Imu_Max_Sample = 0;
+	Imu_Samples = 0;
+	Imu_Release = Time_Host_Cycles;
+	Cpu_At = cpu;
+	Cpu_Release = Time_Host_Cycles + SIM_CPU_PERIOD / 2;
+	Cpu_Left = 0;
+	Cpu_Preempts = 0;
+	Tasks_On = 1;
+	while (Time_Host_Cycles < end) {
+		if (per_char) {
+			for (int c = 0; c < SIM_LCD_CHARS; c++) {
+				I2C0_Burst_Transmit(addr, 0x00, &frame[4 * c], 4);
+				Time_Spin_Until(Time_Stamp(), SIM_LCD_EXEC_US * SYSCLK_CYCLES_PER_US);
+			}
+		} else {
+			I2C0_Burst_Transmit(addr, 0x00, frame, sizeof(frame));
+			Time_Spin_Until(Time_Stamp(), SIM_LCD_EXEC_US * SYSCLK_CYCLES_PER_US);
+		}
+	}
+	Tasks_On = 0;
+	Cpu_At = CPU_NONE;
+
+	ok = frag == 0 || Imu_Max_Wait <= bound;
+	const char* note = ok ? "" : "  TOO LONG";
+	if (cpu == CPU_ABOVE_LCD) {
+		ok = !ok && Cpu_Preempts > 0;
+		note = ok ? "  (inversion, see I2C.h)" : "  NO INVERSION, third task not modeled";
+	}
+	printf("%-22s 0x%02x frag %3u  %4u samples, max wait %6llu us, max sample %6llu us%s\n", name, addr,
+		frag ? frag : (per_char ? 4 : (uint32_t)sizeof(frame)), Imu_Samples,
+		(unsigned long long)(Imu_Max_Wait / SYSCLK_CYCLES_PER_US),
+		(unsigned long long)(Imu_Max_Sample / SYSCLK_CYCLES_PER_US), note);
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000;
+	uint8_t lcd[4] = {0x0D, 0x09, 0x4D, 0x49};
+	uint8_t data, error;
+	int bad = 0;
+
+	Devices[0].Regs[0x75] = 0x68;										//WHO_AM_I
+	I2C0_Init();
+
+	/* Speed table, MTPR of I2C.c against the rates worked out here */
+	printf("SYSCLK %lu Hz\n", (unsigned long)SYSCLK_HZ);
+	for (int sp = 0; sp < I2C_SPEED_COUNT; sp++) {
+		const Speed* want = &Speeds[sp];
+		uint32_t mtpr = I2C0_Speed_MTPR((I2C_SPEED_t)sp), tpr = mtpr & I2C_MTPR_TPR_M;
+		double hz = SYSCLK_HZ / (2.0 * want->Lp_Hp * (tpr + 1));
+		int ok = mtpr == Speed_MTPR(want) && hz <= want->Hz && (uint32_t)hz == I2C0_Speed_HZ((I2C_SPEED_t)sp) &&
+			(tpr == 1 || SYSCLK_HZ / (2.0 * want->Lp_Hp * tpr) > want->Hz);
+
+		printf("%-10s MTPR 0x%02x %9.0f Hz of %9.0f%s\n", want->Name, mtpr, hz, want->Hz, ok ? "" : "  WRONG");
+		if (!ok)
+			bad = 1;
+	}
+
+	/* One pass of the full system test: IMU and color at 100 Hz, 6 LCD characters at 10 Hz */
+	for (uint32_t p = 0; p < passes; p++) {
+		for (int i = 0; i < 12; i++)
+			I2C0_Receive(0x68, 0x3B + i, &data);
+		for (int i = 0; i < 8; i++)
+			I2C0_Receive(0x29, 0x80 | (0x14 + i), &data);
+		if (p % 10 == 0)
+			for (int i = 0; i < 6; i++)
+				I2C0_Burst_Transmit(0x3F, 0x00, lcd, sizeof(lcd));
+		if (p % SIM_MISSING_EVERY == 0)
+			I2C0_Transmit(SIM_MISSING_ADDR, 0x00, 0x00);
+	}
+
+	uint64_t window = I2C0_Stats_Window();
+	printf("simulated %.3f s, %u passes, %u slots\n", (double)window / SYSCLK_HZ, passes, I2C0_Stats_Count());
+	printf("addr   xfer(I2C.c/model)    bytes          nack      arb     busy%%   max us\n");
+	if (I2C0_Stats_Count() != Counts_Used) {
+		printf("slot count %u, model %u\n", I2C0_Stats_Count(), Counts_Used);
+		bad = 1;
+	}
+	for (uint8_t i = 0; i < I2C0_Stats_Count() && i < Counts_Used; i++) {
+		I2C_STATS_t st;
+		const Count* c = &Counts[i];
+		uint32_t hist = 0;
+
+		I2C0_Stats_Read(i, &st);
+		for (int b = 0; b < I2C_HIST_BINS; b++)
+			hist += st.Hist[b];
+		printf("0x%02x %7u/%-7u %7u/%-7u %4u/%-4u %3u/%-3u %5.1f/%-5.1f %5u\n", st.Addr,
+			st.Transactions, c->Transactions, st.Bytes, c->Bytes, st.Nacks, c->Nacks, st.Arb_Lost, c->Arb_Lost,
+			100.0 * st.Busy_Cycles / window, 100.0 * c->Busy_Cycles / window, st.Max_Latency_US);
+		if (st.Addr != c->Addr || st.Transactions != c->Transactions || st.Bytes != c->Bytes || st.Nacks != c->Nacks ||
+			st.Arb_Lost != c->Arb_Lost || st.Busy_Cycles != c->Busy_Cycles || hist != st.Transactions) {
+			printf("  MISMATCH\n");
+			bad = 1;
+		}
+		if (c->Wrong_Speed) {
+			printf("  %u transfers not at MTPR 0x%02x\n", c->Wrong_Speed, Device_MTPR(c->Addr));
+			bad = 1;
+		}
+	}
+	printf(bad ? "accounting differs from the model\n" : "accounting matches the model\n");
+
+	/* Faults, each one must cost a deadline and a recovery, not the system */
+	I2C0_Stats_Reset();
+	int faults_ok = 1;
+	faults_ok &= Fault_Read(FAULT_SDA_LOW, "sda held low", I2C_ERR_TIMEOUT, SIM_SDA_HELD_CLOCKS);
+	faults_ok &= Fault_Read(FAULT_MASTER_BUSY, "master busy", I2C_ERR_TIMEOUT, 0);
+	faults_ok &= Fault_Read(FAULT_BUS_BUSY, "bus busy", I2C_ERR_TIMEOUT, 0);
+
+	error = I2C0_Receive(SIM_MISSING_ADDR, 0x00, &data);
+	int missing_ok = error == (I2C_ERR_ANY | I2C_ERR_NACK_ADDR) && data == 0;
+	printf("%-14s error 0x%02x data 0x%02x%s\n", "missing device", error, data, missing_ok ? "" : "  FAILED");
+
+	Devices[0].Regs[0x10] = I2C_ERR_ANY | I2C_ERR_NACK_ADDR;		//Data that reads like an error
+	error = I2C0_Receive(0x68, 0x10, &data);
+	int data_ok = error == 0 && data == (I2C_ERR_ANY | I2C_ERR_NACK_ADDR);
+	printf("%-14s error 0x%02x data 0x%02x%s\n", "error as data", error, data, data_ok ? "" : "  FAILED");
+
+	I2C_STATS_t st;
+	I2C0_Stats_Read(0, &st);
+	int stats_ok = st.Addr == 0x68 && st.Timeouts == 3;
+	printf("0x68 timeouts %u%s\n", st.Timeouts, stats_ok ? "" : "  FAILED");
+
+	/* Same faults once the kernel runs, the read blocks on I2C0_Done and times out there */
+	Tasks_On = 1;
+	Imu_Release = SIM_NEVER;
+	Task_Waits = 0;
+	faults_ok &= Fault_Read(FAULT_SDA_LOW, "sda low, task", I2C_ERR_TIMEOUT, SIM_SDA_HELD_CLOCKS);
+	faults_ok &= Fault_Read(FAULT_MASTER_BUSY, "busy, task", I2C_ERR_TIMEOUT, 0);
+	Tasks_On = 0;
+	if (Task_Waits == 0) {
+		printf("the task reads never blocked on I2C0_Done\n");
+		faults_ok = 0;
+	}
+
+	if (!(faults_ok && missing_ok && data_ok && stats_ok))
+		bad = 1;
+	printf(faults_ok && missing_ok && data_ok && stats_ok ? "faults recovered\n" : "fault handling failed\n");
+
+	/* IMU latency under a concurrent LCD flush */
+	getcontext(&Imu_Ctx);
+	Imu_Ctx.uc_stack.ss_sp = Imu_Stack;
+	Imu_Ctx.uc_stack.ss_size = sizeof(Imu_Stack);
+	Imu_Ctx.uc_link = 0;
+	makecontext(&Imu_Ctx, Imu_Task, 0);
+	int arb_ok = 1;
+	arb_ok &= Arbitrate("lcd.c per character", 0x3F, 1, CPU_NONE);
+	arb_ok &= Arbitrate("whole frame, split", 0x3F, 0, CPU_NONE);
+	Arbitrate("whole frame, unlisted", 0x27, 0, CPU_NONE);
+	arb_ok &= Arbitrate("cpu task below lcd", 0x3F, 1, CPU_BELOW_LCD);
+	arb_ok &= Arbitrate("cpu task between", 0x3F, 1, CPU_ABOVE_LCD);
+	if (!arb_ok)
+		bad = 1;
+	printf(arb_ok ? "imu waits at most one lcd fragment\n" : "imu waits longer than one lcd fragment\n");
+	return bad;
+}
@@ -0,0 +1,33 @@
+/*
+ * idle_host_port.h
+ *
+ *	Forced include (-include) when ../Idle.c is built on the host,
+ *	together with time_host_port.h. WFI calls Idle_Host_WFI, which
+ *	the model defines: it moves the Time.h virtual clock to the next
+ *	interrupt, as the core would sleep until then. Interrupts are
+ *	masked around every WFI, the model runs the handlers once
+ *	EndCritical unmasks them.
+ *
+ *		gcc -c -include time_host_port.h -include idle_host_port.h -I.. ../Idle.c
+ *
+ * Created on: December 2, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef IDLE_HOST_PORT_H_
+#define IDLE_HOST_PORT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Idle_Host_WFI(void);							//Sleep until the next interrupt is pending
+
+#ifdef __cplusplus
+}
+#endif
+
+#define IDLE_PORT_WFI()				Idle_Host_WFI()
+
+#endif
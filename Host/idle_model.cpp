@@ -0,0 +1,312 @@
+/*
+ * idle_model.cpp
+ *
+ *	Host model of the tickless idle at the default task rates of the
+ *	full system test. Builds ../Time.c, ../Timer.c, ../Idle.c and
+ *	../Sched.c against the Time.h virtual clock and runs the main
+ *	loop of I2CMain.c for a number of simulated seconds.
+ *
+ *	The tasks stand in for the real ones with an estimate of their
+ *	CPU time and of the waits that now sleep in IDLE_WAIT: one per
+ *	I2C transfer step at the I2CTable.h rates (400 kHz for the
+ *	sensors, 100 kHz for the LCD) and the UART refill interrupts
+ *	behind the text telemetry. The 37 us HD44780 execution time is
+ *	covered by the I2C bytes of the next character. WFI moves the clock to the next pending interrupt,
+ *	handlers run (and cost CPU time) when EndCritical unmasks
+ *	interrupts, as on the core. The control path is modeled as its
+ *	scheduler tasks, the kernel stubs never run a task.
+ *
+ *	It prints the time asleep as Idle.c accounts it (the "asleep"
+ *	line of the shell "stats" command) next to the model's own count
+ *	of cycles spent in WFI, and the wake-ups per second by source.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		gcc -O2 -I.. -include time_host_port.h -include timer_host_port.h -c ../Timer.c -o Timer.o
+ *		gcc -O2 -I.. -include time_host_port.h -include idle_host_port.h -c ../Idle.c -o Idle.o
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Sched.c -o Sched.o
+ *		g++ -O2 -std=c++17 idle_model.cpp Time.o Timer.o Idle.o Sched.o -o idle_model
+ *
+ *	Usage:
+ *		idle_model [seconds]
+ *
+ * Created on: December 2, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+#include "time_host_port.h"
+#include "timer_host_port.h"
+#include "../Idle.h"
+#include "../Kernel.h"
+#include "../Sched.h"
+#include "../Timer.h"
+#include "../UART0.h"
+void SysTick_Handler(void);
+}
+
+#define MODEL_NEVER						(0xFFFFFFFFFFFFFFFFULL)
+#define US(us)								((uint64_t)(us) * SYSCLK_CYCLES_PER_US)
+
+/* Target estimates, in us */
+#define I2C_BYTE_US						(90)				//9 SCL clocks at 100 kHz
+#define I2C_FAST_BYTE_US			(23)				//9 SCL clocks at 400 kHz
+#define I2C_STEP_CPU_US				(2)					//Register writes between two waits
+#define ISR_US								(2)					//Entry, handler and exit
+#define FUSION_CPU_US					(150)				//Two atan2, a sqrt, the filter
+#define COLOR_CPU_US					(40)
+#define TELEMETRY_CPU_US			(400)				//Formatting ~250 characters
+#define TELEMETRY_BYTES				(250)
+#define LCD_CHARS							(6)					//Cursor move and the changed digits
+#define UART_BYTE_US					(87)				//10 bits at 115200 baud
+#define UART_REFILL_BYTES			(14)				//FIFO refilled when it drains to 1/8
+
+/* Interrupt sources of the model */
+enum { SRC_SYSTICK, SRC_TIMER, SRC_DEVICE, SRC_UART, SRC_COUNT };
+static const char* const Src_Names[SRC_COUNT] = {"systick", "timer", "i2c/delay", "uart"};
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+volatile uint64_t Timer_Host_Match = MODEL_NEVER;
+volatile uint8_t Timer_Host_Triggered;
+}
+
+static long Masked;													//PRIMASK
+static uint64_t Tick_Next = MODEL_NEVER;		//Next SysTick, MODEL_NEVER while stopped
+static uint64_t Match_Fired = MODEL_NEVER;	//Match value the timer handler already ran for
+static uint64_t Device_Irq = MODEL_NEVER;		//End of the I2C step or delay being waited on
+static uint64_t Uart_Next = MODEL_NEVER;		//Next TX refill interrupt
+static uint32_t Uart_Bytes;									//Still to send
+static uint64_t Asleep;											//Cycles in Idle_Host_WFI
+static uint64_t Wakes[SRC_COUNT];
+
+/*
+ *	--------------------Next_Irq-----------------------
+ *	Local helper
+ *	Input: Source (written)
+ *	Output: Time the next interrupt becomes pending
+ */
+static uint64_t Next_Irq(int* src) {
+	uint64_t next = Tick_Next;
+
+	*src = SRC_SYSTICK;
+	if (Timer_Host_Triggered) {
+		*src = SRC_TIMER;
+		return Time_Host_Cycles;
+	}
+	if (Timer_Host_Match != Match_Fired && Timer_Host_Match < next) {
+		next = Timer_Host_Match;
+		*src = SRC_TIMER;
+	}
+	if (Device_Irq < next) {
+		next = Device_Irq;
+		*src = SRC_DEVICE;
+	}
+	if (Uart_Next < next) {
+		next = Uart_Next;
+		*src = SRC_UART;
+	}
+	return next;
+}
+
+/*
+ *	---------------------Dispatch----------------------
+ *	Local helper to run every handler that is pending, each costs
+ *	ISR_US of CPU time
+ *	Input: none
+ *	Output: none
+ */
+static void Dispatch(void) {
+	for (;;) {
+		uint64_t now = Time_Host_Cycles;
+
+		if (Tick_Next <= now) {
+			Tick_Next += US(1000);
+			SysTick_Handler();
+		} else if (Timer_Host_Triggered || (Timer_Host_Match != Match_Fired && Timer_Host_Match <= now)) {
+			Match_Fired = Timer_Host_Match;
+			WideTimer1A_Handler();
+		} else if (Device_Irq <= now) {
+			Device_Irq = MODEL_NEVER;
+		} else if (Uart_Next <= now) {
+			Uart_Bytes = (Uart_Bytes > UART_REFILL_BYTES) ? Uart_Bytes - UART_REFILL_BYTES : 0;
+			Uart_Next = Uart_Bytes ? Uart_Next + US(UART_REFILL_BYTES * UART_BYTE_US) : MODEL_NEVER;
+		} else {
+			return;
+		}
+		Time_Host_Cycles += US(ISR_US);
+	}
+}
+
+/* Target services the modules link against */
+extern "C" {
+long StartCritical(void) {
+	long sr = Masked;
+	Masked = 1;
+	return sr;
+}
+
+void EndCritical(long sr) {
+	Masked = sr;
+	if (!Masked)
+		Dispatch();
+}
+
+void Time_Host_Yield(void) {}
+
+void Time_Host_Tick(uint8_t on) {
+	Tick_Next = on ? Time_Host_Cycles + US(1000) : MODEL_NEVER;
+}
+
+void Idle_Host_WFI(void) {
+	int src;
+	uint64_t next = Next_Irq(&src);
+
+	if (next == MODEL_NEVER) {
+		fprintf(stderr, "WFI with no interrupt that could end it\n");
+		exit(1);
+	}
+	if (next > Time_Host_Cycles) {
+		Asleep += next - Time_Host_Cycles;
+		Time_Host_Cycles = next;
+	}
+	Wakes[src]++;													//Its handler runs once EndCritical unmasks
+}
+
+uint8_t Kernel_Next_Wake(uint32_t*) { return 0; }
+uint8_t Kernel_Running(void) { return 0; }
+uint8_t Kernel_Sem_Pend(KERNEL_SEM_t*, uint32_t) { return 0; }
+void Kernel_Sem_Post(KERNEL_SEM_t*) {}
+uint8_t UART0_RX_Pending(void) { return 0; }
+}
+
+/*
+ *	----------------------Cpu--------------------------
+ *	Local helper, awake work. Interrupts that fall due meanwhile run
+ *	right after it
+ *	Input: Time in us
+ *	Output: none
+ */
+static void Cpu(uint32_t us) {
+	Time_Host_Cycles += US(us);
+	if (!Masked)
+		Dispatch();
+}
+
+/*
+ *	---------------------Wait_Irq----------------------
+ *	Local helper, one wait that an interrupt ends (an I2C step or a
+ *	delay), through the same IDLE_WAIT as the drivers
+ *	Input: Time until the interrupt in us
+ *	Output: none
+ */
+static void Wait_Irq(uint32_t us) {
+	uint64_t done = Time_Host_Cycles + US(us);
+
+	Device_Irq = done;
+	IDLE_WAIT(Time_Host_Cycles < done);
+}
+
+/*
+ *	------------------I2C_Receive----------------------
+ *	Local helper, I2C0_Receive: address and register, then a repeated
+ *	start and the data byte
+ *	Input: Byte time of the device in us
+ *	Output: none
+ */
+static void I2C_Receive(uint32_t byte_us) {
+	Cpu(I2C_STEP_CPU_US);
+	Wait_Irq(2 * byte_us);
+	Cpu(I2C_STEP_CPU_US);
+	Wait_Irq(2 * byte_us);
+	Cpu(I2C_STEP_CPU_US);
+}
+
+/* Tasks of SchedTable.h */
+extern "C" {
+void Task_Button(void) {}
+void Task_Test(void) {}
+void Task_Servo(void) { Cpu(5); }
+void Task_Fusion(void) { Cpu(FUSION_CPU_US); }
+
+void Task_IMU(void) {
+	for (int i = 0; i < 12; i++)											//Six axes, two registers each
+		I2C_Receive(I2C_FAST_BYTE_US);
+}
+
+void Task_Color(void) {
+	for (int i = 0; i < 8; i++)												//Four channels, two registers each
+		I2C_Receive(I2C_FAST_BYTE_US);
+	Cpu(COLOR_CPU_US);
+}
+
+void Task_Telemetry(void) {
+	Cpu(TELEMETRY_CPU_US);
+	if (Uart_Bytes == 0)
+		Uart_Next = Time_Host_Cycles + US(UART_REFILL_BYTES * UART_BYTE_US);
+	Uart_Bytes += TELEMETRY_BYTES;
+}
+
+void Task_LCD(void) {
+	for (int c = 0; c < LCD_CHARS; c++) {
+		for (int f = 0; f < 2; f++) {										//A fragment per nibble (I2CTable.h)
+			Cpu(I2C_STEP_CPU_US);
+			Wait_Irq(2 * I2C_BYTE_US);										//Address and PCF8574 register
+			for (int i = 0; i < 2; i++) {									//EN high then low
+				Wait_Irq(I2C_BYTE_US);
+				Cpu(I2C_STEP_CPU_US);
+			}
+		}
+	}
+}
+}
+
+int main(int argc, char** argv) {
+	double seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+	uint64_t end;
+
+	Time_Host_Tick(1);
+	Timer_Init();
+	Sched_Init();
+	Sched_Enable(TASK_IMU);
+	Sched_Enable(TASK_FUSION);
+	Sched_Enable(TASK_SERVO);
+	Sched_Enable(TASK_COLOR);
+	Sched_Enable(TASK_TELEMETRY);
+	Sched_Enable(TASK_LCD);
+	Idle_Init();
+
+	/* Main_Loop of I2CMain.c, the shell, marquee and log have nothing to do */
+	end = Time_Host_Cycles + (uint64_t)(seconds * SYSCLK_HZ);
+	while (Time_Host_Cycles < end) {
+		long sr;
+
+		Sched_Run();
+		sr = StartCritical();
+		if (!UART0_RX_Pending())
+			Idle_Until(Sched_Next_Release());
+		EndCritical(sr);
+	}
+
+	uint64_t total = Time_Host_Cycles;
+	uint64_t wakes = 0;
+	printf("simulated        %8.2f s, full system test at the default rates\n", (double)total / SYSCLK_HZ);
+	printf("asleep (Idle.c)  %8.1f %%\n", Idle_Asleep_Permille() / 10.0);
+	printf("asleep (model)   %8.1f %%\n", 100.0 * Asleep / total);
+	for (int s = 0; s < SRC_COUNT; s++) {
+		printf("wake-ups %-9s %7.0f /s\n", Src_Names[s], Wakes[s] * (double)SYSCLK_HZ / total);
+		wakes += Wakes[s];
+	}
+	printf("wake-ups total   %8.0f /s\n", wakes * (double)SYSCLK_HZ / total);
+	for (int i = 0; i < SCHED_TASK_COUNT; i++) {
+		const SCHED_STATS_t* st = Sched_Stats((SCHED_ID_t)i);
+		if (st->Runs)
+			printf("%-10s runs %6u overruns %4u max exec %6u us\n", Sched_Name((SCHED_ID_t)i), st->Runs, st->Overruns, st->Max_Exec_US);
+	}
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * kernel_host_port.h
+ *
+ *	Forced include (-include) when ../Kernel.c is built on the host,
+ *	together with time_host_port.h for ../Time.c. There is no
+ *	context switch on the host: a pended switch calls
+ *	Kernel_Host_Switch, which the test program defines (usually
+ *	Kernel_Current = Kernel_Next) and then checks which task the
+ *	kernel picked. Task stacks are never used, blocking calls return
+ *	right after the task is taken off the ready set.
+ *
+ *		gcc -c -include kernel_host_port.h -I.. ../Kernel.c
+ *
+ *	The test program also provides StartCritical and EndCritical.
+ *
+ * Created on: November 30, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef KERNEL_HOST_PORT_H_
+#define KERNEL_HOST_PORT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Kernel_Host_Switch(void);					//Called for every pended switch
+
+#ifdef __cplusplus
+}
+#endif
+
+#define KERNEL_PORT_PEND_SWITCH()				Kernel_Host_Switch()
+#define KERNEL_PORT_STACK_INIT(top, func)	((void)(func), (top))
+#define KERNEL_PORT_START()							(Kernel_Next = Kernel_Current = 0, Kernel_Reschedule())
+
+#endif
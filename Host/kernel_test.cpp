@@ -0,0 +1,488 @@
+/*
+ * kernel_test.cpp
+ *
+ *	Host checks of the ../Kernel.c scheduling logic. There is no
+ *	context switch on the host (kernel_host_port.h): a pended switch
+ *	makes Kernel_Next the running task at once, and a blocking call
+ *	returns as soon as the task is off the ready set. The test then
+ *	acts for whichever task the kernel picked.
+ *
+ *	A reference model tracks every task (ready, sleeping, blocked on
+ *	a semaphore with or without a timeout) and every semaphore count.
+ *	After each step the running task has to be the highest priority
+ *	ready task of the model, the counts and waiting sets have to
+ *	match and a woken task has to carry the right result (1 posted,
+ *	0 timed out). Covered:
+ *		- Kernel_Task_Create: taken priority, short stack, priority
+ *		  out of range, the stack fill, a task created after
+ *		  Kernel_Start preempting at once
+ *		- Kernel_Sleep and Kernel_Tick, a timeout never ends early
+ *		- semaphores: count taken without blocking, pend with no
+ *		  wait, the highest priority waiter woken first, a timed out
+ *		  waiter no longer waiting
+ *		- queues: order, capacity of Size - 1 and drops
+ *		- Kernel_Delay_Until: fixed rate, restart after a whole
+ *		  missed period
+ *		- Kernel_Next_Wake across the wrap of Time_Now_MS
+ *		- random sleeps, pends, posts from interrupts and ticks
+ *		  against the model
+ *	Time_Now_MS starts just below its wrap, the sleeps and timeouts
+ *	of the directed checks cross it. The idle task never blocks.
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		gcc -O2 -I.. -include kernel_host_port.h -c ../Kernel.c -o Kernel.o
+ *		g++ -O2 -std=c++17 kernel_test.cpp Time.o Kernel.o -o kernel_test
+ *
+ *	Usage:
+ *		kernel_test [random steps]
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+#include "time_host_port.h"
+#include "kernel_host_port.h"
+#include "../Kernel.h"
+#include "../Time.h"
+}
+
+#define TASKS				(9)						//Priorities 0 to 8, 0 created after Kernel_Start
+#define SEMS				(3)
+#define STACK_WORDS	(KERNEL_STACK_MIN_WORDS)
+#define TICKS_NEAR_WRAP	(0xFFFFFF00UL)		//Time_Now_MS a little below its wrap
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+
+long StartCritical(void) { return 0; }
+void EndCritical(long sr) { (void)sr; }
+void Time_Host_Yield(void) {}
+void Time_Host_Tick(uint8_t on) { (void)on; }
+void SysTick_Handler(void);
+
+static uint32_t Switches;
+
+void Kernel_Host_Switch(void) {
+	Kernel_Current = Kernel_Next;
+	Switches++;
+}
+}
+
+static void Never_Runs(void) {}
+
+/* Model of one task */
+enum State { READY, SLEEPING, PENDING };
+
+struct Model {
+	State state;
+	int sem;											//PENDING on this semaphore
+	bool timed;
+	uint32_t wake;								//Time_Now_MS it times out
+	int result;										//Expected Result once woken, -1 = not checked
+};
+
+static KERNEL_TASK_t Tasks[TASKS], Idle;
+static uint32_t Stacks[TASKS][STACK_WORDS], Idle_Stack[STACK_WORDS];
+static Model Models[TASKS];
+static bool Created[TASKS];
+static KERNEL_SEM_t Sems[SEMS];
+static uint32_t Counts[SEMS];
+
+static uint32_t Checks, Failures;
+
+/* Reproducible data, xorshift32 */
+static uint32_t Seed = 0x1B873593;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked
+ *	Output: none
+ */
+static void Check(bool ok, const char* what) {
+	Checks++;
+	if (!ok && Failures++ < 20)
+		printf("  FAILED at %u ms: %s\n", Time_Now_MS(), what);
+}
+
+/*
+ *	---------------------Tick--------------------------
+ *	Local helper, one SysTick: Time_Now_MS and Kernel_Tick, and
+ *	the timeouts of the model
+ *	Input: none
+ *	Output: none
+ */
+static void Tick(void) {
+	Time_Host_Cycles += SYSCLK_CYCLES_PER_MS;
+	SysTick_Handler();
+	uint32_t now = Time_Now_MS();
+	for (int p = 0; p < TASKS; p++) {
+		Model& m = Models[p];
+		if (Created[p] && m.state != READY && m.timed && (int32_t)(now - m.wake) >= 0) {
+			m.state = READY;
+			m.result = 0;
+		}
+	}
+	Kernel_Tick();
+}
+
+/*
+ *	---------------------Verify------------------------
+ *	Local helper, the kernel against the model
+ *	Input: none
+ *	Output: none
+ */
+static void Verify(void) {
+	KERNEL_TASK_t* expect = &Idle;
+	uint32_t waiting[SEMS] = {};
+
+	for (int p = TASKS - 1; p >= 0; p--) {
+		if (!Created[p])
+			continue;
+		if (Models[p].state == READY)
+			expect = &Tasks[p];
+		if (Models[p].state == PENDING)
+			waiting[Models[p].sem] |= 1UL << p;
+		if (Models[p].state == READY && Models[p].result >= 0) {
+			Check(Tasks[p].Result == Models[p].result, "a woken task carries its result");
+			Models[p].result = -1;
+		}
+	}
+	Check(Kernel_Current == expect, "the highest priority ready task runs");
+	for (int s = 0; s < SEMS; s++) {
+		Check(Sems[s].Count == Counts[s], "semaphore count");
+		Check(Sems[s].Waiting == waiting[s], "semaphore waiting set");
+	}
+}
+
+/*
+ *	---------------------Running-----------------------
+ *	Local helper
+ *	Input: none
+ *	Output: Priority of the running test task, -1 for the idle task
+ */
+static int Running(void) {
+	return (Kernel_Current == &Idle) ? -1 : Kernel_Current->Prio;
+}
+
+/*
+ *	---------------------Sleep-------------------------
+ *	Local helper, Kernel_Sleep by the running task
+ *	Input: Time in ms
+ *	Output: none
+ */
+static void Sleep(uint32_t ms) {
+	int p = Running();
+
+	if (p < 0)
+		return;
+	if (ms) {
+		Models[p] = {SLEEPING, 0, true, Time_Now_MS() + ms, -1};
+	}
+	Kernel_Sleep(ms);
+}
+
+/*
+ *	----------------------Pend-------------------------
+ *	Local helper, Kernel_Sem_Pend by the running task
+ *	Input: Semaphore, Timeout in ms
+ *	Output: none
+ */
+static void Pend(int s, uint32_t timeout) {
+	int p = Running();
+
+	if (p < 0)
+		return;
+	if (Counts[s]) {
+		Counts[s]--;
+		Check(Kernel_Sem_Pend(&Sems[s], timeout) == 1, "a count is taken without blocking");
+		return;
+	}
+	if (timeout == 0) {
+		Check(Kernel_Sem_Pend(&Sems[s], 0) == 0, "a pend with no wait returns 0");
+		return;
+	}
+	Models[p] = {PENDING, s, timeout != KERNEL_WAIT_FOREVER, Time_Now_MS() + timeout, -1};
+	Kernel_Sem_Pend(&Sems[s], timeout);
+}
+
+/*
+ *	----------------------Post-------------------------
+ *	Local helper, Kernel_Sem_Post from an interrupt
+ *	Input: Semaphore
+ *	Output: none
+ */
+static void Post(int s) {
+	for (int p = 0; p < TASKS; p++) {
+		if (Created[p] && Models[p].state == PENDING && Models[p].sem == s) {
+			Models[p].state = READY;
+			Models[p].result = 1;
+			Kernel_Sem_Post(&Sems[s]);
+			return;
+		}
+	}
+	Counts[s]++;
+	Kernel_Sem_Post(&Sems[s]);
+}
+
+/*
+ *	------------------Test_Create----------------------
+ *	Local helper, Kernel_Task_Create and Kernel_Start
+ *	Input: none
+ *	Output: none
+ */
+static void Test_Create(void) {
+	static uint32_t spare[STACK_WORDS];
+	static KERNEL_TASK_t other;
+
+	Check(Kernel_Task_Create(&Idle, "idle", Never_Runs, Idle_Stack, STACK_WORDS, KERNEL_PRIO_IDLE), "create idle");
+	for (int p = 1; p < TASKS; p++) {
+		Created[p] = Kernel_Task_Create(&Tasks[p], "task", Never_Runs, Stacks[p], STACK_WORDS, (uint8_t)p);
+		Models[p] = {READY, 0, false, 0, -1};
+		Check(Created[p], "create a task");
+	}
+	Check(!Kernel_Task_Create(&other, "taken", Never_Runs, spare, STACK_WORDS, 3), "a taken priority is refused");
+	Check(!Kernel_Task_Create(&other, "short", Never_Runs, spare, STACK_WORDS - 1, 20), "a short stack is refused");
+	Check(!Kernel_Task_Create(&other, "range", Never_Runs, spare, STACK_WORDS, KERNEL_PRIO_COUNT),
+		"a priority out of range is refused");
+	Check(Kernel_Stack_Unused(&Tasks[4]) == STACK_WORDS, "the stack is filled");
+	Check(Switches == 0 && !Kernel_Running(), "nothing runs before Kernel_Start");
+
+	Kernel_Start();
+	Check(Kernel_Running(), "Kernel_Running after Kernel_Start");
+	Verify();
+
+	/* A higher priority task created by a running task preempts it */
+	Created[0] = Kernel_Task_Create(&Tasks[0], "late", Never_Runs, Stacks[0], STACK_WORDS, 0);
+	Models[0] = {READY, 0, false, 0, -1};
+	Verify();
+	printf("create   %u checks, running %s\n", Checks, Kernel_Current->Name);
+}
+
+/*
+ *	-------------------Test_Block----------------------
+ *	Local helper, directed sleeps, pends, posts and timeouts
+ *	Input: none
+ *	Output: none
+ */
+static void Test_Block(void) {
+	/* Everyone sleeps a different time, each one wakes on its own tick */
+	for (int p = 0; p < TASKS; p++) {
+		Sleep(3 + p);
+		Verify();
+	}
+	Check(Kernel_Current == &Idle, "the idle task runs once everyone sleeps");
+
+	uint32_t wake = 0;
+	Check(Kernel_Next_Wake(&wake) && wake == Time_Now_MS() + 3, "Kernel_Next_Wake is the earliest timeout");
+	for (int t = 0; t < 2; t++) {
+		Tick();
+		Verify();
+	}
+	Check(Kernel_Current == &Idle, "no timeout ends early");
+	for (int t = 0; t < TASKS; t++) {
+		Tick();
+		Verify();
+		Check(Running() == t, "the woken task runs on its tick");
+		Sleep(1000);
+		Verify();
+	}
+
+	/* Wake them all again for the semaphore checks */
+	for (int t = 0; t < 1000; t++)
+		Tick();
+	Verify();
+
+	/* Pends of 0 to 4 on semaphore 0, 5 to 8 on semaphore 1 with a timeout */
+	for (int p = 0; p < TASKS; p++) {
+		Pend(p < 5 ? 0 : 1, p < 5 ? KERNEL_WAIT_FOREVER : 10);
+		Verify();
+	}
+	Post(0);
+	Verify();
+	Check(Running() == 0, "a post wakes the highest priority waiter");
+	Pend(0, KERNEL_WAIT_FOREVER);
+	Verify();
+	for (int t = 0; t < 10; t++) {
+		Tick();
+		Verify();
+		while (Running() >= 5) {
+			Sleep(50);
+			Verify();
+		}
+	}
+	Check(Sems[1].Waiting == 0, "timed out tasks no longer wait");
+	Post(1);
+	Post(1);
+	Verify();
+	Check(Sems[1].Count == 2, "posts with no waiter are counted");
+	for (int i = 0; i < 5; i++) {
+		Post(0);
+		Verify();
+		Sleep(2000);
+		Verify();
+	}
+	printf("block    %u checks\n", Checks);
+}
+
+/*
+ *	-------------------Test_Queue----------------------
+ *	Local helper, Kernel_Queue order, capacity and drops
+ *	Input: none
+ *	Output: none
+ */
+static void Test_Queue(void) {
+	KERNEL_QUEUE_t q;
+	uint32_t buf[8], msg = 0;
+	uint32_t sent = 0, got = 0, bad = 0;
+
+	Kernel_Queue_Init(&q, buf, 8);
+	for (uint32_t i = 0; i < 10; i++)
+		sent += Kernel_Queue_Send(&q, 100 + i);
+	Check(sent == 7 && q.Dropped == 3, "a queue holds Size - 1");
+	for (uint32_t i = 0; i < 7; i++) {
+		got += Kernel_Queue_Receive(&q, &msg, 0);
+		bad += msg != 100 + i;
+	}
+	Check(got == 7 && bad == 0, "messages come out in order");
+	Check(!Kernel_Queue_Receive(&q, &msg, 0), "an empty queue with no wait returns 0");
+
+	/* Wrap the ring a few times */
+	for (uint32_t i = 0; i < 50; i++) {
+		Kernel_Queue_Send(&q, i);
+		Kernel_Queue_Send(&q, i + 1000);
+		Kernel_Queue_Receive(&q, &msg, 0);
+		bad += msg != i;
+		Kernel_Queue_Receive(&q, &msg, 0);
+		bad += msg != i + 1000;
+	}
+	Check(bad == 0 && q.Dropped == 3, "the ring wraps");
+	printf("queue    %u checks\n", Checks);
+}
+
+/*
+ *	----------------Test_Delay_Until-------------------
+ *	Local helper, a fixed rate loop and a missed period
+ *	Input: none
+ *	Output: none
+ */
+static void Test_Delay_Until(void) {
+	uint32_t last, first, runs = 0, drift = 0;
+
+	/* Wake every task, then put all but the top one to sleep */
+	for (int t = 0; t < 3000; t++)
+		Tick();
+	Verify();
+	Sleep(5);
+	while (Running() >= 0) {
+		Sleep(1000);
+		Verify();
+	}
+	for (int t = 0; t < 5; t++)
+		Tick();
+	Verify();
+	Check(Running() == 0, "only the top task is ready");
+
+	last = first = Time_Now_MS();
+	for (uint32_t i = 1; i <= 20; i++) {
+		Models[0] = {SLEEPING, 0, true, first + 7 * i, -1};
+		Kernel_Delay_Until(&last, 7);
+		while (Running() != 0)
+			Tick();
+		runs++;
+		drift += Time_Now_MS() != first + 7 * i;
+		if (i == 10)
+			Tick(), Tick();																	//Late, but less than a period
+	}
+	Check(runs == 20 && drift == 0, "Kernel_Delay_Until keeps a fixed rate");
+
+	for (int t = 0; t < 25; t++)
+		Tick();																					//Three periods behind
+	uint32_t before = Time_Now_MS();
+	Kernel_Delay_Until(&last, 7);
+	Check(Running() == 0 && last == before, "a whole missed period restarts from now");
+	Verify();
+	printf("delay    %u checks\n", Checks);
+}
+
+/*
+ *	-------------------Test_Random---------------------
+ *	Local helper, random steps against the model
+ *	Input: Steps
+ *	Output: none
+ */
+static void Test_Random(uint32_t steps) {
+	uint32_t ticks = 0, pends = 0, posts = 0, sleeps = 0;
+	uint32_t idle = 0;
+
+	for (int t = 0; t < 1000; t++)
+		Tick();
+	Verify();
+	for (uint32_t i = 0; i < steps; i++) {
+		uint32_t r = Next() % 100;
+
+		if (r < 30) {
+			Tick();
+			ticks++;
+		} else if (r < 55) {
+			Post(Next() % SEMS);
+			posts++;
+		} else if (r < 80) {
+			uint32_t w = Next() % 4;
+			Pend(Next() % SEMS, w == 0 ? 0 : w == 1 ? KERNEL_WAIT_FOREVER : 1 + Next() % 30);
+			pends++;
+		} else {
+			Sleep(Next() % 40);
+			sleeps++;
+		}
+		Verify();
+		idle += Kernel_Current == &Idle;
+
+		uint32_t wake;
+		if (Kernel_Next_Wake(&wake)) {
+			bool later = true;
+			for (int p = 0; p < TASKS; p++) {
+				if (Created[p] && Models[p].state != READY && Models[p].timed)
+					later &= (int32_t)(Models[p].wake - wake) >= 0;
+			}
+			Check(later && (int32_t)(wake - Time_Now_MS()) > 0, "Kernel_Next_Wake is the earliest timeout");
+		}
+	}
+	printf("random   %u steps: %u ticks, %u posts, %u pends, %u sleeps, idle %u, now %u ms, %u switches\n", steps,
+		ticks, posts, pends, sleeps, idle, Time_Now_MS(), Switches);
+}
+
+int main(int argc, char** argv) {
+	uint32_t steps = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+
+	/* Time_Now_MS starts a little below its wrap */
+	Time_Host_Cycles = (uint64_t)TICKS_NEAR_WRAP * SYSCLK_CYCLES_PER_MS;
+	Time_Tick_Resume();
+	for (int s = 0; s < SEMS; s++)
+		Kernel_Sem_Init(&Sems[s], 0);
+
+	Test_Create();
+	Test_Block();
+	Test_Queue();
+	Test_Delay_Until();
+	Test_Random(steps);
+
+	printf("%u checks, %u failed\n", Checks, Failures);
+	return Failures != 0;
+}
@@ -0,0 +1,309 @@
+/*
+ * lcd_check.cpp
+ *
+ *	Host checks of the ../LCD.c marquee. The I2C writes to the
+ *	PCF8574A backpack are decoded back into HD44780 instructions
+ *	(a nibble is latched on every EN falling edge) and run on a
+ *	model of the two 40 character DDRAM lines, the address counter
+ *	and the display shift. TIMER1A is a plain struct, the check
+ *	calls Timer1A_Handler itself.
+ *
+ *	Covered, for every row of the configured geometry:
+ *		- the span LCD_Marquee_Start writes: from the row to the end
+ *		  of its DDRAM line, the message cut or padded with spaces,
+ *		  nothing else in DDRAM changed
+ *		- TIMER1A periodic at the step period, its interrupt armed
+ *		- one display shift command per tick, sent by
+ *		  LCD_Marquee_Service and nothing else, also for ticks that
+ *		  piled up between two calls, and LCD_Marquee_Pending
+ *		- the visible row after each step, around the wrap of the line
+ *		- LCD_Marquee_Stop: timer off, display back home, ticks left
+ *		  over are not sent, and the next LCD_Flush redraws the frame
+ *		  buffer on every row
+ *		- a new marquee while one runs, and a row out of range
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder), the same LCD_GEOMETRY for both (add
+ *	-DLCD_GEOMETRY=LCD_20X4 or LCD_40X2 to check another panel):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		gcc -O2 -c ../Format.c -o Format.o
+ *		gcc -O2 -I.. -include time_host_port.h -include lcd_host_port.h -DPROFILE_ENABLE=0 -c ../LCD.c -o LCD.o
+ *		g++ -O2 -std=c++17 -I.. -DPROFILE_ENABLE=0 lcd_check.cpp Time.o Format.o LCD.o -o lcd_check
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include "time_host_port.h"
+#include "lcd_host_port.h"
+#include "../LCD.h"
+#include "../I2C.h"
+void Timer1A_Handler(void);
+}
+
+#define DDRAM_LINE						(40)
+
+static const uint8_t Row_Offset[LCD_ROWS] = LCD_ROW_OFFSETS;
+
+/* HD44780 model */
+static uint8_t Ddram[2][DDRAM_LINE];
+static uint8_t Ac;											//Address counter
+static int Shift;												//Display shift, left steps
+static uint8_t Pcf = 0;									//Last byte on the PCF8574A pins
+static int Nibble = -1;									//Upper half of an instruction, -1 if none
+static uint32_t Instructions, Shifts, Data_Writes;
+
+static uint32_t Checks, Failures;
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+LCD_HOST_REGS_t Lcd_Host_Regs;
+
+void Time_Host_Yield(void) { Time_Host_Cycles += 1; }
+void Time_Host_Tick(uint8_t) {}
+void DELAY_US(uint32_t us) { Time_Host_Cycles += (uint64_t)us * SYSCLK_CYCLES_PER_US; }
+void Idle_Notify(void) {}
+}
+
+/*
+ *	--------------------Execute------------------------
+ *	Local helper, one HD44780 instruction or data write
+ *	Input: Byte, RS
+ *	Output: none
+ */
+static void Execute(uint8_t b, uint8_t rs) {
+	Instructions++;
+	if (rs) {
+		Ddram[(Ac & 0x40) ? 1 : 0][Ac & 0x3F] = b;
+		Data_Writes++;
+		if (Ac == 0x40 + DDRAM_LINE - 1)
+			Ac = 0x00;
+		else if (Ac == DDRAM_LINE - 1)
+			Ac = 0x40;
+		else
+			Ac++;
+	} else if (b & SET_DDRAM_CMD) {
+		Ac = b & 0x7F;
+	} else if (b & SHIFT_CMD) {
+		if (b & SHIFT_DISPLAY) {
+			Shift += (b & SHIFT_RIGHT) ? -1 : 1;
+			Shifts++;
+		}
+	} else if (b & FUNC_MODE) {
+	} else if (b & DISP_CMD) {
+	} else if (b & ENTRY_MODE_CMD) {
+	} else if (b & RETURN_HOME_CMD) {
+		Ac = 0;
+		Shift = 0;
+	} else if (b == CLEAR_DISP_CMD) {
+		memset(Ddram, ' ', sizeof(Ddram));
+		Ac = 0;
+		Shift = 0;
+	}
+}
+
+/*
+ *	---------------------Pins--------------------------
+ *	Local helper, one byte written to the PCF8574A. A nibble is
+ *	latched when EN falls, two make an instruction (4-bit mode)
+ *	Input: Byte
+ *	Output: none
+ */
+static void Pins(uint8_t b) {
+	if ((Pcf & EN_Pin) && !(b & EN_Pin)) {
+		uint8_t n = Pcf & UPPER_NIBBLE_MSK;
+		if (Nibble < 0) {
+			Nibble = n;
+		} else {
+			Execute((uint8_t)(Nibble | (n >> NIBBLE_SHIFT)), Pcf & RS_Pin);
+			Nibble = -1;
+		}
+	}
+	Pcf = b;
+}
+
+extern "C" {
+uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data) {
+	if (slave_addr == LCD_WRITE_ADDR) {
+		Pins(slave_reg_addr);
+		Pins(data);
+	}
+	return 0;
+}
+
+/* The buffer goes out from its end, as I2C.c sends it */
+uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size) {
+	if (slave_addr == LCD_WRITE_ADDR) {
+		Pins(slave_reg_addr);
+		while (size > 0)
+			Pins(data[--size]);
+	}
+	return 0;
+}
+}
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked, Row
+ *	Output: none
+ */
+static void Check(bool ok, const char* what, int row) {
+	Checks++;
+	if (!ok && Failures++ < 20)
+		printf("  FAILED row %d: %s\n", row + 1, what);
+}
+
+/*
+ *	---------------------Visible-----------------------
+ *	Local helper, what a row of the panel shows
+ *	Input: Row
+ *	Output: The LCD_COLS characters
+ */
+static std::string Visible(int row) {
+	std::string s;
+	uint8_t line = (Row_Offset[row] & 0x40) ? 1 : 0;
+	int start = Row_Offset[row] & 0x3F;
+
+	for (int c = 0; c < LCD_COLS; c++)
+		s += (char)Ddram[line][(((start + c + Shift) % DDRAM_LINE) + DDRAM_LINE) % DDRAM_LINE];
+	return s;
+}
+
+/*
+ *	--------------------Fill_Frame---------------------
+ *	Local helper, a different letter on every row of the frame
+ *	buffer, flushed so the display matches it
+ *	Input: none
+ *	Output: none
+ */
+static void Fill_Frame(std::string frame[LCD_ROWS]) {
+	for (int r = 0; r < LCD_ROWS; r++) {
+		frame[r] = std::string(LCD_COLS, (char)('a' + r));
+		frame[r][0] = (char)('0' + r);
+		LCD_Buf_Write((uint8_t)r, 0, frame[r].c_str());
+	}
+	LCD_Flush();
+}
+
+/*
+ *	--------------------Check_Row----------------------
+ *	Local helper, a marquee on one row from start to stop
+ *	Input: Row, Message, Step Period in ms
+ *	Output: none
+ */
+static void Check_Row(int row, const char* msg, uint32_t step_ms) {
+	std::string frame[LCD_ROWS];
+	uint8_t before[2][DDRAM_LINE];
+	uint8_t line = (Row_Offset[row] & 0x40) ? 1 : 0;
+	int start = Row_Offset[row] & 0x3F;
+	int len = DDRAM_LINE - start;
+	size_t msg_len = strlen(msg);
+
+	Fill_Frame(frame);
+	memcpy(before, Ddram, sizeof(Ddram));
+
+	LCD_Marquee_Start((uint8_t)row, msg, step_ms);
+
+	/* Span: the rest of the DDRAM line, everything else as it was */
+	bool span = true, rest = true;
+	for (int l = 0; l < 2; l++) {
+		for (int p = 0; p < DDRAM_LINE; p++) {
+			if (l == line && p >= start) {
+				uint8_t want = (size_t)(p - start) < msg_len ? (uint8_t)msg[p - start] : ' ';
+				span &= Ddram[l][p] == want;
+			} else {
+				rest &= Ddram[l][p] == before[l][p];
+			}
+		}
+	}
+	Check(span, "message written from the row to the end of its DDRAM line", row);
+	Check(rest, "nothing outside the span written", row);
+	Check(Shift == 0 && Visible(row) == std::string(msg, std::min<size_t>(msg_len, LCD_COLS)) +
+		std::string(LCD_COLS - std::min<size_t>(msg_len, LCD_COLS), ' '), "row shows the start of the message", row);
+
+	/* Timer */
+	Check((Lcd_Host_Regs.CTL & TIMER_CTL_TAEN) && Lcd_Host_Regs.TAMR == TIMER_TAMR_TAMR_PERIOD &&
+		Lcd_Host_Regs.TAILR == step_ms * LCD_TIMER_TICKS_PER_MS - 1, "TIMER1A periodic at the step", row);
+	Check((Lcd_Host_Regs.IMR & TIMER_IMR_TATOIM) && (Lcd_Host_Regs.EN0 & NVIC_EN0_TIMER1A), "TIMER1A interrupt armed", row);
+
+	/* Steps: nothing is sent from the interrupt, one shift per tick from the service */
+	Check(!LCD_Marquee_Pending(), "nothing pending before a tick", row);
+	LCD_Marquee_Service();
+	int steps = 0;
+	for (int round = 1; round <= 30; round++) {
+		int ticks = (round % 7 == 0) ? 5 : 1;						//Some ticks pile up between services
+		uint32_t i0 = Instructions;
+		for (int t = 0; t < ticks; t++)
+			Timer1A_Handler();
+		Check(Instructions == i0, "the interrupt sends nothing", row);
+		Check(LCD_Marquee_Pending(), "pending after a tick", row);
+
+		uint32_t s0 = Shifts;
+		LCD_Marquee_Service();
+		steps += ticks;
+		Check(Instructions - i0 == (uint32_t)ticks && Shifts - s0 == (uint32_t)ticks, "one shift command per tick", row);
+		Check(!LCD_Marquee_Pending(), "nothing pending after the service", row);
+
+		std::string want;
+		for (int c = 0; c < LCD_COLS; c++) {
+			int p = (start + c + steps) % DDRAM_LINE;
+			want += (p >= start && (size_t)(p - start) < msg_len && p - start < len) ? msg[p - start] :
+				(char)((p >= start) ? ' ' : before[line][p]);
+		}
+		Check(Visible(row) == want, "row scrolled by the steps so far", row);
+	}
+
+	/* Stop: home, timer off, late ticks dropped, the flush redraws every row */
+	Timer1A_Handler();
+	LCD_Marquee_Stop();
+	Check(Shift == 0 && Ac == 0, "stop returns the display home", row);
+	Check(!(Lcd_Host_Regs.CTL & TIMER_CTL_TAEN) && !(Lcd_Host_Regs.IMR & TIMER_IMR_TATOIM), "stop disarms TIMER1A", row);
+	Check(!LCD_Marquee_Pending(), "nothing pending after a stop", row);
+	uint32_t s0 = Shifts;
+	LCD_Marquee_Service();
+	Check(Shifts == s0, "no shift after a stop", row);
+	LCD_Flush();
+	bool redrawn = true;
+	for (int r = 0; r < LCD_ROWS; r++)
+		redrawn &= Visible(r) == frame[r];
+	Check(redrawn, "the next flush redraws the frame buffer", row);
+}
+
+int main(void) {
+	static const char* const msgs[] = {"Oliver Cabral and Jason Chan", "x", "",
+		"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJ"};
+
+	LCD_Init();
+	Check(Ac == 0 && Shift == 0, "LCD_Init leaves the display home", 0);
+
+	for (int row = 0; row < LCD_ROWS; row++) {
+		for (const char* m : msgs)
+			Check_Row(row, m, 250);
+	}
+
+	/* A new marquee while one runs starts from home */
+	LCD_Marquee_Start(ROW1, msgs[0], 100);
+	Timer1A_Handler();
+	Timer1A_Handler();
+	LCD_Marquee_Service();
+	Check(Shift == 2, "two steps", 0);
+	Check_Row(LCD_ROWS - 1, msgs[0], 500);
+
+	/* Out of range falls back to row 1, as LCD_Set_Cursor does */
+	LCD_Marquee_Start(LCD_ROWS, "fallback", 100);
+	Check(memcmp(Ddram[0], "fallback", 8) == 0 && Ac == 0x40, "row out of range writes row 1", 0);
+	LCD_Marquee_Stop();
+
+	printf("%u x %u panel, %u checks, %u failed\n", LCD_COLS, LCD_ROWS, Checks, Failures);
+	return Failures != 0;
+}
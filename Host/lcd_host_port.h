@@ -0,0 +1,62 @@
+/*
+ * lcd_host_port.h
+ *
+ *	Forced include (-include) when ../LCD.c is built on the host,
+ *	together with time_host_port.h. Pulls in the real register
+ *	header first, so the later include in LCD.c is skipped, then
+ *	points the TIMER1A marquee and setup registers at a plain
+ *	struct the check owns (Host/lcd_check.cpp).
+ *
+ *		gcc -c -include time_host_port.h -include lcd_host_port.h -DPROFILE_ENABLE=0 -I.. ../LCD.c
+ *
+ *	The check also provides I2C0_Transmit, I2C0_Burst_Transmit
+ *	(decoded into an HD44780 model), DELAY_US and Idle_Notify.
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef LCD_HOST_PORT_H_
+#define LCD_HOST_PORT_H_
+
+#include <stdint.h>
+#include "../tm4c123gh6pm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Registers LCD.c touches, one field each */
+typedef struct{
+	uint32_t CTL, CFG, TAMR, TAILR, ICR, IMR;
+	uint32_t RCGCTIMER, PRI5, EN0;
+} LCD_HOST_REGS_t;
+
+extern LCD_HOST_REGS_t Lcd_Host_Regs;
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef TIMER1_CTL_R
+#undef TIMER1_CFG_R
+#undef TIMER1_TAMR_R
+#undef TIMER1_TAILR_R
+#undef TIMER1_ICR_R
+#undef TIMER1_IMR_R
+#undef SYSCTL_RCGCTIMER_R
+#undef NVIC_PRI5_R
+#undef NVIC_EN0_R
+
+#define TIMER1_CTL_R					(Lcd_Host_Regs.CTL)
+#define TIMER1_CFG_R					(Lcd_Host_Regs.CFG)
+#define TIMER1_TAMR_R					(Lcd_Host_Regs.TAMR)
+#define TIMER1_TAILR_R				(Lcd_Host_Regs.TAILR)
+#define TIMER1_ICR_R					(Lcd_Host_Regs.ICR)
+#define TIMER1_IMR_R					(Lcd_Host_Regs.IMR)
+#define SYSCTL_RCGCTIMER_R		(Lcd_Host_Regs.RCGCTIMER)
+#define NVIC_PRI5_R						(Lcd_Host_Regs.PRI5)
+#define NVIC_EN0_R						(Lcd_Host_Regs.EN0)
+
+#endif
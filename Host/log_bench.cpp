@@ -0,0 +1,85 @@
+/*
+ * log_bench.cpp
+ *
+ *	Compares the cost of a deferred log call (Log_Write from ../Log.c,
+ *	built for the host) against formatting the same message with
+ *	snprintf and copying it into a transmit ring, which is what the
+ *	init routines used to do. Both paths are timed with rdtsc in
+ *	batches that never fill the ring.
+ *
+ *	Host cycles are not Cortex-M4 cycles, but the ratio between the
+ *	two paths carries over: the deferred path is a fixed ~20 stores
+ *	and loads, the snprintf path walks the format string and divides.
+ *
+ *	Build (from this folder, x86-64 Linux):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		gcc -O2 -I. -include log_bench_port.h -c ../Log.c -o Log.o
+ *		g++ -O2 -std=c++17 log_bench.cpp Log.o Telemetry.o -o log_bench
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <x86intrin.h>
+
+extern "C" {
+#include "../Log.h"
+}
+
+#define BATCH							(32)				//Less than LOG_RING_SIZE so nothing is dropped
+#define BATCHES						(200000)
+#define TX_RING_SIZE			(256)
+
+/* Target services Log.c links against */
+extern "C" {
+volatile uint32_t Log_Bench_Clock;
+static uint64_t TxBytes;
+
+long StartCritical(void) { return 0; }
+void EndCritical(long) {}
+uint32_t UART0_Write(const uint8_t*, uint32_t len) { TxBytes += len; return len; }
+}
+
+/* What the init routines used to do: format, then copy into the TX ring */
+static uint8_t TxRing[TX_RING_SIZE];
+static uint32_t TxPut;
+
+static void __attribute__((noinline)) sprintf_path(uint32_t a, uint32_t b, uint32_t c) {
+	char buf[80];
+	int n = snprintf(buf, sizeof(buf), "Error on Transmit to %02x register %02x, error code %x\r\n", a, b, c);
+	for (int i = 0; i < n; i++)
+		TxRing[TxPut++ & (TX_RING_SIZE - 1)] = (uint8_t)buf[i];
+}
+
+int main() {
+	uint64_t log_cycles = 0, fmt_cycles = 0;
+	volatile uint32_t sink = 0;
+
+	for (int b = 0; b < BATCHES; b++) {
+		uint64_t t0 = __rdtsc();
+		for (uint32_t i = 0; i < BATCH; i++)
+			LOG3(LOG_I2C_TX_ERROR, 0x29, i, b);
+		uint64_t t1 = __rdtsc();
+		Log_Flush();											//Untimed, runs in the main loop on the target
+		log_cycles += t1 - t0;
+
+		t0 = __rdtsc();
+		for (uint32_t i = 0; i < BATCH; i++)
+			sprintf_path(0x29, i, (uint32_t)b);
+		t1 = __rdtsc();
+		fmt_cycles += t1 - t0;
+		sink += TxRing[b & (TX_RING_SIZE - 1)];
+	}
+
+	double calls = (double)BATCH * BATCHES;
+	printf("deferred log  %8.1f TSC cycles/call (%u dropped, %llu bytes sent)\n",
+		log_cycles / calls, Log_Dropped(), (unsigned long long)TxBytes);
+	printf("snprintf+ring %8.1f TSC cycles/call\n", fmt_cycles / calls);
+	printf("ratio         %8.1fx\n", (double)fmt_cycles / log_cycles);
+	return sink == 0xFFFFFFFF;
+}
@@ -0,0 +1,22 @@
+/*
+ * log_bench_port.h
+ *
+ *	Forced include (-include) when ../Log.c is built for log_bench.
+ *	Replaces the DWT cycle counter with a plain volatile word so the
+ *	timestamp costs one load, as it does on the target.
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef LOG_BENCH_PORT_H_
+#define LOG_BENCH_PORT_H_
+
+#include <stdint.h>
+
+extern volatile uint32_t Log_Bench_Clock;
+
+#define LOG_TIMESTAMP()					(Log_Bench_Clock)
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * log_expand.hpp
+ *
+ *	Expands the deferred log records in TLM_TYPE_LOG frames back into
+ *	text. The ID to format table is built from the same LogMessages.h
+ *	the firmware is compiled with.
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef LOG_EXPAND_HPP_
+#define LOG_EXPAND_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include "../Log.h"
+}
+
+
+struct LogMessageInfo {
+	const char* name;
+	const char* fmt;
+};
+
+#define LOG_MSG(id, fmt)		{ #id, fmt },
+static const LogMessageInfo LOG_TABLE[] = {
+	LOG_MESSAGE_TABLE
+};
+#undef LOG_MSG
+
+static const uint32_t LOG_TABLE_SIZE = sizeof(LOG_TABLE) / sizeof(LOG_TABLE[0]);
+
+struct LogRecord {
+	uint16_t id;
+	uint8_t nargs;
+	uint32_t timestamp;
+	uint32_t args[LOG_MAX_ARGS];
+};
+
+/*
+	Split a TLM_TYPE_LOG payload into records, returns false if the
+	payload is cut short (the records before that are still delivered)
+*/
+template <typename Fn>
+inline bool log_parse(const uint8_t* p, uint32_t len, Fn&& fn) {
+	uint32_t i = 0;
+	while (i < len) {
+		if (len - i < 7)
+			return false;
+		LogRecord r = {};
+		r.id = (uint16_t)(p[i] | (p[i+1] << 8));
+		r.nargs = p[i+2];
+		std::memcpy(&r.timestamp, &p[i+3], 4);
+		i += 7;
+		if (r.nargs > LOG_MAX_ARGS || len - i < 4u * r.nargs)
+			return false;
+		std::memcpy(r.args, &p[i], 4u * r.nargs);
+		i += 4u * r.nargs;
+		fn(r);
+	}
+	return true;
+}
+
+/*
+	printf style expansion with the raw 32-bit arguments. Handles the
+	flags, width and precision of %d %i %u %x %X %c %f and %%
+*/
+inline std::string log_format(const LogRecord& r) {
+	if (r.id >= LOG_TABLE_SIZE) {
+		char buf[96];
+		snprintf(buf, sizeof(buf), "<unknown log id %u, %u args>", r.id, r.nargs);
+		return buf;
+	}
+	std::string out;
+	const char* f = LOG_TABLE[r.id].fmt;
+	int arg = 0;
+	while (*f) {
+		if (*f != '%') {
+			out.push_back(*f++);
+			continue;
+		}
+		//Copy the whole conversion spec so snprintf applies the flags
+		char spec[16];
+		size_t n = 0;
+		spec[n++] = *f++;
+		while (*f && std::strchr("-+ #0123456789.", *f) && n < sizeof(spec) - 2)
+			spec[n++] = *f++;
+		char conv = *f ? *f++ : '\0';
+		if (conv == '%') {
+			out.push_back('%');
+			continue;
+		}
+		if (arg >= r.nargs) {
+			out += "<?>";
+			continue;
+		}
+		uint32_t v = r.args[arg++];
+		char buf[64];
+		spec[n++] = conv;
+		spec[n] = '\0';
+		switch (conv) {
+			case 'd': case 'i':
+				snprintf(buf, sizeof(buf), spec, (int)(int32_t)v);
+				break;
+			case 'u': case 'x': case 'X':
+				snprintf(buf, sizeof(buf), spec, (unsigned)v);
+				break;
+			case 'c':
+				snprintf(buf, sizeof(buf), spec, (int)(v & 0xFF));
+				break;
+			case 'f': {
+				float fv;
+				std::memcpy(&fv, &v, 4);
+				snprintf(buf, sizeof(buf), spec, (double)fv);
+				break;
+			}
+			default:
+				snprintf(buf, sizeof(buf), "<bad %%%c>", conv);
+				break;
+		}
+		out += buf;
+	}
+	return out;
+}
+
+#endif
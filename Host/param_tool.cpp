@@ -0,0 +1,371 @@
+/*
+ * param_tool.cpp
+ *
+ *	Host side client for the parameter registry (Param.h). Sends
+ *	TLM_TYPE_PARAM requests on the board's UART and waits for the
+ *	matching reply, while samples keep streaming on the same line.
+ *	Names, types and ranges are read from the board, so the tool
+ *	does not need to be rebuilt when ParamTable.h changes.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 param_tool.cpp Telemetry.o -o param_tool
+ *
+ *	Usage:
+ *		param_tool [-b baud] /dev/ttyACM0 list
+ *		param_tool [-b baud] /dev/ttyACM0 get <name>
+ *		param_tool [-b baud] /dev/ttyACM0 set <name> <value>
+ *		param_tool [-b baud] /dev/ttyACM0 sweep <name> <start> <stop> <step> [dwell ms]
+ *		param_tool [-b baud] /dev/ttyACM0 save|load|defaults
+ *
+ *	sweep sets each value in turn, then averages the samples that
+ *	arrive during the dwell time, one line per value.
+ *
+ * Created on: November 27, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "serial_source.hpp"
+#include "stream_decoder.hpp"
+
+extern "C" {
+#include "../Param.h"
+}
+
+#define REPLY_TIMEOUT_MS			(300)
+#define REQUEST_TRIES					(3)
+#define DEFAULT_DWELL_MS			(1000)
+
+struct ParamDesc {
+	uint8_t id;
+	uint8_t type;
+	uint8_t flags;
+	uint32_t value;
+	uint32_t min;
+	uint32_t max;
+	std::string name;
+	std::string unit;
+};
+
+struct Reply {
+	uint8_t op;
+	uint8_t status;
+	std::vector<uint8_t> body;
+};
+
+/* Running mean of the samples seen during a sweep step */
+struct SampleMean {
+	uint64_t count = 0;
+	double angle[3] = {0, 0, 0};
+
+	void add(const SensorRecord& r) {
+		if (!(r.channels & TLM_CH_ANGLE))
+			return;
+		count++;
+		for (int i = 0; i < 3; i++)
+			angle[i] += (r.angle[i] - angle[i]) / (double)count;
+	}
+};
+
+static uint32_t get_u32(const uint8_t* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static const char* status_name(uint8_t s) {
+	switch (s) {
+		case PARAM_OK:						return "ok";
+		case PARAM_CLAMPED:				return "clamped";
+		case PARAM_ERR_ID:				return "bad id";
+		case PARAM_ERR_READONLY:	return "read only";
+		case PARAM_ERR_FLASH:			return "flash error";
+		case PARAM_ERR_REQUEST:		return "bad request";
+		default:									return "unknown status";
+	}
+}
+
+/* Value word to text, in the type of the parameter */
+static std::string format_value(uint8_t type, uint32_t raw) {
+	char buf[32];
+	if (type == PARAM_TYPE_FLOAT) {
+		float f;
+		std::memcpy(&f, &raw, 4);
+		snprintf(buf, sizeof(buf), "%g", (double)f);
+	} else if (type == PARAM_TYPE_Q16) {
+		snprintf(buf, sizeof(buf), "%.5f", (int32_t)raw / 65536.0);
+	} else {
+		snprintf(buf, sizeof(buf), "%d", (int32_t)raw);
+	}
+	return buf;
+}
+
+/* Text to value word, false if it does not parse */
+static bool parse_value(uint8_t type, const char* s, uint32_t& raw) {
+	char* end;
+	double d = strtod(s, &end);
+	if (end == s || *end)
+		return false;
+	if (type == PARAM_TYPE_FLOAT) {
+		float f = (float)d;
+		std::memcpy(&raw, &f, 4);
+	} else if (type == PARAM_TYPE_Q16) {
+		raw = (uint32_t)(int32_t)std::lround(d * 65536.0);
+	} else {
+		raw = (uint32_t)(int32_t)std::lround(d);
+	}
+	return true;
+}
+
+class ParamClient {
+public:
+	SampleMean mean;
+
+	explicit ParamClient(Source& src) : src_(src) {
+		dec_.on_frame = [this](uint8_t type, uint16_t seq, const uint8_t* payload, uint32_t len, uint64_t) {
+			if (type != TLM_TYPE_PARAM || seq != seq_ || len < 2 || !(payload[0] & TLM_PARAM_REPLY))
+				return;
+			reply_.op = payload[0] & ~TLM_PARAM_REPLY;
+			reply_.status = payload[1];
+			reply_.body.assign(payload + 2, payload + len);
+			got_ = true;
+		};
+		dec_.on_sample = [this](const SensorRecord& r) { mean.add(r); };
+	}
+
+	/* Send a request and wait for its reply, retrying on a timeout */
+	bool request(const std::vector<uint8_t>& req, Reply& out) {
+		for (int attempt = 0; attempt < REQUEST_TRIES; attempt++) {
+			seq_++;
+			uint8_t frame[TLM_MAX_FRAME + 1];
+			frame[0] = 0;																//Opening delimiter for the shell
+			uint32_t n = Telemetry_Pack(TLM_TYPE_PARAM, seq_, req.data(), (uint32_t)req.size(), frame + 1);
+			if (!write_all(frame, n + 1))
+				return false;
+			got_ = false;
+			if (pump(REPLY_TIMEOUT_MS, true) && reply_.op == req[0]) {
+				out = reply_;
+				return true;
+			}
+		}
+		fprintf(stderr, "no reply from the board\n");
+		return false;
+	}
+
+	/* Keep decoding for ms milliseconds, or until a reply when wait_reply is set */
+	bool pump(int ms, bool wait_reply) {
+		uint8_t buf[4096];
+		uint64_t deadline = now_ns() + (uint64_t)ms * 1000000ULL;
+		for (;;) {
+			uint64_t t = now_ns();
+			if (t >= deadline)
+				return got_;
+			ssize_t n = read_source(src_, buf, sizeof(buf), (int)((deadline - t) / 1000000ULL) + 1);
+			if (n < 0)
+				return got_;
+			if (n > 0)
+				dec_.feed(buf, (size_t)n, now_ns());
+			if (wait_reply && got_)
+				return true;
+		}
+	}
+
+	/* Read every descriptor from the board */
+	bool list(std::vector<ParamDesc>& out) {
+		out.clear();
+		uint8_t count = 1;
+		for (uint8_t id = 0; id < count; id++) {
+			Reply r;
+			if (!request({TLM_PARAM_OP_LIST, id}, r))
+				return false;
+			if (r.status != PARAM_OK || r.body.size() < 20) {
+				fprintf(stderr, "list %u: %s\n", id, status_name(r.status));
+				return false;
+			}
+			const uint8_t* b = r.body.data();
+			count = b[0];
+			ParamDesc d;
+			d.id = b[1];
+			d.type = b[2];
+			d.flags = b[3];
+			d.value = get_u32(&b[4]);
+			d.min = get_u32(&b[8]);
+			d.max = get_u32(&b[12]);
+			const char* s = (const char*)&b[16];
+			const char* end = (const char*)b + r.body.size();
+			d.name.assign(s, strnlen(s, (size_t)(end - s)));
+			s += d.name.size() + 1;
+			if (s < end)
+				d.unit.assign(s, strnlen(s, (size_t)(end - s)));
+			out.push_back(d);
+		}
+		return true;
+	}
+
+	bool set(const ParamDesc& d, uint32_t raw, uint32_t& stored, uint8_t& status) {
+		Reply r;
+		std::vector<uint8_t> req = {TLM_PARAM_OP_SET, d.id,
+			(uint8_t)raw, (uint8_t)(raw >> 8), (uint8_t)(raw >> 16), (uint8_t)(raw >> 24)};
+		if (!request(req, r))
+			return false;
+		status = r.status;
+		stored = (r.body.size() >= 5) ? get_u32(&r.body[1]) : 0;
+		return true;
+	}
+
+private:
+	bool write_all(const uint8_t* p, size_t n) {
+		while (n) {
+			ssize_t w = write(src_.fd, p, n);
+			if (w < 0) {
+				if (errno == EINTR)
+					continue;
+				perror("write");
+				return false;
+			}
+			p += w;
+			n -= (size_t)w;
+		}
+		return true;
+	}
+
+	Source& src_;
+	StreamDecoder dec_;
+	uint16_t seq_ = 0;
+	Reply reply_;
+	bool got_ = false;
+};
+
+static const ParamDesc* find(const std::vector<ParamDesc>& all, const char* name) {
+	for (const ParamDesc& d : all)
+		if (d.name == name)
+			return &d;
+	fprintf(stderr, "unknown parameter %s\n", name);
+	return nullptr;
+}
+
+static void print_desc(const ParamDesc& d) {
+	printf("%-18s %12s %-4s [%s .. %s]%s%s\n", d.name.c_str(), format_value(d.type, d.value).c_str(),
+		d.unit.c_str(), format_value(d.type, d.min).c_str(), format_value(d.type, d.max).c_str(),
+		(d.flags & PARAM_F_PERSIST) ? " persist" : "", (d.flags & PARAM_F_READONLY) ? " readonly" : "");
+}
+
+static void usage() {
+	fprintf(stderr,
+		"usage: param_tool [-b baud] <tty> list\n"
+		"       param_tool [-b baud] <tty> get <name>\n"
+		"       param_tool [-b baud] <tty> set <name> <value>\n"
+		"       param_tool [-b baud] <tty> sweep <name> <start> <stop> <step> [dwell ms]\n"
+		"       param_tool [-b baud] <tty> save|load|defaults\n");
+}
+
+int main(int argc, char** argv) {
+	unsigned baud = 115200;
+	std::vector<const char*> args;
+
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			baud = (unsigned)strtoul(argv[++i], nullptr, 10);
+		else
+			args.push_back(argv[i]);
+	}
+	if (args.size() < 2) {
+		usage();
+		return 2;
+	}
+
+	Source src;
+	if (!open_path(src, args[0], baud, O_RDWR))
+		return 1;
+	ParamClient client(src);
+	std::string cmd = args[1];
+	Reply r;
+
+	if (cmd == "save" || cmd == "load" || cmd == "defaults") {
+		uint8_t op = (cmd == "save") ? TLM_PARAM_OP_SAVE : (cmd == "load") ? TLM_PARAM_OP_LOAD : TLM_PARAM_OP_DEFAULTS;
+		if (!client.request({op}, r))
+			return 1;
+		printf("%s: %s\n", cmd.c_str(), status_name(r.status));
+		return r.status == PARAM_OK ? 0 : 1;
+	}
+
+	std::vector<ParamDesc> all;
+	if (!client.list(all))
+		return 1;
+
+	if (cmd == "list" && args.size() == 2) {
+		for (const ParamDesc& d : all)
+			print_desc(d);
+		return 0;
+	}
+
+	if (cmd == "get" && args.size() == 3) {
+		const ParamDesc* d = find(all, args[2]);
+		if (!d)
+			return 1;
+		print_desc(*d);
+		return 0;
+	}
+
+	if (cmd == "set" && args.size() == 4) {
+		const ParamDesc* d = find(all, args[2]);
+		uint32_t raw, stored;
+		uint8_t status;
+		if (!d)
+			return 1;
+		if (!parse_value(d->type, args[3], raw)) {
+			fprintf(stderr, "bad value %s\n", args[3]);
+			return 2;
+		}
+		if (!client.set(*d, raw, stored, status))
+			return 1;
+		printf("%s = %s (%s)\n", d->name.c_str(), format_value(d->type, stored).c_str(), status_name(status));
+		return (status == PARAM_OK || status == PARAM_CLAMPED) ? 0 : 1;
+	}
+
+	if (cmd == "sweep" && (args.size() == 6 || args.size() == 7)) {
+		const ParamDesc* d = find(all, args[2]);
+		if (!d)
+			return 1;
+		double start = strtod(args[3], nullptr);
+		double stop = strtod(args[4], nullptr);
+		double step = std::fabs(strtod(args[5], nullptr));
+		int dwell = (args.size() == 7) ? atoi(args[6]) : DEFAULT_DWELL_MS;
+		if (step == 0.0 || dwell <= 0) {
+			usage();
+			return 2;
+		}
+		if (stop < start)
+			step = -step;
+
+		printf("# %s value, samples, mean angle x y z (deg)\n", d->name.c_str());
+		uint32_t steps = (uint32_t)std::floor((stop - start) / step + 1e-9) + 1;
+		for (uint32_t i = 0; i < steps; i++) {
+			char text[32];
+			uint32_t raw, stored;
+			uint8_t status;
+			snprintf(text, sizeof(text), "%.9g", start + step * i);
+			if (!parse_value(d->type, text, raw) || !client.set(*d, raw, stored, status))
+				return 1;
+			client.mean = SampleMean();
+			client.pump(dwell, false);
+			printf("%s %llu %.3f %.3f %.3f%s\n", format_value(d->type, stored).c_str(),
+				(unsigned long long)client.mean.count, client.mean.angle[0], client.mean.angle[1],
+				client.mean.angle[2], status == PARAM_OK ? "" : " (clamped)");
+			fflush(stdout);
+		}
+		//Leave the parameter where it was
+		uint32_t stored;
+		uint8_t status;
+		client.set(*d, d->value, stored, status);
+		return 0;
+	}
+
+	usage();
+	return 2;
+}
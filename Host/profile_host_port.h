@@ -0,0 +1,39 @@
+/*
+ * profile_host_port.h
+ *
+ *	Forced include (-include) for every file built on the host that
+ *	includes ../Profile.h (Profile.c and any module with markers).
+ *	Replaces the DWT cycle counter with CLOCK_MONOTONIC scaled to
+ *	SYSCLK_HZ, so the histograms keep their target units. The host
+ *	program defines StartCritical and EndCritical, as for the other
+ *	modules, and can print the regions with Profile_Read.
+ *
+ *		gcc -c -include profile_host_port.h -I.. ../Profile.c
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef PROFILE_HOST_PORT_H_
+#define PROFILE_HOST_PORT_H_
+
+#include <stdint.h>
+#include <time.h>
+#include "../SysClock.h"
+
+/*
+ *	------------------Profile_Host_Now-----------------
+ *	Input: none
+ *	Output: Host monotonic time in SYSCLK_HZ cycles, low 32 bits
+ */
+static inline uint32_t Profile_Host_Now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) * SYSCLK_CYCLES_PER_US / 1000);
+}
+
+#define PROFILE_NOW()					Profile_Host_Now()
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * serial_source.hpp
+ *
+ *	Opens the byte sources the host tools read from: a serial tty at
+ *	a given baud rate, a pseudo terminal or pipe that stands in for
+ *	the board, or a recorded capture file. Linux only.
+ *
+ * Created on: November 22, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SERIAL_SOURCE_HPP_
+#define SERIAL_SOURCE_HPP_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+enum SourceKind {
+	SRC_TTY,
+	SRC_PTY,
+	SRC_PIPE,
+	SRC_FILE
+};
+
+struct Source {
+	int fd = -1;
+	int slave_fd = -1;							//PTY only, held open so reads never see EOF
+	SourceKind kind = SRC_FILE;
+	std::string name;								//Device path, or the slave path for a PTY
+};
+
+/* Monotonic host time in nanoseconds */
+static inline uint64_t now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline speed_t baud_to_speed(unsigned baud) {
+	switch (baud) {
+		case 9600:		return B9600;
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		case 460800:	return B460800;
+		case 921600:	return B921600;
+		case 1000000:	return B1000000;
+		case 2000000:	return B2000000;
+		default:			return 0;
+	}
+}
+
+static inline bool set_raw(int fd, unsigned baud) {
+	struct termios tio;
+	if (tcgetattr(fd, &tio) < 0)
+		return false;
+	cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+	if (baud) {
+		speed_t sp = baud_to_speed(baud);
+		if (!sp)
+			return false;
+		cfsetispeed(&tio, sp);
+		cfsetospeed(&tio, sp);
+	}
+	return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+/* Open a tty in raw mode, or a regular file for replay (writable tools pass O_RDWR) */
+static inline bool open_path(Source& src, const char* path, unsigned baud, int mode = O_RDONLY) {
+	src.fd = open(path, mode | O_NOCTTY);
+	if (src.fd < 0) {
+		perror(path);
+		return false;
+	}
+	src.name = path;
+	struct stat st;
+	if (fstat(src.fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		src.kind = SRC_FILE;
+		return true;
+	}
+	src.kind = SRC_TTY;
+	if (!set_raw(src.fd, baud)) {
+		fprintf(stderr, "%s: cannot set raw mode at %u baud\n", path, baud);
+		return false;
+	}
+	return true;
+}
+
+/* Create a PTY pair, whatever is written to src.name shows up on src.fd */
+static inline bool open_pty(Source& src) {
+	src.fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (src.fd < 0 || grantpt(src.fd) < 0 || unlockpt(src.fd) < 0) {
+		perror("posix_openpt");
+		return false;
+	}
+	src.name = ptsname(src.fd);
+	src.slave_fd = open(src.name.c_str(), O_RDWR | O_NOCTTY);
+	if (src.slave_fd < 0 || !set_raw(src.slave_fd, 0) || !set_raw(src.fd, 0)) {
+		perror(src.name.c_str());
+		return false;
+	}
+	src.kind = SRC_PTY;
+	return true;
+}
+
+/* Wrap an already open descriptor, such as the read end of a pipe */
+static inline void open_fd(Source& src, int fd, const std::string& name) {
+	src.fd = fd;
+	src.kind = SRC_PIPE;
+	src.name = name;
+}
+
+/*
+	Read what is available, waiting at most timeout_ms on live sources
+	Returns bytes read, 0 on timeout, -1 on end of file or error
+*/
+static inline ssize_t read_source(const Source& src, uint8_t* buf, size_t cap, int timeout_ms) {
+	if (src.kind != SRC_FILE) {
+		struct pollfd p = { src.fd, POLLIN, 0 };
+		int r = poll(&p, 1, timeout_ms);
+		if (r <= 0)
+			return (r < 0 && errno != EINTR) ? -1 : 0;
+	}
+	ssize_t n = read(src.fd, buf, cap);
+	if (n < 0 && errno == EINTR)
+		return 0;
+	return n > 0 ? n : -1;
+}
+
+static inline void close_source(Source& src) {
+	if (src.fd >= 0)
+		close(src.fd);
+	if (src.slave_fd >= 0)
+		close(src.slave_fd);
+	src.fd = src.slave_fd = -1;
+}
+
+#endif
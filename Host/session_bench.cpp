@@ -0,0 +1,148 @@
+/*
+ * session_bench.cpp
+ *
+ *	Compares scanning one channel of a recorded session through the
+ *	text parsing path (StreamDecoder over the terminal log) against
+ *	the columnar path (mmap the session file and sum the column).
+ *	Without arguments a synthetic ASCII log is generated first.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 session_bench.cpp Telemetry.o -o session_bench
+ *
+ *	Usage:
+ *		session_bench [-n rows]							(synthetic log in /tmp)
+ *		session_bench <log> <session>				(existing pair from session_convert)
+ *
+ * Created on: November 23, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "board_sim.hpp"
+#include "serial_source.hpp"
+#include "session_file.hpp"
+#include "stream_decoder.hpp"
+
+#define BENCH_RUNS						(5)			//Best of, so the page cache is warm
+
+static std::vector<uint8_t> read_file(const char* path) {
+	std::vector<uint8_t> data;
+	FILE* f = fopen(path, "rb");
+	if (!f)
+		return data;
+	fseek(f, 0, SEEK_END);
+	data.resize((size_t)ftell(f));
+	fseek(f, 0, SEEK_SET);
+	if (fread(data.data(), 1, data.size(), f) != data.size())
+		data.clear();
+	fclose(f);
+	return data;
+}
+
+/* Synthetic log plus its session file, returns false on I/O errors */
+static bool make_pair(const std::string& log, const std::string& sess, uint32_t rows) {
+	FILE* f = fopen(log.c_str(), "wb");
+	if (!f)
+		return false;
+	SessionWriter w;
+	add_sensor_channels(w);
+	if (!w.open(sess.c_str())) {
+		fclose(f);
+		return false;
+	}
+	StreamDecoder dec;
+	dec.on_sample = [&](const SensorRecord& r) { append_record(w, r); };
+	for (uint32_t i = 0; i < rows; i++) {
+		std::string txt = BoardSim::ascii_sample(BoardSim::make_sample(i * 1000));
+		fwrite(txt.data(), 1, txt.size(), f);
+		dec.feed((const uint8_t*)txt.data(), txt.size(), i);
+	}
+	dec.flush(rows);
+	fclose(f);
+	return w.close();
+}
+
+int main(int argc, char** argv) {
+	uint32_t rows = 1000000;
+	std::string log = "/tmp/session_bench.txt";
+	std::string sess = "/tmp/session_bench.sess";
+
+	if (argc == 3 && std::string(argv[1]) == "-n") {
+		rows = (uint32_t)strtoul(argv[2], nullptr, 10);
+	} else if (argc == 3) {
+		log = argv[1];
+		sess = argv[2];
+	} else if (argc != 1) {
+		fprintf(stderr, "usage: session_bench [-n rows] | <log> <session>\n");
+		return 2;
+	}
+	if (argc == 1 || std::string(argv[1]) == "-n") {
+		fprintf(stderr, "generating %u rows...\n", rows);
+		if (!make_pair(log, sess, rows)) {
+			fprintf(stderr, "cannot write %s / %s\n", log.c_str(), sess.c_str());
+			return 1;
+		}
+	}
+
+	/* Text path: read the log and parse every line */
+	double text_s = 1e30, text_sum = 0;
+	size_t text_bytes = 0;
+	uint64_t text_rows = 0;
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		uint64_t t0 = now_ns();
+		std::vector<uint8_t> data = read_file(log.c_str());
+		double sum = 0;
+		uint64_t n = 0;
+		StreamDecoder dec;
+		dec.on_sample = [&](const SensorRecord& r) { sum += r.accel[0]; n++; };
+		dec.feed(data.data(), data.size(), 0);
+		dec.flush(0);
+		double s = (now_ns() - t0) * 1e-9;
+		if (s < text_s)
+			text_s = s;
+		text_sum = sum;
+		text_rows = n;
+		text_bytes = data.size();
+	}
+
+	/* Column path: mmap the session and sum one column */
+	double col_s = 1e30, col_sum = 0;
+	uint64_t col_rows = 0;
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		uint64_t t0 = now_ns();
+		SessionReader rd;
+		if (!rd.open(sess.c_str()))
+			return 1;
+		int ch = rd.find("Ax_g");
+		if (ch < 0) {
+			fprintf(stderr, "%s: no Ax_g channel\n", sess.c_str());
+			return 1;
+		}
+		double sum = 0;
+		uint64_t n = 0;
+		for (uint32_t k = 0; k < rd.chunk_count(); k++) {
+			ColumnSpan<float> c = rd.span<float>(ch, k);
+			for (uint32_t i = 0; i < c.rows; i++)
+				sum += c.data[i];
+			n += c.rows;
+		}
+		double s = (now_ns() - t0) * 1e-9;
+		if (s < col_s)
+			col_s = s;
+		col_sum = sum;
+		col_rows = n;
+	}
+
+	printf("text   %10llu rows %8.3f s %10.0f rows/s %8.1f MB/s of log  sum %.6f\n",
+		(unsigned long long)text_rows, text_s, text_rows / text_s, text_bytes / text_s / 1e6, text_sum);
+	printf("column %10llu rows %8.3f s %10.0f rows/s %8.1f MB/s of column  sum %.6f\n",
+		(unsigned long long)col_rows, col_s, col_rows / col_s, col_rows * sizeof(float) / col_s / 1e6, col_sum);
+	printf("speedup %.0fx\n", text_s / col_s);
+	return (text_rows == col_rows) ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/*
+ * session_convert.cpp
+ *
+ *	Converts a captured terminal log (the ASCII printout of
+ *	ModuleTest.c) or a raw capture from telemetry_ingest into a
+ *	columnar session file. Text and binary frames may be mixed.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 session_convert.cpp Telemetry.o -o session_convert
+ *
+ *	Usage:
+ *		session_convert <log or capture> <out.sess>
+ *
+ * Created on: November 23, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "session_file.hpp"
+#include "stream_decoder.hpp"
+
+#define READ_CHUNK						(1 << 20)
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		fprintf(stderr, "usage: session_convert <log or capture> <out.sess>\n");
+		return 2;
+	}
+	FILE* in = fopen(argv[1], "rb");
+	if (!in) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	SessionWriter w;
+	add_sensor_channels(w);
+	if (!w.open(argv[2]))
+		return 1;
+
+	StreamDecoder dec;
+	dec.on_sample = [&](const SensorRecord& r) { append_record(w, r); };
+
+	//Logs carry no host time, use the byte offset so rows keep their order
+	std::vector<uint8_t> buf(READ_CHUNK);
+	size_t n;
+	while ((n = fread(buf.data(), 1, buf.size(), in)) > 0)
+		dec.feed(buf.data(), n, dec.stats().bytes);
+	dec.flush(dec.stats().bytes);
+	fclose(in);
+
+	if (!w.close()) {
+		fprintf(stderr, "%s: write failed\n", argv[2]);
+		return 1;
+	}
+	const DecoderStats& s = dec.stats();
+	fprintf(stderr, "%llu rows from %llu bytes (%llu frames, %llu lines, %llu bad)\n",
+		(unsigned long long)w.rows(), (unsigned long long)s.bytes, (unsigned long long)s.frames,
+		(unsigned long long)s.text_lines, (unsigned long long)s.bad_frames);
+	return 0;
+}
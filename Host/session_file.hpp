@@ -0,0 +1,371 @@
+/*
+ * session_file.hpp
+ *
+ *	Columnar on-disk format for recorded sessions. Every channel is
+ *	stored as a contiguous typed column inside fixed size chunks, so
+ *	an analysis tool can mmap the file and scan a single channel with
+ *	no parsing at all.
+ *
+ *	Layout (little endian, every section 8 byte aligned):
+ *		SessionHeader													at offset 0
+ *		chunk 0: column 0, column 1, ... column n-1
+ *		chunk 1: ...
+ *		ChannelDesc[channel_count]						at desc_offset
+ *		ChunkEntry[chunk_count], each followed by
+ *			uint64_t column_offset[channel_count]	at index_offset
+ *
+ *	The header is written last, a file with a zero magic was not
+ *	closed properly.
+ *
+ * Created on: November 23, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SESSION_FILE_HPP_
+#define SESSION_FILE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stream_decoder.hpp"
+
+#define SESSION_MAGIC						"SENSSESS"
+#define SESSION_VERSION					(1)
+#define SESSION_CHUNK_ROWS			(65536)
+#define SESSION_NAME_SIZE				(24)
+
+/* Column element types */
+enum ColType : uint8_t {
+	COL_U8  = 0,
+	COL_I16 = 1,
+	COL_U16 = 2,
+	COL_U32 = 3,
+	COL_U64 = 4,
+	COL_F32 = 5
+};
+
+static inline uint8_t col_size(uint8_t type) {
+	static const uint8_t SIZES[] = { 1, 2, 2, 4, 8, 4 };
+	return type <= COL_F32 ? SIZES[type] : 0;
+}
+
+/* Maps a C++ type to its column type for the typed accessors */
+template <typename T> struct ColTypeOf;
+template <> struct ColTypeOf<uint8_t>  { static const uint8_t value = COL_U8; };
+template <> struct ColTypeOf<int16_t>  { static const uint8_t value = COL_I16; };
+template <> struct ColTypeOf<uint16_t> { static const uint8_t value = COL_U16; };
+template <> struct ColTypeOf<uint32_t> { static const uint8_t value = COL_U32; };
+template <> struct ColTypeOf<uint64_t> { static const uint8_t value = COL_U64; };
+template <> struct ColTypeOf<float>    { static const uint8_t value = COL_F32; };
+
+struct SessionHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t channel_count;
+	uint32_t chunk_rows;						//Rows per chunk, the last chunk may be shorter
+	uint32_t chunk_count;
+	uint64_t row_count;
+	uint64_t desc_offset;
+	uint64_t index_offset;
+	uint8_t reserved[16];
+};
+
+struct ChannelDesc {
+	char name[SESSION_NAME_SIZE];
+	uint8_t type;										//ColType
+	uint8_t reserved[3];
+	float scale;										//Multiply to get physical units, 1 if none
+};
+
+struct ChunkEntry {
+	uint64_t first_row;
+	uint32_t rows;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(SessionHeader) == 64, "SessionHeader layout");
+static_assert(sizeof(ChannelDesc) == 32, "ChannelDesc layout");
+static_assert(sizeof(ChunkEntry) == 16, "ChunkEntry layout");
+
+/*
+	Buffers one chunk of every column in memory and appends it to the
+	file when full. Declare the channels first, then put() one value
+	per channel and end_row()
+*/
+class SessionWriter {
+public:
+	explicit SessionWriter(uint32_t chunk_rows = SESSION_CHUNK_ROWS) : chunk_rows_(chunk_rows) {}
+	~SessionWriter() { close(); }
+
+	/* Returns the channel index */
+	int add_channel(const char* name, uint8_t type, float scale = 1.0f) {
+		ChannelDesc d;
+		std::memset(&d, 0, sizeof(d));
+		std::strncpy(d.name, name, SESSION_NAME_SIZE - 1);
+		d.type = type;
+		d.scale = scale;
+		descs_.push_back(d);
+		cols_.emplace_back();
+		cols_.back().reserve((size_t)chunk_rows_ * col_size(type));
+		return (int)descs_.size() - 1;
+	}
+
+	bool open(const char* path) {
+		f_ = fopen(path, "wb");
+		if (!f_) {
+			perror(path);
+			return false;
+		}
+		setvbuf(f_, nullptr, _IOFBF, 1 << 20);
+		SessionHeader h;
+		std::memset(&h, 0, sizeof(h));			//Zero magic until close()
+		fwrite(&h, sizeof(h), 1, f_);
+		pos_ = sizeof(h);
+		return true;
+	}
+
+	template <typename T>
+	void put(int ch, T v) {
+		std::vector<uint8_t>& c = cols_[ch];
+		size_t n = c.size();
+		c.resize(n + sizeof(T));
+		std::memcpy(&c[n], &v, sizeof(T));
+	}
+
+	void end_row() {
+		rows_++;
+		if (++chunk_fill_ == chunk_rows_)
+			flush_chunk();
+	}
+
+	uint64_t rows() const { return rows_; }
+
+	bool close() {
+		if (!f_)
+			return true;
+		flush_chunk();
+
+		SessionHeader h;
+		std::memset(&h, 0, sizeof(h));
+		std::memcpy(h.magic, SESSION_MAGIC, 8);
+		h.version = SESSION_VERSION;
+		h.channel_count = (uint32_t)descs_.size();
+		h.chunk_rows = chunk_rows_;
+		h.chunk_count = (uint32_t)chunks_.size();
+		h.row_count = rows_;
+
+		h.desc_offset = pos_;
+		write_raw(descs_.data(), descs_.size() * sizeof(ChannelDesc));
+		h.index_offset = pos_;
+		for (size_t i = 0; i < chunks_.size(); i++) {
+			write_raw(&chunks_[i], sizeof(ChunkEntry));
+			write_raw(&offsets_[i * descs_.size()], descs_.size() * sizeof(uint64_t));
+		}
+
+		fseek(f_, 0, SEEK_SET);
+		fwrite(&h, sizeof(h), 1, f_);
+		bool ok = (ferror(f_) == 0);
+		ok = (fclose(f_) == 0) && ok;
+		f_ = nullptr;
+		return ok;
+	}
+
+private:
+	FILE* f_ = nullptr;
+	uint32_t chunk_rows_;
+	uint32_t chunk_fill_ = 0;
+	uint64_t rows_ = 0;
+	uint64_t pos_ = 0;
+	std::vector<ChannelDesc> descs_;
+	std::vector<std::vector<uint8_t>> cols_;
+	std::vector<ChunkEntry> chunks_;
+	std::vector<uint64_t> offsets_;			//channel_count per chunk
+
+	void write_raw(const void* p, size_t n) {
+		static const uint8_t PAD[8] = {0};
+		fwrite(p, 1, n, f_);
+		pos_ += n;
+		size_t pad = (size_t)(-pos_ & 7);
+		fwrite(PAD, 1, pad, f_);
+		pos_ += pad;
+	}
+
+	void flush_chunk() {
+		if (chunk_fill_ == 0)
+			return;
+		ChunkEntry e = { rows_ - chunk_fill_, chunk_fill_, 0 };
+		chunks_.push_back(e);
+		for (size_t c = 0; c < cols_.size(); c++) {
+			offsets_.push_back(pos_);
+			write_raw(cols_[c].data(), cols_[c].size());
+			cols_[c].clear();
+		}
+		chunk_fill_ = 0;
+	}
+};
+
+/* One chunk of one column, valid while the reader is open */
+template <typename T>
+struct ColumnSpan {
+	const T* data;
+	uint32_t rows;
+	uint64_t first_row;
+};
+
+/* Read-only mmap view of a closed session file */
+class SessionReader {
+public:
+	~SessionReader() { close(); }
+
+	bool open(const char* path) {
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0) {
+			perror(path);
+			return false;
+		}
+		struct stat st;
+		if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SessionHeader)) {
+			::close(fd);
+			return fail(path, "too short");
+		}
+		size_ = (size_t)st.st_size;
+		void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (p == MAP_FAILED) {
+			perror(path);
+			return false;
+		}
+		base_ = (const uint8_t*)p;
+		madvise(p, size_, MADV_SEQUENTIAL);
+
+		hdr_ = (const SessionHeader*)base_;
+		if (std::memcmp(hdr_->magic, SESSION_MAGIC, 8) != 0)
+			return fail(path, "not a session file or not closed");
+		if (hdr_->version != SESSION_VERSION)
+			return fail(path, "unsupported version");
+		size_t entry = sizeof(ChunkEntry) + hdr_->channel_count * sizeof(uint64_t);
+		if (hdr_->desc_offset + hdr_->channel_count * sizeof(ChannelDesc) > size_ ||
+				hdr_->index_offset + hdr_->chunk_count * entry > size_)
+			return fail(path, "truncated");
+		descs_ = (const ChannelDesc*)(base_ + hdr_->desc_offset);
+		entry_size_ = entry;
+
+		//Check every column lies inside the file once, so span() needs no checks
+		for (uint32_t k = 0; k < hdr_->chunk_count; k++)
+			for (uint32_t c = 0; c < hdr_->channel_count; c++)
+				if (col_offset(k, c) + (uint64_t)chunk(k).rows * col_size(descs_[c].type) > size_)
+					return fail(path, "column out of range");
+		return true;
+	}
+
+	void close() {
+		if (base_)
+			munmap((void*)base_, size_);
+		base_ = nullptr;
+	}
+
+	uint32_t channel_count() const { return hdr_->channel_count; }
+	uint32_t chunk_count() const { return hdr_->chunk_count; }
+	uint64_t row_count() const { return hdr_->row_count; }
+	const ChannelDesc& channel(int ch) const { return descs_[ch]; }
+
+	/* Channel index by name, -1 if missing */
+	int find(const char* name) const {
+		for (uint32_t c = 0; c < hdr_->channel_count; c++)
+			if (std::strncmp(descs_[c].name, name, SESSION_NAME_SIZE) == 0)
+				return (int)c;
+		return -1;
+	}
+
+	/* Typed view of one chunk of a column, null data on a type mismatch */
+	template <typename T>
+	ColumnSpan<T> span(int ch, uint32_t k) const {
+		const ChunkEntry& e = chunk(k);
+		if (descs_[ch].type != ColTypeOf<T>::value)
+			return ColumnSpan<T>{ nullptr, 0, e.first_row };
+		return ColumnSpan<T>{ (const T*)(base_ + col_offset(k, (uint32_t)ch)), e.rows, e.first_row };
+	}
+
+private:
+	const uint8_t* base_ = nullptr;
+	size_t size_ = 0;
+	size_t entry_size_ = 0;
+	const SessionHeader* hdr_ = nullptr;
+	const ChannelDesc* descs_ = nullptr;
+
+	const ChunkEntry& chunk(uint32_t k) const {
+		return *(const ChunkEntry*)(base_ + hdr_->index_offset + k * entry_size_);
+	}
+
+	uint64_t col_offset(uint32_t k, uint32_t c) const {
+		const uint64_t* offs = (const uint64_t*)(base_ + hdr_->index_offset + k * entry_size_ + sizeof(ChunkEntry));
+		return offs[c];
+	}
+
+	bool fail(const char* path, const char* why) {
+		fprintf(stderr, "%s: %s\n", path, why);
+		close();
+		return false;
+	}
+};
+
+/*
+	Standard channel set for SensorRecord, in this order. Raw IMU
+	scales assume the default +-2g and +-250 deg/s ranges
+*/
+enum SensorChannel {
+	SC_HOST_NS, SC_DEVICE_TS, SC_SEQ, SC_FORMAT, SC_CHANNELS,
+	SC_AX_RAW, SC_AY_RAW, SC_AZ_RAW, SC_GX_RAW, SC_GY_RAW, SC_GZ_RAW,
+	SC_AX_G, SC_AY_G, SC_AZ_G, SC_GX_DPS, SC_GY_DPS, SC_GZ_DPS,
+	SC_ANGLE_X, SC_ANGLE_Y, SC_ANGLE_Z,
+	SC_R_RAW, SC_G_RAW, SC_B_RAW, SC_C_RAW, SC_COLOR,
+	SC_COUNT
+};
+
+static inline void add_sensor_channels(SessionWriter& w) {
+	w.add_channel("host_ns", COL_U64, 1e-9f);
+	w.add_channel("device_ts", COL_U32, 1e-6f);
+	w.add_channel("seq", COL_U16);
+	w.add_channel("format", COL_U8);
+	w.add_channel("channels", COL_U16);
+	static const char* const RAW[] = { "Ax_RAW", "Ay_RAW", "Az_RAW", "Gx_RAW", "Gy_RAW", "Gz_RAW" };
+	for (int i = 0; i < 6; i++)
+		w.add_channel(RAW[i], COL_I16, i < 3 ? 1.0f / 16384.0f : 1.0f / 131.0f);
+	static const char* const PHYS[] = { "Ax_g", "Ay_g", "Az_g", "Gx_dps", "Gy_dps", "Gz_dps", "Angle_X", "Angle_Y", "Angle_Z" };
+	for (int i = 0; i < 9; i++)
+		w.add_channel(PHYS[i], COL_F32);
+	static const char* const RGBC[] = { "R_RAW", "G_RAW", "B_RAW", "C_RAW" };
+	for (int i = 0; i < 4; i++)
+		w.add_channel(RGBC[i], COL_U16);
+	w.add_channel("color", COL_U8);
+}
+
+static inline void append_record(SessionWriter& w, const SensorRecord& r) {
+	w.put<uint64_t>(SC_HOST_NS, r.host_ns);
+	w.put<uint32_t>(SC_DEVICE_TS, r.device_ts);
+	w.put<uint16_t>(SC_SEQ, r.seq);
+	w.put<uint8_t>(SC_FORMAT, r.format);
+	w.put<uint16_t>(SC_CHANNELS, r.channels);
+	for (int i = 0; i < 3; i++) {
+		w.put<int16_t>(SC_AX_RAW + i, r.accel_raw[i]);
+		w.put<int16_t>(SC_GX_RAW + i, r.gyro_raw[i]);
+		w.put<float>(SC_AX_G + i, r.accel[i]);
+		w.put<float>(SC_GX_DPS + i, r.gyro[i]);
+		w.put<float>(SC_ANGLE_X + i, r.angle[i]);
+	}
+	for (int i = 0; i < 4; i++)
+		w.put<uint16_t>(SC_R_RAW + i, r.rgbc_raw[i]);
+	w.put<uint8_t>(SC_COLOR, r.color);
+	w.end_row();
+}
+
+#endif
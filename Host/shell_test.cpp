@@ -0,0 +1,313 @@
+/*
+ * shell_test.cpp
+ *
+ *	Host checks of the ../Shell.c line editor and command dispatch.
+ *	The modules the commands reach (UART0, parameters, scheduler,
+ *	module tests, I2C statistics) are replaced by stubs that record
+ *	their calls, bytes are fed through a stand-in UART0_Read and
+ *	everything the shell prints is collected.
+ *
+ *	Covered:
+ *		- tokenizing: runs of spaces before, between and after the
+ *		  words, lines that are only spaces
+ *		- CR, LF and CR LF each ending a line once
+ *		- backspace, delete and Ctrl-C/Ctrl-U editing
+ *		- unknown commands
+ *		- SHELL_MAX_ARGS words reaching the command, one more word
+ *		  refused before any command runs
+ *		- lines past SHELL_LINE_SIZE: the extra characters are
+ *		  refused with a bell and never reach the command
+ *		- a binary frame between two 0x00 bytes in the middle of a
+ *		  typed line
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -DPROFILE_ENABLE=0 -c ../Shell.c -o Shell.o
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 -I.. shell_test.cpp Shell.o Telemetry.o -o shell_test
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../Shell.h"
+#include "../UART0.h"
+#include "../Log.h"
+#include "../MPU6050.h"
+#include "../ModuleTest.h"
+#include "../Param.h"
+#include "../Sched.h"
+#include "../Idle.h"
+#include "../I2C.h"
+#include "../Telemetry.h"
+}
+
+static uint32_t Checks, Failures;
+
+/* Bytes the shell has not read yet, and everything it printed */
+static std::deque<uint8_t> Input;
+static std::string Output;
+
+/* What the stubs were asked to do */
+static std::vector<std::string> Calls;
+static MODULE_TEST_NAME Mode = DELAY_TEST;
+static uint32_t Period_MS;
+static float Param_Value;
+static uint32_t Frames_Handled;
+
+/* Stand-ins for the modules Shell.c calls */
+extern "C" {
+uint32_t UART0_Read(uint8_t* data, uint32_t len) {
+	uint32_t n = 0;
+
+	while (n < len && !Input.empty()) {
+		data[n++] = Input.front();
+		Input.pop_front();
+	}
+	return n;
+}
+
+void UART0_OutChar(char data) { Output += data; }
+void UART0_OutString(char* pt) { Output += pt; }
+void UART0_OutCRLF(void) { Output += "\r\n"; }
+void UART0_OutDec(int32_t n) { Output += std::to_string(n); }
+
+void UART0_OutUHex(uint32_t n) {
+	char buf[16];
+	snprintf(buf, sizeof(buf), "%X", n);
+	Output += buf;
+}
+
+void UART0_OutFloat(float n, uint8_t prec) {
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.*f", prec, (double)n);
+	Output += buf;
+}
+
+uint32_t UART0_TX_Dropped(void) { return 0; }
+uint32_t UART0_RX_Dropped(void) { return 0; }
+uint32_t UART0_DMA_Errors(void) { return 0; }
+uint32_t Log_Dropped(void) { return 0; }
+uint16_t Idle_Asleep_Permille(void) { return 975; }
+void Idle_Reset_Stats(void) { Calls.push_back("Idle_Reset_Stats"); }
+
+uint8_t MPU6050_Set_Sample_Rate(uint16_t hz) {
+	Calls.push_back("MPU6050_Set_Sample_Rate " + std::to_string(hz));
+	return 0;
+}
+
+void Module_Test_Set_Mode(MODULE_TEST_NAME test) {
+	Mode = test;
+	Calls.push_back("Module_Test_Set_Mode " + std::to_string(test));
+}
+MODULE_TEST_NAME Module_Test_Get_Mode(void) { return Mode; }
+
+void Module_Test_Set_Period(uint32_t ms) {
+	Period_MS = ms;
+	Calls.push_back("Module_Test_Set_Period " + std::to_string(ms));
+}
+uint32_t Module_Test_Get_Period(void) { return Period_MS; }
+
+/* One parameter called "gain" */
+static const PARAM_INFO_t Gain_Info = {"gain", "x", PARAM_TYPE_FLOAT, 0, {0}, {0}, {0}};
+
+PARAM_ID_t Param_Find(const char* name) {
+	Calls.push_back(std::string("Param_Find ") + name);
+	return strcmp(name, "gain") == 0 ? (PARAM_ID_t)0 : PARAM_COUNT;
+}
+const PARAM_INFO_t* Param_Info(PARAM_ID_t id) { (void)id; return &Gain_Info; }
+int32_t Param_Get_Int(PARAM_ID_t id) { (void)id; return 0; }
+float Param_Get_Float(PARAM_ID_t id) { (void)id; return Param_Value; }
+
+PARAM_STATUS Param_Set_Float(PARAM_ID_t id, float value) {
+	(void)id;
+	Param_Value = value;
+	Calls.push_back("Param_Set_Float " + std::to_string(value));
+	return PARAM_OK;
+}
+PARAM_STATUS Param_Save(void) { return PARAM_OK; }
+PARAM_STATUS Param_Load(void) { return PARAM_OK; }
+void Param_Defaults(void) {}
+
+void Param_Handle_Frame(uint16_t seq, const uint8_t* payload, uint32_t len) {
+	(void)payload;
+	Frames_Handled++;
+	Calls.push_back("Param_Handle_Frame " + std::to_string(seq) + " " + std::to_string(len));
+}
+
+static const SCHED_STATS_t No_Stats = {0, 0, 0, 0};
+
+SCHED_ID_t Sched_Find(const char* name) {
+	Calls.push_back(std::string("Sched_Find ") + name);
+	return strcmp(name, "imu") == 0 ? TASK_IMU : SCHED_TASK_COUNT;
+}
+const char* Sched_Name(SCHED_ID_t id) { (void)id; return "task"; }
+uint8_t Sched_Enabled(SCHED_ID_t id) { (void)id; return 1; }
+uint32_t Sched_Get_Period(SCHED_ID_t id) { (void)id; return 10000; }
+const SCHED_STATS_t* Sched_Stats(SCHED_ID_t id) { (void)id; return &No_Stats; }
+void Sched_Reset_Stats(void) {}
+
+void Sched_Set_Period(SCHED_ID_t id, uint32_t period_us) {
+	Calls.push_back("Sched_Set_Period " + std::to_string(id) + " " + std::to_string(period_us));
+}
+
+uint8_t I2C0_Stats_Count(void) { return 0; }
+void I2C0_Stats_Read(uint8_t slot, I2C_STATS_t* st) { (void)slot; memset(st, 0, sizeof(*st)); }
+uint64_t I2C0_Stats_Window(void) { return 0; }
+void I2C0_Stats_Reset(void) {}
+uint8_t I2C0_Recover(void) { return 0; }
+uint32_t I2C0_Speed_HZ(I2C_SPEED_t speed) { (void)speed; return 100000; }
+I2C_SPEED_t I2C0_Device_Speed(uint8_t slave_addr) { (void)slave_addr; return (I2C_SPEED_t)0; }
+I2C_PRIO_t I2C0_Device_Prio(uint8_t slave_addr) { (void)slave_addr; return (I2C_PRIO_t)0; }
+}
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked
+ *	Output: none
+ */
+static void Check(bool ok, const std::string& what) {
+	Checks++;
+	if (!ok && Failures++ < 20) {
+		printf("  FAILED: %s\n", what.c_str());
+		printf("    output \"");
+		for (char c : Output)
+			printf(c == '\r' ? "\\r" : c == '\n' ? "\\n" : c == '\a' ? "\\a" : "%c", c);
+		printf("\"\n");
+	}
+}
+
+/*
+ *	---------------------Type--------------------------
+ *	Local helper, feeds bytes and lets the shell read them. Output
+ *	and recorded calls start empty
+ *	Input: Bytes
+ *	Output: none
+ */
+static void Type(const std::string& bytes) {
+	Output.clear();
+	Calls.clear();
+	Input.insert(Input.end(), bytes.begin(), bytes.end());
+	Shell_Service();
+}
+
+/*
+ *	---------------------Called------------------------
+ *	Local helper
+ *	Input: Expected calls, in order
+ *	Output: 1 if the stubs saw exactly these
+ */
+static bool Called(const std::vector<std::string>& want) {
+	return Calls == want;
+}
+
+static bool Has(const std::string& text) {
+	return Output.find(text) != std::string::npos;
+}
+
+int main(void) {
+	uint32_t lines;
+
+	Shell_Init();
+	Check(Output == "\r\n> ", "Shell_Init prints the prompt");
+
+	/* Words are split on runs of spaces */
+	Type("mode servo\r");
+	Check(Output == "mode servo\r\n> " && Called({"Module_Test_Set_Mode " + std::to_string(SERVO_TEST)}),
+		"a command with one argument");
+	Type("   param    gain     2.5   \r");
+	Check(Called({"Param_Find gain", "Param_Set_Float 2.500000"}) && Has("gain = 2.5000 x"),
+		"spaces before, between and after the words");
+	Type("sched imu 200\r");
+	Check(Called({"Sched_Find imu", "Sched_Set_Period " + std::to_string(TASK_IMU) + " 5000"}), "two arguments");
+	lines = Shell_Lines();
+	Type("      \r\r\n");
+	Check(Calls.empty() && Shell_Lines() == lines && Output == "      \r\n> \r\n> ", "blank lines run nothing");
+
+	/* Line endings */
+	lines = Shell_Lines();
+	Type("mode uart\r\nmode lcd\nmode i2c\r");
+	Check(Called({"Module_Test_Set_Mode " + std::to_string(UART_TEST), "Module_Test_Set_Mode " + std::to_string(LCD_TEST),
+		"Module_Test_Set_Mode " + std::to_string(I2C_TEST)}) && Shell_Lines() == lines + 3, "CR, LF and CR LF end a line once");
+	Type("\n");
+	Check(Calls.empty() && Shell_Lines() == lines + 3, "the LF of a CR LF split across reads");
+
+	/* Editing */
+	Type("modx\be fulk\x7Fl\r");
+	Check(Called({"Module_Test_Set_Mode " + std::to_string(FULL_SYSTEM_TEST)}), "backspace and delete");
+	Type("\b\b\bmode delay\x03mode tcs34727\x15mode mpu6050\r");
+	Check(Called({"Module_Test_Set_Mode " + std::to_string(MPU6050_TEST)}) && Has("^C"), "Ctrl-C and Ctrl-U drop the line");
+
+	/* Unknown commands are counted as lines but run nothing */
+	lines = Shell_Lines();
+	Type("frobnicate 1 2\r");
+	Check(Calls.empty() && Has("unknown command, try help") && Shell_Lines() == lines + 1, "unknown command");
+	Type("MODE servo\r");
+	Check(Calls.empty() && Has("unknown command"), "command names are case sensitive");
+	Type("mod\r");
+	Check(Calls.empty() && Has("unknown command"), "a prefix is not a command");
+
+	/* SHELL_MAX_ARGS words reach the command, one more is refused */
+	std::string max_words = "rate imu 200";
+	for (int i = 3; i < SHELL_MAX_ARGS; i++)
+		max_words += " x";
+	Type(max_words + "\r");
+	Check(Calls.empty() && Has("usage: rate"), "SHELL_MAX_ARGS words reach the command");
+	lines = Shell_Lines();
+	Type(max_words + " y\r");
+	Check(Calls.empty() && Has("too many arguments") && !Has("usage") && Shell_Lines() == lines,
+		"one word past SHELL_MAX_ARGS runs nothing");
+	Type("rate imu 200\r");
+	Check(Called({"MPU6050_Set_Sample_Rate 200"}), "the next line is parsed afresh");
+
+	/* Lines past SHELL_LINE_SIZE keep the first SHELL_LINE_SIZE - 1 characters */
+	std::string padded = "mode servo";
+	padded.resize(SHELL_LINE_SIZE - 1, ' ');
+	Type(padded + "extra words\r");
+	Check(Called({"Module_Test_Set_Mode " + std::to_string(SERVO_TEST)}), "characters past the line size never reach the command");
+	Check(std::count(Output.begin(), Output.end(), '\a') == (long)strlen("extra words") &&
+		Output.compare(0, padded.size(), padded) == 0, "every refused character rings the bell and is not echoed");
+	std::string digits = "rate ";
+	digits.resize(SHELL_LINE_SIZE + 20, '1');
+	Type(digits + "\r");
+	Check(Calls.empty() && Has("usage: rate"), "an overlong number is cut and rejected");
+	Type(std::string(SHELL_LINE_SIZE + 10, 'x') + "\b\b\r");
+	Check(Calls.empty() && Has("unknown command"), "backspace works after a full line");
+	Type("rate 5\r");
+	Check(Called({"Module_Test_Set_Period 5"}), "the next line after an overlong one");
+
+	/* A binary frame in the middle of a typed line */
+	uint8_t frame[TLM_MAX_FRAME], request[2] = {TLM_PARAM_OP_GET, 0};
+	uint32_t n = Telemetry_Pack(TLM_TYPE_PARAM, 42, request, sizeof(request), frame);
+	std::string bytes = "mode ";
+	bytes += '\0';
+	bytes.append((const char*)frame, n);
+	bytes += "delay\r";
+	Type(bytes);
+	Check(Called({"Param_Handle_Frame 42 2", "Module_Test_Set_Mode " + std::to_string(DELAY_TEST)}),
+		"a frame between 0x00 bytes is taken out of the typed line");
+
+	/* Every command in the help list is found */
+	Type("help\r");
+	std::string help = Output;
+	for (const char* name : {"help", "mode", "rate", "param", "stats", "sched", "i2c"}) {
+		Type(std::string(name) + "\r");
+		Check(help.find(std::string(name) + " - ") != std::string::npos && !Has("unknown command"),
+			std::string("help lists and the shell finds ") + name);
+	}
+
+	printf("%u checks, %u failed\n", Checks, Failures);
+	return Failures != 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * spsc_queue.hpp
+ *
+ *	Bounded lock-free single producer / single consumer queue used to
+ *	hand decoded records from a reader thread to the writer thread.
+ *
+ * Created on: November 22, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SPSC_QUEUE_HPP_
+#define SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+public:
+	/* Capacity is rounded up to a power of 2 */
+	explicit SpscQueue(size_t capacity) {
+		size_t n = 1;
+		while (n < capacity)
+			n <<= 1;
+		slots_.resize(n);
+		mask_ = n - 1;
+	}
+
+	/* Producer side, returns false when the queue is full */
+	bool push(const T& item) {
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (head - tail_cache_ > mask_) {
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			if (head - tail_cache_ > mask_)
+				return false;
+		}
+		slots_[head & mask_] = item;
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Consumer side, returns false when the queue is empty */
+	bool pop(T& item) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail == head_cache_) {
+			head_cache_ = head_.load(std::memory_order_acquire);
+			if (tail == head_cache_)
+				return false;
+		}
+		item = slots_[tail & mask_];
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	std::vector<T> slots_;
+	size_t mask_ = 0;
+
+	/* Indices live on separate cache lines so the threads don't share them */
+	alignas(64) std::atomic<size_t> head_{0};
+	size_t tail_cache_ = 0;						//Producer's copy of tail
+	alignas(64) std::atomic<size_t> tail_{0};
+	size_t head_cache_ = 0;						//Consumer's copy of head
+};
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ * stream_decoder.hpp
+ *
+ *	Turns the raw byte stream coming out of the board into sensor
+ *	records. Handles both the binary COBS telemetry frames from
+ *	Telemetry.c and the ASCII printout of ModuleTest.c, which can be
+ *	mixed on the same stream (init messages are always text).
+ *
+ * Created on: November 22, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef STREAM_DECODER_HPP_
+#define STREAM_DECODER_HPP_
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../Telemetry.h"
+}
+
+/* Extra channel bits for values only the ASCII printout carries */
+#define REC_CH_ACCEL_G					(0x0100)		//accel[] in g
+#define REC_CH_GYRO_DPS					(0x0200)		//gyro[] in deg/s
+
+/* Where a record came from */
+enum RecordFormat : uint8_t {
+	REC_BINARY = 0,
+	REC_ASCII  = 1
+};
+
+/* One decoded sample, a superset of both output formats */
+struct SensorRecord {
+	uint64_t host_ns;								//Host receive time (CLOCK_MONOTONIC)
+	uint32_t device_ts;							//Device timestamp, 0 when unknown
+	uint16_t seq;										//Frame sequence number (binary only)
+	uint8_t format;
+	uint8_t color;
+	uint16_t channels;							//TLM_CH_* and REC_CH_* bits present
+	int16_t accel_raw[3];
+	int16_t gyro_raw[3];
+	uint16_t rgbc_raw[4];
+	float accel[3];
+	float gyro[3];
+	float angle[3];									//Degrees, from either format
+};
+
+/* Running counters, only touched by the decoding thread */
+struct DecoderStats {
+	uint64_t bytes = 0;
+	uint64_t frames = 0;						//Good binary frames of any type
+	uint64_t samples = 0;						//Sample records produced (both formats)
+	uint64_t bad_frames = 0;				//COBS, CRC, length or version errors
+	uint64_t lost_frames = 0;				//Gaps in the sequence numbers
+	uint64_t text_lines = 0;
+	uint64_t overruns = 0;					//Segments too long to be a frame or line
+};
+
+class StreamDecoder {
+public:
+	using SampleFn = std::function<void(const SensorRecord&)>;
+	using FrameFn = std::function<void(uint8_t type, uint16_t seq, const uint8_t* payload, uint32_t len, uint64_t host_ns)>;
+	using LineFn = std::function<void(const std::string& line, uint64_t host_ns)>;
+
+	SampleFn on_sample;							//Sample records from either format
+	FrameFn on_frame;								//Good binary frames that are not samples
+	LineFn on_line;									//Every text line, after the sample parser
+
+	StreamDecoder() { buf_.reserve(MAX_SEGMENT); reset_pending(); }
+
+	const DecoderStats& stats() const { return stats_; }
+
+	/* Feed a chunk of the stream, records are delivered through the callbacks */
+	void feed(const uint8_t* data, size_t n, uint64_t host_ns) {
+		stats_.bytes += n;
+		for (size_t i = 0; i < n; i++) {
+			uint8_t b = data[i];
+			if (b == 0) {
+				end_segment(host_ns);
+				continue;
+			}
+			if (buf_.size() == MAX_SEGMENT) {
+				stats_.overruns++;
+				clear();
+			}
+			buf_.push_back(b);
+			if (!is_text(b))
+				binary_ = true;
+			//A line needs at least one character, a lone '\n' may be a COBS code byte
+			else if (b == '\n' && !binary_ && buf_.size() >= 2) {
+				text_line(host_ns);
+				clear();
+			}
+		}
+	}
+
+	/* Emit whatever ASCII sample is still pending, call at end of stream */
+	void flush(uint64_t host_ns) {
+		if (!buf_.empty() && !binary_)
+			text_line(host_ns);
+		clear();
+		emit_pending();
+	}
+
+private:
+	static const size_t MAX_SEGMENT = 1024;
+
+	enum Section { SEC_ACCEL, SEC_GYRO, SEC_ANGLE };
+
+	std::vector<uint8_t> buf_;
+	bool binary_ = false;
+	DecoderStats stats_;
+	bool have_seq_[256] = {};				//Every frame type numbers its frames separately
+	uint16_t last_seq_[256] = {};
+
+	/* ASCII parser state */
+	Section section_ = SEC_ACCEL;
+	int axis_ = 0;
+	SensorRecord pending_;
+
+	static bool is_text(uint8_t b) {
+		return (b >= 0x20 && b < 0x7F) || b == '\r' || b == '\n' || b == '\t' || b == 0x1B;
+	}
+
+	void clear() {
+		buf_.clear();
+		binary_ = false;
+	}
+
+	void reset_pending() {
+		std::memset(&pending_, 0, sizeof(pending_));
+		pending_.format = REC_ASCII;
+		section_ = SEC_ACCEL;
+		axis_ = 0;
+	}
+
+	void end_segment(uint64_t host_ns) {
+		if (buf_.empty())
+			return;
+
+		uint8_t type;
+		uint16_t seq;
+		uint8_t payload[TLM_MAX_PAYLOAD];
+		uint32_t plen;
+		if (Telemetry_Unpack(buf_.data(), (uint32_t)buf_.size(), &type, &seq, payload, &plen) == TLM_OK) {
+			stats_.frames++;
+			if (have_seq_[type])
+				stats_.lost_frames += (uint16_t)(seq - last_seq_[type] - 1);
+			have_seq_[type] = true;
+			last_seq_[type] = seq;
+			if (type == TLM_TYPE_SAMPLE)
+				binary_sample(host_ns);
+			else if (on_frame)
+				on_frame(type, seq, payload, plen, host_ns);
+		} else if (!binary_) {
+			text_line(host_ns);					//Text right before a frame
+		} else {
+			stats_.bad_frames++;
+		}
+		clear();
+	}
+
+	void binary_sample(uint64_t host_ns) {
+		TELEMETRY_SAMPLE_t s;
+		uint16_t seq;
+		if (Telemetry_Decode_Sample(buf_.data(), (uint32_t)buf_.size(), &s, &seq) != TLM_OK) {
+			stats_.bad_frames++;
+			return;
+		}
+		SensorRecord r;
+		std::memset(&r, 0, sizeof(r));
+		r.host_ns = host_ns;
+		r.device_ts = s.Timestamp;
+		r.seq = seq;
+		r.format = REC_BINARY;
+		r.channels = s.Channels;
+		r.color = s.Color;
+		for (int i = 0; i < 3; i++) {
+			r.accel_raw[i] = s.Accel_RAW[i];
+			r.gyro_raw[i] = s.Gyro_RAW[i];
+			r.angle[i] = s.Angle_cdeg[i] / 100.0f;
+		}
+		for (int i = 0; i < 4; i++)
+			r.rgbc_raw[i] = s.RGBC_RAW[i];
+		stats_.samples++;
+		if (on_sample)
+			on_sample(r);
+	}
+
+	void emit_pending() {
+		if (pending_.channels) {
+			stats_.samples++;
+			if (on_sample)
+				on_sample(pending_);
+		}
+		reset_pending();
+	}
+
+	/* Value after "tag" in s, false if the tag is missing */
+	static bool value_after(const char* s, const char* tag, float& out) {
+		const char* p = std::strstr(s, tag);
+		if (!p)
+			return false;
+		char* end;
+		out = std::strtof(p + std::strlen(tag), &end);
+		return end != p + std::strlen(tag);
+	}
+
+	static bool hex_after(const char* s, const char* tag, uint16_t& out) {
+		const char* p = std::strstr(s, tag);
+		if (!p)
+			return false;
+		char* end;
+		out = (uint16_t)std::strtoul(p + std::strlen(tag), &end, 16);
+		return end != p + std::strlen(tag);
+	}
+
+	/*
+		Parses the ModuleTest.c printout:
+			X: ax / Y: ay / Z: az, "Gyro Instance", X/Y/Z gyro,
+			"Angle Instance", "X: a Y: b Z: c" (no newline), then
+			"RED RAW: hex", "GREEN RAW: hex", "BLUE RAW: hex"
+		Axes are taken by position since older firmware labels Z as "Y:"
+	*/
+	void text_line(uint64_t host_ns) {
+		std::string line;
+		line.reserve(buf_.size());
+		for (size_t i = 0; i < buf_.size(); i++) {
+			uint8_t c = buf_[i];
+			if (c == 0x1B) {						//Skip CSI sequences such as "\033[2J"
+				if (i + 1 < buf_.size() && buf_[i+1] == '[') {
+					i += 2;
+					while (i < buf_.size() && buf_[i] >= 0x20 && buf_[i] <= 0x3F)
+						i++;
+					if (i < buf_.size() && !(buf_[i] >= 0x40 && buf_[i] <= 0x7E))
+						i--;							//Cut short, leave the next byte alone
+				}
+				continue;
+			}
+			if (c != '\r' && c != '\n')
+				line.push_back((char)c);
+		}
+		stats_.text_lines++;
+		parse_line(line, host_ns);
+		if (on_line)
+			on_line(line, host_ns);
+	}
+
+	void parse_line(const std::string& line, uint64_t host_ns) {
+		const char* s = line.c_str();
+		float v;
+
+		if (std::strstr(s, "Gyro Instance")) {
+			section_ = SEC_GYRO;
+			axis_ = 0;
+			return;
+		}
+		if (std::strstr(s, "Angle Instance")) {
+			section_ = SEC_ANGLE;
+			axis_ = 0;
+			return;
+		}
+
+		if (section_ == SEC_ANGLE && std::strncmp(s, "X:", 2) == 0) {
+			float x, y, z;
+			if (value_after(s, "X:", x) && value_after(s, "Y:", y) && value_after(s, "Z:", z)) {
+				pending_.angle[0] = x;
+				pending_.angle[1] = y;
+				pending_.angle[2] = z;
+				pending_.channels |= TLM_CH_ANGLE;
+			}
+			section_ = SEC_ACCEL;
+			axis_ = 0;
+			//RED RAW follows on the same line, fall through
+		} else if (std::strlen(s) >= 2 && (s[0] == 'X' || s[0] == 'Y' || s[0] == 'Z') && s[1] == ':') {
+			if (!value_after(s, ":", v))
+				return;
+			//New accel block starts a new sample (MPU only printout has no color)
+			if (section_ == SEC_ACCEL && axis_ == 0 && (pending_.channels & (REC_CH_ACCEL_G|TLM_CH_ANGLE)))
+				emit_pending();
+			if (pending_.channels == 0)
+				pending_.host_ns = host_ns;
+			if (section_ == SEC_ACCEL) {
+				pending_.accel[axis_] = v;
+				pending_.channels |= REC_CH_ACCEL_G;
+			} else {
+				pending_.gyro[axis_] = v;
+				pending_.channels |= REC_CH_GYRO_DPS;
+			}
+			axis_ = (axis_ + 1) % 3;
+			return;
+		}
+
+		uint16_t h;
+		if (hex_after(s, "RED RAW:", h)) {
+			pending_.rgbc_raw[0] = h;
+			pending_.channels |= TLM_CH_RGBC_RAW;
+		}
+		if (hex_after(s, "GREEN RAW:", h))
+			pending_.rgbc_raw[1] = h;
+		if (hex_after(s, "BLUE RAW:", h)) {
+			pending_.rgbc_raw[2] = h;
+			emit_pending();
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,337 @@
+/*
+ * telemetry_ingest.cpp
+ *
+ *	Host side ingest tool. Reads the board's UART stream from a tty,
+ *	a PTY stand-in or a recorded capture, decodes it on a dedicated
+ *	reader thread and hands the records to the writer (main) thread
+ *	through a lock-free queue. The writer records the session and
+ *	prints throughput and drop statistics once a second.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 -pthread telemetry_ingest.cpp Telemetry.o -o telemetry_ingest
+ *
+ *	Usage:
+ *		telemetry_ingest [-b baud] [-o prefix] [-q] /dev/ttyACM0
+ *		telemetry_ingest [-o prefix] capture.raw						(replay, full speed)
+ *		telemetry_ingest --pty [--sim rate] [-n count] [-o prefix]
+ *
+ *	Outputs, when -o is given:
+ *		prefix.raw		Raw bytes as received (live sources only), can be replayed
+ *		prefix.sess		Columnar session file, one row per decoded sample
+ *		prefix.log		Text lines and expanded log records with their host timestamps
+ *
+ *	Deferred log records (TLM_TYPE_LOG) are expanded with the table in
+ *	LogMessages.h and also printed to stdout.
+ *
+ * Created on: November 22, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "board_sim.hpp"
+#include "log_expand.hpp"
+#include "serial_source.hpp"
+#include "session_file.hpp"
+#include "spsc_queue.hpp"
+#include "stream_decoder.hpp"
+
+#define QUEUE_SIZE						(16384)
+#define READ_CHUNK						(65536)
+#define EVENT_DATA_SIZE				(240)			//Raw capture bytes or one text line per event
+#define STATS_PERIOD_NS				(1000000000ULL)
+
+/* What the reader hands to the writer */
+enum EventKind : uint8_t {
+	EV_SAMPLE,
+	EV_LINE,
+	EV_RAW,
+	EV_FRAME
+};
+
+struct Event {
+	EventKind kind;
+	uint8_t type;										//Frame type for EV_FRAME
+	uint16_t len;										//Bytes used in data
+	SensorRecord rec;								//EV_SAMPLE, host_ns is valid for every kind
+	uint8_t data[EVENT_DATA_SIZE];
+};
+
+/* Reader counters the writer thread samples for the live statistics */
+struct SharedStats {
+	std::atomic<uint64_t> bytes{0};
+	std::atomic<uint64_t> frames{0};
+	std::atomic<uint64_t> samples{0};
+	std::atomic<uint64_t> bad_frames{0};
+	std::atomic<uint64_t> lost_frames{0};
+	std::atomic<uint64_t> text_lines{0};
+	std::atomic<uint64_t> overruns{0};
+	std::atomic<uint64_t> queue_drops{0};
+};
+
+static std::atomic<bool> Stop{false};
+static std::atomic<bool> ReaderDone{false};
+
+static void on_signal(int) {
+	Stop.store(true);
+}
+
+/*
+	Reader thread. Live sources drop events when the writer falls
+	behind (counted), file replay waits instead so nothing is lost
+*/
+static void reader_main(Source* src, SpscQueue<Event>* q, SharedStats* shared, bool capture) {
+	static uint8_t buf[READ_CHUNK];
+	StreamDecoder dec;
+	bool lossless = (src->kind == SRC_FILE);
+	Event ev;
+
+	auto post = [&](const Event& e) {
+		while (!q->push(e)) {
+			if (!lossless) {
+				shared->queue_drops.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			std::this_thread::yield();
+		}
+	};
+
+	dec.on_sample = [&](const SensorRecord& r) {
+		ev.kind = EV_SAMPLE;
+		ev.rec = r;
+		ev.len = 0;
+		post(ev);
+	};
+	dec.on_line = [&](const std::string& line, uint64_t t) {
+		ev.kind = EV_LINE;
+		ev.rec.host_ns = t;
+		ev.len = (uint16_t)std::min(line.size(), (size_t)EVENT_DATA_SIZE);
+		std::memcpy(ev.data, line.data(), ev.len);
+		post(ev);
+	};
+	dec.on_frame = [&](uint8_t type, uint16_t, const uint8_t* payload, uint32_t len, uint64_t t) {
+		ev.kind = EV_FRAME;
+		ev.type = type;
+		ev.rec.host_ns = t;
+		ev.len = (uint16_t)std::min(len, (uint32_t)EVENT_DATA_SIZE);
+		std::memcpy(ev.data, payload, ev.len);
+		post(ev);
+	};
+
+	while (!Stop.load(std::memory_order_relaxed)) {
+		ssize_t n = read_source(*src, buf, sizeof(buf), 100);
+		if (n < 0)
+			break;
+		if (n == 0)
+			continue;
+		uint64_t t = now_ns();
+		if (capture) {
+			for (ssize_t off = 0; off < n; off += EVENT_DATA_SIZE) {
+				ev.kind = EV_RAW;
+				ev.rec.host_ns = t;
+				ev.len = (uint16_t)std::min((ssize_t)EVENT_DATA_SIZE, n - off);
+				std::memcpy(ev.data, buf + off, ev.len);
+				post(ev);
+			}
+		}
+		dec.feed(buf, (size_t)n, t);
+
+		const DecoderStats& s = dec.stats();
+		shared->bytes.store(s.bytes, std::memory_order_relaxed);
+		shared->frames.store(s.frames, std::memory_order_relaxed);
+		shared->samples.store(s.samples, std::memory_order_relaxed);
+		shared->bad_frames.store(s.bad_frames, std::memory_order_relaxed);
+		shared->lost_frames.store(s.lost_frames, std::memory_order_relaxed);
+		shared->text_lines.store(s.text_lines, std::memory_order_relaxed);
+		shared->overruns.store(s.overruns, std::memory_order_relaxed);
+	}
+	dec.flush(now_ns());
+	shared->samples.store(dec.stats().samples, std::memory_order_relaxed);
+	shared->text_lines.store(dec.stats().text_lines, std::memory_order_relaxed);
+	ReaderDone.store(true, std::memory_order_release);
+}
+
+static void print_stats(const SharedStats& s, uint64_t& last_bytes, uint64_t& last_samples, double dt, bool final) {
+	uint64_t bytes = s.bytes.load(std::memory_order_relaxed);
+	uint64_t samples = s.samples.load(std::memory_order_relaxed);
+	fprintf(stderr, "%s%9.1f kB/s %9.0f samples/s | frames %llu lines %llu | bad %llu lost %llu overrun %llu qdrop %llu\n",
+		final ? "total " : "",
+		(bytes - last_bytes) / dt / 1000.0, (samples - last_samples) / dt,
+		(unsigned long long)s.frames.load(), (unsigned long long)s.text_lines.load(),
+		(unsigned long long)s.bad_frames.load(), (unsigned long long)s.lost_frames.load(),
+		(unsigned long long)s.overruns.load(), (unsigned long long)s.queue_drops.load());
+	last_bytes = bytes;
+	last_samples = samples;
+}
+
+static FILE* open_out(const std::string& prefix, const char* ext) {
+	std::string path = prefix + ext;
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f) {
+		perror(path.c_str());
+		return nullptr;
+	}
+	setvbuf(f, nullptr, _IOFBF, 1 << 20);
+	return f;
+}
+
+static void usage() {
+	fprintf(stderr,
+		"usage: telemetry_ingest [-b baud] [-o prefix] [-q] <tty|capture file>\n"
+		"       telemetry_ingest --pty [--sim rate] [-n count] [--ascii-every n] [-o prefix] [-q]\n");
+}
+
+int main(int argc, char** argv) {
+	unsigned baud = 115200;
+	const char* path = nullptr;
+	std::string prefix;
+	bool use_pty = false;
+	bool quiet = false;
+	bool sim = false;
+	SimConfig sim_cfg;
+
+	for (int i = 1; i < argc; i++) {
+		std::string a = argv[i];
+		bool has_val = (i + 1 < argc);
+		if (a == "-b" && has_val)
+			baud = (unsigned)strtoul(argv[++i], nullptr, 10);
+		else if (a == "-o" && has_val)
+			prefix = argv[++i];
+		else if (a == "-q")
+			quiet = true;
+		else if (a == "--pty")
+			use_pty = true;
+		else if (a == "--sim" && has_val) {
+			sim = true;
+			sim_cfg.rate_hz = strtod(argv[++i], nullptr);
+		} else if (a == "-n" && has_val)
+			sim_cfg.count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (a == "--ascii-every" && has_val)
+			sim_cfg.ascii_every = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (a[0] != '-' && !path)
+			path = argv[i];
+		else {
+			usage();
+			return 2;
+		}
+	}
+	if (use_pty == (path != nullptr) || (sim && !use_pty)) {
+		usage();
+		return 2;
+	}
+
+	Source src;
+	if (use_pty ? !open_pty(src) : !open_path(src, path, baud))
+		return 1;
+	if (use_pty)
+		fprintf(stderr, "pty: %s\n", src.name.c_str());
+
+	FILE* raw_f = nullptr;
+	FILE* log_f = nullptr;
+	SessionWriter session;
+	bool record = !prefix.empty();
+	if (record) {
+		if (src.kind != SRC_FILE && !(raw_f = open_out(prefix, ".raw")))
+			return 1;
+		if (!(log_f = open_out(prefix, ".log")))
+			return 1;
+		add_sensor_channels(session);
+		if (!session.open((prefix + ".sess").c_str()))
+			return 1;
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	SpscQueue<Event>* q = new SpscQueue<Event>(QUEUE_SIZE);
+	SharedStats shared;
+	std::thread reader(reader_main, &src, q, &shared, raw_f != nullptr);
+
+	//The simulator writes into the slave side, the reader sees it on the master
+	std::thread sim_thread;
+	BoardSim board(sim_cfg);
+	if (sim)
+		sim_thread = std::thread([&] { board.run(src.slave_fd, Stop); if (sim_cfg.count) { usleep(200000); Stop.store(true); } });
+
+	uint64_t start = now_ns();
+	uint64_t last = start;
+	uint64_t last_bytes = 0, last_samples = 0;
+	uint64_t other_frames = 0;
+	uint32_t log_clock_hz = 0;						//From the LOG_START record
+	Event ev;
+	for (;;) {
+		bool got = q->pop(ev);
+		if (!got) {
+			//Check the queue once more after the reader is done, it may have raced the last push
+			if (ReaderDone.load(std::memory_order_acquire)) {
+				if (!q->pop(ev))
+					break;
+				got = true;
+			} else {
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+		}
+		if (got) {
+			switch (ev.kind) {
+				case EV_SAMPLE:
+					if (record)
+						append_record(session, ev.rec);
+					break;
+				case EV_LINE:
+					if (log_f)
+						fprintf(log_f, "%llu %.*s\n", (unsigned long long)ev.rec.host_ns, (int)ev.len, (const char*)ev.data);
+					break;
+				case EV_RAW:
+					fwrite(ev.data, 1, ev.len, raw_f);
+					break;
+				case EV_FRAME:
+					if (ev.type == TLM_TYPE_LOG)
+						log_parse(ev.data, ev.len, [&](const LogRecord& r) {
+							if (r.id == LOG_START && r.nargs == 1)
+								log_clock_hz = r.args[0];
+							std::string text = log_format(r);
+							double t = log_clock_hz ? (double)r.timestamp / log_clock_hz : 0.0;
+							printf("[%12.6f] %s\n", t, text.c_str());
+							if (log_f)
+								fprintf(log_f, "%llu [%.6f] %s\n", (unsigned long long)ev.rec.host_ns, t, text.c_str());
+						});
+					else
+						other_frames++;
+					break;
+			}
+		}
+
+		uint64_t t = now_ns();
+		if (!quiet && t - last >= STATS_PERIOD_NS) {
+			print_stats(shared, last_bytes, last_samples, (t - last) * 1e-9, false);
+			last = t;
+		}
+	}
+	Stop.store(true);
+	reader.join();
+	if (sim_thread.joinable())
+		sim_thread.join();
+
+	double elapsed = (now_ns() - start) * 1e-9;
+	uint64_t zero_b = 0, zero_s = 0;
+	print_stats(shared, zero_b, zero_s, elapsed > 0 ? elapsed : 1e-9, true);
+	if (other_frames)
+		fprintf(stderr, "%llu frames of other types\n", (unsigned long long)other_frames);
+
+	if (raw_f)
+		fclose(raw_f);
+	if (record && !session.close())
+		fprintf(stderr, "%s.sess: write failed\n", prefix.c_str());
+	if (log_f)
+		fclose(log_f);
+	close_source(src);
+	delete q;
+	return 0;
+}
@@ -0,0 +1,320 @@
+/*
+ * telemetry_merge.cpp
+ *
+ *	Multi-board aggregator. Every board stream gets its own reader
+ *	thread that decodes it, maps the device timestamps onto the host
+ *	clock (clock_align.hpp) and hands the records to the merge stage
+ *	through a private lock-free queue, so streams never contend with
+ *	each other. The merge stage (main thread) does a k-way merge on
+ *	the aligned time and writes one time-ordered stream.
+ *
+ *	A record is released once every other live stream has something
+ *	queued that is at least as new, or once it is older than the
+ *	latency bound (-l) so a silent board cannot stall the rest.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 -pthread telemetry_merge.cpp Telemetry.o -o telemetry_merge
+ *
+ *	Usage:
+ *		telemetry_merge [-b baud] [-l ms] [-o merged.sess] [--print] /dev/ttyACM0 /dev/ttyACM1 ...
+ *		telemetry_merge --sim N [--rate hz] [-n count] [-o merged.sess] [--print]
+ *
+ *	With --sim, N simulated boards write to pipes, each with its own
+ *	clock offset and drift. Since they all sample at the same true
+ *	instants, the spread of the aligned times of equal sequence
+ *	numbers measures the alignment error.
+ *
+ * Created on: November 24, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "board_sim.hpp"
+#include "clock_align.hpp"
+#include "serial_source.hpp"
+#include "session_file.hpp"
+#include "spsc_queue.hpp"
+#include "stream_decoder.hpp"
+
+#define QUEUE_SIZE						(8192)
+#define READ_CHUNK						(16384)
+#define DEFAULT_LATENCY_MS		(100)
+
+/* Extra columns after the standard sensor channels */
+#define MC_BOARD							(SC_COUNT)
+#define MC_T_ALIGNED					(SC_COUNT + 1)
+
+struct AlignedRecord {
+	int64_t t;											//Aligned host time (ns)
+	uint16_t board;
+	SensorRecord rec;
+};
+
+struct Stream {
+	Source src;
+	SpscQueue<AlignedRecord> q{QUEUE_SIZE};
+	std::atomic<bool> done{false};
+	std::atomic<double> drift_ppm{0.0};
+	uint64_t merged = 0;						//Merge thread only
+	bool has_head = false;					//Merge thread only, head is in the heap
+	AlignedRecord head;
+};
+
+static std::atomic<bool> Stop{false};
+
+static void on_signal(int) {
+	Stop.store(true);
+}
+
+/*
+	Reader thread for one stream. Waits when its queue is full, the
+	backpressure lands on the kernel buffer of the tty or pipe
+*/
+static void reader_main(Stream* st, uint16_t board) {
+	std::vector<uint8_t> buf(READ_CHUNK);
+	StreamDecoder dec;
+	ClockAligner clk;
+
+	dec.on_sample = [&](const SensorRecord& r) {
+		AlignedRecord a;
+		a.board = board;
+		a.rec = r;
+		//ASCII printouts carry no device time, fall back on the receive time
+		a.t = (r.format == REC_BINARY) ? clk.add(r.device_ts, (int64_t)r.host_ns) : (int64_t)r.host_ns;
+		while (!st->q.push(a)) {
+			if (Stop.load(std::memory_order_relaxed))
+				return;
+			std::this_thread::yield();
+		}
+	};
+
+	while (!Stop.load(std::memory_order_relaxed)) {
+		ssize_t n = read_source(st->src, buf.data(), buf.size(), 100);
+		if (n < 0)
+			break;
+		if (n > 0) {
+			dec.feed(buf.data(), (size_t)n, now_ns());
+			st->drift_ppm.store(clk.drift_ppm(), std::memory_order_relaxed);
+		}
+	}
+	dec.flush(now_ns());
+	st->done.store(true, std::memory_order_release);
+}
+
+/* Merge heap entry, smallest time first, board breaks ties */
+struct HeapItem {
+	int64_t t;
+	uint16_t board;
+	bool operator>(const HeapItem& o) const { return t != o.t ? t > o.t : board > o.board; }
+};
+
+/* Spread of the aligned times of one sequence number across simulated boards */
+struct SeqSpread {
+	int64_t lo = INT64_MAX, hi = INT64_MIN;
+	uint32_t count = 0;
+};
+
+static void usage() {
+	fprintf(stderr,
+		"usage: telemetry_merge [-b baud] [-l ms] [-o merged.sess] [--print] <stream> ...\n"
+		"       telemetry_merge --sim N [--rate hz] [-n count] [-l ms] [-o merged.sess] [--print]\n");
+}
+
+int main(int argc, char** argv) {
+	unsigned baud = 115200;
+	int64_t latency_ns = DEFAULT_LATENCY_MS * 1000000LL;
+	const char* out_path = nullptr;
+	bool print = false;
+	uint32_t sims = 0;
+	SimConfig sim_cfg;
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; i++) {
+		std::string a = argv[i];
+		bool has_val = (i + 1 < argc);
+		if (a == "-b" && has_val)
+			baud = (unsigned)strtoul(argv[++i], nullptr, 10);
+		else if (a == "-l" && has_val)
+			latency_ns = strtoll(argv[++i], nullptr, 10) * 1000000LL;
+		else if (a == "-o" && has_val)
+			out_path = argv[++i];
+		else if (a == "--print")
+			print = true;
+		else if (a == "--sim" && has_val)
+			sims = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (a == "--rate" && has_val)
+			sim_cfg.rate_hz = strtod(argv[++i], nullptr);
+		else if (a == "-n" && has_val)
+			sim_cfg.count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (a[0] != '-')
+			paths.push_back(argv[i]);
+		else {
+			usage();
+			return 2;
+		}
+	}
+	size_t n_streams = sims ? sims : paths.size();
+	if (n_streams == 0 || (sims && !paths.empty()) || n_streams > 0xFFFF) {
+		usage();
+		return 2;
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	signal(SIGPIPE, SIG_IGN);
+
+	/* Open every stream, or a pipe per simulated board */
+	std::vector<std::unique_ptr<Stream>> streams;
+	std::vector<std::unique_ptr<BoardSim>> boards;
+	std::vector<int> sim_fds;
+	for (size_t i = 0; i < n_streams; i++) {
+		streams.emplace_back(new Stream);
+		Stream& st = *streams.back();
+		if (sims) {
+			int fds[2];
+			if (pipe(fds) < 0) {
+				perror("pipe");
+				return 1;
+			}
+			open_fd(st.src, fds[0], "sim" + std::to_string(i));
+			sim_fds.push_back(fds[1]);
+			SimConfig c = sim_cfg;
+			c.clock_offset_us = (uint32_t)(i * 7919013u);			//Boards powered up at different times
+			c.drift_ppm = ((int)(i % 11) - 5) * 10.0;					//-50 to +50 ppm crystals
+			boards.emplace_back(new BoardSim(c));
+		} else if (!open_path(st.src, paths[i], baud)) {
+			return 1;
+		}
+	}
+
+	SessionWriter session;
+	if (out_path) {
+		add_sensor_channels(session);
+		session.add_channel("board", COL_U16);
+		session.add_channel("t_aligned", COL_U64, 1e-9f);
+		if (!session.open(out_path))
+			return 1;
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < n_streams; i++)
+		threads.emplace_back(reader_main, streams[i].get(), (uint16_t)i);
+	std::atomic<bool> sim_stop{false};
+	std::vector<std::thread> sim_threads;
+	auto sim_start = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+	for (size_t i = 0; i < boards.size(); i++)
+		sim_threads.emplace_back([&, i] { boards[i]->run(sim_fds[i], sim_stop, sim_start); close(sim_fds[i]); });
+
+	/* Merge stage */
+	std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+	std::vector<SeqSpread> spread(sims ? 0x10000 : 0);
+	int64_t spread_max = 0;
+	double spread_sum = 0;
+	uint64_t spread_n = 0;
+	uint64_t merged = 0;
+	uint64_t out_of_order = 0;
+	int64_t last_t = INT64_MIN;
+	uint64_t start = now_ns();
+
+	for (;;) {
+		//Pull the head of every stream that has none in the heap
+		size_t waiting = 0;						//Live streams with nothing queued
+		size_t live = 0;
+		for (size_t i = 0; i < n_streams; i++) {
+			Stream& st = *streams[i];
+			if (st.has_head)
+				continue;
+			bool done = st.done.load(std::memory_order_acquire);
+			if (st.q.pop(st.head)) {
+				st.has_head = true;
+				heap.push(HeapItem{ st.head.t, (uint16_t)i });
+			} else if (!done) {
+				waiting++;
+			}
+		}
+		for (size_t i = 0; i < n_streams; i++)
+			if (streams[i]->has_head || !streams[i]->done.load(std::memory_order_acquire))
+				live++;
+		if (live == 0)
+			break;
+
+		if (heap.empty() || (waiting && heap.top().t > (int64_t)now_ns() - latency_ns)) {
+			if (Stop.load())
+				sim_stop.store(true);
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			continue;
+		}
+
+		//Every live stream is represented (or the head is old enough), release the oldest
+		HeapItem top = heap.top();
+		heap.pop();
+		Stream& st = *streams[top.board];
+		st.has_head = false;
+		st.merged++;
+		merged++;
+		if (top.t < last_t)
+			out_of_order++;							//Released by the latency bound, a late stream caught up
+		last_t = top.t;
+
+		const AlignedRecord& r = st.head;
+		if (out_path) {
+			session.put<uint16_t>(MC_BOARD, r.board);
+			session.put<uint64_t>(MC_T_ALIGNED, (uint64_t)r.t);
+			append_record(session, r.rec);
+		}
+		if (print)
+			printf("%lld %u %u %u %.2f %.2f %.2f\n", (long long)r.t, r.board, r.rec.seq, r.rec.device_ts,
+				r.rec.angle[0], r.rec.angle[1], r.rec.angle[2]);
+		if (sims && r.rec.format == REC_BINARY) {
+			SeqSpread& s = spread[r.rec.seq];
+			if (r.t < s.lo)
+				s.lo = r.t;
+			if (r.t > s.hi)
+				s.hi = r.t;
+			if (++s.count == sims) {
+				int64_t d = s.hi - s.lo;
+				if (d > spread_max)
+					spread_max = d;
+				spread_sum += (double)d;
+				spread_n++;
+				s = SeqSpread();
+			}
+		}
+	}
+
+	Stop.store(true);
+	sim_stop.store(true);
+	for (std::thread& t : sim_threads)
+		t.join();
+	for (std::thread& t : threads)
+		t.join();
+
+	double secs = (now_ns() - start) * 1e-9;
+	fprintf(stderr, "merged %llu records from %zu streams in %.2f s (%.0f records/s), %llu released out of order\n",
+		(unsigned long long)merged, n_streams, secs, merged / secs, (unsigned long long)out_of_order);
+	for (size_t i = 0; i < n_streams; i++)
+		fprintf(stderr, "  %-14s %10llu records  drift %+7.1f ppm\n", streams[i]->src.name.c_str(),
+			(unsigned long long)streams[i]->merged, streams[i]->drift_ppm.load());
+	if (spread_n)
+		fprintf(stderr, "alignment spread across boards: mean %.1f us, max %.1f us\n",
+			spread_sum / spread_n / 1000.0, spread_max / 1000.0);
+
+	if (out_path && !session.close()) {
+		fprintf(stderr, "%s: write failed\n", out_path);
+		return 1;
+	}
+	for (size_t i = 0; i < n_streams; i++)
+		close_source(streams[i]->src);
+	return 0;
+}
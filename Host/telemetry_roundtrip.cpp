@@ -0,0 +1,358 @@
+/*
+ * telemetry_roundtrip.cpp
+ *
+ *	Round trip checks of ../Telemetry.c, the same object the ingest
+ *	tools link:
+ *		- COBS_Encode/COBS_Decode over every length up to a few
+ *		  blocks, with no zeros (runs of 254 and more), only zeros,
+ *		  sparse zeros and zeros right at the 254 byte block edge.
+ *		  The encoding must hold no 0x00 and stay within the size
+ *		  Telemetry.h promises
+ *		- malformed COBS input (a code past the end, a 0x00 inside)
+ *		- Telemetry_Pack/Unpack for every payload length, and the
+ *		  rejection of one byte too many
+ *		- Telemetry_Encode_Sample/Decode_Sample for every channel
+ *		  subset, absent channels must come back as 0
+ *		- the CRC: the CCITT check value, every single bit flip of a
+ *		  frame reported as TLM_ERR_CRC, a wrong version with a good
+ *		  CRC as TLM_ERR_VERSION, short payloads as TLM_ERR_LENGTH
+ *		- a stream of frames through StreamDecoder with one of them
+ *		  corrupted, which must be counted and skipped
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Telemetry.c -o Telemetry.o
+ *		g++ -O2 -std=c++17 telemetry_roundtrip.cpp Telemetry.o -o telemetry_roundtrip
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "stream_decoder.hpp"
+
+#define COBS_MAX_LEN				(1100)			//A little over four 254 byte blocks
+
+static uint32_t Checks, Failures;
+
+/* Reproducible data, xorshift32 */
+static uint32_t Seed = 0x1B873593;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked
+ *	Output: none
+ */
+static void Check(bool ok, const char* what) {
+	Checks++;
+	if (!ok && Failures++ < 10)
+		printf("  FAILED: %s\n", what);
+}
+
+/*
+ *	-------------------Cobs_Round----------------------
+ *	Local helper, one COBS round trip
+ *	Input: Data
+ *	Output: none
+ */
+static void Cobs_Round(const std::vector<uint8_t>& in) {
+	std::vector<uint8_t> enc(in.size() + in.size() / 254 + 1), dec(enc.size());
+	uint32_t n = COBS_Encode(in.data(), (uint32_t)in.size(), enc.data());
+
+	Check(n <= enc.size(), "COBS_Encode within len + len/254 + 1");
+	Check(std::memchr(enc.data(), 0, n) == 0, "COBS_Encode output has no 0x00");
+	uint32_t m = COBS_Decode(enc.data(), n, dec.data());
+	Check(m == in.size() && std::memcmp(dec.data(), in.data(), m) == 0, "COBS_Decode gives back the input");
+}
+
+/*
+ *	---------------------Cobs_All----------------------
+ *	Local helper, every length with the byte patterns that move the
+ *	code bytes around
+ *	Input: none
+ *	Output: none
+ */
+static void Cobs_All(void) {
+	//A zero length input encodes to one code byte, and decodes to 0 bytes, which reads as malformed. Frames are never empty
+	for (uint32_t len = 1; len <= COBS_MAX_LEN; len++) {
+		std::vector<uint8_t> none(len), zeros(len, 0), sparse(len), edge(len);
+
+		for (uint32_t i = 0; i < len; i++) {
+			none[i] = (uint8_t)(1 + Next() % 255);
+			sparse[i] = (Next() % 64) ? (uint8_t)(1 + Next() % 255) : 0;
+			edge[i] = (i % 254 == 253 || i % 254 == 0) ? 0 : (uint8_t)(1 + i % 255);
+		}
+		Cobs_Round(none);
+		Cobs_Round(zeros);
+		Cobs_Round(sparse);
+		Cobs_Round(edge);
+	}
+
+	/* Exactly one block of 254 non-zero bytes: 0xFF, the data, and a closing 0x01 */
+	std::vector<uint8_t> block(254, 0x55), enc(256);
+	uint32_t n = COBS_Encode(block.data(), (uint32_t)block.size(), enc.data());
+	Check(n == 256 && enc[0] == 0xFF && enc[255] == 0x01, "COBS_Encode of a full 254 byte block");
+
+	/* Malformed input */
+	uint8_t out[16];
+	const uint8_t past_end[] = {0x05, 0x11, 0x22};
+	const uint8_t inner_zero[] = {0x04, 0x11, 0x00, 0x22};
+	const uint8_t zero_code[] = {0x02, 0x11, 0x00};
+	Check(COBS_Decode(past_end, sizeof(past_end), out) == 0, "COBS_Decode rejects a code past the end");
+	Check(COBS_Decode(inner_zero, sizeof(inner_zero), out) == 0, "COBS_Decode rejects a 0x00 inside a block");
+	Check(COBS_Decode(zero_code, sizeof(zero_code), out) == 0, "COBS_Decode rejects a 0x00 code");
+}
+
+/*
+ *	---------------------Raw_Of------------------------
+ *	Local helper
+ *	Input: Delimited frame
+ *	Output: The frame before COBS, CRC included
+ */
+static std::vector<uint8_t> Raw_Of(const uint8_t* frame, uint32_t len) {
+	std::vector<uint8_t> raw(len);
+
+	raw.resize(COBS_Decode(frame, len - 1, raw.data()));
+	return raw;
+}
+
+/*
+ *	---------------------Frame_Of----------------------
+ *	Local helper
+ *	Input: Frame before COBS
+ *	Output: COBS encoded, without the delimiter
+ */
+static std::vector<uint8_t> Frame_Of(const std::vector<uint8_t>& raw) {
+	std::vector<uint8_t> frame(raw.size() + raw.size() / 254 + 1);
+
+	frame.resize(COBS_Encode(raw.data(), (uint32_t)raw.size(), frame.data()));
+	return frame;
+}
+
+/*
+ *	---------------------Pack_All----------------------
+ *	Local helper, Telemetry_Pack/Unpack for every payload length
+ *	Input: none
+ *	Output: none
+ */
+static void Pack_All(void) {
+	uint8_t payload[TLM_MAX_PAYLOAD + 1], got[TLM_MAX_PAYLOAD], frame[TLM_MAX_FRAME];
+
+	for (uint32_t len = 0; len <= TLM_MAX_PAYLOAD; len++) {
+		for (int pattern = 0; pattern < 3; pattern++) {
+			for (uint32_t i = 0; i < len; i++)
+				payload[i] = (pattern == 0) ? 0 : (pattern == 1) ? (uint8_t)(1 + Next() % 255) : (uint8_t)Next();
+			uint8_t type = (uint8_t)(1 + Next() % 3), got_type = 0;
+			uint16_t seq = (uint16_t)Next(), got_seq = 0;
+			uint32_t plen = 0;
+			uint32_t n = Telemetry_Pack(type, seq, payload, len, frame);
+
+			Check(n > 0 && n <= TLM_MAX_FRAME && frame[n - 1] == 0 && std::memchr(frame, 0, n - 1) == 0,
+				"Telemetry_Pack gives one delimited frame within TLM_MAX_FRAME");
+			Check(Telemetry_Unpack(frame, n - 1, &got_type, &got_seq, got, &plen) == TLM_OK && got_type == type &&
+				got_seq == seq && plen == len && std::memcmp(got, payload, len) == 0,
+				"Telemetry_Unpack gives back type, sequence and payload");
+		}
+	}
+	Check(Telemetry_Pack(TLM_TYPE_LOG, 0, payload, TLM_MAX_PAYLOAD + 1, frame) == 0,
+		"Telemetry_Pack rejects a payload over TLM_MAX_PAYLOAD");
+}
+
+/*
+ *	--------------------Sample_All---------------------
+ *	Local helper, samples with every channel subset
+ *	Input: none
+ *	Output: none
+ */
+static void Sample_All(void) {
+	uint8_t frame[TLM_MAX_FRAME];
+
+	for (int round = 0; round < 200; round++) {
+		for (uint16_t ch = 0; ch <= TLM_CH_ALL; ch++) {
+			TELEMETRY_SAMPLE_t s, got, want;
+			uint16_t seq = (uint16_t)Next(), got_seq = 0;
+
+			std::memset(&s, 0, sizeof(s));
+			s.Timestamp = (round & 1) ? Next() : (Next() & 0xFF00FF00);	//Zero bytes in the even rounds
+			s.Channels = ch;
+			for (int i = 0; i < 3; i++) {
+				s.Accel_RAW[i] = (int16_t)Next();
+				s.Gyro_RAW[i] = (int16_t)((round & 1) ? Next() : 0);
+				s.Angle_cdeg[i] = (int16_t)(Next() % 36001 - 18000);
+			}
+			for (int i = 0; i < 4; i++)
+				s.RGBC_RAW[i] = (uint16_t)Next();
+			s.Color = (uint8_t)Next();
+
+			want = s;
+			if (!(ch & TLM_CH_ACCEL_RAW))
+				std::memset(want.Accel_RAW, 0, sizeof(want.Accel_RAW));
+			if (!(ch & TLM_CH_GYRO_RAW))
+				std::memset(want.Gyro_RAW, 0, sizeof(want.Gyro_RAW));
+			if (!(ch & TLM_CH_ANGLE))
+				std::memset(want.Angle_cdeg, 0, sizeof(want.Angle_cdeg));
+			if (!(ch & TLM_CH_RGBC_RAW))
+				std::memset(want.RGBC_RAW, 0, sizeof(want.RGBC_RAW));
+			if (!(ch & TLM_CH_COLOR))
+				want.Color = 0;
+
+			uint32_t n = Telemetry_Encode_Sample(&s, seq, frame);
+			Check(n > 0 && Telemetry_Decode_Sample(frame, n - 1, &got, &got_seq) == TLM_OK && got_seq == seq &&
+				got.Timestamp == want.Timestamp && got.Channels == want.Channels &&
+				!std::memcmp(got.Accel_RAW, want.Accel_RAW, sizeof(got.Accel_RAW)) &&
+				!std::memcmp(got.Gyro_RAW, want.Gyro_RAW, sizeof(got.Gyro_RAW)) &&
+				!std::memcmp(got.Angle_cdeg, want.Angle_cdeg, sizeof(got.Angle_cdeg)) &&
+				!std::memcmp(got.RGBC_RAW, want.RGBC_RAW, sizeof(got.RGBC_RAW)) && got.Color == want.Color,
+				"Telemetry_Decode_Sample gives back the channels that were sent");
+		}
+	}
+}
+
+/*
+ *	--------------------Errors_All---------------------
+ *	Local helper, frames Telemetry_Unpack and Decode_Sample must refuse
+ *	Input: none
+ *	Output: none
+ */
+static void Errors_All(void) {
+	const uint8_t check[] = "123456789";
+	uint8_t frame[TLM_MAX_FRAME], payload[TLM_MAX_PAYLOAD], type;
+	uint16_t seq;
+	uint32_t plen;
+	TELEMETRY_SAMPLE_t s;
+
+	Check(Telemetry_CRC16(check, 9, 0xFFFF) == 0x29B1, "Telemetry_CRC16 check value (CCITT-FALSE)");
+
+	/* Every single bit flip, the COBS framing is kept so the CRC has to catch it */
+	std::memset(&s, 0, sizeof(s));
+	s.Timestamp = 0x12345678;
+	s.Channels = TLM_CH_ALL;
+	s.Angle_cdeg[0] = -4500;
+	s.Color = 3;
+	uint32_t n = Telemetry_Encode_Sample(&s, 77, frame);
+	std::vector<uint8_t> raw = Raw_Of(frame, n);
+	uint32_t crc_errors = 0;
+	for (size_t bit = 0; bit < raw.size() * 8; bit++) {
+		std::vector<uint8_t> bad = raw;
+		bad[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+		std::vector<uint8_t> f = Frame_Of(bad);
+		crc_errors += Telemetry_Unpack(f.data(), (uint32_t)f.size(), &type, &seq, payload, &plen) == TLM_ERR_CRC;
+	}
+	printf("%u of %zu single bit flips caught by the CRC\n", crc_errors, raw.size() * 8);
+	Check(crc_errors == raw.size() * 8, "Telemetry_Unpack reports every single bit flip as TLM_ERR_CRC");
+
+	/* Burst errors up to 16 bits */
+	uint32_t bursts = 0, caught = 0;
+	for (size_t at = 0; at + 2 <= raw.size(); at++) {
+		std::vector<uint8_t> bad = raw;
+		uint16_t mask = (uint16_t)(Next() | 0x8001);
+		bad[at] ^= (uint8_t)(mask >> 8);
+		bad[at + 1] ^= (uint8_t)mask;
+		std::vector<uint8_t> f = Frame_Of(bad);
+		bursts++;
+		caught += Telemetry_Unpack(f.data(), (uint32_t)f.size(), &type, &seq, payload, &plen) == TLM_ERR_CRC;
+	}
+	Check(caught == bursts, "Telemetry_Unpack reports every 16 bit burst as TLM_ERR_CRC");
+
+	/* A wrong version behind a good CRC */
+	std::vector<uint8_t> v2 = raw;
+	v2[0] = TELEMETRY_VERSION + 1;
+	uint16_t crc = Telemetry_CRC16(v2.data(), (uint32_t)v2.size() - TLM_CRC_SIZE, 0xFFFF);
+	v2[v2.size() - 2] = (uint8_t)crc;
+	v2[v2.size() - 1] = (uint8_t)(crc >> 8);
+	std::vector<uint8_t> f = Frame_Of(v2);
+	Check(Telemetry_Unpack(f.data(), (uint32_t)f.size(), &type, &seq, payload, &plen) == TLM_ERR_VERSION,
+		"Telemetry_Unpack reports a different version");
+
+	/* A frame shorter than a header and CRC, and a sample frame that promises more channels than it holds */
+	const uint8_t tiny[] = {0x04, 0x01, 0x02, 0x03};
+	Check(Telemetry_Unpack(tiny, sizeof(tiny), &type, &seq, payload, &plen) == TLM_ERR_LENGTH,
+		"Telemetry_Unpack rejects a short frame");
+	uint8_t short_payload[8] = {0, 0, 0, 0, TLM_CH_RGBC_RAW, 0, 1, 2};
+	n = Telemetry_Pack(TLM_TYPE_SAMPLE, 1, short_payload, sizeof(short_payload), frame);
+	Check(Telemetry_Decode_Sample(frame, n - 1, &s, &seq) == TLM_ERR_LENGTH, "Telemetry_Decode_Sample rejects a short sample");
+	n = Telemetry_Pack(TLM_TYPE_LOG, 1, short_payload, sizeof(short_payload), frame);
+	Check(Telemetry_Decode_Sample(frame, n - 1, &s, &seq) == TLM_ERR_TYPE, "Telemetry_Decode_Sample rejects another frame type");
+
+	/* Truncated frame: the last COBS block is cut */
+	n = Telemetry_Encode_Sample(&s, 5, frame);
+	Check(Telemetry_Unpack(frame, n - 3, &type, &seq, payload, &plen) != TLM_OK, "Telemetry_Unpack rejects a cut frame");
+}
+
+/*
+ *	--------------------Stream_All---------------------
+ *	Local helper, frames back to back through StreamDecoder with one
+ *	CRC error in the middle
+ *	Input: none
+ *	Output: none
+ */
+static void Stream_All(void) {
+	const uint32_t frames = 500, corrupt = 250;
+	std::vector<uint8_t> stream;
+	uint8_t frame[TLM_MAX_FRAME];
+	uint32_t in_order = 0;
+	uint16_t next_seq = 0;
+
+	for (uint32_t k = 0; k < frames; k++) {
+		TELEMETRY_SAMPLE_t s;
+		std::memset(&s, 0, sizeof(s));
+		s.Timestamp = k * 10000;
+		s.Channels = TLM_CH_ACCEL_RAW | TLM_CH_ANGLE;
+		for (int i = 0; i < 3; i++) {
+			s.Accel_RAW[i] = (int16_t)Next();
+			s.Angle_cdeg[i] = (int16_t)(Next() % 9000);
+		}
+		uint32_t n = Telemetry_Encode_Sample(&s, (uint16_t)k, frame);
+		if (k == corrupt) {
+			std::vector<uint8_t> raw = Raw_Of(frame, n);
+			raw[6] ^= 0x10;
+			std::vector<uint8_t> f = Frame_Of(raw);
+			stream.insert(stream.end(), f.begin(), f.end());
+			stream.push_back(0);
+		} else {
+			stream.insert(stream.end(), frame, frame + n);
+		}
+	}
+
+	StreamDecoder dec;
+	dec.on_sample = [&](const SensorRecord& r) {
+		if (next_seq == corrupt)
+			next_seq++;
+		in_order += r.seq == next_seq && r.device_ts == (uint32_t)next_seq * 10000;
+		next_seq = (uint16_t)(r.seq + 1);
+	};
+	for (size_t i = 0; i < stream.size(); i += 37)
+		dec.feed(&stream[i], (stream.size() - i < 37) ? stream.size() - i : 37, 0);
+	dec.flush(0);
+
+	const DecoderStats& st = dec.stats();
+	printf("stream: %llu samples, %llu bad frames, %llu lost frames\n", (unsigned long long)st.samples,
+		(unsigned long long)st.bad_frames, (unsigned long long)st.lost_frames);
+	Check(st.samples == frames - 1 && in_order == frames - 1, "StreamDecoder delivers every good frame in order");
+	Check(st.bad_frames == 1 && st.lost_frames == 1, "StreamDecoder counts the corrupted frame once");
+}
+
+int main(void) {
+	Cobs_All();
+	Pack_All();
+	Sample_All();
+	Errors_All();
+	Stream_All();
+
+	printf("%u checks, %u failed\n", Checks, Failures);
+	return Failures != 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * time_check.cpp
+ *
+ *	Checks the Time.h cycle conversions and the ../Time.c spin waits
+ *	for every SYSCLK_HZ that SysClock.h accepts (400 MHz over a whole
+ *	divider, in whole MHz), 4 to 80 MHz:
+ *		- TIME_US_TO_CYCLES is exact, also for a full 32-bit us
+ *		- TIME_NS_TO_CYCLES rounds up, so a wait is never short and
+ *		  never a whole cycle longer than asked
+ *		- TIME_CYCLES_TO_NS rounds down and gives back at least the
+ *		  ns that went in
+ *		- TIME_SPIN_MAX_US is the last us whose cycles still fit the
+ *		  uint32_t cast of TIME_SPIN_US
+ *	SYSCLK_CYCLES_PER_US is replaced by a 32-bit variable for this,
+ *	the macros expand the same way they do in a build for that clock.
+ *
+ *	Time_Spin_Until and Time_Spin_Cycles then run on the virtual
+ *	clock, every yield moves it by a random number of cycles. A wait
+ *	has to last at least its cycles and end at the first yield after
+ *	them, also when the 32-bit stamps wrap during the wait, when the
+ *	stamp was taken just before the wrap and for a wait of nearly a
+ *	whole wrap.
+ *	A stamp whose cycles have already passed has to return without
+ *	a yield.
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		g++ -O2 -std=c++17 -I.. time_check.cpp Time.o -o time_check
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "time_host_port.h"
+#include "../Time.h"
+}
+
+/* The Time.h macros below expand against this clock */
+static uint32_t Clock_MHz;
+#undef SYSCLK_CYCLES_PER_US
+#define SYSCLK_CYCLES_PER_US	Clock_MHz
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+
+static uint32_t Step_Max = 1;						//Largest move of one yield
+static uint32_t Yields;
+
+/* Reproducible data, xorshift32 */
+static uint32_t Seed = 0x2545F491;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+void Time_Host_Yield(void) {
+	Time_Host_Cycles += 1 + Next() % Step_Max;
+	Yields++;
+}
+
+void Time_Host_Tick(uint8_t on) { (void)on; }
+}
+
+static uint32_t Checks, Failures;
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked, Clock in MHz, Value
+ *	Output: none
+ */
+static void Check(bool ok, const char* what, uint32_t mhz, uint64_t value) {
+	Checks++;
+	if (!ok && Failures++ < 20)
+		printf("  FAILED at %u MHz: %s (%llu)\n", mhz, what, (unsigned long long)value);
+}
+
+/*
+ *	------------------Check_Convert--------------------
+ *	Local helper, the conversion macros at the current Clock_MHz
+ *	Input: none
+ *	Output: none
+ */
+static void Check_Convert(void) {
+	const uint32_t mhz = Clock_MHz;
+	std::vector<uint64_t> values = {0, 1, 2, 999, 1000, 1001, 65535, 1000000, 0xFFFFFFFFULL};
+
+	for (int i = 0; i < 20000; i++)
+		values.push_back(Next() >> (Next() % 32));
+
+	for (uint64_t v : values) {
+		/* us, exact in 64 bits */
+		Check(TIME_US_TO_CYCLES(v) == v * mhz, "TIME_US_TO_CYCLES exact", mhz, v);
+
+		/* ns, rounded up: c cycles cover ns, c - 1 do not */
+		uint64_t c = TIME_NS_TO_CYCLES(v);
+		Check(c * 1000 >= v * mhz, "TIME_NS_TO_CYCLES never short", mhz, v);
+		Check(c == 0 || (c - 1) * 1000 < v * mhz, "TIME_NS_TO_CYCLES at most one cycle long", mhz, v);
+		Check(TIME_CYCLES_TO_NS(c) >= v, "TIME_CYCLES_TO_NS of the rounded cycles", mhz, v);
+
+		/* cycles to ns, rounded down */
+		uint64_t ns = TIME_CYCLES_TO_NS(v);
+		Check(ns * mhz <= v * 1000 && (ns + 1) * mhz > v * 1000, "TIME_CYCLES_TO_NS rounds down", mhz, v);
+	}
+
+	Check(TIME_US_TO_CYCLES(TIME_SPIN_MAX_US) <= 0xFFFFFFFFULL, "TIME_SPIN_MAX_US fits 32 bits", mhz, TIME_SPIN_MAX_US);
+	Check(TIME_US_TO_CYCLES(TIME_SPIN_MAX_US + 1) > 0xFFFFFFFFULL, "TIME_SPIN_MAX_US is the largest", mhz,
+		TIME_SPIN_MAX_US);
+}
+
+/*
+ *	--------------------Spin_Once----------------------
+ *	Local helper, one Time_Spin_Until from a cycle count
+ *	Input: Start cycle, Cycles to wait, Largest yield step
+ *	Output: none
+ */
+static void Spin_Once(uint64_t at, uint32_t cycles, uint32_t step) {
+	Time_Host_Cycles = at;
+	Step_Max = step;
+	Yields = 0;
+
+	uint32_t stamp = Time_Stamp();
+	Time_Spin_Until(stamp, cycles);
+	uint64_t took = Time_Host_Cycles - at;
+
+	Check(stamp == (uint32_t)at, "Time_Stamp is the low 32 bits", Clock_MHz, at);
+	Check(took >= cycles, "Time_Spin_Until never short", Clock_MHz, cycles);
+	Check(took < (uint64_t)cycles + step + 1, "Time_Spin_Until ends at the first yield past it", Clock_MHz, cycles);
+	Check(cycles != 0 || Yields == 0, "Time_Spin_Until of 0 does not yield", Clock_MHz, at);
+}
+
+/*
+ *	--------------------Check_Spin---------------------
+ *	Local helper, the spin waits on the virtual clock
+ *	Input: none
+ *	Output: none
+ */
+static void Check_Spin(void) {
+	const uint32_t mhz = Clock_MHz;
+	const uint64_t wrap = 0x100000000ULL;
+	const uint64_t starts[] = {0, 12345, wrap - 1, wrap, wrap - 100, 7 * wrap - 5000, 0xFFFFFFFF00000000ULL - 3};
+
+	for (uint64_t at : starts) {
+		Spin_Once(at, 0, 1);
+		Spin_Once(at, 1, 1);
+		Spin_Once(at, 150, 7);
+		Spin_Once(at, (uint32_t)TIME_US_TO_CYCLES(1000), 1 + mhz);
+		for (int i = 0; i < 200; i++)
+			Spin_Once(at - (Next() % 100000), Next() % 200000, 1 + Next() % 64);
+	}
+
+	/* A long wait, the stamp difference runs up to just under a full
+	   wrap (a yield must come before it, or the difference wraps) */
+	Spin_Once(wrap - 17, 0xFFFF0000, 0x8000);
+
+	/* Stamp taken earlier, its cycles already passed: no yield */
+	for (uint64_t at : starts) {
+		Time_Host_Cycles = at;
+		uint32_t stamp = Time_Stamp();
+		Time_Host_Cycles = at + 5000;
+		Yields = 0;
+		Time_Spin_Until(stamp, 4999);
+		Check(Yields == 0 && Time_Host_Cycles == at + 5000, "Time_Spin_Until of a passed stamp returns at once", mhz, at);
+	}
+
+	/* TIME_SPIN_US and TIME_SPIN_NS through Time_Spin_Cycles, no call cost measured on the host */
+	const uint32_t us[] = {1, 10, 1000, 250000};
+	for (uint32_t u : us) {
+		Time_Host_Cycles = 2 * wrap - TIME_US_TO_CYCLES(u) / 2;
+		Step_Max = 3;
+		uint64_t at = Time_Host_Cycles;
+		TIME_SPIN_US(u);
+		uint64_t took = Time_Host_Cycles - at;
+		Check(took >= (uint64_t)u * mhz && took <= (uint64_t)u * mhz + 3, "TIME_SPIN_US across the wrap", mhz, u);
+	}
+	const uint32_t ns[] = {1, 60, 125, 600, 1300, 4700};
+	for (uint32_t n : ns) {
+		Time_Host_Cycles = wrap - 1;
+		Step_Max = 1;
+		uint64_t at = Time_Host_Cycles;
+		TIME_SPIN_NS(n);
+		uint64_t took = Time_Host_Cycles - at;
+		Check(took * 1000 >= (uint64_t)n * mhz && took == TIME_NS_TO_CYCLES(n), "TIME_SPIN_NS never short", mhz, n);
+	}
+}
+
+int main(void) {
+	std::vector<uint32_t> clocks;
+	uint32_t before;
+
+	for (uint32_t d = 5; d <= 128; d++) {
+		if (SYSCLK_PLL_HZ % d == 0 && (SYSCLK_PLL_HZ / d) % 1000000UL == 0)
+			clocks.push_back(SYSCLK_PLL_HZ / d / 1000000UL);
+	}
+
+	for (uint32_t mhz : clocks) {
+		Clock_MHz = mhz;
+		before = Failures;
+		Check_Convert();
+		Check_Spin();
+		printf("%2u MHz: TIME_SPIN_MAX_US %10lu, 125 ns = %llu cycles, %s\n", mhz, (unsigned long)TIME_SPIN_MAX_US,
+			(unsigned long long)TIME_NS_TO_CYCLES(125), (Failures == before) ? "ok" : "FAILED");
+	}
+
+	printf("%u checks, %u failed\n", Checks, Failures);
+	return Failures != 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * time_host_port.h
+ *
+ *	Forced include (-include) when ../Time.c is built on the host.
+ *	Replaces the WTIMER1 counter with a virtual cycle clock the test
+ *	program owns and routes the cooperative yield to it, so a wait
+ *	advances virtual time instead of spinning forever. Time_Spin
+ *	waits yield the same way. Call
+ *	SysTick_Handler to advance Time_Now_MS, it does not call into
+ *	the kernel here (call Kernel_Tick after it when testing Kernel.c).
+ *	Stopping and starting SysTick calls Time_Host_Tick, so a model
+ *	of the tickless idle knows when the 1 ms interrupt would run.
+ *
+ *		gcc -c -include time_host_port.h -I.. ../Time.c
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef TIME_HOST_PORT_H_
+#define TIME_HOST_PORT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile uint64_t Time_Host_Cycles;		//Virtual WTIMER1 count
+void Time_Host_Yield(void);										//Called by every cooperative wait
+void Time_Host_Tick(uint8_t on);								//SysTick stopped (0) or started (1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#define TIME_CYCLES()					(Time_Host_Cycles)
+#define TIME_STAMP()					((uint32_t)Time_Host_Cycles)
+#define TIME_YIELD()					Time_Host_Yield()
+#define TIME_SPIN()						Time_Host_Yield()
+#define TIME_TICK_HOOK()
+#define TIME_TICK_STOP()			Time_Host_Tick(0)
+#define TIME_TICK_START()			Time_Host_Tick(1)
+
+#endif
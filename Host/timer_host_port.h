@@ -0,0 +1,39 @@
+/*
+ * timer_host_port.h
+ *
+ *	Forced include (-include) when ../Timer.c is built on the host,
+ *	together with time_host_port.h for ../Time.c. The WTIMER1 match
+ *	becomes Timer_Host_Match, the test program advances
+ *	Time_Host_Cycles and calls WideTimer1A_Handler whenever it
+ *	reaches the match or Timer_Host_Triggered is set.
+ *
+ *		gcc -c -include timer_host_port.h -I.. ../Timer.c
+ *
+ *	The test program also provides StartCritical and EndCritical.
+ *
+ * Created on: December 1, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef TIMER_HOST_PORT_H_
+#define TIMER_HOST_PORT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile uint64_t Timer_Host_Match;			//Virtual WTIMER1 match in cycles
+extern volatile uint8_t Timer_Host_Triggered;		//Set by a software trigger
+
+#ifdef __cplusplus
+}
+#endif
+
+#define TIMER_PORT_SET_MATCH(cycles)	(Timer_Host_Match = (cycles))
+#define TIMER_PORT_TRIGGER()				(Timer_Host_Triggered = 1)
+#define TIMER_PORT_ACK()						(Timer_Host_Triggered = 0)
+
+#endif
@@ -0,0 +1,365 @@
+/*
+ * timer_wheel_test.cpp
+ *
+ *	Host checks of the ../Timer.c wheel against the Time.h virtual
+ *	clock. The WTIMER1 match fires as the hardware does, once, when
+ *	the counter reaches it: a match written at or behind the counter
+ *	only runs if Timer.c also triggers the interrupt by software.
+ *
+ *	Every timer function checks that it runs no earlier than asked
+ *	and at most one tick (TIMER_TICK_US) late, and that its timer was
+ *	still started. Covered:
+ *		- insert: delays on both sides of every level boundary and
+ *		  past the top level (parked on the farthest slot)
+ *		- cascade: far timers moved down level by level, with the
+ *		  number of match interrupts that took
+ *		- cancel: stopped timers never run, also when stopped by
+ *		  another timer function due on the same tick
+ *		- wrap: every run starts once just below the 32-bit wrap of
+ *		  the low match word and once with every level on its last
+ *		  slot, so slot indices wrap through 0 right away
+ *		- random starts, restarts and stops, from the main loop and
+ *		  from timer functions, one-shot and periodic
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -I.. -include time_host_port.h -c ../Time.c -o Time.o
+ *		gcc -O2 -I.. -include time_host_port.h -include timer_host_port.h -c ../Timer.c -o Timer.o
+ *		g++ -O2 -std=c++17 timer_wheel_test.cpp Time.o Timer.o -o timer_wheel_test
+ *
+ *	Usage:
+ *		timer_wheel_test [random timers]
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+#include "time_host_port.h"
+#include "timer_host_port.h"
+#include "../Timer.h"
+}
+
+#define TICK_CYCLES						((uint64_t)TIMER_TICK_US * SYSCLK_CYCLES_PER_US)
+#define LEVEL_TICKS(level)		(1ULL << (TIMER_SLOT_BITS * (level)))
+#define MATCH_NONE						(0xFFFFFFFFFFFFFFFFULL)
+
+extern "C" {
+volatile uint64_t Time_Host_Cycles;
+volatile uint64_t Timer_Host_Match = MATCH_NONE;
+volatile uint8_t Timer_Host_Triggered;
+
+long StartCritical(void) { return 0; }
+void EndCritical(long sr) { (void)sr; }
+void Time_Host_Tick(uint8_t on) { (void)on; }
+
+void Time_Host_Yield(void) {
+	fprintf(stderr, "Timer.c waited on the clock\n");
+	exit(1);
+}
+}
+
+/* One timer under test */
+struct Probe {
+	TIMER_t t;
+	uint64_t due;										//Earliest cycle it may run
+	uint64_t period;								//Cycles, 0 = one-shot
+	bool started;
+	uint32_t fired;
+	uint32_t stop_after;						//Periodic: stops itself after this many runs
+	bool meddle;										//Starts or stops another probe when it runs
+};
+
+static std::vector<Probe> Probes;
+static uint32_t Checks, Failures, Interrupts, Early, Late, Stray;
+static uint64_t Last_Match;
+
+/* Reproducible data, xorshift32 */
+static uint32_t Seed = 0x68E31DA4;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/*
+ *	---------------------Check-------------------------
+ *	Local helper
+ *	Input: Result, What was checked
+ *	Output: none
+ */
+static void Check(bool ok, const char* what) {
+	Checks++;
+	if (!ok && Failures++ < 20)
+		printf("  FAILED: %s\n", what);
+}
+
+/*
+ *	---------------------Start-------------------------
+ *	Local helper, Timer_Start and the window the probe has to run in
+ *	Input: Probe, Delay in us, Period in us
+ *	Output: none
+ */
+static void Start(Probe& p, uint32_t delay_us, uint32_t period_us) {
+	p.due = Time_Host_Cycles + (uint64_t)delay_us * SYSCLK_CYCLES_PER_US;
+	p.period = (uint64_t)period_us * SYSCLK_CYCLES_PER_US;
+	p.started = true;
+	Timer_Start(&p.t, delay_us, period_us);
+}
+
+static void Stop(Probe& p) {
+	p.started = false;
+	Timer_Stop(&p.t);
+}
+
+/*
+ *	---------------------Fired-------------------------
+ *	Timer function of every probe
+ *	Input: Probe
+ *	Output: none
+ */
+static void Fired(void* arg) {
+	Probe& p = *(Probe*)arg;
+	uint64_t now = Time_Host_Cycles;
+
+	if (!p.started) {
+		Stray++;
+		return;
+	}
+	if (now < p.due)
+		Early++;
+	else if (now - p.due > TICK_CYCLES)
+		Late++;
+	p.fired++;
+
+	if (p.period) {
+		p.due = now + p.period;				//Fixed rate from the tick it ran on, periods are whole ticks here
+		if (p.fired >= p.stop_after)
+			Stop(p);
+	} else {
+		p.started = false;
+	}
+
+	/* Start or stop a random other probe from interrupt context */
+	if (p.meddle) {
+		Probe& o = Probes[Next() % Probes.size()];
+		if (&o == &p)
+			return;
+		if (o.started && (Next() & 1))
+			Stop(o);
+		else if (!o.started || o.period == 0)
+			Start(o, Next() % 200000, 0);
+	}
+}
+
+/*
+ *	---------------------Run---------------------------
+ *	Local helper, moves the virtual clock and takes the match
+ *	interrupt whenever the counter reaches the match, or at once
+ *	when it was triggered by software
+ *	Input: Cycle to run to
+ *	Output: none
+ */
+static void Run(uint64_t to) {
+	for (;;) {
+		if (Timer_Host_Triggered) {
+			Interrupts++;
+			WideTimer1A_Handler();
+		} else if (Timer_Host_Match != Last_Match && Timer_Host_Match > Time_Host_Cycles && Timer_Host_Match <= to) {
+			Time_Host_Cycles = Timer_Host_Match;
+			Last_Match = Timer_Host_Match;					//Equal match fires once
+			Interrupts++;
+			WideTimer1A_Handler();
+		} else {
+			break;
+		}
+	}
+	if (to > Time_Host_Cycles)
+		Time_Host_Cycles = to;
+}
+
+/*
+ *	---------------------Reset-------------------------
+ *	Local helper, an empty wheel at a starting cycle
+ *	Input: Starting cycle, Number of probes
+ *	Output: none
+ */
+static void Reset(uint64_t at, size_t probes) {
+	Time_Host_Cycles = at;
+	Timer_Host_Match = MATCH_NONE;
+	Last_Match = MATCH_NONE;
+	Timer_Host_Triggered = 0;
+	Timer_Init();
+	Probes.assign(probes, Probe());
+	for (auto& p : Probes) {
+		Timer_Setup(&p.t, Fired, &p);
+		p.started = false;
+		p.fired = 0;
+		p.stop_after = 0;
+		p.meddle = false;
+	}
+	Interrupts = Early = Late = Stray = 0;
+}
+
+/*
+ *	-------------------Test_Insert---------------------
+ *	Local helper, one timer either side of every level boundary and
+ *	past the top level, then counts the interrupts the cascade took
+ *	Input: Starting cycle
+ *	Output: none
+ */
+static void Test_Insert(uint64_t at) {
+	std::vector<uint64_t> ticks;
+
+	for (int level = 0; level <= TIMER_LEVELS; level++) {
+		uint64_t edge = LEVEL_TICKS(level);
+		for (int64_t d = -2; d <= 2; d++) {
+			if ((int64_t)edge + d >= 0)
+				ticks.push_back(edge + d);
+		}
+	}
+	ticks.push_back(2 * LEVEL_TICKS(TIMER_LEVELS) + 17);					//Parked twice, near the 32-bit us delay limit
+
+	Reset(at, ticks.size());
+	for (size_t i = 0; i < ticks.size(); i++)
+		Start(Probes[i], (uint32_t)(ticks[i] * TIMER_TICK_US), 0);
+	Check(Timer_Count() == ticks.size(), "Timer_Count after the starts");
+	Run(at + (4 * LEVEL_TICKS(TIMER_LEVELS)) * TICK_CYCLES);
+
+	uint32_t once = 0;
+	for (auto& p : Probes)
+		once += p.fired == 1;
+	printf("insert   %2zu timers from 0 to %llu ticks, %u ran once, %u interrupts\n", ticks.size(),
+		(unsigned long long)ticks.back(), once, Interrupts);
+	Check(once == ticks.size() && Early == 0 && Late == 0 && Timer_Count() == 0, "every level boundary runs on time");
+
+	/* One far timer alone: a match per level it moves down, and the expiry */
+	Reset(at + 12345, 1);
+	Start(Probes[0], (uint32_t)((LEVEL_TICKS(3) * 5 + LEVEL_TICKS(2) * 7 + LEVEL_TICKS(1) * 11 + 13) * TIMER_TICK_US), 0);
+	Run(at + 6 * LEVEL_TICKS(3) * TICK_CYCLES);
+	printf("cascade  one timer %llu ticks out, %u interrupts\n",
+		(unsigned long long)(LEVEL_TICKS(3) * 5 + LEVEL_TICKS(2) * 7 + LEVEL_TICKS(1) * 11 + 13), Interrupts);
+	Check(Probes[0].fired == 1 && Early == 0 && Late == 0, "a far timer runs on time");
+	Check(Interrupts <= TIMER_LEVELS + 1, "a far timer costs one interrupt per level");
+}
+
+/*
+ *	-------------------Test_Cancel---------------------
+ *	Local helper, stops half the timers, some of them from a timer
+ *	function due on the same tick
+ *	Input: Starting cycle
+ *	Output: none
+ */
+static void Test_Cancel(uint64_t at) {
+	const size_t n = 2000;
+
+	Reset(at, n);
+	for (size_t i = 0; i < n; i++)
+		Start(Probes[i], (uint32_t)(Next() % (LEVEL_TICKS(3) * 2)) * TIMER_TICK_US, 0);
+	for (size_t i = 0; i < n; i += 2)
+		Stop(Probes[i]);
+	Check(Timer_Count() == n / 2, "Timer_Count after the stops");
+	Stop(Probes[0]);
+	Check(Timer_Count() == n / 2, "stopping a stopped timer does nothing");
+
+	/* Same tick: the first one to run stops the other, whichever order the slot holds them */
+	Probe& a = Probes[1];
+	Probe& b = Probes[3];
+	Stop(a);
+	Stop(b);
+	Timer_Setup(&a.t, [](void* arg) { Probe& p = *(Probe*)arg; p.fired++; p.started = false; Stop(Probes[3]); }, &a);
+	Timer_Setup(&b.t, [](void* arg) { Probe& p = *(Probe*)arg; p.fired++; p.started = false; Stop(Probes[1]); }, &b);
+	Start(a, 5000, 0);
+	Start(b, 5000, 0);
+
+	Run(at + 3 * LEVEL_TICKS(3) * TICK_CYCLES);
+	uint32_t ran = 0, stopped_ran = 0;
+	for (size_t i = 4; i < n; i++) {
+		if (i % 2 == 0)
+			stopped_ran += Probes[i].fired != 0;
+		else
+			ran += Probes[i].fired == 1;
+	}
+	printf("cancel   %zu stopped, %u of them ran, %u of %zu others ran once, same tick pair ran %u\n", n / 2,
+		stopped_ran, ran, n / 2 - 2, a.fired + b.fired);
+	Check(stopped_ran == 0 && Stray == 0, "a stopped timer never runs");
+	Check(ran == n / 2 - 2 && Early == 0 && Late == 0, "the rest run once and on time");
+	Check(a.fired + b.fired == 1, "a timer stopped on its own tick by another one does not run");
+	Check(Timer_Count() == 0, "the wheel is empty at the end");
+}
+
+/*
+ *	-------------------Test_Random---------------------
+ *	Local helper, random starts, restarts and stops over a long run,
+ *	one-shot and periodic, from the loop and from timer functions
+ *	Input: Starting cycle, Number of timers
+ *	Output: none
+ */
+static void Test_Random(uint64_t at, size_t n) {
+	uint64_t ops = 0, runs = 0;
+
+	Reset(at, n);
+	for (size_t step = 0; step < n * 10; step++) {
+		Probe& p = Probes[Next() % n];
+		uint32_t r = Next() % 100;
+
+		if (r < 10 && p.started) {
+			Stop(p);
+		} else if (r < 25) {
+			p.stop_after = 1 + Next() % 50;
+			p.meddle = false;
+			Start(p, Next() % 1000000, (1 + Next() % 500) * TIMER_TICK_US);
+		} else {
+			uint32_t shift = Next() % 32;
+			p.meddle = (Next() % 8) == 0;
+			Start(p, Next() >> shift, 0);								//Log spread, 0 us to ~71 min
+		}
+		ops++;
+		Run(Time_Host_Cycles + (Next() % 20000) * SYSCLK_CYCLES_PER_US);
+	}
+
+	/* Let everything that is still started run out */
+	for (auto& p : Probes) {
+		if (p.started && p.period)
+			Stop(p);
+	}
+	Run(Time_Host_Cycles + (uint64_t)0xFFFFFFFF * SYSCLK_CYCLES_PER_US + 2 * TICK_CYCLES);
+	uint32_t left = 0;
+	for (auto& p : Probes) {
+		left += p.started;
+		runs += p.fired;
+	}
+	printf("random   %llu operations, %llu runs, %u interrupts, %u early, %u late, %u stray, %u never ran\n",
+		(unsigned long long)ops, (unsigned long long)runs, Interrupts, Early, Late, Stray, left);
+	Check(Early == 0 && Late == 0, "random timers run within a tick");
+	Check(Stray == 0, "random stopped timers never run");
+	Check(left == 0 && Timer_Count() == 0, "every started timer ran");
+}
+
+int main(int argc, char** argv) {
+	size_t n = (argc > 1) ? (size_t)atoi(argv[1]) : 3000;
+	const uint64_t starts[] = {
+		0,
+		0x100000000ULL - 3 * TICK_CYCLES - 1,																	//Low match word about to wrap
+		(3 * LEVEL_TICKS(TIMER_LEVELS) - 2) * TICK_CYCLES,										//Every level on its last slot
+	};
+
+	for (uint64_t at : starts) {
+		printf("start at cycle %llu (tick %llu)\n", (unsigned long long)at, (unsigned long long)(at / TICK_CYCLES));
+		Test_Insert(at);
+		Test_Cancel(at);
+		Test_Random(at, n);
+	}
+
+	printf("%u checks, %u failed\n", Checks, Failures);
+	return Failures != 0;
+}
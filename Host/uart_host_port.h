@@ -0,0 +1,136 @@
+/*
+ * uart_host_port.h
+ *
+ *	Forced include (-include) when ../UART0.c is built on the host.
+ *	Pulls in the real register header first, so the later include
+ *	in UART0.c is skipped, then points the UART0, uDMA and setup
+ *	registers at a plain struct the simulation owns
+ *	(Host/uart_sim.cpp).
+ *
+ *	Every read of UART0_FR calls Uart_Host_FR, which lets a little
+ *	virtual time pass first, so a polling loop sees the FIFO drain
+ *	as it would on the line. Data register writes and reads go
+ *	through Uart_Host_Tx_Put and Uart_Host_Rx_Get, the simulation
+ *	keeps both FIFOs. The interrupt status (MIS) is set by the
+ *	simulation before it calls UART0_Handler, and what the handler
+ *	writes to ICR is cleared from the raw status when it returns.
+ *
+ *		gcc -c -include uart_host_port.h -I.. ../UART0.c
+ *
+ *	The uDMA sees buffers through UART0_DMA_ADDR, which here returns
+ *	a 32 bit handle from Uart_Host_Dma_Addr in place of the 64 bit
+ *	host pointer. The simulation resolves the handles it finds in the
+ *	control table when the channel is enabled.
+ *
+ *	The test program also provides StartCritical, EndCritical and
+ *	Idle_Sleep.
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef UART_HOST_PORT_H_
+#define UART_HOST_PORT_H_
+
+#include <stdint.h>
+#include "../tm4c123gh6pm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Registers UART0.c touches, one field each */
+typedef struct{
+	uint32_t DR, FR, IM, MIS, ICR, IBRD, FBRD, CTL, CC, LCRH, IFLS, DMACTL;
+	uint32_t RCGC1, RCGC2, RCGCDMA, PRI1, EN0, PRI11, EN1;
+	uint32_t PA_AFSEL, PA_DEN, PA_PCTL, PA_AMSEL;
+	uint32_t CHIS, ENASET, ENACLR, ERRCLR, CFG, CTLBASE, CHMAP1, PRIOCLR, ALTCLR, USEBURSTCLR, REQMASKCLR;
+} UART_HOST_REGS_t;
+
+extern UART_HOST_REGS_t Uart_Host_Regs;
+
+volatile uint32_t* Uart_Host_FR(void);				//Flag register, after a little virtual time
+void Uart_Host_Tx_Put(uint8_t data);					//Data register write
+uint8_t Uart_Host_Rx_Get(void);								//Data register read
+uint32_t Uart_Host_Dma_Addr(const volatile void* p);	//Handle for a uDMA pointer
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef UART0_DR_R
+#undef UART0_FR_R
+#undef UART0_IM_R
+#undef UART0_MIS_R
+#undef UART0_ICR_R
+#undef UART0_IBRD_R
+#undef UART0_FBRD_R
+#undef UART0_CTL_R
+#undef UART0_CC_R
+#undef UART0_LCRH_R
+#undef UART0_IFLS_R
+#undef UART0_DMACTL_R
+#undef SYSCTL_RCGC1_R
+#undef SYSCTL_RCGC2_R
+#undef SYSCTL_RCGCDMA_R
+#undef NVIC_PRI1_R
+#undef NVIC_EN0_R
+#undef NVIC_PRI11_R
+#undef NVIC_EN1_R
+#undef GPIO_PORTA_AFSEL_R
+#undef GPIO_PORTA_DEN_R
+#undef GPIO_PORTA_PCTL_R
+#undef GPIO_PORTA_AMSEL_R
+#undef UDMA_CHIS_R
+#undef UDMA_ENASET_R
+#undef UDMA_ENACLR_R
+#undef UDMA_ERRCLR_R
+#undef UDMA_CFG_R
+#undef UDMA_CTLBASE_R
+#undef UDMA_CHMAP1_R
+#undef UDMA_PRIOCLR_R
+#undef UDMA_ALTCLR_R
+#undef UDMA_USEBURSTCLR_R
+#undef UDMA_REQMASKCLR_R
+
+#define UART0_DR_R						(Uart_Host_Regs.DR)
+#define UART0_FR_R						(*Uart_Host_FR())
+#define UART0_IM_R						(Uart_Host_Regs.IM)
+#define UART0_MIS_R						(Uart_Host_Regs.MIS)
+#define UART0_ICR_R						(Uart_Host_Regs.ICR)
+#define UART0_IBRD_R					(Uart_Host_Regs.IBRD)
+#define UART0_FBRD_R					(Uart_Host_Regs.FBRD)
+#define UART0_CTL_R						(Uart_Host_Regs.CTL)
+#define UART0_CC_R						(Uart_Host_Regs.CC)
+#define UART0_LCRH_R					(Uart_Host_Regs.LCRH)
+#define UART0_IFLS_R					(Uart_Host_Regs.IFLS)
+#define UART0_DMACTL_R				(Uart_Host_Regs.DMACTL)
+#define SYSCTL_RCGC1_R				(Uart_Host_Regs.RCGC1)
+#define SYSCTL_RCGC2_R				(Uart_Host_Regs.RCGC2)
+#define SYSCTL_RCGCDMA_R			(Uart_Host_Regs.RCGCDMA)
+#define NVIC_PRI1_R						(Uart_Host_Regs.PRI1)
+#define NVIC_EN0_R						(Uart_Host_Regs.EN0)
+#define NVIC_PRI11_R					(Uart_Host_Regs.PRI11)
+#define NVIC_EN1_R						(Uart_Host_Regs.EN1)
+#define GPIO_PORTA_AFSEL_R		(Uart_Host_Regs.PA_AFSEL)
+#define GPIO_PORTA_DEN_R			(Uart_Host_Regs.PA_DEN)
+#define GPIO_PORTA_PCTL_R			(Uart_Host_Regs.PA_PCTL)
+#define GPIO_PORTA_AMSEL_R		(Uart_Host_Regs.PA_AMSEL)
+#define UDMA_CHIS_R						(Uart_Host_Regs.CHIS)
+#define UDMA_ENASET_R					(Uart_Host_Regs.ENASET)
+#define UDMA_ENACLR_R					(Uart_Host_Regs.ENACLR)
+#define UDMA_ERRCLR_R					(Uart_Host_Regs.ERRCLR)
+#define UDMA_CFG_R						(Uart_Host_Regs.CFG)
+#define UDMA_CTLBASE_R				(Uart_Host_Regs.CTLBASE)
+#define UDMA_CHMAP1_R					(Uart_Host_Regs.CHMAP1)
+#define UDMA_PRIOCLR_R				(Uart_Host_Regs.PRIOCLR)
+#define UDMA_ALTCLR_R					(Uart_Host_Regs.ALTCLR)
+#define UDMA_USEBURSTCLR_R		(Uart_Host_Regs.USEBURSTCLR)
+#define UDMA_REQMASKCLR_R			(Uart_Host_Regs.REQMASKCLR)
+
+#define UART0_TX_PUT(data)		Uart_Host_Tx_Put(data)
+#define UART0_RX_GET()				Uart_Host_Rx_Get()
+#define UART0_DMA_ADDR(p)			Uart_Host_Dma_Addr(p)
+
+#endif
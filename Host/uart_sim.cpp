@@ -0,0 +1,768 @@
+/*
+ * uart_sim.cpp
+ *
+ *	Host simulation of UART0. Builds ../UART0.c against a model of
+ *	the 16 byte TX and RX FIFOs, the shift register at the baud rate
+ *	UART0.c programs into IBRD/FBRD, the FIFO level interrupts
+ *	(TX at <= 1/8, RX at >= 1/2 and the RX time-out after 32 idle
+ *	bits) and PRIMASK, all on a virtual cycle clock. Interrupts run
+ *	when they are pending and unmasked, WFI (Idle_Sleep) moves the
+ *	clock to the next event. The uDMA channel 9 model reads the
+ *	control table UART0.c wrote when the channel is enabled, feeds
+ *	the TX FIFO whenever it has room and raises the completion on
+ *	the UART0 vector, as the TM4C123 does for peripheral channels.
+ *
+ *	It then drives the paths the firmware relies on:
+ *		- a long text stream in random chunks with CPU work between
+ *		  them, which must come out of the line unchanged, never
+ *		  overrun the FIFO and never leave the line idle while bytes
+ *		  are queued
+ *		- the same with interrupts masked, where UART0_Write has to
+ *		  make progress on its own
+ *		- the drop policy, which must drop exactly what does not fit
+ *		- received bytes through the level and time-out interrupts,
+ *		  and the drop count once the receive ring overflows
+ *		- uDMA ping-pong frames, where the buffers must swap on every
+ *		  send, every completion must be acknowledged and start the
+ *		  queued buffer, and a write into a buffer the uDMA still owns
+ *		  must fail
+ *		- text written while a frame is in flight, which must wait for
+ *		  the frame and hold back the frame queued after it
+ *		- the text stream, a masked write and a frame with text behind
+ *		  it again with the kernel running, where a task that waits
+ *		  for room has to pend on the kernel and never sleep in WFI
+ *		  (only the masked write may)
+ *		- a bus error in the middle of a frame, which has to reach
+ *		  uDMA_Error (interrupt 47 enabled, at the UART0 priority),
+ *		  start the frame queued behind it and leave the channel
+ *		  free for the next one
+ *
+ *	A failure makes the exit code 1.
+ *
+ *	Build (from this folder):
+ *		gcc -O2 -c ../Format.c -o Format.o
+ *		gcc -O2 -I.. -include uart_host_port.h -c ../UART0.c -o UART0.o
+ *		g++ -O2 -std=c++17 uart_sim.cpp UART0.o Format.o -o uart_sim
+ *
+ *	Usage:
+ *		uart_sim [stream bytes]
+ *
+ * Created on: December 5, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <set>
+#include <vector>
+
+extern "C" {
+#include "uart_host_port.h"
+#include "../UART0.h"
+#include "../Kernel.h"
+void UART0_Handler(void);
+void uDMA_Error(void);
+}
+
+#define SIM_NEVER						(0xFFFFFFFFFFFFFFFFULL)
+#define SIM_FIFO_SIZE				(16)
+#define SIM_TX_LEVEL				(2)					//1/8 of the FIFO
+#define SIM_RX_LEVEL				(8)					//1/2 of the FIFO
+#define SIM_RX_TIMEOUT_BITS	(32)
+#define SIM_REG_CYCLES			(2)					//A peripheral register read
+#define SIM_ISR_CYCLES			(40)				//Entry, handler and exit
+#define SIM_STORM						(1000)			//Back to back handler runs that count as a storm
+#define SIM_DMA_CH					(9)
+#define SIM_DMA_BIT					(1UL << SIM_DMA_CH)
+#define SIM_CHIS_MARK				(0x80000000UL)	//Set with a completion, gone once the handler acknowledged it
+#define SIM_EN1_UDMA_ERR		(1UL << (47 - 32))	//uDMA error, interrupt 47
+#define SIM_PRI11_UDMA_ERR(r)	((r) >> 29)		//Its priority field
+#define SIM_PRI1_UART0(r)		(((r) >> 13) & 7)	//Interrupt 5
+
+/* Line and FIFOs */
+static uint64_t Now;
+static std::deque<uint8_t> Tx_Fifo, Rx_Fifo;
+static uint8_t Shifting;								//Byte in the shift register
+static uint64_t Shift_End = SIM_NEVER;
+static std::vector<uint8_t> Wire;				//Every byte that left the line
+static uint32_t Ris;										//Raw interrupt status
+static uint64_t Rx_Last;								//Time the last byte was received
+
+/* Bytes on their way in */
+struct Rx_Byte {
+	uint64_t At;
+	uint8_t Data;
+};
+static std::deque<Rx_Byte> Rx_Line;
+
+/* Core */
+static long Masked;
+static uint8_t In_Isr;
+static uint32_t Isr_Runs, Tx_Overruns, Rx_Overruns;
+static uint64_t Queued;									//Bytes the test handed to UART0_Write and got accepted
+static uint64_t Idle_Cycles;						//Line idle while accepted bytes had not left yet
+static uint8_t Tasks_On;								//Kernel_Running
+static uint32_t Sleeps, Pends;					//Idle_Sleep calls, Kernel_Sem_Pend calls that blocked
+
+/* uDMA channel 9 */
+static std::vector<const volatile void*> Dma_Handles;	//Uart_Host_Dma_Addr handle - 1 to pointer
+static uint8_t Dma_On;
+static const uint8_t* Dma_Src;
+static uint32_t Dma_Left;
+static uint32_t Dma_Started, Dma_Done, Dma_Faults;
+static uint32_t Dma_Fail_At;						//Bytes left when the injected bus error hits, 0 for none
+static uint8_t Dma_Error;								//Bus error raised, not cleared by uDMA_Error yet
+static void Dma_Feed(void);
+static std::set<const uint8_t*> Dma_Buffers;		//Start of every buffer the channel ran from
+
+extern "C" {
+UART_HOST_REGS_t Uart_Host_Regs;
+}
+
+/*
+ *	--------------------Byte_Cycles--------------------
+ *	Local helper
+ *	Input: none
+ *	Output: Core cycles of one frame (start, 8 data, stop) at the
+ *	divisor UART0.c programmed
+ */
+static uint64_t Byte_Cycles(void) {
+	uint64_t div = (Uart_Host_Regs.CTL & UART_CTL_HSE) ? 8 : 16;
+	uint64_t brd64 = ((uint64_t)Uart_Host_Regs.IBRD << 6) | (Uart_Host_Regs.FBRD & 0x3F);
+
+	return (10 * div * brd64 + 32) / 64;
+}
+
+/*
+ *	---------------------Tx_Start----------------------
+ *	Local helper, the shift register takes the next FIFO entry. The
+ *	TX interrupt is raised when the level drops through 1/8
+ *	Input: none
+ *	Output: none
+ */
+static void Tx_Start(void) {
+	uint32_t level = (uint32_t)Tx_Fifo.size();
+
+	Shifting = Tx_Fifo.front();
+	Tx_Fifo.pop_front();
+	Shift_End = Now + Byte_Cycles();
+	if (level > SIM_TX_LEVEL && level - 1 <= SIM_TX_LEVEL)
+		Ris |= UART_MIS_TXMIS;
+}
+
+/*
+ *	--------------------Dma_Resolve--------------------
+ *	Local helper
+ *	Input: Handle from Uart_Host_Dma_Addr
+ *	Output: Pointer it stands for, 0 for an unknown handle
+ */
+static const volatile void* Dma_Resolve(uint32_t handle) {
+	if (handle == 0 || handle > Dma_Handles.size())
+		return 0;
+	return Dma_Handles[handle - 1];
+}
+
+/*
+ *	--------------------Dma_Fault----------------------
+ *	Local helper
+ *	Input: What the channel found wrong
+ *	Output: none
+ */
+static void Dma_Fault(const char* what) {
+	if (Dma_Faults++ < 10)
+		printf("  uDMA: %s\n", what);
+}
+
+/*
+ *	--------------------Dma_Poll-----------------------
+ *	Local helper, picks up ENASET/ENACLR writes. An enable loads the
+ *	channel 9 primary control structure UART0.c wrote
+ *	Input: none
+ *	Output: none
+ */
+static void Dma_Poll(void) {
+	if (Uart_Host_Regs.ENACLR & SIM_DMA_BIT) {
+		Uart_Host_Regs.ENACLR &= ~SIM_DMA_BIT;
+		Dma_On = 0;
+	}
+	if (!(Uart_Host_Regs.ENASET & SIM_DMA_BIT))
+		return;
+	Uart_Host_Regs.ENASET &= ~SIM_DMA_BIT;
+	if (Dma_On)
+		Dma_Fault("enabled while a transfer is in flight");
+	if (!(Uart_Host_Regs.CFG & UDMA_CFG_MASTEN) || !(Uart_Host_Regs.DMACTL & UART_DMACTL_TXDMAE)) {
+		Dma_Fault("enabled before the controller or the UART request");
+		return;
+	}
+
+	uint32_t* table = (uint32_t*)Dma_Resolve(Uart_Host_Regs.CTLBASE);
+	if (table == 0) {
+		Dma_Fault("control table not set");
+		return;
+	}
+	uint32_t* ch = &table[SIM_DMA_CH * 4];
+	uint32_t ctl = ch[2];
+	uint32_t count = ((ctl & UDMA_CHCTL_XFERSIZE_M) >> UDMA_CHCTL_XFERSIZE_S) + 1;
+	const uint8_t* src_end = (const uint8_t*)Dma_Resolve(ch[0]);
+
+	if ((ctl & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_BASIC || (ctl & UDMA_CHCTL_DSTINC_M) != UDMA_CHCTL_DSTINC_NONE ||
+		(ctl & UDMA_CHCTL_SRCINC_M) != UDMA_CHCTL_SRCINC_8 || src_end == 0 || Dma_Resolve(ch[1]) != &Uart_Host_Regs.DR) {
+		Dma_Fault("channel 9 control structure is not a byte transfer into UART0_DR");
+		return;
+	}
+	Dma_Src = src_end - (count - 1);
+	Dma_Left = count;
+	Dma_On = 1;
+	Dma_Started++;
+	Dma_Buffers.insert(Dma_Src);
+}
+
+/*
+ *	---------------------Pending-----------------------
+ *	Local helper
+ *	Input: none
+ *	Output: 1 if the UART0 interrupt is pending
+ */
+static int Pending(void) {
+	return (Ris & Uart_Host_Regs.IM) != 0 || (Uart_Host_Regs.CHIS & SIM_DMA_BIT) != 0 ||
+		(Dma_Error && (Uart_Host_Regs.EN1 & SIM_EN1_UDMA_ERR));
+}
+
+/*
+ *	---------------------Deliver-----------------------
+ *	Local helper, runs UART0_Handler for as long as the interrupt
+ *	is pending and unmasked, as the NVIC would
+ *	Input: none
+ *	Output: none
+ */
+static void Deliver(void) {
+	uint32_t runs = 0;
+
+	while (!Masked && !In_Isr && Pending()) {
+		In_Isr = 1;
+		if (Dma_Error && (Uart_Host_Regs.EN1 & SIM_EN1_UDMA_ERR)) {
+			Uart_Host_Regs.ERRCLR = 0;
+			uDMA_Error();
+			if (Uart_Host_Regs.ERRCLR & UDMA_ERRCLR_ERRCLR)
+				Dma_Error = 0;																//Write 1 to clear
+			Uart_Host_Regs.ERRCLR = Dma_Error;
+			Dma_Poll();
+			Dma_Feed();
+			Now += SIM_ISR_CYCLES;
+			Isr_Runs++;
+			In_Isr = 0;
+			if (++runs > SIM_STORM) {
+				fprintf(stderr, "uDMA error interrupt storm\n");
+				exit(1);
+			}
+			continue;
+		}
+		Uart_Host_Regs.MIS = Ris & Uart_Host_Regs.IM;
+		Uart_Host_Regs.ICR = 0;
+		if (Uart_Host_Regs.CHIS & SIM_DMA_BIT)
+			Uart_Host_Regs.CHIS |= SIM_CHIS_MARK;
+		UART0_Handler();
+		Ris &= ~Uart_Host_Regs.ICR;
+		if (Uart_Host_Regs.CHIS & SIM_CHIS_MARK)
+			Uart_Host_Regs.CHIS &= ~SIM_CHIS_MARK;					//Not acknowledged, still pending
+		else
+			Uart_Host_Regs.CHIS = 0;												//Write 1 to clear
+		Dma_Poll();
+		Dma_Feed();
+		Now += SIM_ISR_CYCLES;
+		Isr_Runs++;
+		In_Isr = 0;
+		if (++runs > SIM_STORM) {
+			fprintf(stderr, "UART0 interrupt storm, RIS 0x%02x IM 0x%02x\n", Ris, Uart_Host_Regs.IM);
+			exit(1);
+		}
+	}
+}
+
+/*
+ *	--------------------Next_Event---------------------
+ *	Local helper
+ *	Input: none
+ *	Output: Time of the next line event, SIM_NEVER if none
+ */
+static uint64_t Next_Event(void) {
+	uint64_t next = Shift_End;
+
+	if (!Rx_Line.empty() && Rx_Line.front().At < next)
+		next = Rx_Line.front().At;
+	if (!Rx_Fifo.empty() && !(Ris & UART_MIS_RTMIS)) {
+		uint64_t timeout = Rx_Last + SIM_RX_TIMEOUT_BITS * Byte_Cycles() / 10;
+		if (timeout < next)
+			next = timeout;
+	}
+	return next;
+}
+
+/*
+ *	---------------------Advance-----------------------
+ *	Local helper, runs the line up to a time. Interrupts run as
+ *	soon as they become pending, unless masked
+ *	Input: Time
+ *	Output: none
+ */
+static void Advance(uint64_t to) {
+	for (;;) {
+		uint64_t next = Next_Event();
+
+		if (Shift_End == SIM_NEVER && Queued > Wire.size() + Tx_Fifo.size())
+			Idle_Cycles += ((next < to) ? next : to) - Now;
+		if (next > to) {
+			Now = to;
+			break;
+		}
+		Now = next;
+		if (Now == Shift_End) {
+			Wire.push_back(Shifting);
+			Shift_End = SIM_NEVER;
+			if (!Tx_Fifo.empty())
+				Tx_Start();
+			Dma_Feed();
+		} else if (!Rx_Line.empty() && Now == Rx_Line.front().At) {
+			if (Rx_Fifo.size() < SIM_FIFO_SIZE)
+				Rx_Fifo.push_back(Rx_Line.front().Data);
+			else
+				Rx_Overruns++;
+			Rx_Line.pop_front();
+			Rx_Last = Now;
+			if (Rx_Fifo.size() == SIM_RX_LEVEL)
+				Ris |= UART_MIS_RXMIS;
+		} else {
+			Ris |= UART_MIS_RTMIS;
+		}
+		Deliver();
+	}
+	Deliver();
+}
+
+/* Target services UART0.c links against */
+extern "C" {
+long StartCritical(void) {
+	long sr = Masked;
+	Masked = 1;
+	return sr;
+}
+
+void EndCritical(long sr) {
+	Masked = sr;
+	Dma_Poll();
+	Dma_Feed();
+	Deliver();
+}
+
+void Idle_Sleep(void) {
+	Sleeps++;
+	while (!Pending()) {
+		uint64_t next = Next_Event();
+
+		if (next == SIM_NEVER) {
+			fprintf(stderr, "WFI with nothing that could end it\n");
+			exit(1);
+		}
+		Advance(next);
+	}
+}
+
+void Idle_Notify(void) {}								//Nothing blocks on it here
+
+uint8_t Kernel_Running(void) { return Tasks_On; }
+
+/* A blocked task: the line runs until an interrupt posts the semaphore */
+uint8_t Kernel_Sem_Pend(KERNEL_SEM_t* sem, uint32_t timeout_ms) {
+	if (sem->Count) {
+		sem->Count--;
+		return 1;
+	}
+	if (timeout_ms == 0)
+		return 0;
+	if (Masked || In_Isr) {
+		fprintf(stderr, "Kernel_Sem_Pend blocks with interrupts masked\n");
+		exit(1);
+	}
+	Pends++;
+	while (sem->Count == 0) {
+		uint64_t next = Next_Event();
+
+		if (next == SIM_NEVER) {
+			fprintf(stderr, "task blocked with nothing that could wake it\n");
+			exit(1);
+		}
+		Advance(next);
+	}
+	sem->Count--;
+	return 1;
+}
+
+void Kernel_Sem_Post(KERNEL_SEM_t* sem) { sem->Count++; }
+
+volatile uint32_t* Uart_Host_FR(void) {
+	uint32_t fr = 0;
+
+	Dma_Poll();
+	Dma_Feed();
+	Advance(Now + SIM_REG_CYCLES);
+	if (Tx_Fifo.size() == SIM_FIFO_SIZE)
+		fr |= UART_FR_TXFF;
+	if (Tx_Fifo.empty())
+		fr |= UART_FR_TXFE;
+	if (Shift_End != SIM_NEVER || !Tx_Fifo.empty())
+		fr |= UART_FR_BUSY;
+	if (Rx_Fifo.empty())
+		fr |= UART_FR_RXFE;
+	if (Rx_Fifo.size() == SIM_FIFO_SIZE)
+		fr |= UART_FR_RXFF;
+	Uart_Host_Regs.FR = fr;
+	return &Uart_Host_Regs.FR;
+}
+
+void Uart_Host_Tx_Put(uint8_t data) {
+	if (Tx_Fifo.size() == SIM_FIFO_SIZE) {
+		Tx_Overruns++;
+		return;
+	}
+	Tx_Fifo.push_back(data);
+	if (Shift_End == SIM_NEVER)
+		Tx_Start();
+}
+
+uint32_t Uart_Host_Dma_Addr(const volatile void* p) {
+	for (size_t i = 0; i < Dma_Handles.size(); i++) {
+		if (Dma_Handles[i] == p)
+			return (uint32_t)(i + 1);
+	}
+	Dma_Handles.push_back(p);
+	return (uint32_t)Dma_Handles.size();
+}
+
+uint8_t Uart_Host_Rx_Get(void) {
+	uint8_t data = 0;
+
+	if (!Rx_Fifo.empty()) {
+		data = Rx_Fifo.front();
+		Rx_Fifo.pop_front();
+	}
+	if (Rx_Fifo.size() < SIM_RX_LEVEL)
+		Ris &= ~UART_MIS_RXMIS;
+	return data;
+}
+}
+
+/*
+ *	--------------------Dma_Feed-----------------------
+ *	Local helper, the UART requests a byte whenever the TX FIFO has
+ *	room. The last one stops the channel and raises the completion.
+ *	An injected bus error stops it early and raises the uDMA error
+ *	interrupt instead
+ *	Input: none
+ *	Output: none
+ */
+static void Dma_Feed(void) {
+	while (Dma_On && Tx_Fifo.size() < SIM_FIFO_SIZE) {
+		if (Dma_Fail_At != 0 && Dma_Left == Dma_Fail_At) {
+			Dma_Fail_At = 0;
+			Dma_On = 0;																			//The channel stops, no completion
+			Dma_Error = 1;
+			Uart_Host_Regs.ERRCLR = 1;
+			return;
+		}
+		Uart_Host_Tx_Put(*Dma_Src++);
+		if (--Dma_Left == 0) {
+			Dma_On = 0;
+			Dma_Done++;
+			Uart_Host_Regs.CHIS |= SIM_DMA_BIT;
+		}
+	}
+}
+
+/* Reproducible data, xorshift32 */
+static uint32_t Seed = 0x9E3779B9;
+
+static uint32_t Next(void) {
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	return Seed;
+}
+
+/*
+ *	---------------------Drain-------------------------
+ *	Local helper, UART0_Flush and a check of everything that left
+ *	Input: Name, Bytes that should have left since Start
+ *	Output: 1 if they did, unchanged and in order
+ */
+static int Drain(const char* name, const std::vector<uint8_t>& want, size_t start) {
+	size_t got;
+	int ok;
+
+	UART0_Flush();
+	got = Wire.size() - start;
+	ok = got == want.size() && std::equal(want.begin(), want.end(), Wire.begin() + (long)start) && Tx_Overruns == 0;
+	printf("%-16s %6zu bytes out of %6zu%s\n", name, got, want.size(), ok ? "" : "  WRONG");
+	return ok;
+}
+
+/*
+ *	---------------------Settle------------------------
+ *	Local helper, runs the line until frames and text are all out
+ *	Input: none
+ *	Output: none
+ */
+static void Settle(void) {
+	uint64_t limit = Now + 4000 * Byte_Cycles();
+
+	while ((Dma_On || Shift_End != SIM_NEVER || Pending()) && Now < limit)
+		Advance(Now + Byte_Cycles());
+	UART0_Flush();
+}
+
+/*
+ *	---------------------Frame-------------------------
+ *	Local helper, random frame bytes
+ *	Input: Length
+ *	Output: The frame
+ */
+static std::vector<uint8_t> Frame(uint32_t len) {
+	std::vector<uint8_t> f(len);
+
+	for (auto& b : f)
+		b = (uint8_t)Next();
+	return f;
+}
+
+int main(int argc, char** argv) {
+	uint32_t stream = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20000;
+	std::vector<uint8_t> want;
+	uint8_t chunk[80];
+	size_t start;
+	int bad = 0;
+
+	UART0_Init();
+	printf("UART0 %lu baud at %lu Hz: IBRD %u FBRD %u, %llu cycles per byte\n", (unsigned long)UART0_BAUD,
+		(unsigned long)UART0_CLOCK_HZ, Uart_Host_Regs.IBRD, Uart_Host_Regs.FBRD, (unsigned long long)Byte_Cycles());
+
+	/* Text stream, the line must never idle while bytes wait in the ring */
+	uint64_t t0 = Now;
+	uint32_t runs0 = Isr_Runs;
+	start = Wire.size();
+	for (uint32_t sent = 0; sent < stream;) {
+		uint32_t n = 1 + Next() % sizeof(chunk);
+		if (n > stream - sent)
+			n = stream - sent;
+		for (uint32_t i = 0; i < n; i++)
+			chunk[i] = (uint8_t)Next();
+		want.insert(want.end(), chunk, chunk + n);
+		Queued += UART0_Write(chunk, n);
+		sent += n;
+		Advance(Now + Next() % (8 * Byte_Cycles()));				//Work between two lines of text
+	}
+	bad |= !Drain("stream", want, start);
+	double line = (double)stream * Byte_Cycles() / (double)(Now - t0);
+	printf("  line busy %5.1f %%, idle with bytes queued %llu cycles, %.1f interrupts per 100 bytes\n", 100.0 * line,
+		(unsigned long long)Idle_Cycles, 100.0 * (Isr_Runs - runs0) / stream);
+	if (Idle_Cycles != 0)
+		bad = 1;
+
+	/* Interrupts masked the whole time, UART0_Write kicks the FIFO itself */
+	want.clear();
+	start = Wire.size();
+	long sr = StartCritical();
+	for (int i = 0; i < 1000; i++)
+		want.push_back((uint8_t)Next());
+	Queued += UART0_Write(want.data(), (uint32_t)want.size());
+	EndCritical(sr);
+	bad |= !Drain("masked", want, start);
+
+	/* Drop policy, the ring takes UART0_TX_BUF_SIZE and the rest is counted */
+	std::vector<uint8_t> burst(600);
+	for (auto& b : burst)
+		b = (uint8_t)Next();
+	start = Wire.size();
+	UART0_Set_TX_Policy(UART0_TX_DROP);
+	uint32_t taken = UART0_Write(burst.data(), (uint32_t)burst.size());
+	Queued += taken;
+	UART0_Set_TX_Policy(UART0_TX_BLOCK);
+	want.assign(burst.begin(), burst.begin() + taken);
+	int drop_ok = taken == UART0_TX_BUF_SIZE && UART0_TX_Dropped() == burst.size() - UART0_TX_BUF_SIZE;
+	printf("drop policy      %6u taken, %6u dropped%s\n", taken, UART0_TX_Dropped(), drop_ok ? "" : "  WRONG");
+	bad |= !drop_ok;
+	bad |= !Drain("  after drop", want, start);
+
+	/* Receive, read as it comes in: level interrupts and the time-out for the tail */
+	std::vector<uint8_t> sent_rx, got_rx;
+	uint64_t at = Now;
+	for (int i = 0; i < 45; i++) {
+		at += Byte_Cycles();
+		sent_rx.push_back((uint8_t)Next());
+		Rx_Line.push_back({at, sent_rx.back()});
+	}
+	while (got_rx.size() < sent_rx.size() && Now < at + 100 * Byte_Cycles()) {
+		uint8_t buf[16];
+		uint32_t n = UART0_Read(buf, sizeof(buf));
+		got_rx.insert(got_rx.end(), buf, buf + n);
+		Advance(Now + Byte_Cycles());
+	}
+	int rx_ok = got_rx == sent_rx && UART0_RX_Dropped() == 0 && Rx_Overruns == 0;
+	printf("receive          %6zu bytes of %6zu%s\n", got_rx.size(), sent_rx.size(), rx_ok ? "" : "  WRONG");
+	bad |= !rx_ok;
+
+	/* Nobody reads, the ring keeps the first UART0_RX_BUF_SIZE bytes */
+	sent_rx.clear();
+	got_rx.clear();
+	at = Now;
+	for (int i = 0; i < 100; i++) {
+		at += Byte_Cycles();
+		sent_rx.push_back((uint8_t)Next());
+		Rx_Line.push_back({at, sent_rx.back()});
+	}
+	Advance(at + 2 * SIM_RX_TIMEOUT_BITS * Byte_Cycles() / 10);
+	for (;;) {
+		uint8_t buf[16];
+		uint32_t n = UART0_Read(buf, sizeof(buf));
+		if (n == 0)
+			break;
+		got_rx.insert(got_rx.end(), buf, buf + n);
+	}
+	int full_ok = got_rx.size() == UART0_RX_BUF_SIZE &&
+		std::equal(got_rx.begin(), got_rx.end(), sent_rx.begin()) &&
+		UART0_RX_Dropped() == sent_rx.size() - UART0_RX_BUF_SIZE && Rx_Overruns == 0;
+	printf("receive overflow %6zu kept, %6u dropped%s\n", got_rx.size(), UART0_RX_Dropped(), full_ok ? "" : "  WRONG");
+	bad |= !full_ok;
+
+	/* uDMA ping-pong, one frame built while the other one leaves */
+	UART0_DMA_Init();
+	want.clear();
+	start = Wire.size();
+	runs0 = Isr_Runs;
+	Idle_Cycles = 0;
+	uint32_t frames = 300, busy = 0;
+	for (uint32_t k = 0; k < frames; k++) {
+		std::vector<uint8_t> f = Frame(1 + Next() % UART0_DMA_BUF_SIZE);
+		while (!UART0_DMA_Write(f.data(), (uint32_t)f.size())) {
+			busy++;
+			Advance(Now + Byte_Cycles());								//Both buffers still with the uDMA
+		}
+		if (!UART0_DMA_Send()) {
+			printf("UART0_DMA_Send refused a filled buffer\n");
+			bad = 1;
+		}
+		Queued += f.size();
+		want.insert(want.end(), f.begin(), f.end());
+	}
+	Settle();
+	int dma_ok = Wire.size() - start == want.size() && std::equal(want.begin(), want.end(), Wire.begin() + (long)start) &&
+		Dma_Started == frames && Dma_Done == frames && Dma_Buffers.size() == 2 && Dma_Faults == 0 &&
+		Tx_Overruns == 0 && UART0_DMA_Errors() == 0 && Idle_Cycles == 0;
+	printf("dma ping-pong    %6u frames, %6u started, %6u completed, %zu buffers%s\n", frames, Dma_Started, Dma_Done,
+		Dma_Buffers.size(), dma_ok ? "" : "  WRONG");
+	printf("  %zu bytes, writer waited %u byte times, %.2f interrupts per frame, idle with bytes queued %llu cycles\n",
+		want.size(), busy, (double)(Isr_Runs - runs0) / frames, (unsigned long long)Idle_Cycles);
+	bad |= !dma_ok;
+
+	/* Both buffers with the uDMA, the writer has to wait */
+	std::vector<uint8_t> fa = Frame(UART0_DMA_BUF_SIZE), fb = Frame(40), fc = Frame(8);
+	start = Wire.size();
+	uint32_t done0 = Dma_Done;
+	int own_ok = UART0_DMA_Write(fa.data(), (uint32_t)fa.size()) && UART0_DMA_Send() &&
+		UART0_DMA_Write(fb.data(), (uint32_t)fb.size()) && UART0_DMA_Send() &&
+		!UART0_DMA_Write(fc.data(), (uint32_t)fc.size()) && !UART0_DMA_Write(fc.data(), UART0_DMA_BUF_SIZE + 1);
+	Queued += fa.size() + fb.size();
+	while (Dma_Done == done0)
+		Advance(Now + Byte_Cycles());
+	own_ok &= UART0_DMA_Write(fc.data(), (uint32_t)fc.size()) && UART0_DMA_Send();
+	Queued += fc.size();
+	Settle();
+	want = fa;
+	want.insert(want.end(), fb.begin(), fb.end());
+	want.insert(want.end(), fc.begin(), fc.end());
+	own_ok &= Wire.size() - start == want.size() && std::equal(want.begin(), want.end(), Wire.begin() + (long)start);
+	printf("dma ownership    write refused while both buffers are out%s\n", own_ok ? "" : "  WRONG");
+	bad |= !own_ok;
+
+	/* Text during a frame waits for it, and holds back the frame after it */
+	std::vector<uint8_t> f1 = Frame(100), text = Frame(30), f2 = Frame(50);
+	start = Wire.size();
+	int order_ok = UART0_DMA_Write(f1.data(), (uint32_t)f1.size()) && UART0_DMA_Send();
+	Advance(Now + 10 * Byte_Cycles());
+	Queued += f1.size() + UART0_Write(text.data(), (uint32_t)text.size());
+	order_ok &= UART0_DMA_Write(f2.data(), (uint32_t)f2.size()) && UART0_DMA_Send();
+	Queued += f2.size();
+	Settle();
+	want = f1;
+	want.insert(want.end(), text.begin(), text.end());
+	want.insert(want.end(), f2.begin(), f2.end());
+	order_ok &= Wire.size() - start == want.size() && std::equal(want.begin(), want.end(), Wire.begin() + (long)start) &&
+		Dma_Faults == 0 && Tx_Overruns == 0;
+	printf("dma and text     frame, text, frame in order%s\n", order_ok ? "" : "  WRONG");
+	bad |= !order_ok;
+
+	/* Bus error in the middle of a frame, the frame queued behind it goes out and the channel is free again */
+	std::vector<uint8_t> e1 = Frame(UART0_DMA_BUF_SIZE), e2 = Frame(60), e3 = Frame(30);
+	start = Wire.size();
+	uint32_t errors0 = UART0_DMA_Errors();
+	int err_ok = (Uart_Host_Regs.EN1 & SIM_EN1_UDMA_ERR) &&
+		SIM_PRI11_UDMA_ERR(Uart_Host_Regs.PRI11) == SIM_PRI1_UART0(Uart_Host_Regs.PRI1);
+	err_ok &= UART0_DMA_Write(e1.data(), (uint32_t)e1.size()) && UART0_DMA_Send();
+	Dma_Fail_At = UART0_DMA_BUF_SIZE - 50;								//After 50 bytes
+	err_ok &= UART0_DMA_Write(e2.data(), (uint32_t)e2.size()) && UART0_DMA_Send();
+	Settle();
+	err_ok &= UART0_DMA_Write(e3.data(), (uint32_t)e3.size()) && UART0_DMA_Send();
+	Settle();
+	want.assign(e1.begin(), e1.begin() + 50);
+	want.insert(want.end(), e2.begin(), e2.end());
+	want.insert(want.end(), e3.begin(), e3.end());
+	err_ok &= Wire.size() - start == want.size() && std::equal(want.begin(), want.end(), Wire.begin() + (long)start) &&
+		UART0_DMA_Errors() == errors0 + 1 && !Dma_Error && Dma_Faults == 0;
+	printf("dma bus error    %u error, queued and next frame sent%s\n", UART0_DMA_Errors() - errors0,
+		err_ok ? "" : "  WRONG");
+	bad |= !err_ok;
+
+	/* Kernel running: waits pend on TxRoom, posted by UART0_Handler */
+	Tasks_On = 1;
+	uint32_t sleeps0 = Sleeps, pends0 = Pends;
+	want.clear();
+	start = Wire.size();
+	for (uint32_t sent = 0; sent < stream / 4;) {
+		uint32_t n = 1 + Next() % sizeof(chunk);
+		for (uint32_t i = 0; i < n; i++)
+			chunk[i] = (uint8_t)Next();
+		want.insert(want.end(), chunk, chunk + n);
+		Queued += UART0_Write(chunk, n);
+		sent += n;
+		Advance(Now + Next() % (8 * Byte_Cycles()));
+	}
+	bad |= !Drain("task stream", want, start);
+
+	std::vector<uint8_t> t1 = Frame(UART0_DMA_BUF_SIZE), t2 = Frame(3 * UART0_TX_BUF_SIZE / 2);
+	start = Wire.size();
+	int task_ok = UART0_DMA_Write(t1.data(), (uint32_t)t1.size()) && UART0_DMA_Send();
+	Queued += t1.size() + UART0_Write(t2.data(), (uint32_t)t2.size());	//More than the ring, waits for the frame
+	want = t1;
+	want.insert(want.end(), t2.begin(), t2.end());
+	bad |= !Drain("task frame+text", want, start);
+	task_ok &= Sleeps == sleeps0 && Pends > pends0;
+
+	want.clear();
+	start = Wire.size();
+	sr = StartCritical();
+	for (int i = 0; i < 1000; i++)
+		want.push_back((uint8_t)Next());
+	Queued += UART0_Write(want.data(), (uint32_t)want.size());
+	EndCritical(sr);
+	bad |= !Drain("task masked", want, start);
+	task_ok &= Sleeps > sleeps0;
+	Tasks_On = 0;
+	printf("kernel running   %u pends, %u WFI (masked write only)%s\n", Pends - pends0, Sleeps - sleeps0,
+		task_ok ? "" : "  WRONG");
+	bad |= !task_ok;
+
+	printf(bad ? "uart0 model FAILED\n" : "uart0 model passed\n");
+	return bad;
+}
@@ -1,214 +1,648 @@
-/*
- * I2C.h
- *
- *	Main implementation of the I2C Init, Read, and Write Function
- *
- * Created on: November 13, 2024
- *		Author: Oliver Cabral and Jason Chan
- *
- */
- 
-#include "I2C.h"
-#include "tm4c123gh6pm.h"
-
-/*
- *	-------------------I2C0_Init------------------
- *	Basic I2C Initialization function for master mode @ 100kHz
- *	Input: None
- *	Output: None
- */
-void I2C0_Init(void){
-	
-	/* Enable Required System Clock */
-	SYSCTL_RCGCI2C_R |= EN_I2C0_CLOCK;							//Enable I2C0 System Clock
-	SYSCTL_RCGC2_R |= EN_GPIOB_CLOCK;							//Enable GPIOB System Clock
-	
-	//Wait Until GPIOx System Clock is enabled
-	while((SYSCTL_RCGC2_R&EN_GPIOB_CLOCK)!= EN_GPIOB_CLOCK);
-	while((SYSCTL_RCGCI2C_R&EN_I2C0_CLOCK)!= EN_I2C0_CLOCK);
-	
-	/* GPIOx I2C Alternate Function Setup	*/
-	GPIO_PORTB_DEN_R	 |= I2C0_PINS;								//Enable Digital I/O
-	GPIO_PORTB_AFSEL_R |= I2C0_PINS;								//Enable Alternate Function Selection
-	
-	//Select I2C0 as the alternate function 
-	GPIO_PORTB_PCTL_R  |= I2C0_ALT_FUNC_SET;
-	GPIO_PORTB_ODR_R	 |= I2C0_SDA_PIN;						  //Enable Open Drain for SDA pin
-	GPIO_PORTB_AMSEL_R &= ~I2C0_PINS;								//Disable Analog Mode
-	
-	/*	I2C0 Setup as Master Mode @ 100kBits	*/
-	I2C0_MCR_R |= EN_I2C0_MASTER;									//Configure I2C0 as Master 
-	
-	/* Configuring I2C Clock Frequency to 100KHz
-		
-		TPR = (System Clock / (2*(SCL_LP + SCL_HP) * SCL_CLK)) - 1
-		SCL_LP and SCL_HP are fixed
-		SCL_LP = 6 & SCL_HP = 4
-		
-		Example if we want to configure I2C speed to 100kHz for 40MHz system clock
-		TPR = (40MHz / ((2*(6+4)) * 100kHz)) - 1 		(Convert Everything to Hz)
-		TPR = 19
-		
-	*/
-	
-	// take care of master timer period: standard speed and TPR value	
-	I2C0_MTPR_R = (I2C0_MTPR_R&~0xFF)|I2C_MTPR_TPR_VALUE|I2C_MTPR_STD_SPEED;
-
-}
-
-/*
- *	-------------------I2C0_Receive------------------
- *	Polls to receive data from specified peripheral
- *	Input: Slave address & Slave Register Address
- *	Output: Returns 8-bit data that has been received
- */
-uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr){
-	
-	char error;																	//Temp Variable to hold errors
-	                                 
-	/* Check if I2C0 is busy: check MCS register Busy bit */
-	while(I2C0_MCS_R&I2C_MCS_BUSY);
-	
-	/* Configure I2C0 Slave Address and Read Mode */
-	I2C0_MSA_R = (slave_addr << 1);								// Slave Address is the 7 MSB
-	I2C0_MDR_R = slave_reg_addr;								// Set Data Register to slave register address
-	
-	/* Initiate I2C by generating a START & RUN cmd:
-	   Set MCS register START bit to generate and RUN bit to enable I2C Master
-	*/
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_START;
-	
-	/* Wait until write is done: check MCS register to see is I2C is still busy */
-	while(I2C0_MCS_R&I2C_MCS_BUSY);
-	
-	/* Set I2C to Receive with Slave Address and change to Read */
-	I2C0_MSA_R = (slave_addr << 1) | I2C0_RW_PIN;
-	
-	/* Initiate I2C by generating a repeated START, STOP, & RUN cmd */
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_START | I2C_MCS_STOP ;
-	
-	/* Wait until I2C bus is not busy: check MCS register for I2C bus busy bit */
-	while(I2C0_MCS_R&I2C_MCS_BUSBSY);
-	
-	/* Check for any error: read the error flag from MCS register */
-	error = I2C0_MCS_R & 0x0E;
-	if(error != 0){
-		return error;
-	}else{
-		return ((uint8_t)I2C0_MDR_R & 0xFF);  // return I2C data register least significant 8 bits.
-	}
-}
-
-/*
- *	-------------------I2C0_Transmit------------------
- *	Transmit a byte of data to specified peripheral
- *	Input: Slave address, Slave Register Address, Data to Transmit
- *	Output: Any Errors if detected, otherwise 0
- */
-uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data){
-	
-	char error;																	//Temp Variable to hold errors
-	
-	/* Check if I2C0 is busy: check MCS register Busy bit */
-	while(I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
-	I2C0_MSA_R = (slave_addr << 1);								//Slave Address is the first 7 MSB
-	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
-	I2C0_MDR_R = slave_reg_addr;								//Transmit register addr to interact
-	
-	/* Initiate I2C by generate a START bit and RUN cmd */
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_START;
-	
-	/* Wait until write has been completed */
-	while(I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Update Data Register with data to be transmitted */
-	I2C0_MDR_R = data; 
-	
-	/* Initiate I2C by generating a STOP & RUN cmd */
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_STOP;
-	
-	/* Wait until write has been completed: check MCS register Busy bit */
-	while(I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Wait until bus isn't busy: check MCS register for I2C bus busy bit */
-	while(I2C0_MCS_R & I2C_MCS_BUSBSY);
-
-	/* Check for any error: read the error flag from MCS register */
-	error = I2C0_MCS_R & 0x0E;
-	if(error != 0){
-		return error;
-  }else{
-		return 0;
-	}
-	
-}
-
-//Has Yet to be Implemented
-/*
- *	----------------I2C0_Burst_Receive-----------------
- *	Polls to receive multiple bytes of data from specified
- *  peripheral by incrementing starting slave register address
- *	Input: Slave address, Slave Register Address, Data Buffer
- *	Output: None
- */
-void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
-	
-}
-
-/*
- *	----------------I2C0_Burst_Transmit-----------------
- *	Transmit multiple bytes of data to specified peripheral
- *  by incrementing starting slave address
- *	Input: Slave address, Slave Register Address, Data Buffer to transmit
- *	Output: None
- */
-uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
-	
-	char error; //Temp Error Variable
-	
-	/* Asserting Param */
-	if(size <= 0)
-		return 0;
-	
-	/* Check if I2C0 is busy */
-	while (I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
-	I2C0_MSA_R = (slave_addr << 1);					//Slave Address is the first 7 MSB
-	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
-	I2C0_MDR_R = slave_reg_addr;						//Transmit register addr to interact
-	
-	/* Initiate I2C by generate a START bit and RUN cmd */
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_START;
-	
-	/* Wait until write has been completed */
-	while(I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Loop to Burst Transmit what is stored in data buffer */
-	while(size > 1){
-		
-		I2C0_MDR_R = data[size-1];						//Deference Pointer from data array and load into data reg. Post-Increment the pointer after
-		I2C0_MCS_R = RUN_CMD;									//Initiate I2C RUN CMD
-		while(I2C0_MCS_R & I2C_MCS_BUSY);
-		size--;																//Reduce size until 1 is left
-		
-	}
-	
-	I2C0_MDR_R = data[size-1];								//Deference Pointer from data array and load into data reg
-	I2C0_MCS_R = I2C_MCS_RUN | I2C_MCS_STOP;						//Initiate I2C STOP condition and RUN CMD
-	
-	/* Wait until write has been completed: check MCS register Busy bit */
-	while(I2C0_MCS_R & I2C_MCS_BUSY);
-	
-	/* Wait until bus isn't busy: check MCS register for I2C bus busy bit */
-	while(I2C0_MCS_R & I2C_MCS_BUSBSY);
-	
-	/* Check for any error */
-	error = I2C0_MCS_R & 0x0E;
-	if(error != 0)
-		return error;
-  else
-		return 0;
-}
+/*
+ * I2C.h
+ *
+ *	Main implementation of the I2C Init, Read, and Write Function
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+ 
+#include "I2C.h"
+#include "I2CTable.h"
+#include "Kernel.h"
+#include "Idle.h"
+#include "Profile.h"
+#include "tm4c123gh6pm.h"
+#include <string.h>
+
+/* Bus lock, once the kernel runs a task may preempt another one
+   in the middle of a transfer. Before Kernel_Start it is a no-op.
+   Real-time transfers waiting for it are counted, a bulk write hands
+   the bus over at its next fragment boundary while there are any */
+static KERNEL_SEM_t I2C0_Bus = {1, 0};
+static volatile uint8_t I2C0_Urgent;
+
+/* Posted by I2C0_Handler once the kernel runs, a task waiting for
+   its command pends on it and the CPU goes to the other tasks */
+static KERNEL_SEM_t I2C0_Done = {0, 0};
+
+#define I2C0_UNLOCK()			do{ if(Kernel_Running()) Kernel_Sem_Post(&I2C0_Bus); }while(0)
+
+/* Bus pins as GPIO and the module reset, for I2C0_Recover. The build may override them (host bus model) */
+#ifndef I2C0_SCL_OUT
+#define I2C0_SCL_OUT(level)		(GPIO_PORTB_DATA_BITS_R[I2C0_SCL_PIN] = (level) ? I2C0_SCL_PIN : 0)
+#define I2C0_SDA_OUT(level)		(GPIO_PORTB_DATA_BITS_R[I2C0_SDA_PIN] = (level) ? I2C0_SDA_PIN : 0)
+#define I2C0_SDA_IN()					(GPIO_PORTB_DATA_BITS_R[I2C0_SDA_PIN] != 0)
+#define I2C0_MODULE_RESET()		do{ SYSCTL_SRI2C_R |= SYSCTL_SRI2C_R0; SYSCTL_SRI2C_R &= ~SYSCTL_SRI2C_R0; \
+																	while((SYSCTL_PRI2C_R & SYSCTL_PRI2C_R0) == 0); }while(0)
+#define I2C0_PORT_TARGET
+#endif
+
+/* Bus free check after a STOP, no interrupt marks it */
+#define I2C_POLL_US				(1)
+
+/* Bytes on the wire per transfer, address and register bytes included */
+#define I2C_RX_BYTES			(4)								//Address, register, address again, data
+#define I2C_TX_BYTES			(3)								//Address, register, data
+#define I2C_BURST_BYTES(size)	(2 + (size))
+
+/* Master interrupt, wakes the transfer waits (I2C0_Wait) */
+#define I2C0_PRI					(0x000000A0)			//Priority 5
+#define I2C0_PRI_MSK			(0xFFFFFF1F)
+#define NVIC_EN0_I2C0			(0x00000100)			//Interrupt 8
+
+static void I2C0_Master_Setup(void);
+static uint8_t I2C0_Bus_Recover(void);
+
+/* MTPR value and SCL period in TPR units of every speed */
+#define I2C_SPEED(id, hz, lp_hp, hs)		(uint8_t)(I2C_TPR(hz, lp_hp) | (hs)),
+static const uint8_t I2C0_Speed_Mtpr[I2C_SPEED_COUNT] = {
+	I2C_SPEED_TABLE
+};
+#undef I2C_SPEED
+#define I2C_SPEED(id, hz, lp_hp, hs)		(uint8_t)(2*(lp_hp)),
+static const uint8_t I2C0_Speed_Period[I2C_SPEED_COUNT] = {
+	I2C_SPEED_TABLE
+};
+#undef I2C_SPEED
+
+/* Devices, their speeds and priorities, from I2CTable.h */
+typedef struct{
+	uint8_t Addr;
+	uint8_t Speed;												//I2C_SPEED_t
+	uint8_t Prio;													//I2C_PRIO_t
+	uint8_t Fragment;											//Data bytes per burst transfer, 0 for whole
+} I2C_DEVICE_t;
+
+#define I2C_DEVICE(addr, speed, prio, frag)		{addr, speed, prio, frag},
+static const I2C_DEVICE_t I2C0_Devices[] = {
+	I2C_DEVICE_TABLE
+};
+#undef I2C_DEVICE
+
+#define I2C0_DEVICE_COUNT		(sizeof(I2C0_Devices)/sizeof(I2C0_Devices[0]))
+
+/* Entry of an address that is not in the table */
+static const I2C_DEVICE_t I2C0_Unlisted = {0, I2C_SPEED_STD, I2C_PRIO_RT, 0};
+
+static uint8_t I2C0_Mtpr;										//MTPR as last written
+
+static I2C_STATS_t I2C0_Stats[I2C_STATS_SLOTS];
+static uint8_t I2C0_Stats_Used;
+static uint64_t I2C0_Stats_Since;					//Time_Now_Cycles at the last reset
+
+/*
+ *	-------------------I2C0_Device------------------
+ *	Local helper
+ *	Input: Slave address
+ *	Output: Its I2CTable.h entry, I2C0_Unlisted if it has none
+ */
+static const I2C_DEVICE_t* I2C0_Device(uint8_t addr){
+	uint8_t i;
+	
+	for(i = 0; i < I2C0_DEVICE_COUNT; i++)
+		if(I2C0_Devices[i].Addr == addr)
+			return &I2C0_Devices[i];
+	return &I2C0_Unlisted;
+}
+
+/*
+ *	--------------------I2C0_Lock-------------------
+ *	Local helper to take the bus lock, a real-time transfer is
+ *	counted in I2C0_Urgent while it waits. Nothing to do before
+ *	Kernel_Start
+ *	Input: Priority of the transfer
+ *	Output: None
+ */
+static void I2C0_Lock(I2C_PRIO_t prio){
+	long sr;
+	
+	if(!Kernel_Running())
+		return;
+	if(prio != I2C_PRIO_RT){
+		Kernel_Sem_Pend(&I2C0_Bus, KERNEL_WAIT_FOREVER);
+		return;
+	}
+	sr = StartCritical();
+	I2C0_Urgent++;
+	EndCritical(sr);
+	Kernel_Sem_Pend(&I2C0_Bus, KERNEL_WAIT_FOREVER);
+	sr = StartCritical();
+	I2C0_Urgent--;
+	EndCritical(sr);
+}
+
+/*
+ *	------------------I2C0_Account------------------
+ *	Local helper to count a finished transfer against the slot of
+ *	its address. Called with the bus lock held, the update itself
+ *	is masked so I2C0_Stats_Read always sees a whole transfer
+ *	Input: Slave address, Bytes, MCS bits of every step,
+ *	Time_Stamp at the call and at the START
+ *	Output: None
+ */
+static void I2C0_Account(uint8_t addr, uint32_t bytes, uint32_t status, uint32_t called, uint32_t started){
+	uint32_t now = Time_Stamp();
+	uint32_t latency = (now - called)/SYSCLK_CYCLES_PER_US;
+	uint32_t bin = 31 - (uint32_t)__builtin_clz(latency | 1);
+	I2C_STATS_t* st;
+	uint8_t i;
+	long sr;
+	
+	if(bin >= I2C_HIST_BINS)
+		bin = I2C_HIST_BINS - 1;
+	
+	sr = StartCritical();
+	
+	/* Slot of the address, a new one takes the next free slot */
+	for(i = 0; i < I2C0_Stats_Used && I2C0_Stats[i].Addr != addr; i++);
+	if(i == I2C0_Stats_Used){
+		if(I2C0_Stats_Used < I2C_STATS_SLOTS){
+			I2C0_Stats_Used++;
+			I2C0_Stats[i].Addr = (i == I2C_STATS_SLOTS - 1) ? I2C_STATS_OTHER : addr;
+		}else{
+			i = I2C_STATS_SLOTS - 1;
+		}
+	}
+	st = &I2C0_Stats[i];
+	
+	st->Transactions++;
+	st->Bytes += bytes;
+	if(status & (I2C_MCS_ADRACK|I2C_MCS_DATACK))
+		st->Nacks++;
+	if(status & I2C_MCS_ARBLST)
+		st->Arb_Lost++;
+	if(status & I2C_ERR_TIMEOUT)
+		st->Timeouts++;
+	st->Busy_Cycles += now - started;
+	if(latency > st->Max_Latency_US)
+		st->Max_Latency_US = latency;
+	st->Hist[bin]++;
+	EndCritical(sr);
+}
+
+/*
+ *	------------------I2C0_Select-------------------
+ *	Local helper to switch MTPR to the speed of the slave, only
+ *	written when it changes. Call with the master idle, nothing is
+ *	done once the transfer has timed out
+ *	Input: Slave address, Status
+ *	Output: MCS bits the START commands of the speed need (HS)
+ */
+static uint32_t I2C0_Select(uint8_t addr, uint32_t status){
+	uint8_t mtpr = I2C0_Speed_Mtpr[I2C0_Device_Speed(addr)];
+	
+	if(status & I2C_ERR_TIMEOUT)
+		return 0;
+	if(mtpr != I2C0_Mtpr){
+		I2C0_MTPR_R = mtpr;
+		I2C0_Mtpr = mtpr;
+	}
+	return (mtpr & I2C_MTPR_HS) ? I2C_MCS_HS : 0;
+}
+
+/*
+ *	-------------------I2C0_Wait--------------------
+ *	Local helper to wait until the master is done with its command
+ *	or the deadline passes. Once the kernel runs the task pends on
+ *	I2C0_Done, with the bus lock held, so lower priority tasks get
+ *	the CPU. Before that the core sleeps in IDLE_WAIT, checked on
+ *	every interrupt. Either way it ends at most a tick late
+ *	Input: Deadline
+ *	Output: MCS, or I2C_ERR_TIMEOUT if the master is still busy
+ */
+static uint32_t I2C0_Wait(TIME_US_t deadline){
+	if(Kernel_Running()){
+		while(Kernel_Sem_Pend(&I2C0_Done, 0));						//Wake-ups of earlier commands
+		while((I2C0_MCS_R & I2C_MCS_BUSY) && !Time_Elapsed(deadline))
+			Kernel_Sem_Pend(&I2C0_Done, (uint32_t)(Time_Remaining(deadline)/1000) + 1);
+	}else{
+		IDLE_WAIT((I2C0_MCS_R & I2C_MCS_BUSY) && !Time_Elapsed(deadline));
+	}
+	if(I2C0_MCS_R & I2C_MCS_BUSY)
+		return I2C_ERR_TIMEOUT;
+	return I2C0_MCS_R;
+}
+
+/*
+ *	------------------I2C0_Command------------------
+ *	Local helper to run one master command and collect its error
+ *	bits, MCS only shows those of the last command. Does nothing
+ *	once the transfer has timed out
+ *	Input: MCS command, Status (updated), Deadline
+ *	Output: None
+ */
+static void I2C0_Command(uint32_t cmd, uint32_t* status, TIME_US_t deadline){
+	if(*status & I2C_ERR_TIMEOUT)
+		return;
+	I2C0_MCS_R = cmd;
+	*status |= I2C0_Wait(deadline);
+}
+
+/*
+ *	-------------------I2C0_Finish------------------
+ *	Local helper to end every transfer: waits out the STOP (a few
+ *	us), recovers the bus if the deadline passed and counts the
+ *	transfer
+ *	Input: Slave address, Bytes, Status of the commands, Deadline,
+ *	Time_Stamp at the call and at the START
+ *	Output: Any Errors (I2C_ERR_xxx), otherwise 0
+ */
+static uint8_t I2C0_Finish(uint8_t addr, uint32_t bytes, uint32_t status, TIME_US_t deadline, uint32_t called, uint32_t started){
+	
+	/* Wait until bus isn't busy: check MCS register for I2C bus busy bit */
+	while(!(status & I2C_ERR_TIMEOUT) && (I2C0_MCS_R & I2C_MCS_BUSBSY)){
+		if(Time_Elapsed(deadline))
+			status |= I2C_ERR_TIMEOUT;
+		else
+			TIME_SPIN_US(I2C_POLL_US);
+	}
+	
+	/* Check for any error: read the error flag from MCS register */
+	if(status & I2C_ERR_TIMEOUT)
+		I2C0_Bus_Recover();
+	else
+		status |= I2C0_MCS_R;
+	
+	I2C0_Account(addr, bytes, status, called, started);
+	return (uint8_t)(status & I2C_ERR_MASK);
+}
+
+/*
+ *	-------------------I2C0_Init------------------
+ *	Basic I2C Initialization function for master mode @ 100kHz,
+ *	each transfer then runs at the speed of its device (I2CTable.h)
+ *	Input: None
+ *	Output: None
+ */
+void I2C0_Init(void){
+	
+	/* Enable Required System Clock */
+	SYSCTL_RCGCI2C_R |= EN_I2C0_CLOCK;							//Enable I2C0 System Clock
+	SYSCTL_RCGC2_R |= EN_GPIOB_CLOCK;							//Enable GPIOB System Clock
+	
+	//Wait Until GPIOx System Clock is enabled
+	while((SYSCTL_RCGC2_R&EN_GPIOB_CLOCK)!= EN_GPIOB_CLOCK);
+	while((SYSCTL_RCGCI2C_R&EN_I2C0_CLOCK)!= EN_I2C0_CLOCK);
+	
+	/* GPIOx I2C Alternate Function Setup	*/
+	GPIO_PORTB_DEN_R	 |= I2C0_PINS;								//Enable Digital I/O
+	GPIO_PORTB_AFSEL_R |= I2C0_PINS;								//Enable Alternate Function Selection
+	
+	//Select I2C0 as the alternate function 
+	GPIO_PORTB_PCTL_R  |= I2C0_ALT_FUNC_SET;
+	GPIO_PORTB_ODR_R	 |= I2C0_SDA_PIN;						  //Enable Open Drain for SDA pin
+	GPIO_PORTB_AMSEL_R &= ~I2C0_PINS;								//Disable Analog Mode
+	
+	/* Master mode, clock and interrupt, also redone by every recovery */
+	I2C0_Master_Setup();
+	NVIC_PRI2_R = (NVIC_PRI2_R&I2C0_PRI_MSK)|I2C0_PRI;
+	NVIC_EN0_R = NVIC_EN0_I2C0;
+	
+	I2C0_Stats_Reset();
+}
+
+/*
+ *	----------------I2C0_Master_Setup----------------
+ *	Local helper to set up the module as master, after I2C0_Init
+ *	enabled it or a recovery reset it
+ *	Input: None
+ *	Output: None
+ */
+static void I2C0_Master_Setup(void){
+	
+	/*	I2C0 Setup as Master Mode @ 100kBits	*/
+	I2C0_MCR_R |= EN_I2C0_MASTER;									//Configure I2C0 as Master 
+	
+	/* Configuring I2C Clock Frequency to 100KHz, each transfer then
+	   switches it to the speed of its slave (I2C0_Select)
+		
+		TPR = (System Clock / (2*(SCL_LP + SCL_HP) * SCL_CLK)) - 1
+		SCL_LP and SCL_HP are fixed
+		SCL_LP = 6 & SCL_HP = 4
+		
+		Example if we want to configure I2C speed to 100kHz for 80MHz system clock
+		TPR = (80MHz / ((2*(6+4)) * 100kHz)) - 1 		(Convert Everything to Hz)
+		TPR = 39		(I2C_MTPR_TPR_VALUE, from SYSCLK_HZ and I2C_SCL_HZ)
+		
+	*/
+	
+	// take care of master timer period: standard speed and TPR value	
+	I2C0_Mtpr = I2C0_Speed_Mtpr[I2C_SPEED_STD];
+	I2C0_MTPR_R = (I2C0_MTPR_R&~0xFF)|I2C0_Mtpr;
+	
+	/* Byte done interrupt, the core sleeps through each transfer */
+	I2C0_MICR_R = I2C_MICR_IC;
+	I2C0_MIMR_R |= I2C_MIMR_IM;
+}
+
+/*
+ *	------------------I2C0_Handler------------------
+ *	Master interrupt, raised at the end of every byte. The waits
+ *	read MCS themselves, the interrupt only wakes the core or, once
+ *	the kernel runs, the waiting task
+ *	Input: None
+ *	Output: None
+ */
+void I2C0_Handler(void){
+	I2C0_MICR_R = I2C_MICR_IC;
+	if(Kernel_Running())
+		Kernel_Sem_Post(&I2C0_Done);
+}
+
+/*
+ *	-------------------I2C0_Receive------------------
+ *	Receive a byte of data from specified peripheral
+ *	Input: Slave address, Slave Register Address, Received data
+ *	(written, 0 on an error)
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data){
+	
+	uint8_t error;																//Temp Variable to hold errors
+	uint32_t called = Time_Stamp(), started, status;
+	uint32_t hs;
+	TIME_US_t deadline;
+	
+	I2C0_Lock(I2C0_Device_Prio(slave_addr));
+	PROFILE_BEGIN(PROF_I2C_RX);
+	deadline = Time_Deadline(I2C_TIMEOUT_US(I2C_RX_BYTES));
+	                                 
+	/* Check if I2C0 is busy: check MCS register Busy bit */
+	status = I2C0_Wait(deadline) & I2C_ERR_TIMEOUT;
+	started = Time_Stamp();
+	hs = I2C0_Select(slave_addr, status);
+	
+	/* Configure I2C0 Slave Address and Read Mode */
+	I2C0_MSA_R = (slave_addr << 1);								// Slave Address is the 7 MSB
+	I2C0_MDR_R = slave_reg_addr;								// Set Data Register to slave register address
+	
+	/* Initiate I2C by generating a START & RUN cmd:
+	   Set MCS register START bit to generate and RUN bit to enable I2C Master
+	   and wait until write is done
+	*/
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_START | hs, &status, deadline);
+	
+	/* Set I2C to Receive with Slave Address and change to Read */
+	I2C0_MSA_R = (slave_addr << 1) | I2C0_RW_PIN;
+	
+	/* Initiate I2C by generating a repeated START, STOP, & RUN cmd */
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_START | I2C_MCS_STOP | hs, &status, deadline);
+	
+	*data = (uint8_t)I2C0_MDR_R & 0xFF;						// I2C data register least significant 8 bits
+	error = I2C0_Finish(slave_addr, I2C_RX_BYTES, status, deadline, called, started);
+	if(error != 0)
+		*data = 0;
+	PROFILE_END(PROF_I2C_RX);
+	I2C0_UNLOCK();
+	return error;
+}
+
+/*
+ *	-------------------I2C0_Transmit------------------
+ *	Transmit a byte of data to specified peripheral
+ *	Input: Slave address, Slave Register Address, Data to Transmit
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data){
+	
+	uint8_t error;																//Temp Variable to hold errors
+	uint32_t called = Time_Stamp(), started, status;
+	uint32_t hs;
+	TIME_US_t deadline;
+	
+	I2C0_Lock(I2C0_Device_Prio(slave_addr));
+	PROFILE_BEGIN(PROF_I2C_TX);
+	deadline = Time_Deadline(I2C_TIMEOUT_US(I2C_TX_BYTES));
+	
+	/* Check if I2C0 is busy: check MCS register Busy bit */
+	status = I2C0_Wait(deadline) & I2C_ERR_TIMEOUT;
+	started = Time_Stamp();
+	hs = I2C0_Select(slave_addr, status);
+	
+	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
+	I2C0_MSA_R = (slave_addr << 1);								//Slave Address is the first 7 MSB
+	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
+	I2C0_MDR_R = slave_reg_addr;								//Transmit register addr to interact
+	
+	/* Initiate I2C by generate a START bit and RUN cmd, wait until write has been completed */
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_START | hs, &status, deadline);
+	
+	/* Update Data Register with data to be transmitted */
+	I2C0_MDR_R = data; 
+	
+	/* Initiate I2C by generating a STOP & RUN cmd */
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_STOP, &status, deadline);
+	
+	error = I2C0_Finish(slave_addr, I2C_TX_BYTES, status, deadline, called, started);
+	PROFILE_END(PROF_I2C_TX);
+	I2C0_UNLOCK();
+	return error;
+}
+
+//Has Yet to be Implemented
+/*
+ *	----------------I2C0_Burst_Receive-----------------
+ *	Polls to receive multiple bytes of data from specified
+ *  peripheral by incrementing starting slave register address
+ *	Input: Slave address, Slave Register Address, Data Buffer
+ *	Output: None
+ */
+void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
+	
+}
+
+/*
+ *	----------------I2C0_Burst_Fragment----------------
+ *	Local helper, one transfer of a burst with the bus lock held:
+ *	START, the register address, the data from the last byte of the
+ *	buffer to the first, STOP
+ *	Input: Slave address, Slave Register Address, Data, Size (at
+ *	least 1), Time_Stamp at the call
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+static uint8_t I2C0_Burst_Fragment(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size, uint32_t called){
+	
+	uint8_t error; //Temp Error Variable
+	uint32_t started, status, hs, bytes = I2C_BURST_BYTES(size);
+	TIME_US_t deadline;
+	
+	PROFILE_BEGIN(PROF_I2C_TX);
+	deadline = Time_Deadline(I2C_TIMEOUT_US(bytes));
+	
+	/* Check if I2C0 is busy */
+	status = I2C0_Wait(deadline) & I2C_ERR_TIMEOUT;
+	started = Time_Stamp();
+	hs = I2C0_Select(slave_addr, status);
+	
+	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
+	I2C0_MSA_R = (slave_addr << 1);					//Slave Address is the first 7 MSB
+	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
+	I2C0_MDR_R = slave_reg_addr;						//Transmit register addr to interact
+	
+	/* Initiate I2C by generate a START bit and RUN cmd, wait until write has been completed */
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_START | hs, &status, deadline);
+	
+	/* Loop to Burst Transmit what is stored in data buffer */
+	while(size > 1){
+		
+		I2C0_MDR_R = data[size-1];						//Deference Pointer from data array and load into data reg. Post-Increment the pointer after
+		I2C0_Command(RUN_CMD, &status, deadline);		//Initiate I2C RUN CMD
+		size--;																//Reduce size until 1 is left
+		
+	}
+	
+	I2C0_MDR_R = data[size-1];								//Deference Pointer from data array and load into data reg
+	I2C0_Command(I2C_MCS_RUN | I2C_MCS_STOP, &status, deadline);		//Initiate I2C STOP condition and RUN CMD
+	
+	error = I2C0_Finish(slave_addr, bytes, status, deadline, called, started);
+	PROFILE_END(PROF_I2C_TX);
+	return error;
+}
+
+/*
+ *	----------------I2C0_Burst_Transmit-----------------
+ *	Transmit multiple bytes of data to specified peripheral
+ *  by incrementing starting slave address, in fragments for a
+ *	bulk device
+ *	Input: Slave address, Slave Register Address, Data Buffer to transmit
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
+	
+	const I2C_DEVICE_t* dev = I2C0_Device(slave_addr);
+	uint8_t error = 0;
+	uint32_t called = Time_Stamp(), n;
+	
+	/* Asserting Param */
+	if(size <= 0)
+		return 0;
+	
+	I2C0_Lock((I2C_PRIO_t)dev->Prio);
+	
+	/* The buffer goes out from its end, so do the fragments. Each one
+	   counts as a transfer of its own, from the end of the one before */
+	while(size > 0 && error == 0){
+		n = (dev->Fragment != 0 && size > dev->Fragment) ? dev->Fragment : size;
+		size -= n;
+		error = I2C0_Burst_Fragment(slave_addr, slave_reg_addr, &data[size], n, called);
+		called = Time_Stamp();
+		
+		/* Boundary: a real-time transfer waiting for the bus goes first */
+		if(size > 0 && dev->Prio == I2C_PRIO_BULK && I2C0_Urgent){
+			I2C0_UNLOCK();
+			I2C0_Lock(I2C_PRIO_BULK);
+		}
+	}
+	
+	I2C0_UNLOCK();
+	return error;
+}
+
+/*
+ *	----------------I2C0_Bus_Recover-----------------
+ *	Local helper, I2C0_Recover with the bus lock already held.
+ *	A slave cut off in the middle of a read holds SDA low until it
+ *	has clocked out the rest of its byte, so SCL is clocked as a
+ *	GPIO until SDA reads high, then a STOP resets every slave and
+ *	the module is reset and set up again
+ *	Input: None
+ *	Output: SCL clocks given before SDA was released,
+ *	I2C_RECOVER_CLOCKS if it never was
+ */
+static uint8_t I2C0_Bus_Recover(void){
+	uint8_t clocks = 0;
+	
+	/* Both pins as open drain GPIO, released high. SDA is only read for now */
+	I2C0_MCR_R &= ~EN_I2C0_MASTER;
+	I2C0_SCL_OUT(1);
+	I2C0_SDA_OUT(1);
+	GPIO_PORTB_ODR_R |= I2C0_PINS;
+	GPIO_PORTB_DIR_R = (GPIO_PORTB_DIR_R & ~I2C0_SDA_PIN) | I2C0_SCL_PIN;
+	GPIO_PORTB_AFSEL_R &= ~I2C0_PINS;
+	TIME_SPIN_US(I2C_RECOVER_HALF_US);
+	
+	/* Clock SCL until the slave lets go of SDA, a byte and its ACK at most */
+	while(!I2C0_SDA_IN() && clocks < I2C_RECOVER_CLOCKS){
+		I2C0_SCL_OUT(0);
+		TIME_SPIN_US(I2C_RECOVER_HALF_US);
+		I2C0_SCL_OUT(1);
+		TIME_SPIN_US(I2C_RECOVER_HALF_US);
+		clocks++;
+	}
+	
+	/* STOP: SDA low to high while SCL is high */
+	I2C0_SCL_OUT(0);
+	I2C0_SDA_OUT(0);
+	GPIO_PORTB_DIR_R |= I2C0_SDA_PIN;
+	TIME_SPIN_US(I2C_RECOVER_HALF_US);
+	I2C0_SCL_OUT(1);
+	TIME_SPIN_US(I2C_RECOVER_HALF_US);
+	I2C0_SDA_OUT(1);
+	TIME_SPIN_US(I2C_RECOVER_HALF_US);
+	
+	/* Pins back to I2C0 as I2C0_Init left them, then a fresh module */
+	GPIO_PORTB_DIR_R &= ~I2C0_PINS;
+	GPIO_PORTB_ODR_R &= ~I2C0_SCL_PIN;
+	GPIO_PORTB_AFSEL_R |= I2C0_PINS;
+	I2C0_MODULE_RESET();
+	I2C0_Master_Setup();
+	
+	return clocks;
+}
+
+uint8_t I2C0_Recover(void){
+	uint8_t clocks;
+	
+	I2C0_Lock(I2C_PRIO_BULK);
+	clocks = I2C0_Bus_Recover();
+	I2C0_UNLOCK();
+	return clocks;
+}
+
+uint32_t I2C0_Speed_MTPR(I2C_SPEED_t speed){
+	return I2C0_Speed_Mtpr[speed];
+}
+
+uint32_t I2C0_Speed_HZ(I2C_SPEED_t speed){
+	uint32_t tpr = I2C0_Speed_Mtpr[speed] & I2C_MTPR_TPR_M;
+	
+	return SYSCLK_HZ/(I2C0_Speed_Period[speed]*(tpr + 1));
+}
+
+I2C_SPEED_t I2C0_Device_Speed(uint8_t slave_addr){
+	return (I2C_SPEED_t)I2C0_Device(slave_addr)->Speed;
+}
+
+I2C_PRIO_t I2C0_Device_Prio(uint8_t slave_addr){
+	return (I2C_PRIO_t)I2C0_Device(slave_addr)->Prio;
+}
+
+uint8_t I2C0_Device_Fragment(uint8_t slave_addr){
+	return I2C0_Device(slave_addr)->Fragment;
+}
+
+uint8_t I2C0_Stats_Count(void){
+	return I2C0_Stats_Used;
+}
+
+void I2C0_Stats_Read(uint8_t slot, I2C_STATS_t* st){
+	long sr = StartCritical();
+	
+	*st = I2C0_Stats[slot];
+	EndCritical(sr);
+}
+
+uint64_t I2C0_Stats_Window(void){
+	return Time_Now_Cycles() - I2C0_Stats_Since;
+}
+
+void I2C0_Stats_Reset(void){
+	long sr = StartCritical();
+	
+	memset(I2C0_Stats, 0, sizeof(I2C0_Stats));
+	I2C0_Stats_Used = 0;
+	I2C0_Stats_Since = Time_Now_Cycles();
+	EndCritical(sr);
+}
@@ -1,87 +1,277 @@
-/*
- * I2C.h
- *
- *	Provides the I2C Init, Read, and Write Function
- *
- * Created on: November 13, 2024
- *		Author: Oliver Cabral and Jason Chan
- *
- */
-
-#ifndef I2C_H_
-#define I2C_H_
-
-#include <stdint.h>
-#include "tm4c123gh6pm.h"
-#include "util.h"
-
-#include "UART0.h"
-
-/* List of Fill In Macros */
-
-//Init Function
-//B2 = SCL
-//B3 = SDA
-#define EN_I2C0_CLOCK			(0x1)
-#define EN_GPIOB_CLOCK		(0x2)
-#define I2C0_PINS					(0xC)
-#define I2C0_ALT_FUNC_MSK	(0xFFFF00FF)
-#define I2C0_ALT_FUNC_SET	(0x00003300)
-#define I2C0_SDA_PIN			(0x8)
-#define I2C0_SCL_PIN			(0x4)
-#define EN_I2C0_MASTER		(0x10)
-#define I2C_MTPR_TPR_VALUE	(19)
-#define I2C_MTPR_STD_SPEED (0x00)
-
-//Transmit Function (Most came from above Macros)
-#define I2C0_RW_PIN				(0x1)
-
-//Burst Transmit Function
-#define RUN_CMD						(I2C_MCS_RUN)
-
-/*
- *	-------------------I2C0_Init------------------
- *	Basic I2C Initialization function for master mode @ 100kHz
- *	Input: None
- *	Output: None
- */
-void I2C0_Init(void);
-
-/*
- *	-------------------I2C0_Receive------------------
- *	Polls to receive data from specified peripheral
- *	Input: Slave address & Slave Register Address
- *	Output: Returns 8-bit data that has been received
- */
-uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr);
-
-/*
- *	-------------------I2C0_Transmit------------------
- *	Transmit a byte of data to specified peripheral
- *	Input: Slave address, Slave Register Address, Data to Transmit
- *	Output: Any Errors if detected, otherwise 0
- */
-uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data);
-
-//Has Yet to be Implemented
-/*
- *	----------------I2C0_Burst_Receive-----------------
- *	Polls to receive multiple bytes of data from specified
- *  peripheral by incrementing starting slave register address
- *	Input: Slave address, Slave Register Address, Data Buffer
- *	Output: None
- */
-void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
-
-/*
- *	----------------I2C0_Burst_Transmit-----------------
- *	Transmit multiple bytes of data to specified peripheral
- *  by incrementing starting slave address
- *	Input: Slave address, Slave Register Address, Data Buffer to transmit, Size of Transmit
- *	Output: None
- */
-uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
-
-#endif //I2C_H_
-
-
+/*
+ * I2C.h
+ *
+ *	Provides the I2C Init, Read, and Write Function
+ *
+ *	Each transfer runs at the fastest SCL rate its slave takes, from
+ *	I2CTable.h. The rates and their MTPR values are the compile-time
+ *	I2C_SPEED_TABLE below.
+ *
+ *	Every transfer has a deadline from its length (I2C_TIMEOUT_US).
+ *	A transfer that misses it, a slave holding SDA low or a stuck
+ *	master, frees the bus with I2C0_Recover and returns
+ *	I2C_ERR_TIMEOUT. Errors are always returned apart from the data.
+ *	Once the kernel runs, a task waiting for its transfer blocks and
+ *	the other tasks get the CPU, before that the core sleeps.
+ *
+ *	Each device also has a priority (I2CTable.h). A write to a bulk
+ *	device, the LCD, goes out in fragments of its own transfer,
+ *	split where the device takes a STOP in between, and a real-time
+ *	transfer waiting for the bus gets it at the next fragment
+ *	boundary. A sensor read then waits at most one fragment, not a
+ *	whole write. The bus lock has no priority inheritance, so this
+ *	only holds while no task between the writer and the reader in
+ *	priority runs long CPU work: keep such tasks below every task
+ *	that uses the bus (MODULE_TEST_MAIN_PRIO in ModuleTest.h).
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef I2C_H_
+#define I2C_H_
+
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+#include "util.h"
+
+#include "UART0.h"
+#include "Time.h"
+
+/* List of Fill In Macros */
+
+//Init Function
+//B2 = SCL
+//B3 = SDA
+#define EN_I2C0_CLOCK			(0x1)
+#define EN_GPIOB_CLOCK		(0x2)
+#define I2C0_PINS					(0xC)
+#define I2C0_ALT_FUNC_MSK	(0xFFFF00FF)
+#define I2C0_ALT_FUNC_SET	(0x00003300)
+#define I2C0_SDA_PIN			(0x8)
+#define I2C0_SCL_PIN			(0x4)
+#define EN_I2C0_MASTER		(0x10)
+#define I2C_SCL_HZ				(100000UL)			//Standard mode, the slowest rate in use
+
+/*
+ *	--------------------I2C_TPR------------------------
+ *	MTPR timer period for an SCL rate,
+ *		TPR = SYSCLK_HZ / (2*(SCL_LP + SCL_HP) * SCL) - 1
+ *	rounded up so the rate is never above the nominal one, and at
+ *	least 1, the fastest the module runs (below the nominal rate
+ *	when SYSCLK_HZ is too slow for it)
+ *	Input: SCL rate in Hz, SCL_LP + SCL_HP of the mode
+ *	Output: TPR value
+ */
+#define I2C_TPR_DIV(hz, lp_hp)	((SYSCLK_HZ + 2UL*(lp_hp)*(hz) - 1)/(2UL*(lp_hp)*(hz)))
+#define I2C_TPR(hz, lp_hp)		((I2C_TPR_DIV(hz, lp_hp) > 1) ? I2C_TPR_DIV(hz, lp_hp) - 1 : 1)
+
+#define I2C_MTPR_TPR_VALUE	I2C_TPR(I2C_SCL_HZ, 6 + 4)
+#define I2C_MTPR_STD_SPEED (0x00)
+
+#if I2C_MTPR_TPR_VALUE > 127
+#error "I2C_SCL_HZ cannot be generated from SYSCLK_HZ"
+#endif
+
+/* SCL rates the module can run, each entry is
+	I2C_SPEED(id, nominal rate in Hz, SCL_LP + SCL_HP, MTPR HS bit)
+   SCL_LP and SCL_HP are fixed, 6 and 4 up to fast mode plus, 2 and 1 in
+   high-speed mode, where START commands also carry the MCS HS bit */
+#define I2C_SPEED_TABLE \
+	I2C_SPEED(I2C_SPEED_STD,				100000UL,		6 + 4,	0) \
+	I2C_SPEED(I2C_SPEED_FAST,				400000UL,		6 + 4,	0) \
+	I2C_SPEED(I2C_SPEED_FAST_PLUS,	1000000UL,	6 + 4,	0) \
+	I2C_SPEED(I2C_SPEED_HIGH,				3330000UL,	2 + 1,	I2C_MTPR_HS)
+
+#define I2C_SPEED(id, hz, lp_hp, hs)		id,
+typedef enum{
+	I2C_SPEED_TABLE
+	I2C_SPEED_COUNT
+} I2C_SPEED_t;
+#undef I2C_SPEED
+
+/* Transfer priorities, per device in I2CTable.h */
+typedef enum{
+	I2C_PRIO_RT,										//Reads the control loop waits on, never split
+	I2C_PRIO_BULK										//Long writes, split and handed over to I2C_PRIO_RT
+} I2C_PRIO_t;
+
+//Transmit Function (Most came from above Macros)
+#define I2C0_RW_PIN				(0x1)
+
+//Burst Transmit Function
+#define RUN_CMD						(I2C_MCS_RUN)
+
+/* Transfer errors, returned apart from the data, 0 when none */
+#define I2C_ERR_NONE			(0x00)
+#define I2C_ERR_ANY				(I2C_MCS_ERROR)				//Set with every controller error below
+#define I2C_ERR_NACK_ADDR	(I2C_MCS_ADRACK)
+#define I2C_ERR_NACK_DATA	(I2C_MCS_DATACK)
+#define I2C_ERR_ARB_LOST	(I2C_MCS_ARBLST)
+#define I2C_ERR_TIMEOUT		(I2C_MCS_CLKTO)				//Deadline passed, the bus was recovered (MCS clock timeout is not used)
+#define I2C_ERR_MASK			(I2C_ERR_ANY|I2C_ERR_NACK_ADDR|I2C_ERR_NACK_DATA|I2C_ERR_ARB_LOST|I2C_ERR_TIMEOUT)
+
+/* Deadline of one transfer: twice its bytes at I2C_SCL_HZ, plus a SysTick
+   period, as a stuck wait is only checked again when the core wakes up */
+#define I2C_BYTE_US				((9*1000000UL + I2C_SCL_HZ - 1)/I2C_SCL_HZ)
+#define I2C_TIMEOUT_US(bytes)	(1000000UL/TIME_TICK_HZ + 2*(bytes)*I2C_BYTE_US)
+
+/* Bus recovery, SCL clocked by hand until the slave lets go of SDA */
+#define I2C_RECOVER_CLOCKS	(9)
+#define I2C_RECOVER_HALF_US	((1000000UL + 2*I2C_SCL_HZ - 1)/(2*I2C_SCL_HZ))
+
+/* Bus statistics per slave address, kept by every transfer */
+#define I2C_STATS_SLOTS		(8)						//Addresses tracked, any later one shares the last slot
+#define I2C_STATS_OTHER		(0xFF)				//Address of the shared slot
+#define I2C_HIST_BINS			(16)					//log2 of the latency in us, 1 us to 65 ms
+
+typedef struct{
+	uint8_t Addr;										//7-bit slave address, I2C_STATS_OTHER for the shared slot
+	uint32_t Transactions;
+	uint32_t Bytes;									//Address and register bytes included
+	uint32_t Nacks;									//Transfers with an address or data byte not acknowledged
+	uint32_t Arb_Lost;							//Transfers that lost the bus to another master
+	uint32_t Timeouts;							//Transfers past their deadline, each one recovered the bus
+	uint64_t Busy_Cycles;						//Bus held, from the START to the end of the STOP
+	uint32_t Max_Latency_US;				//Call to return, bus lock wait included
+	uint32_t Hist[I2C_HIST_BINS];		//Latency, bin b counts 2^b to 2^(b+1)-1 us
+} I2C_STATS_t;
+
+/*
+ *	-------------------I2C0_Init------------------
+ *	Basic I2C Initialization function for master mode @ 100kHz,
+ *	each transfer then runs at the speed of its device (I2CTable.h)
+ *	Input: None
+ *	Output: None
+ */
+void I2C0_Init(void);
+
+/*
+ *	------------------I2C0_Speed_MTPR-----------------
+ *	Input: Speed
+ *	Output: MTPR value of the speed, TPR and HS bit
+ */
+uint32_t I2C0_Speed_MTPR(I2C_SPEED_t speed);
+
+/*
+ *	-------------------I2C0_Speed_HZ------------------
+ *	Input: Speed
+ *	Output: SCL rate the MTPR value gives at SYSCLK_HZ, at most
+ *	the nominal one
+ */
+uint32_t I2C0_Speed_HZ(I2C_SPEED_t speed);
+
+/*
+ *	------------------I2C0_Device_Speed---------------
+ *	Input: Slave address
+ *	Output: Speed of the address in I2CTable.h, I2C_SPEED_STD if
+ *	it is not listed
+ */
+I2C_SPEED_t I2C0_Device_Speed(uint8_t slave_addr);
+
+/*
+ *	------------------I2C0_Device_Prio----------------
+ *	Input: Slave address
+ *	Output: Priority of the address in I2CTable.h, I2C_PRIO_RT if
+ *	it is not listed
+ */
+I2C_PRIO_t I2C0_Device_Prio(uint8_t slave_addr);
+
+/*
+ *	----------------I2C0_Device_Fragment--------------
+ *	Input: Slave address
+ *	Output: Data bytes per transfer of a burst to the address,
+ *	0 if it is sent whole
+ */
+uint8_t I2C0_Device_Fragment(uint8_t slave_addr);
+
+/*
+ *	-------------------I2C0_Receive------------------
+ *	Receive a byte of data from specified peripheral
+ *	Input: Slave address, Slave Register Address, Received data
+ *	(written, 0 on an error)
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data);
+
+/*
+ *	-------------------I2C0_Transmit------------------
+ *	Transmit a byte of data to specified peripheral
+ *	Input: Slave address, Slave Register Address, Data to Transmit
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data);
+
+//Has Yet to be Implemented
+/*
+ *	----------------I2C0_Burst_Receive-----------------
+ *	Polls to receive multiple bytes of data from specified
+ *  peripheral by incrementing starting slave register address
+ *	Input: Slave address, Slave Register Address, Data Buffer
+ *	Output: None
+ */
+void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
+
+/*
+ *	----------------I2C0_Burst_Transmit-----------------
+ *	Transmit multiple bytes of data to specified peripheral
+ *  by incrementing starting slave address. The last byte of the
+ *	buffer goes out first. A bulk device gets it in fragments
+ *	(I2C0_Device_Fragment bytes each, from the end of the buffer),
+ *	every one with the register address and a STOP, and the first
+ *	error ends it
+ *	Input: Slave address, Slave Register Address, Data Buffer to transmit, Size of Transmit
+ *	Output: Any Errors if detected (I2C_ERR_xxx), otherwise 0
+ */
+uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
+
+/*
+ *	------------------I2C0_Recover--------------------
+ *	Free a stuck bus: clock SCL by hand until the slave holding
+ *	SDA low lets go (at most I2C_RECOVER_CLOCKS), generate a STOP
+ *	and reset the I2C0 module. Every transfer that misses its
+ *	deadline calls it before returning I2C_ERR_TIMEOUT. Call with
+ *	no transfer running
+ *	Input: None
+ *	Output: SCL clocks given before SDA was released,
+ *	I2C_RECOVER_CLOCKS if it never was
+ */
+uint8_t I2C0_Recover(void);
+
+/*
+ *	-----------------I2C0_Stats_Count------------------
+ *	Input: None
+ *	Output: Number of statistics slots in use, in order of the
+ *	first transfer to each address
+ */
+uint8_t I2C0_Stats_Count(void);
+
+/*
+ *	-----------------I2C0_Stats_Read-------------------
+ *	Copy the statistics of one slot, consistent even while a
+ *	transfer is being counted
+ *	Input: Slot (below I2C0_Stats_Count), Copy (written)
+ *	Output: None
+ */
+void I2C0_Stats_Read(uint8_t slot, I2C_STATS_t* st);
+
+/*
+ *	----------------I2C0_Stats_Window------------------
+ *	Input: None
+ *	Output: Cycles since the statistics were last reset, the
+ *	divisor for the bus utilization of a slot (Busy_Cycles)
+ */
+uint64_t I2C0_Stats_Window(void);
+
+/*
+ *	-----------------I2C0_Stats_Reset------------------
+ *	Forget every address and start a new window
+ *	Input: None
+ *	Output: None
+ */
+void I2C0_Stats_Reset(void);
+
+#endif //I2C_H_
+
+
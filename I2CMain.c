@@ -1,108 +1,194 @@
-/*
- * I2CTestMain.c
- *
- *	Test the basic functionality of I2C by reading and writing to the 
- *	TCS34727 RGB Sensor and MPU6050 6-dof IMU, as well as controlling
- *	a Servo Motor and a 16x2 LCD 
- *
- * Created on: November 13, 2024
- *		Author: Oliver Cabral and Jason Chan
- *
- */
- 
-#include "tm4c123gh6pm.h"
-#include "I2C.h"
-#include "UART0.h"
-#include "TCS34727.h"
-#include "MPU6050.h"
-#include "ButtonLED.h"
-#include "util.h"
-#include "Servo.h"
-#include "LCD.h"
-#include <stdio.h>
-#include <string.h>
-#include "ModuleTest.h"
-
-/* List of Predefined Macros for individual Peripheral Testing */
-//#define DELAY
-//#define UART
-//#define I2C
-//#define TCS34727
-//#define MPU6050
-//#define SERVO
-#define LCD
-//#define FULL_SYSTEM
-
-int main(void){
-	
-	/* Peripheral Initialization */
-	UART0_Init();
-	LED_Init();
-	BTN_Init();
-	
-	#if defined(DELAY) || defined(TCS34727) || defined(MPU6050) || defined(LCD) || defined(FULL_SYSTEM)	
-	WTIMER0_Init();
-	#endif
-	
-	#if defined (I2C) || defined(TCS34727) || defined(MPU6050) || defined(LCD) || defined(FULL_SYSTEM)
-	I2C0_Init();
-	#endif
-	
-	#if defined(TCS34727) || defined(FULL_SYSTEM)
-	/* Color Sensor Initialization */
-	TCS34727_Init();
-	#endif
-	
-	#if defined(MPU6050) || defined(FULL_SYSTEM)
-	/* MPU6050 Initialization */
-	MPU6050_Init();
-	#endif
-	
-	#if defined(SERVO) || defined(FULL_SYSTEM)
-	/* Servo Initialization */
-	Servo_Init();
-	#endif
-	
-	#if defined(LCD) || defined(FULL_SYSTEM)
-	/* LCD Initialization */
-	LCD_Init();
-	#endif
-	
-	while(1){
-		
-		#ifdef DELAY
-		Module_Test(DELAY_TEST);
-		#endif
-		
-		#ifdef UART
-		Module_Test(UART_TEST);
-		#endif
-		
-		#ifdef I2C
-		Module_Test(I2C_TEST);
-		#endif
-		
-		#ifdef MPU6050
-		Module_Test(MPU6050_TEST);
-		#endif
-		
-		#ifdef TCS34727
-		Module_Test(TCS34727_TEST);
-		#endif
-		
-		#ifdef SERVO
-		Module_Test(SERVO_TEST);
-		#endif
-		
-		#ifdef LCD
-		Module_Test(LCD_TEST);
-		#endif
-		
-		#ifdef FULL_SYSTEM
-		Module_Test(FULL_SYSTEM_TEST);
-		#endif
-		
-	}
-	
-	return 0;
-}
+/*
+ * I2CTestMain.c
+ *
+ *	Test the basic functionality of I2C by reading and writing to the 
+ *	TCS34727 RGB Sensor and MPU6050 6-dof IMU, as well as controlling
+ *	a Servo Motor and a 16x2 LCD 
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+ 
+#include "tm4c123gh6pm.h"
+#include "SysClock.h"
+#include "Time.h"
+#include "Timer.h"
+#include "Idle.h"
+#include "Sched.h"
+#include "Kernel.h"
+#include "I2C.h"
+#include "UART0.h"
+#include "Log.h"
+#include "Profile.h"
+#include "Param.h"
+#include "TCS34727.h"
+#include "MPU6050.h"
+#include "ButtonLED.h"
+#include "util.h"
+#include "Servo.h"
+#include "LCD.h"
+#include <string.h>
+#include "ModuleTest.h"
+#include "Shell.h"
+
+/* List of Predefined Macros to pick the test run at reset, the
+   shell "mode" command switches between them at runtime */
+//#define DELAY
+//#define UART
+//#define I2C
+//#define TCS34727
+//#define MPU6050
+//#define SERVO
+#define LCD
+//#define FULL_SYSTEM
+
+#if defined(FULL_SYSTEM)
+#define INITIAL_TEST		FULL_SYSTEM_TEST
+#elif defined(LCD)
+#define INITIAL_TEST		LCD_TEST
+#elif defined(SERVO)
+#define INITIAL_TEST		SERVO_TEST
+#elif defined(TCS34727)
+#define INITIAL_TEST		TCS34727_TEST
+#elif defined(MPU6050)
+#define INITIAL_TEST		MPU6050_TEST
+#elif defined(I2C)
+#define INITIAL_TEST		I2C_TEST
+#elif defined(UART)
+#define INITIAL_TEST		UART_TEST
+#else
+#define INITIAL_TEST		DELAY_TEST
+#endif
+
+#ifdef KERNEL_CONTROL
+#define MAIN_STACK_WORDS		(512)
+#define IDLE_STACK_WORDS		(128)
+
+static KERNEL_TASK_t Main_Task;
+static KERNEL_TASK_t Idle_Task;
+static uint32_t Main_Stack[MAIN_STACK_WORDS];
+static uint32_t Idle_Stack[IDLE_STACK_WORDS];
+#endif
+
+/*
+ *	-------------------Main_Service------------------
+ *	One pass of everything that is not a test stage task
+ *	Input: None
+ *	Output: None
+ */
+static void Main_Service(void){
+	
+	/* Highest priority task that is due, if any */
+	Sched_Run();
+	
+	/* Handle any command typed since the last pass */
+	Shell_Service();
+	
+	/* Advance any running LCD marquee, no-op otherwise */
+	LCD_Marquee_Service();
+	
+	/* Send whatever was logged during this pass */
+	Log_Flush();
+}
+
+#ifdef KERNEL_CONTROL
+/*
+ *	--------------------Main_Thread------------------
+ *	The main loop as a kernel task. Blocks until the next release or
+ *	an interrupt that brings work calls Idle_Notify, so a wake-up
+ *	between the check and the wait is never lost
+ *	Input: None
+ *	Output: None
+ */
+static void Main_Thread(void){
+	
+	while(1){
+		Main_Service();
+		if(!UART0_RX_Pending() && !LCD_Marquee_Pending())
+			Idle_Wait_Work(Sched_Next_Release());
+	}
+}
+
+/*
+ *	--------------------Idle_Thread------------------
+ *	Kernel idle task, runs when every other task is blocked and only
+ *	sleeps until the next kernel timeout or interrupt. It never
+ *	blocks, so it never touches I2C or the UART
+ *	Input: None
+ *	Output: None
+ */
+static void Idle_Thread(void){
+	long sr;
+	
+	while(1){
+		sr = StartCritical();
+		Idle_Until(IDLE_FOREVER);
+		EndCritical(sr);
+	}
+}
+#endif
+
+/*
+ *	--------------------Main_Loop--------------------
+ *	Everything that is not a test stage task, when the kernel does
+ *	not run
+ *	Input: None
+ *	Output: None
+ */
+static void Main_Loop(void){
+	long sr;
+	
+	while(1){
+		Main_Service();
+		
+		/* Nothing left to do, sleep until the next release or interrupt.
+		   Checked with interrupts masked so a wake-up cannot slip in
+		   between the check and the WFI */
+		sr = StartCritical();
+		if(!UART0_RX_Pending() && !LCD_Marquee_Pending())
+			Idle_Until(Sched_Next_Release());
+		EndCritical(sr);
+		
+	}
+}
+
+int main(void){
+	
+	/* Core Clock first, every peripheral timing is derived from it */
+	SysClock_Init();
+	Time_Init();
+	Timer_Init();
+	Idle_Init();
+	
+	/* Peripheral Initialization */
+	UART0_Init();
+	Log_Init();
+	Profile_Init();
+	Param_Init();
+	LED_Init();
+	Module_Test_Init();
+	BTN_Init();
+	
+	/* Brings up only the peripherals the selected test needs and
+	   enables its tasks */
+	Sched_Init();
+	Module_Test_Set_Mode(INITIAL_TEST);
+	
+	/* Send the init log records, expanded to text by the host tools */
+	Log_Flush();
+	
+	Shell_Init();
+	
+#ifdef KERNEL_CONTROL
+	/* Test stage tasks above the main loop task, the idle task only sleeps */
+	Module_Test_Kernel_Init();
+	Kernel_Task_Create(&Main_Task, "main", Main_Thread, Main_Stack, MAIN_STACK_WORDS, MODULE_TEST_MAIN_PRIO);
+	Kernel_Task_Create(&Idle_Task, "idle", Idle_Thread, Idle_Stack, IDLE_STACK_WORDS, KERNEL_PRIO_IDLE);
+	Kernel_Start();
+#endif
+	
+	Main_Loop();
+	
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * I2CTable.h
+ *
+ *	Table of every device on I2C0 and the fastest SCL rate it takes.
+ *	Included by I2C.c, which switches MTPR to the rate of the slave
+ *	address before each transfer. Each entry is
+ *
+ *		I2C_DEVICE(addr, speed, prio, frag)
+ *
+ *	with the 7-bit slave address, an I2C_SPEED_t, an I2C_PRIO_t and
+ *	the data bytes per fragment of a burst write (0 to send it
+ *	whole). Addresses not in the table run at I2C_SPEED_STD, as does
+ *	the bus recovery, with I2C_PRIO_RT and no fragments.
+ *
+ *	The MPU6050 and the TCS34727 both take fast mode, the PCF8574A of
+ *	the LCD backpack only standard mode. Every device sees the faster
+ *	traffic to the others, which the I2C spec allows as long as a
+ *	slow device never has to respond to it.
+ *
+ *	The sensor reads are real-time, the control loop waits on them.
+ *	The LCD is bulk and split after every HD44780 nibble pair (EN
+ *	high, EN low): the register byte of the next fragment writes
+ *	0x00 to the PCF8574A, which is harmless with EN already low but
+ *	would latch a wrong nibble in the middle of a pair. A character
+ *	costs two more bytes, a sensor read waits at most one fragment
+ *	(4 bytes at 100 kHz, ~0.4 ms) instead of the rest of a write.
+ *
+ * Created on: December 4, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef I2CTABLE_H_
+#define I2CTABLE_H_
+
+#define I2C_DEVICE_TABLE \
+	I2C_DEVICE(0x68,	I2C_SPEED_FAST,	I2C_PRIO_RT,		0)		/* MPU6050_ADDR_AD0_LOW */ \
+	I2C_DEVICE(0x69,	I2C_SPEED_FAST,	I2C_PRIO_RT,		0)		/* MPU6050_ADDR_AD0_HIGH */ \
+	I2C_DEVICE(0x29,	I2C_SPEED_FAST,	I2C_PRIO_RT,		0)		/* TCS34727_ADDR */ \
+	I2C_DEVICE(0x3F,	I2C_SPEED_STD,	I2C_PRIO_BULK,	2)		/* LCD_WRITE_ADDR, PCF8574A, one nibble pair */
+
+#endif
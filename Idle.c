@@ -0,0 +1,122 @@
+/*
+ * Idle.c
+ *
+ *	Main implementation of the low power waits. Idle_Until turns the
+ *	earliest of the deadline and the next kernel timeout into one
+ *	Timer.h one-shot, so the wheel's match interrupt is the only
+ *	periodic wake-up left while the core sleeps. Idle_Wait_Work is
+ *	a counting semaphore kept at 0 or 1, so a notify that comes
+ *	before the wait is not lost.
+ *
+ * Created on: December 2, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Idle.h"
+#include "Timer.h"
+#include "Kernel.h"
+
+/* Local Macros */
+#define IDLE_MAX_SLEEP_US			(0xFFFFFFFFUL)		//Longest Timer_Start delay, sleeps again after
+#define IDLE_MAX_WAIT_MS			(0x7FFFFFFFUL)		//Longest kernel timeout, waits again after
+
+/* WFI, the build may override it (host virtual clock) */
+#ifndef IDLE_PORT_WFI
+void WaitForInterrupt(void);  // low power mode until the next interrupt
+#define IDLE_PORT_WFI()				WaitForInterrupt()
+#endif
+
+static uint64_t IdleAsleep;										//Cycles in WFI
+static uint64_t IdleSince;										//Start of the window
+static KERNEL_SEM_t IdleWork = {0, 0};				//Posted by Idle_Notify, at most once
+
+/*
+ *	---------------------Idle_Wake---------------------
+ *	Local wake-up timer function, the match interrupt itself ends
+ *	the WFI so there is nothing left to do
+ *	Input: Unused
+ *	Output: none
+ */
+static void Idle_Wake(void* arg){
+	(void)arg;
+}
+
+static TIMER_t Idle_Timer;
+
+void Idle_Init(void){
+	Timer_Setup(&Idle_Timer, Idle_Wake, 0);
+	Idle_Reset_Stats();
+}
+
+void Idle_Sleep(void){
+	uint64_t start = Time_Now_Cycles();
+
+	IDLE_PORT_WFI();
+	IdleAsleep += Time_Now_Cycles() - start;
+}
+
+void Idle_Until(TIME_US_t deadline){
+	TIME_US_t now = Time_Now_US();
+	TIME_US_t kernel;
+	uint32_t wake_ms, now_ms;
+
+	/* Kernel timeouts count ms ticks, Time_Tick_Resume makes them now_us/1000 */
+	if(Kernel_Next_Wake(&wake_ms)){
+		now_ms = (uint32_t)(now / 1000);
+		kernel = (now / 1000 + (int32_t)(wake_ms - now_ms)) * 1000;
+		if(kernel < deadline)
+			deadline = kernel;
+	}
+	if(deadline <= now)
+		return;
+
+	if(deadline != IDLE_FOREVER)
+		Timer_Start(&Idle_Timer, (deadline - now > IDLE_MAX_SLEEP_US) ? IDLE_MAX_SLEEP_US : (uint32_t)(deadline - now), 0);
+
+	Time_Tick_Suspend();
+	Idle_Sleep();
+	Time_Tick_Resume();
+	Timer_Stop(&Idle_Timer);
+}
+
+void Idle_Notify(void){
+	long sr;
+
+	if(!Kernel_Running())
+		return;
+	sr = StartCritical();
+	if(IdleWork.Count == 0)
+		Kernel_Sem_Post(&IdleWork);
+	EndCritical(sr);
+}
+
+void Idle_Wait_Work(TIME_US_t deadline){
+	TIME_US_t now = Time_Now_US();
+	TIME_US_t ms;
+
+	if(deadline <= now)
+		return;
+	if(deadline == IDLE_FOREVER){
+		Kernel_Sem_Pend(&IdleWork, KERNEL_WAIT_FOREVER);
+		return;
+	}
+	ms = (deadline - now + 999) / 1000;
+	Kernel_Sem_Pend(&IdleWork, (ms > IDLE_MAX_WAIT_MS) ? IDLE_MAX_WAIT_MS : (uint32_t)ms);
+}
+
+uint16_t Idle_Asleep_Permille(void){
+	uint64_t total = Time_Now_Cycles() - IdleSince;
+
+	if(total == 0)
+		return 0;
+	return (uint16_t)(IdleAsleep * 1000 / total);
+}
+
+void Idle_Reset_Stats(void){
+	long sr = StartCritical();
+
+	IdleAsleep = 0;
+	IdleSince = Time_Now_Cycles();
+	EndCritical(sr);
+}
@@ -0,0 +1,131 @@
+/*
+ * Idle.h
+ *
+ *	Provides the low power waits. Every wait sleeps the core with
+ *	WFI until an interrupt, instead of spinning on a flag:
+ *
+ *	  - IDLE_WAIT(cond) for driver waits on a condition an interrupt
+ *	    ends (I2C transfer done, UART ring, delay timer)
+ *	  - Idle_Until for the main loop (the kernel idle task when the
+ *	    kernel runs), which sleeps tickless until the next scheduler
+ *	    release or kernel timeout. SysTick is stopped and a Timer.h
+ *	    one-shot on the WTIMER1 match wakes the core, any other
+ *	    interrupt (UART, GPIO, I2C) wakes it early
+ *	  - Idle_Wait_Work for the main loop once it is a kernel task.
+ *	    It blocks until the next scheduler release or Idle_Notify,
+ *	    which the interrupts that bring it work call, and lets the
+ *	    idle task sleep
+ *
+ *	The condition is always checked with interrupts masked, WFI still
+ *	wakes on an interrupt that becomes pending while they are masked,
+ *	so a wake-up between the check and the WFI is never lost. The
+ *	interrupt runs once they are unmasked again.
+ *
+ *	Cycles spent in WFI are counted, Idle_Asleep_Permille gives the
+ *	fraction of time asleep since the last Idle_Reset_Stats.
+ *
+ *	WFI is a port macro, Host/idle_host_port.h replaces it with a
+ *	jump of the Time.h virtual clock (Host/idle_model.cpp).
+ *
+ * Created on: December 2, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+#include <stdint.h>
+#include "Time.h"
+
+/* Idle_Until deadline with nothing scheduled, sleep until an interrupt */
+#define IDLE_FOREVER					(0xFFFFFFFFFFFFFFFFULL)
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+/*
+ *	----------------------IDLE_WAIT--------------------
+ *	Sleep while a condition holds. An interrupt must end the wait,
+ *	its source has to be enabled in the NVIC. If the caller already
+ *	masked interrupts the handler cannot run, the condition should
+ *	then also be true of the raw hardware flag
+ *	Input: Condition, evaluated with interrupts masked
+ *	Output: none
+ */
+#define IDLE_WAIT(cond)	do{ \
+	long idle_sr = StartCritical(); \
+	while(cond){ \
+		Idle_Sleep(); \
+		EndCritical(idle_sr); \
+		idle_sr = StartCritical(); \
+	} \
+	EndCritical(idle_sr); \
+}while(0)
+
+/*
+ *	---------------------Idle_Init---------------------
+ *	Set up the wake-up timer and start the first measurement window.
+ *	Call after Timer_Init
+ *	Input: none
+ *	Output: none
+ */
+void Idle_Init(void);
+
+/*
+ *	---------------------Idle_Sleep--------------------
+ *	WFI once, counting the time asleep. Call with interrupts masked,
+ *	returns with them still masked
+ *	Input: none
+ *	Output: none
+ */
+void Idle_Sleep(void);
+
+/*
+ *	---------------------Idle_Until--------------------
+ *	Tickless sleep of the main loop, or of the kernel idle task. Sleeps
+ *	until the deadline, the next kernel timeout or any interrupt,
+ *	whichever is first, with SysTick stopped. Returns at once if the
+ *	deadline has passed. Call with interrupts masked, after checking
+ *	there is no other work, returns with them still masked
+ *	Input: Absolute deadline in us, IDLE_FOREVER for none
+ *	Output: none
+ */
+void Idle_Until(TIME_US_t deadline);
+
+/*
+ *	---------------------Idle_Notify-------------------
+ *	Wake the main loop task blocked in Idle_Wait_Work, or make its
+ *	next wait return at once. Safe to call from an interrupt, does
+ *	nothing before the kernel runs
+ *	Input: none
+ *	Output: none
+ */
+void Idle_Notify(void);
+
+/*
+ *	--------------------Idle_Wait_Work-----------------
+ *	Block the calling kernel task until the deadline or Idle_Notify.
+ *	Returns at once if the deadline has passed. Call with interrupts
+ *	enabled, after checking there is no other work
+ *	Input: Absolute deadline in us, IDLE_FOREVER for none
+ *	Output: none
+ */
+void Idle_Wait_Work(TIME_US_t deadline);
+
+/*
+ *	----------------Idle_Asleep_Permille---------------
+ *	Input: none
+ *	Output: Time asleep in WFI since the last reset, in 1/1000
+ */
+uint16_t Idle_Asleep_Permille(void);
+
+/*
+ *	------------------Idle_Reset_Stats-----------------
+ *	Start a new measurement window
+ *	Input: none
+ *	Output: none
+ */
+void Idle_Reset_Stats(void);
+
+#endif
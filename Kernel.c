@@ -0,0 +1,346 @@
+/*
+ * Kernel.c
+ *
+ *	Main implementation of the preemptive kernel. The ready tasks
+ *	are a 32-bit set with one bit per priority, so picking the next
+ *	task is a count of trailing zeros. Every change of the sets is
+ *	made with interrupts masked and ends in Kernel_Reschedule, which
+ *	pends PendSV when a different task should run.
+ *
+ * Created on: November 30, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Kernel.h"
+#include "Time.h"
+#include "tm4c123gh6pm.h"
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+/* Local Macros */
+#define KERNEL_BIT(prio)				(1UL << (prio))
+#define KERNEL_HIGHEST(set)			((uint8_t)__builtin_ctz(set))		//Lowest bit = highest priority
+
+/* Context switch port, the build may override it (host tests) */
+#ifndef KERNEL_PORT_PEND_SWITCH
+#define KERNEL_PENDSV_PRI				(0x00E00000)		//PendSV Priority 7, below every interrupt
+#define KERNEL_XPSR_THUMB				(0x01000000)
+#define KERNEL_EXC_RETURN_PSP		(0xFFFFFFFDUL)	//Thread mode, PSP, no FPU state
+
+#define KERNEL_PORT_PEND_SWITCH()	(NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV)
+#define KERNEL_PORT_STACK_INIT(top, func)	Kernel_Stack_Init(top, func)
+#define KERNEL_PORT_START()				Kernel_Port_Start()
+#define KERNEL_PORT_TARGET
+#endif
+
+KERNEL_TASK_t* volatile Kernel_Current;
+KERNEL_TASK_t* volatile Kernel_Next;
+
+static KERNEL_TASK_t* KernelTasks[KERNEL_PRIO_COUNT];
+static volatile uint32_t KernelReady;				//Bit per priority, ready to run
+static volatile uint32_t KernelTimed;				//Bit per priority, timeout pending
+static uint8_t KernelStarted;
+
+#ifdef KERNEL_PORT_TARGET
+/*
+ *	-------------------Kernel_Task_Exit----------------
+ *	Local helper a task returns into, stops the task for good
+ *	Input: none
+ *	Output: none
+ */
+static void Kernel_Task_Exit(void){
+	long sr = StartCritical();
+	KernelReady &= ~KERNEL_BIT(Kernel_Current->Prio);
+	KernelTasks[Kernel_Current->Prio] = 0;
+	Kernel_Next = KernelTasks[KERNEL_HIGHEST(KernelReady)];
+	KERNEL_PORT_PEND_SWITCH();
+	EndCritical(sr);
+	while(1);
+}
+
+/*
+ *	-------------------Kernel_Stack_Init---------------
+ *	Local helper to build the frames PendSV expects on a new stack,
+ *	as if the task had been switched out right before its first
+ *	instruction
+ *	Input: Top of the Stack, Task Function
+ *	Output: Initial Stack Pointer
+ */
+static uint32_t* Kernel_Stack_Init(uint32_t* top, void (*func)(void)){
+	uint32_t* sp = (uint32_t*)((uint32_t)top & ~7UL);		//AAPCS 8 byte alignment
+
+	/* Hardware frame, popped on exception return */
+	*--sp = KERNEL_XPSR_THUMB;											//xPSR
+	*--sp = (uint32_t)func;													//PC
+	*--sp = (uint32_t)Kernel_Task_Exit;							//LR
+	sp -= 5;																				//R12, R3-R0
+
+	/* Software frame, popped by PendSV */
+	*--sp = KERNEL_EXC_RETURN_PSP;									//EXC_RETURN
+	sp -= 8;																				//R11-R4
+	return sp;
+}
+
+/*
+ *	-------------------Kernel_Port_Start---------------
+ *	Local helper, PendSV below every interrupt, lazy FPU stacking,
+ *	then pend the first switch. There is no task to save yet
+ *	(Kernel_Current is 0), the main stack is left behind for the
+ *	interrupt handlers
+ *	Input: none
+ *	Output: none
+ */
+static void Kernel_Port_Start(void){
+	NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~NVIC_SYS_PRI3_PENDSV_M) | KERNEL_PENDSV_PRI;
+	NVIC_FPCC_R |= NVIC_FPCC_ASPEN | NVIC_FPCC_LSPEN;
+	Kernel_Current = 0;
+	Kernel_Next = KernelTasks[KERNEL_HIGHEST(KernelReady)];
+	KERNEL_PORT_PEND_SWITCH();
+}
+#endif
+
+/*
+ *	------------------Kernel_Reschedule----------------
+ *	Local helper, pend a switch if the highest ready task is not
+ *	the running one. Call with interrupts masked
+ *	Input: none
+ *	Output: none
+ */
+static void Kernel_Reschedule(void){
+	KERNEL_TASK_t* next;
+
+	if(!KernelStarted || KernelReady == 0)
+		return;
+	next = KernelTasks[KERNEL_HIGHEST(KernelReady)];
+	if(next != Kernel_Current){
+		Kernel_Next = next;
+		KERNEL_PORT_PEND_SWITCH();
+	}
+}
+
+/*
+ *	--------------------Kernel_Block-------------------
+ *	Local helper to take the running task off the ready set, with
+ *	an optional timeout. Call with interrupts masked, the switch
+ *	happens once they are unmasked
+ *	Input: Semaphore or 0, Timeout in ms
+ *	Output: none
+ */
+static void Kernel_Block(KERNEL_SEM_t* sem, uint32_t timeout_ms){
+	KERNEL_TASK_t* self = Kernel_Current;
+	uint32_t bit = KERNEL_BIT(self->Prio);
+
+	self->Wait = sem;
+	self->Result = 0;
+	if(sem)
+		sem->Waiting |= bit;
+	if(timeout_ms != KERNEL_WAIT_FOREVER){
+		self->Wake = Time_Now_MS() + timeout_ms;
+		KernelTimed |= bit;
+	}
+	KernelReady &= ~bit;
+	Kernel_Reschedule();
+}
+
+/*
+ *	--------------------Kernel_Wake--------------------
+ *	Local helper to make a blocked task ready again. Call with
+ *	interrupts masked
+ *	Input: Priority, Result the blocking call returns
+ *	Output: none
+ */
+static void Kernel_Wake(uint8_t prio, uint8_t result){
+	KERNEL_TASK_t* t = KernelTasks[prio];
+	uint32_t bit = KERNEL_BIT(prio);
+
+	if(t->Wait)
+		((KERNEL_SEM_t*)t->Wait)->Waiting &= ~bit;
+	t->Wait = 0;
+	t->Result = result;
+	KernelTimed &= ~bit;
+	KernelReady |= bit;
+}
+
+uint8_t Kernel_Task_Create(KERNEL_TASK_t* task, const char* name, void (*func)(void),
+													 uint32_t* stack, uint32_t words, uint8_t prio){
+	uint32_t i;
+	long sr;
+
+	if(prio >= KERNEL_PRIO_COUNT || KernelTasks[prio] || words < KERNEL_STACK_MIN_WORDS)
+		return 0;
+
+	for(i = 0; i < words; i++)
+		stack[i] = KERNEL_STACK_FILL;
+
+	task->Name = name;
+	task->Stack = stack;
+	task->Stack_Words = words;
+	task->Prio = prio;
+	task->Wait = 0;
+	task->Result = 0;
+	task->Sp = KERNEL_PORT_STACK_INIT(stack + words, func);
+
+	sr = StartCritical();
+	KernelTasks[prio] = task;
+	KernelReady |= KERNEL_BIT(prio);
+	Kernel_Reschedule();
+	EndCritical(sr);
+	return 1;
+}
+
+void Kernel_Start(void){
+	long sr = StartCritical();
+	KernelStarted = 1;
+	KERNEL_PORT_START();
+	EndCritical(sr);
+}
+
+uint8_t Kernel_Running(void){
+	return KernelStarted;
+}
+
+void Kernel_Tick(void){
+	uint32_t now, timed;
+	uint8_t prio;
+	long sr;
+
+	if(!KernelStarted)
+		return;
+
+	sr = StartCritical();
+	now = Time_Now_MS();
+	timed = KernelTimed;
+	while(timed){
+		prio = KERNEL_HIGHEST(timed);
+		timed &= timed - 1;
+		if((int32_t)(now - KernelTasks[prio]->Wake) >= 0)
+			Kernel_Wake(prio, 0);
+	}
+	Kernel_Reschedule();
+	EndCritical(sr);
+}
+
+uint8_t Kernel_Next_Wake(uint32_t* wake_ms){
+	uint32_t now, timed, best = 0;
+	uint8_t prio, found = 0;
+	long sr = StartCritical();
+
+	now = Time_Now_MS();
+	timed = KernelTimed;
+	while(timed){
+		prio = KERNEL_HIGHEST(timed);
+		timed &= timed - 1;
+		if(!found || (int32_t)(KernelTasks[prio]->Wake - now) < (int32_t)(best - now)){
+			best = KernelTasks[prio]->Wake;
+			found = 1;
+		}
+	}
+	EndCritical(sr);
+	if(found)
+		*wake_ms = best;
+	return found;
+}
+
+void Kernel_Sleep(uint32_t ms){
+	long sr;
+
+	if(ms == 0)
+		return;
+	sr = StartCritical();
+	Kernel_Block(0, ms);
+	EndCritical(sr);
+}
+
+void Kernel_Delay_Until(uint32_t* last, uint32_t period_ms){
+	int32_t left;
+
+	*last += period_ms;
+	left = (int32_t)(*last - Time_Now_MS());
+	if(left > 0)
+		Kernel_Sleep((uint32_t)left);
+	else if((uint32_t)-left >= period_ms)			//Missed a whole period, restart from now
+		*last = Time_Now_MS();
+}
+
+void Kernel_Sem_Init(KERNEL_SEM_t* sem, uint32_t count){
+	sem->Count = count;
+	sem->Waiting = 0;
+}
+
+uint8_t Kernel_Sem_Pend(KERNEL_SEM_t* sem, uint32_t timeout_ms){
+	KERNEL_TASK_t* self = Kernel_Current;
+	long sr = StartCritical();
+
+	if(sem->Count){
+		sem->Count--;
+		EndCritical(sr);
+		return 1;
+	}
+	if(timeout_ms == 0){
+		EndCritical(sr);
+		return 0;
+	}
+	Kernel_Block(sem, timeout_ms);
+	EndCritical(sr);									//Switches away here until posted or timed out
+	return self->Result;
+}
+
+void Kernel_Sem_Post(KERNEL_SEM_t* sem){
+	long sr = StartCritical();
+
+	if(sem->Waiting){
+		Kernel_Wake(KERNEL_HIGHEST(sem->Waiting), 1);
+		Kernel_Reschedule();
+	}else{
+		sem->Count++;
+	}
+	EndCritical(sr);
+}
+
+void Kernel_Queue_Init(KERNEL_QUEUE_t* q, uint32_t* buf, uint16_t size){
+	q->Buf = buf;
+	q->Size = size;
+	q->Head = 0;
+	q->Tail = 0;
+	q->Dropped = 0;
+	Kernel_Sem_Init(&q->Items, 0);
+}
+
+uint8_t Kernel_Queue_Send(KERNEL_QUEUE_t* q, uint32_t msg){
+	uint16_t next;
+	long sr = StartCritical();
+
+	next = (uint16_t)((q->Head + 1) % q->Size);
+	if(next == q->Tail){
+		q->Dropped++;
+		EndCritical(sr);
+		return 0;
+	}
+	q->Buf[q->Head] = msg;
+	q->Head = next;
+	Kernel_Sem_Post(&q->Items);
+	EndCritical(sr);
+	return 1;
+}
+
+uint8_t Kernel_Queue_Receive(KERNEL_QUEUE_t* q, uint32_t* msg, uint32_t timeout_ms){
+	long sr;
+
+	if(!Kernel_Sem_Pend(&q->Items, timeout_ms))
+		return 0;
+	sr = StartCritical();
+	*msg = q->Buf[q->Tail];
+	q->Tail = (uint16_t)((q->Tail + 1) % q->Size);
+	EndCritical(sr);
+	return 1;
+}
+
+uint32_t Kernel_Stack_Unused(const KERNEL_TASK_t* task){
+	uint32_t i = 0;
+
+	while(i < task->Stack_Words && task->Stack[i] == KERNEL_STACK_FILL)
+		i++;
+	return i;
+}
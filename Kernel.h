@@ -0,0 +1,166 @@
+/*
+ * Kernel.h
+ *
+ *	Provides a minimal fixed priority preemptive kernel. Each task
+ *	has its own priority (0 is the highest, KERNEL_PRIO_IDLE the
+ *	lowest) and its own stack, and the highest priority ready task
+ *	always runs. A task gives up the CPU only by blocking (sleep,
+ *	semaphore, queue), anything an interrupt makes ready preempts
+ *	the running task as soon as the interrupt returns.
+ *
+ *	Context switches happen in PendSV (KernelPort.s) at the lowest
+ *	exception priority. FPU registers are saved only for tasks that
+ *	used the FPU (lazy stacking, EXC_RETURN bit 4).
+ *
+ *	Timeouts count Time_Now_MS ticks, Kernel_Tick runs from the
+ *	SysTick interrupt in Time.c.
+ *
+ *	Semaphores and queues may be posted from interrupts. Pend,
+ *	Receive, Sleep and Delay_Until block and must only be called
+ *	from a task.
+ *
+ *	The switch and stack setup are port macros, Host/kernel_host_port.h
+ *	replaces them so the scheduling logic runs on the host.
+ *
+ * Created on: November 30, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include <stdint.h>
+
+#define KERNEL_PRIO_COUNT				(32)
+#define KERNEL_PRIO_IDLE				(KERNEL_PRIO_COUNT - 1)
+#define KERNEL_WAIT_FOREVER			(0xFFFFFFFFUL)
+#define KERNEL_STACK_MIN_WORDS	(64)			//Both exception frames with FPU state, plus margin
+#define KERNEL_STACK_FILL				(0xA5A5A5A5UL)
+
+/* Task Control Block, Sp must stay the first member (KernelPort.s) */
+typedef struct{
+	uint32_t* Sp;									//Saved stack pointer while not running
+	const char* Name;
+	uint32_t* Stack;							//Lowest word, for Kernel_Stack_Unused
+	uint32_t Stack_Words;
+	uint32_t Wake;								//Time_Now_MS the timeout expires
+	void* Wait;										//Semaphore blocked on, 0 if none
+	uint8_t Prio;
+	uint8_t Result;								//1 = woken by a post, 0 = timed out
+} KERNEL_TASK_t;
+
+/* Counting semaphore */
+typedef struct{
+	volatile uint32_t Count;
+	volatile uint32_t Waiting;		//Bit per priority of the blocked tasks
+} KERNEL_SEM_t;
+
+/* Queue of 32-bit messages, holds Size - 1 */
+typedef struct{
+	uint32_t* Buf;
+	uint16_t Size;
+	volatile uint16_t Head;
+	volatile uint16_t Tail;
+	KERNEL_SEM_t Items;
+	volatile uint32_t Dropped;		//Sends rejected because the queue was full
+} KERNEL_QUEUE_t;
+
+/* Current and next task, used by the context switch */
+extern KERNEL_TASK_t* volatile Kernel_Current;
+extern KERNEL_TASK_t* volatile Kernel_Next;
+
+/*
+ *	--------------------Kernel_Task_Create-------------
+ *	Add a task, before or after Kernel_Start. The task function
+ *	should never return, if it does the task just stops
+ *	Input: Task, Name, Function, Stack, Stack Size in Words, Priority
+ *	Output: 1 on success, 0 if the priority is taken or the stack is
+ *	too small
+ */
+uint8_t Kernel_Task_Create(KERNEL_TASK_t* task, const char* name, void (*func)(void),
+													 uint32_t* stack, uint32_t words, uint8_t prio);
+
+/*
+ *	---------------------Kernel_Start------------------
+ *	Switch to the highest priority task. Create at least an idle
+ *	task at KERNEL_PRIO_IDLE first, it must never block. Does not
+ *	return on the target, the calling stack is abandoned
+ *	Input: none
+ *	Output: none
+ */
+void Kernel_Start(void);
+
+/*
+ *	--------------------Kernel_Running-----------------
+ *	Input: none
+ *	Output: 1 once Kernel_Start has been called
+ */
+uint8_t Kernel_Running(void);
+
+/*
+ *	---------------------Kernel_Tick-------------------
+ *	Wake tasks whose timeout has expired, called every SysTick
+ *	Input: none
+ *	Output: none
+ */
+void Kernel_Tick(void);
+
+/*
+ *	---------------------Kernel_Sleep------------------
+ *	Block the calling task for a number of ticks
+ *	Input: Time in ms
+ *	Output: none
+ */
+void Kernel_Sleep(uint32_t ms);
+
+/*
+ *	------------------Kernel_Delay_Until---------------
+ *	Block until *last + period, then advance *last. Returns at once
+ *	if that time has already passed, a caller more than a period
+ *	behind is restarted from now
+ *	Input: Last wake time in ms (updated), Period in ms
+ *	Output: none
+ */
+void Kernel_Delay_Until(uint32_t* last, uint32_t period_ms);
+
+/*
+ *	--------------------Kernel_Sem_xxx-----------------
+ *	Init sets the starting count. Pend takes one count, blocking up
+ *	to the timeout (0 = do not block). Post gives one count, or
+ *	wakes the highest priority waiter
+ *	Input: Semaphore, Count or Timeout in ms
+ *	Output: Pend returns 1 if taken, 0 on timeout
+ */
+void Kernel_Sem_Init(KERNEL_SEM_t* sem, uint32_t count);
+uint8_t Kernel_Sem_Pend(KERNEL_SEM_t* sem, uint32_t timeout_ms);
+void Kernel_Sem_Post(KERNEL_SEM_t* sem);
+
+/*
+ *	-------------------Kernel_Queue_xxx----------------
+ *	Send never blocks, so interrupts can use it, and drops the
+ *	message if the queue is full. Receive blocks up to the timeout
+ *	Input: Queue, Buffer and Size, Message or Timeout in ms
+ *	Output: 1 on success, 0 if full (Send) or timed out (Receive)
+ */
+void Kernel_Queue_Init(KERNEL_QUEUE_t* q, uint32_t* buf, uint16_t size);
+uint8_t Kernel_Queue_Send(KERNEL_QUEUE_t* q, uint32_t msg);
+uint8_t Kernel_Queue_Receive(KERNEL_QUEUE_t* q, uint32_t* msg, uint32_t timeout_ms);
+
+/*
+ *	-----------------Kernel_Next_Wake------------------
+ *	Earliest timeout of a blocked task, so the idle task can sleep
+ *	with the tick stopped until then
+ *	Input: Wake Time in ms (written when there is one)
+ *	Output: 1 if a timeout is pending, 0 otherwise
+ */
+uint8_t Kernel_Next_Wake(uint32_t* wake_ms);
+
+/*
+ *	-----------------Kernel_Stack_Unused---------------
+ *	Input: Task
+ *	Output: Words at the bottom of the stack never written
+ */
+uint32_t Kernel_Stack_Unused(const KERNEL_TASK_t* task);
+
+#endif
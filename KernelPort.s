@@ -0,0 +1,59 @@
+;******************************************************************************
+;
+; KernelPort.s
+;
+;	Context switch for the preemptive kernel (Kernel.c). PendSV runs
+;	at the lowest exception priority, after every interrupt that made
+;	a task ready. The hardware already pushed R0-R3, R12, LR, PC and
+;	xPSR (and S0-S15 if the task used the FPU) on the task stack, the
+;	rest is pushed here, so each suspended task stack holds
+;
+;		R4-R11, EXC_RETURN, [S16-S31], hardware frame
+;
+;	S16-S31 are only saved when EXC_RETURN bit 4 is clear, that is
+;	when the task has an active FPU context (lazy stacking).
+;
+; Created on: November 30, 2024
+;		Author: Oliver Cabral and Jason Chan
+;
+;******************************************************************************
+
+        AREA    |.text|, CODE, READONLY, ALIGN=2
+        THUMB
+        PRESERVE8
+
+        IMPORT  Kernel_Current
+        IMPORT  Kernel_Next
+        EXPORT  PendSV_Handler
+
+;*********** PendSV_Handler ***************
+; save the running task, switch to Kernel_Next
+; inputs:  Kernel_Current (0 on the first switch), Kernel_Next
+; outputs: Kernel_Current = Kernel_Next
+PendSV_Handler PROC
+        CPSID   I
+        LDR     R2, =Kernel_Current
+        LDR     R1, [R2]
+        CBZ     R1, PendSV_Restore      ; first switch, nothing to save
+        MRS     R0, PSP
+        TST     LR, #0x10               ; bit 4 clear = FPU frame
+        IT      EQ
+        VSTMDBEQ R0!, {S16-S31}
+        STMDB   R0!, {R4-R11, LR}
+        STR     R0, [R1]                ; Kernel_Current->Sp
+PendSV_Restore
+        LDR     R3, =Kernel_Next
+        LDR     R1, [R3]
+        STR     R1, [R2]                ; Kernel_Current = Kernel_Next
+        LDR     R0, [R1]                ; Kernel_Next->Sp
+        LDMIA   R0!, {R4-R11, LR}
+        TST     LR, #0x10
+        IT      EQ
+        VLDMIAEQ R0!, {S16-S31}
+        MSR     PSP, R0
+        CPSIE   I
+        BX      LR                      ; thread mode on PSP
+        ENDP
+
+        ALIGN                           ; make sure the end of this section is aligned
+        END
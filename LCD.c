@@ -1,187 +1,427 @@
-/*
- * LCD.c
- *
- *	Main Implementation of LCD functions such as initialization, sending
- *	commands and data, and basic functionalities
- *
- * Created on: July 26th, 2023
- *		Author: Jackie Huynh
- *
- */
- 
-#include "LCD.h"
-#include "tm4c123gh6pm.h"
-#include "util.h"
-#include "I2C.h"
-
-/*
- *	-------------------LCD_Send_CMD------------------
- *	Local LCD send commands function
- *	Input: Command to send
- *	Output: None
- */
-static void LCD_Send_CMD(uint8_t cmd){
-	
-	/* Temp Variables to hold upper and lower value */
-	uint8_t cmd_upper, cmd_lower;
-	uint8_t cmd_array[4];								//Command Array to Burst Transmit
-	
-	/* Seperate Upper and Lower Nibble */
-	cmd_upper = cmd &  UPPER_NIBBLE_MSK; // use UPPER_NIBBLE_MSK here
-	cmd_lower = cmd << NIBBLE_SHIFT;     // use UPPER_NIBBLE_MSK here
-	
-	/* LCD I2C Message Pattern */
-	cmd_array[3] = cmd_upper | (BACKLIGHT|EN_Pin);
-	cmd_array[2] = cmd_upper | BACKLIGHT;
-	cmd_array[1] = cmd_lower | (BACKLIGHT|EN_Pin);
-	cmd_array[0] = cmd_lower | BACKLIGHT;
-	
-	/* I2C Burst Transmit Command Array to LCD */
-	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, cmd_array, sizeof(cmd_array));
-}
-
-/*
- *	------------------LCD_Send_Data------------------
- *	Local LCD send data function
- *	Input: Data to send
- *	Output: None
- */
-static void LCD_Send_Data(uint8_t data){
-	
-	/* Temp Variables to hold upper and lower value */
-	uint8_t data_upper, data_lower;
-	uint8_t data_array[4];							//Data Array to Burst Transmit
-	
-	/* Seperate Upper and Lower Nibble */
-	data_upper = data & UPPER_NIBBLE_MSK; // use UPPER_NIBBLE_MSK here
-	data_lower = data << NIBBLE_SHIFT;     // use UPPER_NIBBLE_MSK here
-	
-	/* LCD I2C Message Pattern */
-	data_array[3] = data_upper | (BACKLIGHT|EN_Pin|RS_Pin);
-	data_array[2] = data_upper | (BACKLIGHT|RS_Pin);
-	data_array[1] = data_lower | (BACKLIGHT|EN_Pin|RS_Pin);
-	data_array[0] = data_lower | (BACKLIGHT|RS_Pin);
-	
-	/* I2C Burst Transmit Data Array to LCD */
-	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, data_array, sizeof(data_array));
-}
-
-/*
- *	-------------------LCD_Init------------------
- *	Basic LCD Initialization Function
- *	Input: None
- *	Output: None
- */
-void LCD_Init(void){
-	
-	//Some minor modification to the initialization 
-
-	/* Magic LCD Initialization */
-	DELAY_1MS(50);
-	I2C0_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, 0x00); //Turn off RS and R/W 
-	
-	LCD_Send_CMD(INIT_REG_CMD);
-	DELAY_1MS(5);
-	
-	LCD_Send_CMD(INIT_REG_CMD);
-	DELAY_1MS(5);
-	
-	LCD_Send_CMD(INIT_REG_CMD);
-	DELAY_1MS(1);
-	
-	LCD_Send_CMD(INIT_FUNC_CMD);
-	DELAY_1MS(10);
-	
-	/* 4-Bit Display Mode Initialization */
-	//Set Function to 4-Bit, 2 rows, and 5x8 Character
-	LCD_Send_CMD(FUNC_MODE|FUNC_4_BIT|FUNC_2_ROW|FUNC_5_7);
-	DELAY_1MS(1);
-	
-	//Turn off Display
-	LCD_Send_CMD(DISP_CMD|DISP_OFF|DISP_CURSOR_OFF|DISP_BLINK_OFF);
-	DELAY_1MS(1);
-	
-	//Clear Display
-	LCD_Send_CMD(CLEAR_DISP_CMD);
-	DELAY_1MS(2);
-	
-	//Set Entry Mode
-	LCD_Send_CMD(ENTRY_MODE_CMD|ENTRY_INC_CURSOR);
-	DELAY_1MS(1);
-	
-	//Turn on Display with cursor and blink enable
-	LCD_Send_CMD(DISP_CMD|DISP_ON|DISP_CURSOR_ON|DISP_BLINK_ON);
-}
-
-/*
- *	-------------------LCD_Clear------------------
- *	Clear the LCD Display by passing a command
- *	Input: None
- *	Output: None
- */
-void LCD_Clear(void){
-	LCD_Send_CMD(CLEAR_DISP_CMD);
-	DELAY_1MS(1);
-}
-
-/*
- *	----------------LCD_Set_Cursor----------------
- *	Set Cursor to Desire Place
- *	Input: Desired Row and Column to place Cursor
- *	Output: None
- */
-void LCD_Set_Cursor(uint8_t row, uint8_t col){
-	
-	/* Switch case based of row choice */
-	switch(row){
-		case ROW1:
-			col |= FIRST_ROW_CMD;
-			break;
-		case ROW2:
-			col |= SECOND_ROW_CMD;
-			break;
-		default:
-			col |= FIRST_ROW_CMD;
-			break;
-	}
-	
-	/* Send Command to set Row and Column */
-	LCD_Send_CMD(col);
-	DELAY_1MS(2);
-	
-}
-
-/*
- *	---------------LCD_Reset_Cursor---------------
- *	Reset Cursor back to Row 1 and Column 0
- *	Input: None
- *	Output: None
- */
-void LCD_Reset_Cursor(void){
-	LCD_Send_CMD(RETURN_HOME_CMD);
-	DELAY_1MS(1);
-}
-
-/*
- *	----------------LCD_Print_Char----------------
- *	Prints a Character to LCD
- *	Input: Character Hex Value
- *	Output: None
- */
-void LCD_Print_Char(uint8_t data){
-	LCD_Send_Data(data);
-	DELAY_1MS(1);
-}
-
-/*
- *	----------------LCD_Print_Str-----------------
- *	Prints a string to LCD
- *	Input: Pointer to Character Array
- *	Output: None
- */
-void LCD_Print_Str(uint8_t* str){
-	while(*str){
-		LCD_Send_Data(*str++);
-		DELAY_1MS(1);
-	}
-}
+/*
+ * LCD.c
+ *
+ *	Main Implementation of LCD functions such as initialization, sending
+ *	commands and data, and basic functionalities
+ *
+ * Created on: July 26th, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+#include "LCD.h"
+#include "tm4c123gh6pm.h"
+#include "util.h"
+#include "Time.h"
+#include "I2C.h"
+#include "Idle.h"
+#include "Format.h"
+#include "Profile.h"
+
+/* DDRAM start address of every row for the configured geometry */
+static const uint8_t LCD_Row_Offset[LCD_ROWS] = LCD_ROW_OFFSETS;
+
+/* Frame Buffer and copy of what is currently on the display */
+static uint8_t LCD_Frame[LCD_ROWS][LCD_COLS];
+static uint8_t LCD_Shown[LCD_ROWS][LCD_COLS];
+
+/* Marquee State: ticks are counted by TIMER1A, steps by the main loop */
+static volatile uint32_t LCD_Marquee_Ticks;
+static uint32_t LCD_Marquee_Steps;
+static uint8_t LCD_Marquee_Running;
+
+/* Execution time of the last write, the next one waits for it to end */
+static uint32_t LCD_Sent;										//Time_Stamp when the write ended
+static uint32_t LCD_Exec;										//Cycles the controller is busy after it
+
+/*
+ *	--------------------LCD_Hold------------------
+ *	Local helper to mark the controller busy from now
+ *	Input: Execution time in us
+ *	Output: None
+ */
+static void LCD_Hold(uint32_t us){
+	LCD_Sent = Time_Stamp();
+	LCD_Exec = (uint32_t)TIME_US_TO_CYCLES(us);
+}
+
+/*
+ *	-----------------LCD_Wait_Ready---------------
+ *	Local helper to wait out the execution time of the last write.
+ *	The I2C bytes in between usually cover it, then nothing is
+ *	waited. A long remainder sleeps, the last part is a busy wait
+ *	Input: None
+ *	Output: None
+ */
+static void LCD_Wait_Ready(void){
+	uint32_t elapsed = Time_Stamp() - LCD_Sent;
+	
+	if(elapsed >= LCD_Exec)
+		return;
+	if(LCD_Exec - elapsed > TIME_US_TO_CYCLES(LCD_SLEEP_MIN_US))
+		DELAY_US((LCD_Exec - elapsed)/SYSCLK_CYCLES_PER_US);
+	Time_Spin_Until(LCD_Sent, LCD_Exec);
+}
+
+/*
+ *	-------------------LCD_Send_CMD------------------
+ *	Local LCD send commands function
+ *	Input: Command to send
+ *	Output: None
+ */
+static void LCD_Send_CMD(uint8_t cmd){
+	
+	/* Temp Variables to hold upper and lower value */
+	uint8_t cmd_upper, cmd_lower;
+	uint8_t cmd_array[4];								//Command Array to Burst Transmit
+	
+	/* Seperate Upper and Lower Nibble */
+	cmd_upper = cmd &  UPPER_NIBBLE_MSK; // use UPPER_NIBBLE_MSK here
+	cmd_lower = cmd << NIBBLE_SHIFT;     // use UPPER_NIBBLE_MSK here
+	
+	/* LCD I2C Message Pattern */
+	cmd_array[3] = cmd_upper | (BACKLIGHT|EN_Pin);
+	cmd_array[2] = cmd_upper | BACKLIGHT;
+	cmd_array[1] = cmd_lower | (BACKLIGHT|EN_Pin);
+	cmd_array[0] = cmd_lower | BACKLIGHT;
+	
+	/* I2C Burst Transmit Command Array to LCD */
+	LCD_Wait_Ready();
+	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, cmd_array, sizeof(cmd_array));
+	
+	/* Clear and Return Home take far longer than the rest */
+	LCD_Hold((cmd == CLEAR_DISP_CMD || (cmd & ~1U) == RETURN_HOME_CMD) ? LCD_CLEAR_US : LCD_EXEC_US);
+}
+
+/*
+ *	------------------LCD_Send_Data------------------
+ *	Local LCD send data function
+ *	Input: Data to send
+ *	Output: None
+ */
+static void LCD_Send_Data(uint8_t data){
+	
+	/* Temp Variables to hold upper and lower value */
+	uint8_t data_upper, data_lower;
+	uint8_t data_array[4];							//Data Array to Burst Transmit
+	
+	/* Seperate Upper and Lower Nibble */
+	data_upper = data & UPPER_NIBBLE_MSK; // use UPPER_NIBBLE_MSK here
+	data_lower = data << NIBBLE_SHIFT;     // use UPPER_NIBBLE_MSK here
+	
+	/* LCD I2C Message Pattern */
+	data_array[3] = data_upper | (BACKLIGHT|EN_Pin|RS_Pin);
+	data_array[2] = data_upper | (BACKLIGHT|RS_Pin);
+	data_array[1] = data_lower | (BACKLIGHT|EN_Pin|RS_Pin);
+	data_array[0] = data_lower | (BACKLIGHT|RS_Pin);
+	
+	/* I2C Burst Transmit Data Array to LCD */
+	LCD_Wait_Ready();
+	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, data_array, sizeof(data_array));
+	LCD_Hold(LCD_EXEC_US);
+}
+
+/*
+ *	-------------------LCD_Init------------------
+ *	Basic LCD Initialization Function
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Init(void){
+	
+	uint8_t row, col;
+	
+	//Some minor modification to the initialization 
+
+	/* Magic LCD Initialization, waits from the HD44780 4-bit init by instruction */
+	LCD_Hold(LCD_POWER_ON_MS*1000U);
+	LCD_Wait_Ready();
+	I2C0_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, 0x00); //Turn off RS and R/W 
+	
+	LCD_Send_CMD(INIT_REG_CMD);
+	LCD_Hold(LCD_INIT_WAIT1_US);
+	
+	LCD_Send_CMD(INIT_REG_CMD);
+	LCD_Hold(LCD_INIT_WAIT2_US);
+	
+	LCD_Send_CMD(INIT_REG_CMD);
+	
+	LCD_Send_CMD(INIT_FUNC_CMD);
+	
+	/* 4-Bit Display Mode Initialization, every command waits for the one before */
+	//Set Function to 4-Bit, 2 rows, and 5x8 Character
+	LCD_Send_CMD(FUNC_MODE|FUNC_4_BIT|FUNC_2_ROW|FUNC_5_7);
+	
+	//Turn off Display
+	LCD_Send_CMD(DISP_CMD|DISP_OFF|DISP_CURSOR_OFF|DISP_BLINK_OFF);
+	
+	//Clear Display
+	LCD_Send_CMD(CLEAR_DISP_CMD);
+	
+	//Set Entry Mode
+	LCD_Send_CMD(ENTRY_MODE_CMD|ENTRY_INC_CURSOR);
+	
+	//Turn on Display with cursor and blink enable
+	LCD_Send_CMD(DISP_CMD|DISP_ON|DISP_CURSOR_ON|DISP_BLINK_ON);
+	
+	//Display is blank, start with a matching blank frame buffer
+	LCD_Buf_Clear();
+	for(row = 0; row < LCD_ROWS; row++){
+		for(col = 0; col < LCD_COLS; col++){
+			LCD_Shown[row][col] = ' ';
+		}
+	}
+}
+
+/*
+ *	-------------------LCD_Clear------------------
+ *	Clear the LCD Display by passing a command
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Clear(void){
+	LCD_Send_CMD(CLEAR_DISP_CMD);
+}
+
+/*
+ *	----------------LCD_Set_Cursor----------------
+ *	Set Cursor to Desire Place. Rows outside the configured
+ *	geometry fall back to Row 1
+ *	Input: Desired Row and Column to place Cursor
+ *	Output: None
+ */
+void LCD_Set_Cursor(uint8_t row, uint8_t col){
+	
+	/* Row Start Address comes straight from the geometry table */
+	if(row >= LCD_ROWS)
+		row = ROW1;
+	
+	/* Send Command to set Row and Column */
+	LCD_Send_CMD(SET_DDRAM_CMD | (LCD_Row_Offset[row] + col));
+	
+}
+
+/*
+ *	---------------LCD_Reset_Cursor---------------
+ *	Reset Cursor back to Row 1 and Column 0
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Reset_Cursor(void){
+	LCD_Send_CMD(RETURN_HOME_CMD);
+}
+
+/*
+ *	----------------LCD_Print_Char----------------
+ *	Prints a Character to LCD
+ *	Input: Character Hex Value
+ *	Output: None
+ */
+void LCD_Print_Char(uint8_t data){
+	LCD_Send_Data(data);
+}
+
+/*
+ *	----------------LCD_Print_Str-----------------
+ *	Prints a string to LCD
+ *	Input: Pointer to Character Array
+ *	Output: None
+ */
+void LCD_Print_Str(uint8_t* str){
+	while(*str){
+		LCD_Send_Data(*str++);
+	}
+}
+
+/*
+ *	---------------LCD_Print_Float----------------
+ *	Prints a float with a fixed number of decimals to LCD
+ *	without going through sprintf
+ *	Input: Value, Digits after the Decimal Point
+ *	Output: None
+ */
+void LCD_Print_Float(float val, uint8_t prec){
+	char buf[FORMAT_MAX_LEN+1];
+	Format_Float(buf, val, prec, 0);
+	LCD_Print_Str((uint8_t*)buf);
+}
+
+/*
+ *	-----------------LCD_Buf_Clear----------------
+ *	Fill the frame buffer with spaces. Nothing is sent to the
+ *	LCD until LCD_Flush is called
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Buf_Clear(void){
+	uint8_t row, col;
+	
+	for(row = 0; row < LCD_ROWS; row++){
+		for(col = 0; col < LCD_COLS; col++){
+			LCD_Frame[row][col] = ' ';
+		}
+	}
+}
+
+/*
+ *	-----------------LCD_Buf_Write----------------
+ *	Write a string into the frame buffer at a row and column.
+ *	Text past the end of the row is cut off
+ *	Input: Row, Column, Pointer to Character Array
+ *	Output: None
+ */
+void LCD_Buf_Write(uint8_t row, uint8_t col, const char* str){
+	
+	/* Assert Parameters */
+	if(row >= LCD_ROWS)
+		return;
+	
+	while(*str && col < LCD_COLS){
+		LCD_Frame[row][col++] = (uint8_t)*str++;
+	}
+}
+
+/*
+ *	-------------------LCD_Flush------------------
+ *	Send the part of every row of the frame buffer that changed
+ *	since the last flush to the LCD. Rows are rewritten in place
+ *	so the display does not need to be cleared and does not flicker
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Flush(void){
+	uint8_t row, first, last;
+	PROFILE_BEGIN(PROF_LCD_FLUSH);
+	
+	for(row = 0; row < LCD_ROWS; row++){
+		
+		/* Find the span of columns that differs from the display */
+		first = 0;
+		while(first < LCD_COLS && LCD_Frame[row][first] == LCD_Shown[row][first])
+			first++;
+		if(first == LCD_COLS)
+			continue;
+		last = LCD_COLS - 1;
+		while(LCD_Frame[row][last] == LCD_Shown[row][last])
+			last--;
+		
+		/* Rewrite only that span, the cursor auto increments */
+		LCD_Set_Cursor(row, first);
+		for(; first <= last; first++){
+			LCD_Send_Data(LCD_Frame[row][first]);
+			LCD_Shown[row][first] = LCD_Frame[row][first];
+		}
+	}
+	PROFILE_END(PROF_LCD_FLUSH);
+}
+
+/*
+ *	--------------LCD_Marquee_Start---------------
+ *	Write a message of up to 40 characters once into the DDRAM
+ *	line of a row and start scrolling it with the display shift
+ *	command. Every step costs a single command byte. The display
+ *	shift moves all rows together. A row that starts in the middle
+ *	of a DDRAM line (rows 3 and 4 of a 4-line panel) only gets the
+ *	rest of that line, the other rows on it are redrawn by the next
+ *	LCD_Flush
+ *	Input: Row, Pointer to Character Array, Step Period in ms
+ *	Output: None
+ */
+void LCD_Marquee_Start(uint8_t row, const char* msg, uint32_t step_ms){
+	uint8_t col, r, start, len;
+	
+	LCD_Marquee_Stop();
+	
+	/* Same fallback as LCD_Set_Cursor */
+	if(row >= LCD_ROWS)
+		row = ROW1;
+	
+	/* Write from the row to the end of its DDRAM line once, padded with spaces */
+	start = LCD_Row_Offset[row];
+	len = LCD_DDRAM_LINE_SIZE - (start - LCD_DDRAM_LINE(start));
+	LCD_Set_Cursor(row, 0);
+	for(col = 0; col < len; col++){
+		LCD_Send_Data(*msg ? (uint8_t)*msg++ : ' ');
+	}
+	
+	/* Every row sharing that part of the line now differs from the frame buffer copy, force a redraw later */
+	for(r = 0; r < LCD_ROWS; r++){
+		if(LCD_Row_Offset[r] + LCD_COLS <= start || LCD_Row_Offset[r] >= start + len)
+			continue;
+		for(col = 0; col < LCD_COLS; col++){
+			LCD_Shown[r][col] = 0;
+		}
+	}
+	
+	/* TIMER1A periodic interrupt every step_ms */
+	SYSCTL_RCGCTIMER_R |= EN_TIMER1_CLOCK;
+	while((SYSCTL_RCGCTIMER_R&EN_TIMER1_CLOCK) != EN_TIMER1_CLOCK);
+	
+	TIMER1_CTL_R &= ~TIMER_CTL_TAEN;						//Disable while configuring
+	TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;				//32-bit mode
+	TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;				//Periodic mode
+	TIMER1_TAILR_R = step_ms*LCD_TIMER_TICKS_PER_MS - 1;
+	TIMER1_ICR_R = TIMER_ICR_TATOCINT;						//Clear pending timeout
+	TIMER1_IMR_R |= TIMER_IMR_TATOIM;						//Arm timeout interrupt
+	NVIC_PRI5_R = (NVIC_PRI5_R&TIMER1A_PRI_MSK)|TIMER1A_PRI;
+	NVIC_EN0_R = NVIC_EN0_TIMER1A;
+	
+	LCD_Marquee_Steps = LCD_Marquee_Ticks;
+	LCD_Marquee_Running = 1;
+	TIMER1_CTL_R |= TIMER_CTL_TAEN;
+}
+
+/*
+ *	---------------LCD_Marquee_Stop---------------
+ *	Stop scrolling and shift the display back to its home position
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Marquee_Stop(void){
+	
+	if(!LCD_Marquee_Running)
+		return;
+	
+	TIMER1_CTL_R &= ~TIMER_CTL_TAEN;
+	TIMER1_IMR_R &= ~TIMER_IMR_TATOIM;
+	LCD_Marquee_Running = 0;
+	
+	/* Return Home also undoes any display shift */
+	LCD_Reset_Cursor();
+}
+
+/*
+ *	-------------LCD_Marquee_Service--------------
+ *	Non-blocking, call from the main loop. Sends one display shift
+ *	command for every timer tick that elapsed since the last call
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Marquee_Service(void){
+	
+	if(!LCD_Marquee_Running)
+		return;
+	
+	/* The DDRAM line wraps around, so shifting left forever is fine */
+	while(LCD_Marquee_Steps != LCD_Marquee_Ticks){
+		LCD_Send_CMD(SHIFT_CMD|SHIFT_DISPLAY|SHIFT_LEFT);
+		LCD_Marquee_Steps++;
+	}
+}
+
+uint8_t LCD_Marquee_Pending(void){
+	return LCD_Marquee_Running && LCD_Marquee_Steps != LCD_Marquee_Ticks;
+}
+
+/*
+ *	---------------Timer1A_Handler----------------
+ *	Marquee step timer, only counts ticks so the I2C bus is never
+ *	touched from interrupt context
+ *	Input: None
+ *	Output: None
+ */
+void Timer1A_Handler(void){
+	TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+	LCD_Marquee_Ticks++;
+	Idle_Notify();
+}
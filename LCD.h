@@ -1,111 +1,248 @@
-/*
- * LCD.h
- *
- *	Provides LCD functions such as initialization, sending
- *	commands and data, and basic functionalities
- *
- * Created on: July 26th, 2023
- *		Author: Jackie Huynh
- *
- */
- 
-#ifndef LCD_H_
-#define LCD_H_
-#include "util.h"
-
-/*************PCF8574A Register*************/
-#define LCD_WRITE_ADDR			(0x3FU)
-#define PCF8574A_REG				(0x00U)
-
-/**************LCD CMD Register*************/
-#define INIT_REG_CMD				(0x30U)
-#define INIT_FUNC_CMD				(0x20U)
-
-#define FUNC_MODE						(0x20U)
-	#define FUNC_4_BIT				(0x00U)
-	#define FUNC_2_ROW				(0x08U)
-	#define FUNC_5_7					(0x00U)
-	
-#define DISP_CMD						(0x08U)
-	#define DISP_ON						(0x04U)
-	#define DISP_OFF					(0x00U)
-	#define DISP_CURSOR_ON		(0x02U)
-	#define DISP_CURSOR_OFF		(0x00U)
-	#define DISP_BLINK_ON			(0x01U)
-	#define DISP_BLINK_OFF		(0x00U)
-	
-#define CLEAR_DISP_CMD			(0x01U)
-
-#define ENTRY_MODE_CMD			(0x04U)
-	#define ENTRY_INC_CURSOR	(0x02U)
-  #define ENTRY_DISP_SHIFT	(0x01U)
-	
-#define RETURN_HOME_CMD			(0x02U)
-
-#define FIRST_ROW_CMD				(0x80U)
-#define SECOND_ROW_CMD			(0xC0U)
-
-/* LCD Module Macros */
-#define RS_Pin							(0x01U)
-#define RW_Pin							(0x02U)
-#define EN_Pin							(0x04U)
-#define BACKLIGHT						(0x08U)
-
-/* General Macros */
-#define UPPER_NIBBLE_MSK		(0xF0U)
-#define NIBBLE_SHIFT				(0x4U)
-#define ROW1								(0U)
-#define ROW2								(1U)
-#define LCD_ROW_SIZE				(16)
-
-#include <stdint.h>
-
-/*
- *	-------------------LCD_Init------------------
- *	Basic LCD Initialization Function
- *	Input: None
- *	Output: None
- */
-void LCD_Init(void);
-
-/*
- *	-------------------LCD_Clear------------------
- *	Clear the LCD Display by passing a command
- *	Input: None
- *	Output: None
- */
-void LCD_Clear(void);
-
-/*
- *	----------------LCD_Set_Cursor----------------
- *	Set Cursor to Desire Place
- *	Input: Desired Row and Column to place Cursor
- *	Output: None
- */
-void LCD_Set_Cursor(uint8_t row, uint8_t col);
-
-/*
- *	---------------LCD_Reset_Cursor---------------
- *	Reset Cursor back to Row 1 and Column 0
- *	Input: None
- *	Output: None
- */
-void LCD_Reset_Cursor(void);
-
-/*
- *	----------------LCD_Print_Char----------------
- *	Prints a Character to LCD
- *	Input: Character Hex Value
- *	Output: None
- */
-void LCD_Print_Char(uint8_t data);
-
-/*
- *	----------------LCD_Print_Str-----------------
- *	Prints a string to LCD
- *	Input: Pointer to Character Array
- *	Output: None
- */
-void LCD_Print_Str(uint8_t* str);
-
-#endif
\ No newline at end of file
+/*
+ * LCD.h
+ *
+ *	Provides LCD functions such as initialization, sending
+ *	commands and data, and basic functionalities
+ *
+ * Created on: July 26th, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+#ifndef LCD_H_
+#define LCD_H_
+#include "util.h"
+
+/*************PCF8574A Register*************/
+#define LCD_WRITE_ADDR			(0x3FU)
+#define PCF8574A_REG				(0x00U)
+
+/**************LCD CMD Register*************/
+#define INIT_REG_CMD				(0x30U)
+#define INIT_FUNC_CMD				(0x20U)
+
+#define FUNC_MODE						(0x20U)
+	#define FUNC_4_BIT				(0x00U)
+	#define FUNC_2_ROW				(0x08U)
+	#define FUNC_5_7					(0x00U)
+	
+#define DISP_CMD						(0x08U)
+	#define DISP_ON						(0x04U)
+	#define DISP_OFF					(0x00U)
+	#define DISP_CURSOR_ON		(0x02U)
+	#define DISP_CURSOR_OFF		(0x00U)
+	#define DISP_BLINK_ON			(0x01U)
+	#define DISP_BLINK_OFF		(0x00U)
+	
+#define CLEAR_DISP_CMD			(0x01U)
+
+#define ENTRY_MODE_CMD			(0x04U)
+	#define ENTRY_INC_CURSOR	(0x02U)
+  #define ENTRY_DISP_SHIFT	(0x01U)
+	
+#define RETURN_HOME_CMD			(0x02U)
+
+#define SHIFT_CMD						(0x10U)
+	#define SHIFT_DISPLAY			(0x08U)
+	#define SHIFT_CURSOR			(0x00U)
+	#define SHIFT_RIGHT				(0x04U)
+	#define SHIFT_LEFT				(0x00U)
+
+#define SET_DDRAM_CMD				(0x80U)
+#define FIRST_ROW_CMD				(SET_DDRAM_CMD|0x00U)
+#define SECOND_ROW_CMD			(SET_DDRAM_CMD|0x40U)
+
+/*********HD44780 Execution Times**********/
+//Datasheet values at the 270 kHz internal oscillator
+#define LCD_POWER_ON_MS			(40U)			//Vcc rise to the first instruction
+#define LCD_INIT_WAIT1_US		(4100U)		//After the first 8-bit function set
+#define LCD_INIT_WAIT2_US		(100U)		//After the second
+#define LCD_EXEC_US					(37U)			//Any other instruction or data write
+#define LCD_CLEAR_US				(1520U)		//Clear display and return home
+#define LCD_SLEEP_MIN_US		(100U)		//Longer waits sleep in DELAY_US, shorter ones spin
+
+/*************Display Geometry**************/
+//Supported Panels
+#define LCD_16X2						(0)
+#define LCD_20X4						(1)
+#define LCD_40X2						(2)
+
+//Select the attached panel (can also be set from the project defines)
+#ifndef LCD_GEOMETRY
+#define LCD_GEOMETRY				LCD_16X2
+#endif
+
+/*
+	The HD44780 maps every row to a fixed DDRAM start address. Rows of
+	4-line panels are interleaved behind the 2 physical DDRAM lines
+	(row 3 continues row 1, row 4 continues row 2), so the offsets
+	depend on the column count. The offsets are expanded into a const
+	table in LCD.c so cursor addressing is a single lookup.
+*/
+#if LCD_GEOMETRY == LCD_16X2
+	#define LCD_ROWS					(2)
+	#define LCD_COLS					(16)
+	#define LCD_ROW_OFFSETS		{0x00U, 0x40U}
+#elif LCD_GEOMETRY == LCD_20X4
+	#define LCD_ROWS					(4)
+	#define LCD_COLS					(20)
+	#define LCD_ROW_OFFSETS		{0x00U, 0x40U, 0x14U, 0x54U}
+#elif LCD_GEOMETRY == LCD_40X2
+	#define LCD_ROWS					(2)
+	#define LCD_COLS					(40)
+	#define LCD_ROW_OFFSETS		{0x00U, 0x40U}
+#else
+	#error "LCD_GEOMETRY must be LCD_16X2, LCD_20X4 or LCD_40X2"
+#endif
+
+/* LCD Module Macros */
+#define RS_Pin							(0x01U)
+#define RW_Pin							(0x02U)
+#define EN_Pin							(0x04U)
+#define BACKLIGHT						(0x08U)
+
+/* General Macros */
+#define UPPER_NIBBLE_MSK		(0xF0U)
+#define NIBBLE_SHIFT				(0x4U)
+#define ROW1								(0U)
+#define ROW2								(1U)
+#define ROW3								(2U)
+#define ROW4								(3U)
+#define LCD_ROW_SIZE				(LCD_COLS)
+#define LCD_DDRAM_LINE_SIZE	(40)				//Every DDRAM line holds 40 characters
+#define LCD_DDRAM_LINE(addr)	((addr) & 0x40U)	//Start of the DDRAM line holding an address
+
+/* Marquee Timer Macros (TIMER1A) */
+#define EN_TIMER1_CLOCK			(0x02U)
+#define LCD_TIMER_TICKS_PER_MS	(SYSCLK_CYCLES_PER_MS)	//Runs at the system clock
+#define NVIC_EN0_TIMER1A		(0x00200000U)	//Interrupt 21
+#define TIMER1A_PRI_MSK			(0xFFFF1FFFU)
+#define TIMER1A_PRI					(0x0000A000U)	//Priority 5
+
+#include <stdint.h>
+
+/*
+ *	-------------------LCD_Init------------------
+ *	Basic LCD Initialization Function
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Init(void);
+
+/*
+ *	-------------------LCD_Clear------------------
+ *	Clear the LCD Display by passing a command
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Clear(void);
+
+/*
+ *	----------------LCD_Set_Cursor----------------
+ *	Set Cursor to Desire Place. Rows outside the configured
+ *	geometry fall back to Row 1
+ *	Input: Desired Row and Column to place Cursor
+ *	Output: None
+ */
+void LCD_Set_Cursor(uint8_t row, uint8_t col);
+
+/*
+ *	---------------LCD_Reset_Cursor---------------
+ *	Reset Cursor back to Row 1 and Column 0
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Reset_Cursor(void);
+
+/*
+ *	----------------LCD_Print_Char----------------
+ *	Prints a Character to LCD
+ *	Input: Character Hex Value
+ *	Output: None
+ */
+void LCD_Print_Char(uint8_t data);
+
+/*
+ *	----------------LCD_Print_Str-----------------
+ *	Prints a string to LCD
+ *	Input: Pointer to Character Array
+ *	Output: None
+ */
+void LCD_Print_Str(uint8_t* str);
+
+/*
+ *	---------------LCD_Print_Float----------------
+ *	Prints a float with a fixed number of decimals to LCD
+ *	without going through sprintf
+ *	Input: Value, Digits after the Decimal Point
+ *	Output: None
+ */
+void LCD_Print_Float(float val, uint8_t prec);
+
+/*
+ *	-----------------LCD_Buf_Clear----------------
+ *	Fill the frame buffer with spaces. Nothing is sent to the
+ *	LCD until LCD_Flush is called
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Buf_Clear(void);
+
+/*
+ *	-----------------LCD_Buf_Write----------------
+ *	Write a string into the frame buffer at a row and column.
+ *	Text past the end of the row is cut off
+ *	Input: Row, Column, Pointer to Character Array
+ *	Output: None
+ */
+void LCD_Buf_Write(uint8_t row, uint8_t col, const char* str);
+
+/*
+ *	-------------------LCD_Flush------------------
+ *	Send the part of every row of the frame buffer that changed
+ *	since the last flush to the LCD. Rows are rewritten in place
+ *	so the display does not need to be cleared and does not flicker
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Flush(void);
+
+/*
+ *	--------------LCD_Marquee_Start---------------
+ *	Write a message of up to 40 characters once into the DDRAM
+ *	line of a row and start scrolling it with the display shift
+ *	command. Every step costs a single command byte. The display
+ *	shift moves all rows together. A row that starts in the middle
+ *	of a DDRAM line (rows 3 and 4 of a 4-line panel) only gets the
+ *	rest of that line, the other rows on it are redrawn by the next
+ *	LCD_Flush
+ *	Input: Row, Pointer to Character Array, Step Period in ms
+ *	Output: None
+ */
+void LCD_Marquee_Start(uint8_t row, const char* msg, uint32_t step_ms);
+
+/*
+ *	---------------LCD_Marquee_Stop---------------
+ *	Stop scrolling and shift the display back to its home position
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Marquee_Stop(void);
+
+/*
+ *	-------------LCD_Marquee_Service--------------
+ *	Non-blocking, call from the main loop. Sends one display shift
+ *	command for every timer tick that elapsed since the last call
+ *	Input: None
+ *	Output: None
+ */
+void LCD_Marquee_Service(void);
+
+/*
+ *	-------------LCD_Marquee_Pending--------------
+ *	Input: None
+ *	Output: 1 if LCD_Marquee_Service has shifts to send
+ */
+uint8_t LCD_Marquee_Pending(void);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Log.c
+ *
+ *	Main implementation of the deferred logging ring. Producers may
+ *	be interrupts, so a slot is claimed and filled with interrupts
+ *	masked for a handful of instructions. There is only one consumer
+ *	(Log_Flush in the main loop), which reads completed slots without
+ *	masking anything.
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Log.h"
+#include "Telemetry.h"
+#include "UART0.h"
+#include "tm4c123gh6pm.h"
+
+/* Data Watchpoint and Trace unit, not in tm4c123gh6pm.h */
+#define DWT_CTRL_R							(*((volatile unsigned long *)0xE0001000))
+#define DWT_CYCCNT_R						(*((volatile unsigned long *)0xE0001004))
+#define DWT_CTRL_CYCCNTENA			(0x00000001)
+#define DEMCR_TRCENA						(0x01000000)		//Bit 24 of NVIC_DBG_INT_R (DEMCR)
+
+/* Timestamp source, the build may override it (host benchmark) */
+#ifndef LOG_TIMESTAMP
+#define LOG_TIMESTAMP()					(DWT_CYCCNT_R)
+#endif
+
+#define LOG_RING_MASK						(LOG_RING_SIZE - 1)
+#define LOG_RECORD_HEADER				(7)							//id(2) nargs(1) timestamp(4)
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+typedef struct{
+	uint16_t Id;
+	uint8_t NArgs;
+	uint32_t Timestamp;
+	uint32_t Args[LOG_MAX_ARGS];
+} LOG_RECORD_t;
+
+static LOG_RECORD_t LogRing[LOG_RING_SIZE];
+static volatile uint32_t LogPutI;						//Only changed with interrupts masked
+static volatile uint32_t LogGetI;						//Only changed by Log_Flush
+static volatile uint32_t LogDropped;
+static uint32_t LogReported;								//Drops already sent as LOG_DROPPED
+static uint16_t LogSeq;
+
+/*
+ *	---------------------Log_Init----------------------
+ *	Start the DWT cycle counter used for the timestamps and log
+ *	the timestamp clock so the host can convert them
+ *	Input: none
+ *	Output: none
+ */
+void Log_Init(void){
+	NVIC_DBG_INT_R |= DEMCR_TRCENA;						//Enable the trace blocks (DWT)
+	DWT_CYCCNT_R = 0;
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+
+	LOG1(LOG_START, LOG_TIMESTAMP_HZ);
+}
+
+/*
+ *	---------------------Log_Write---------------------
+ *	Store one record. Use the LOGn macros instead of calling this
+ *	directly. The record is dropped and counted if the ring is full
+ *	Input: Message ID, Argument Count, Arguments
+ *	Output: none
+ */
+void Log_Write(LOG_ID_t id, uint8_t nargs, uint32_t a0, uint32_t a1, uint32_t a2){
+	LOG_RECORD_t* rec;
+	uint32_t put;
+	long sr;
+
+	sr = StartCritical();
+	put = LogPutI;
+	if((put - LogGetI) >= LOG_RING_SIZE){
+		LogDropped++;
+		EndCritical(sr);
+		return;
+	}
+	rec = &LogRing[put & LOG_RING_MASK];
+	rec->Id = (uint16_t)id;
+	rec->NArgs = nargs;
+	rec->Timestamp = LOG_TIMESTAMP();
+	rec->Args[0] = a0;
+	rec->Args[1] = a1;
+	rec->Args[2] = a2;
+	LogPutI = put + 1;												//Publish only once the slot is complete
+	EndCritical(sr);
+}
+
+/*
+ *	--------------------Log_Send-----------------------
+ *	Local helper to wrap a packed payload in a frame and queue it
+ *	Input: Payload, Payload Length
+ *	Output: none
+ */
+static void Log_Send(const uint8_t* payload, uint32_t len){
+	uint8_t frame[TLM_MAX_FRAME];
+	uint32_t flen;
+
+	flen = Telemetry_Pack(TLM_TYPE_LOG, LogSeq++, payload, len, frame);
+	UART0_Write(frame, flen);
+}
+
+/*
+ *	--------------------Log_Pack-----------------------
+ *	Local helper to append one record to a payload, little endian
+ *	Input: Output Position, Message ID, Timestamp, Argument Count, Arguments
+ *	Output: Position after the record
+ */
+static uint8_t* Log_Pack(uint8_t* p, uint16_t id, uint32_t ts, uint8_t nargs, const uint32_t* args){
+	uint8_t i;
+
+	*p++ = (uint8_t)id;
+	*p++ = (uint8_t)(id >> 8);
+	*p++ = nargs;
+	*p++ = (uint8_t)ts;
+	*p++ = (uint8_t)(ts >> 8);
+	*p++ = (uint8_t)(ts >> 16);
+	*p++ = (uint8_t)(ts >> 24);
+	for(i = 0; i < nargs; i++){
+		*p++ = (uint8_t)args[i];
+		*p++ = (uint8_t)(args[i] >> 8);
+		*p++ = (uint8_t)(args[i] >> 16);
+		*p++ = (uint8_t)(args[i] >> 24);
+	}
+	return p;
+}
+
+/*
+ *	---------------------Log_Flush---------------------
+ *	Send every stored record to UART0 as TLM_TYPE_LOG frames,
+ *	preceded by a LOG_DROPPED record if any were lost since the
+ *	last flush
+ *	Input: none
+ *	Output: none
+ */
+void Log_Flush(void){
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint8_t* p = payload;
+	const LOG_RECORD_t* rec;
+	uint32_t dropped = LogDropped;
+	uint32_t size;
+
+	/* Report new drops first so the gap shows up where it happened */
+	if(dropped != LogReported){
+		uint32_t lost = dropped - LogReported;
+		p = Log_Pack(p, LOG_DROPPED, LOG_TIMESTAMP(), 1, &lost);
+		LogReported = dropped;
+	}
+
+	while(LogGetI != LogPutI){
+		rec = &LogRing[LogGetI & LOG_RING_MASK];
+		size = LOG_RECORD_HEADER + 4*rec->NArgs;
+		if((uint32_t)(p - payload) + size > TLM_MAX_PAYLOAD){
+			Log_Send(payload, (uint32_t)(p - payload));
+			p = payload;
+		}
+		p = Log_Pack(p, rec->Id, rec->Timestamp, rec->NArgs, rec->Args);
+		LogGetI++;															//Slot may be reused from here on
+	}
+
+	if(p != payload)
+		Log_Send(payload, (uint32_t)(p - payload));
+}
+
+/*
+ *	--------------------Log_Dropped--------------------
+ *	Number of records dropped because the ring was full
+ *	Input: none
+ *	Output: Dropped record count since reset
+ */
+uint32_t Log_Dropped(void){
+	return LogDropped;
+}
@@ -0,0 +1,94 @@
+/*
+ * Log.h
+ *
+ *	Provides deferred logging. A call site only stores a message ID,
+ *	a timestamp and up to three raw 32-bit arguments into a ring, no
+ *	formatting happens on the target. Log_Flush later packs the
+ *	records into TLM_TYPE_LOG telemetry frames and the host tools
+ *	expand them into text with the table in LogMessages.h.
+ *
+ *	Log_Write is safe to call from any interrupt, Log_Flush must only
+ *	be called from the main loop (it writes to UART0).
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+#include "LogMessages.h"
+#include "SysClock.h"
+
+/* Ring size in records, must be a power of 2 */
+#define LOG_RING_SIZE					(64)
+#define LOG_MAX_ARGS					(3)
+
+/* Timestamp clock, the DWT cycle counter runs at the core clock */
+#define LOG_TIMESTAMP_HZ			(SYSCLK_HZ)
+
+/* Message IDs, one per LogMessages.h entry */
+#define LOG_MSG(id, fmt)			id,
+typedef enum{
+	LOG_MESSAGE_TABLE
+	LOG_ID_COUNT
+} LOG_ID_t;
+#undef LOG_MSG
+
+/* Call site macros, the argument count is part of the record */
+#define LOG0(id)							Log_Write((id), 0, 0, 0, 0)
+#define LOG1(id, a)						Log_Write((id), 1, (uint32_t)(a), 0, 0)
+#define LOG2(id, a, b)				Log_Write((id), 2, (uint32_t)(a), (uint32_t)(b), 0)
+#define LOG3(id, a, b, c)			Log_Write((id), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+/*
+ *	----------------------LOG_F------------------------
+ *	Pass a float argument by its bit pattern (for %f)
+ *	Input: Value
+ *	Output: Raw 32-bit pattern
+ */
+static inline uint32_t LOG_F(float val){
+	union { float f; uint32_t u; } bits;
+	bits.f = val;
+	return bits.u;
+}
+
+/*
+ *	---------------------Log_Init----------------------
+ *	Start the DWT cycle counter used for the timestamps and log
+ *	the timestamp clock so the host can convert them
+ *	Input: none
+ *	Output: none
+ */
+void Log_Init(void);
+
+/*
+ *	---------------------Log_Write---------------------
+ *	Store one record. Use the LOGn macros instead of calling this
+ *	directly. The record is dropped and counted if the ring is full
+ *	Input: Message ID, Argument Count, Arguments
+ *	Output: none
+ */
+void Log_Write(LOG_ID_t id, uint8_t nargs, uint32_t a0, uint32_t a1, uint32_t a2);
+
+/*
+ *	---------------------Log_Flush---------------------
+ *	Send every stored record to UART0 as TLM_TYPE_LOG frames,
+ *	preceded by a LOG_DROPPED record if any were lost since the
+ *	last flush
+ *	Input: none
+ *	Output: none
+ */
+void Log_Flush(void);
+
+/*
+ *	--------------------Log_Dropped--------------------
+ *	Number of records dropped because the ring was full
+ *	Input: none
+ *	Output: Dropped record count since reset
+ */
+uint32_t Log_Dropped(void);
+
+#endif
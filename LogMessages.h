@@ -0,0 +1,47 @@
+/*
+ * LogMessages.h
+ *
+ *	Table of every deferred log message. Each entry pairs a message
+ *	ID with the printf style text the host expands it into, the
+ *	firmware only ever sends the ID and the raw arguments. Included
+ *	by Log.h to build the ID enum and by the host tools to build the
+ *	text table, so both always agree.
+ *
+ *	Only append to the end of the table, IDs are positional and old
+ *	captures are expanded with the current table.
+ *	Arguments are 32-bit words: %d %u %x %c use them as integers,
+ *	%f reinterprets the bits as a float (pass LOG_F(value)).
+ *
+ * Created on: November 25, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef LOGMESSAGES_H_
+#define LOGMESSAGES_H_
+
+#define LOG_MESSAGE_TABLE \
+	LOG_MSG(LOG_START,									"Log started, timestamp clock %u Hz") \
+	LOG_MSG(LOG_DROPPED,								"%u log records dropped") \
+	LOG_MSG(LOG_I2C_TX_ERROR,						"Error on Transmit to %02x register %02x, error code %x") \
+	LOG_MSG(LOG_MPU6050_NOT_DETECTED,		"MPU6050 has not been Detected, ID: %x") \
+	LOG_MSG(LOG_MPU6050_DETECTED,				"MPU6050 has been Detected, ID: %x") \
+	LOG_MSG(LOG_MPU6050_RESET,					"Reset MPU6050") \
+	LOG_MSG(LOG_MPU6050_AWAKE,					"Sensor is awake") \
+	LOG_MSG(LOG_MPU6050_RATE,						"Data Rate is 1kHz") \
+	LOG_MSG(LOG_MPU6050_CONFIG,					"Default Configuration") \
+	LOG_MSG(LOG_MPU6050_ACCEL_CONFIG,		"Default Accelerometer Configuration") \
+	LOG_MSG(LOG_MPU6050_GYRO_CONFIG,		"Default Gyroscope Configuration") \
+	LOG_MSG(LOG_MPU6050_INITIALIZED,		"MPU6050 Initialized") \
+	LOG_MSG(LOG_TCS34727_NOT_DETECTED,	"TCS34727 has not been Detected, ID: %x") \
+	LOG_MSG(LOG_TCS34727_DETECTED,			"TCS34727 has been Detected, ID: %x") \
+	LOG_MSG(LOG_TCS34727_ATIME_SET,			"TCS34727 Integration Time Set") \
+	LOG_MSG(LOG_TCS34727_GAIN_SET,			"TCS34727 Gain Set") \
+	LOG_MSG(LOG_TCS34727_POWER_ON,			"TCS34727 Power On") \
+	LOG_MSG(LOG_TCS34727_RGBC_ON,				"TCS34727 RGBC On") \
+	LOG_MSG(LOG_TCS34727_INITIALIZED,		"TCS34727 Color Sensor Initialized") \
+	LOG_MSG(LOG_PARAM_LOADED,						"%u parameters restored from flash") \
+	LOG_MSG(LOG_PARAM_DEFAULTS,					"No saved parameters, using defaults") \
+	LOG_MSG(LOG_I2C_RX_ERROR,						"Error on Receive from %02x register %02x, error code %x")
+
+#endif
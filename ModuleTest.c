@@ -1,349 +1,834 @@
-/*
- * ModuleTest.c
- *
- *	Provides the testing functions all of individual peripheral testing
- *	and full system testing
- *
- * Created on: November 13, 2024
- *		Author: Oliver Cabral and Jason Chan
- *
- */
- 
-#include "ModuleTest.h"
-#include "TCS34727.h"
-#include "MPU6050.h"
-#include "UART0.h"
-#include "Servo.h"
-#include "LCD.h"
-#include "I2C.h"
-#include "util.h"
-#include "ButtonLED.h"
-#include "tm4c123gh6pm.h"
-#include <stdio.h>
-#include <string.h>
-#include <stdint.h>
-
-static char printBuf[100];
-static char angleBuf[LCD_ROW_SIZE];
-static char colorBuf[LCD_ROW_SIZE];
-static char colorString[6];
-
-/* RGB Color Struct Instance */
-RGB_COLOR_HANDLE_t RGB_COLOR;
-	
-/* MPU6050 Struct Instance */
-MPU6050_ACCEL_t Accel_Instance;
-MPU6050_GYRO_t 	Gyro_Instance;
-MPU6050_ANGLE_t Angle_Instance;
-
-uint8_t Color[] = {RED, GREEN, BLUE};
-uint8_t Color_Idx = 0;
-void GPIOPortF_Handler(){
-	if(SW1_PIN){
-		GPIO_PORTF_ICR_R = SW1_FLAG;
-		Color_Idx = (Color_Idx+1)%3;
-		LEDs = Color[Color_Idx];
-	}
-}
-
-static void Test_Delay(void){
-	/*CODE_FILL*/				//Toggle Red Led
-	/*CODE_FILLor*/				//Delay for 0.5s using millisecond delay
-	LEDs ^= Color[Color_Idx];
-	DELAY_1MS(500);
-}
-
-float num = 0.0f;
-static void Test_UART(void){
-	/*CODE_FILL*/						
-	// 1. Construct a string with letters, decimal numbers and floats using sprintf
-	// 2. Send the string to PC serial terminal for display	
-	// 3. Delay for 1s using ms delay function
-	WTIMER0_Init();
-	float num = 0.0f;
-	while(1){
-		sprintf(printBuf, "Floating Number: %.2f\r\n", num);
-		UART0_OutString(printBuf);
-		DELAY_1MS(1000);
-		num += 0.25f;
-	}
-}
-
-static void Test_I2C(void){
-	/*CODE_FILL*/						
-	
-	/* Check if RGB Color Sensor has been detected and display the ret value on PC serial terminal. */
-		/* Check if RGB Color Sensor has been detected */	
-	//Print ID or Error to Terminal
-	sprintf(printBuf, "ID: %x\r\n", I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR));
-	UART0_OutString(printBuf);
-}
-
-
-static void Test_MPU6050(void){
-	/* Grab Accelerometer and Gyroscope Raw Data*/
-
-	
-	/*CODE_FILL*/
-	MPU6050_Get_Accel(&Accel_Instance);
-	MPU6050_Get_Gyro(&Gyro_Instance);
-		
-	/* Process Raw Accelerometer and Gyroscope Data */
-	/*CODE_FILL*/
-	MPU6050_Process_Accel(&Accel_Instance);
-	MPU6050_Process_Gyro(&Gyro_Instance);
-	
-	//Clear Terminal
-	UART0_OutString("\033[2J");
-			
-	/* Calculate Tilt Angle */
-	/*CODE_FILL*/
-	MPU6050_Get_Angle(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
-		
-	/* Format buffer to print data and angle */
-	/*CODE_FILL*/
-	//UART0_OutString("Accel Instance\r\n");
-	sprintf(printBuf, "X: %f\r\nY: %f\r\nY: %f\r\n", Accel_Instance.Ax, Accel_Instance.Ay, Accel_Instance.Az);
-	UART0_OutString(printBuf);
-  UART0_OutString("Gyro Instance\r\n");
-	sprintf(printBuf, "X: %f\r\nY: %f\r\nY: %f\r\n", Gyro_Instance.Gx, Gyro_Instance.Gy, Gyro_Instance.Gz);
-	UART0_OutString(printBuf);
-	UART0_OutString("Angle Instance\r\n");
-	sprintf(printBuf, "X: %f Y: %f Z: %f", Angle_Instance.ArX, Angle_Instance.ArY, Angle_Instance.ArZ);
-	UART0_OutString(printBuf);
-	
-	DELAY_1MS(50);
-}
-
-static void Test_TCS34727(void){
-	WTIMER0_Init();
-	/* Grab Raw Color Data From Sensor */
-	RGB_COLOR.R_RAW = TCS34727_GET_RAW_RED();
-	RGB_COLOR.G_RAW = TCS34727_GET_RAW_GREEN();
-	RGB_COLOR.B_RAW = TCS34727_GET_RAW_BLUE();
-	RGB_COLOR.C_RAW = TCS34727_GET_RAW_CLEAR();
-	
-	//Clear Terminal
-	UART0_OutChar(0x1B);
-	UART0_OutChar(0x5B);
-	UART0_OutChar(0x32);
-	UART0_OutChar(0x1B);
-	
-	sprintf(printBuf,"RED RAW: %x\r\nGREEN RAW: %x\r\nBLUE RAW: %x\r\n",RGB_COLOR.R_RAW, RGB_COLOR.G_RAW, RGB_COLOR.B_RAW);
-	UART0_OutString(printBuf);
-	
-	/* Process Raw Color Data to RGB Value */
-	/*CODE_FILL*/
-	TCS34727_GET_RGB(&RGB_COLOR);
-		
-	
-	/* Change Onboard RGB LED Color to Detected Color */
-	switch(Detect_Color(&RGB_COLOR)){
-		case RED_DETECT:
-			LEDs = RED;
-			break;
-		case GREEN_DETECT:
-			LEDs = GREEN;
-			break;
-		case BLUE_DETECT:
-			LEDs = BLUE;
-			break;
-		case NOTHING_DETECT:
-			LEDs = DARK;
-			break;
-		}
-		
-	/* Format String to Print */
-	/*CODE_FILL*/
-		
-	/* Print String to Terminal through USB */
-	/*CODE_FILL*/
-		
-	DELAY_1MS(10);
-}
-
-static void Test_Servo(void){
-
-	/*
-	 * In this test, follow the series of steps below (each step requires a 1s delay after)
-	 * 1. Drive Servo to 0 degree
-	 * 2. Drive Servo to -45 degree
-	 * 3. Drive Servo to 0 degree
-	 * 4. Drive Servo to 45 degree
-	 * 5. Drive Servo to 0 degree
-	 * 6. Drive Servo to -90 degree
-	 * 7. Drive Servo to 0 degree
-	 * 8. Drive Servo to 90 degree
-	 */ 
-	
-	
-	UART0_OutString("Setting Angle to 0 Degree\r\n");
-	Drive_Servo(0);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to -45 Degree\r\n");
-	Drive_Servo(-45);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to 0 Degree\r\n");
-	Drive_Servo(0);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to 45 Degree\r\n");
-	Drive_Servo(45);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to 0 Degree\r\n");
-	Drive_Servo(0);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to -90 Degree\r\n");
-	Drive_Servo(-90);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to 0 Degree\r\n");
-	Drive_Servo(0);
-	DELAY_1MS(1000);
-	
-	UART0_OutString("Setting Angle to 90 Degree\r\n");
-	Drive_Servo(90);
-	DELAY_1MS(1000);
-	
-	/*CODE_FILL*/
-	
-}
-
-static void Test_LCD(void){
-	/* Print Name to LCD at Center Location */
-	/*CODE_FILL*/
-	LCD_Clear();
-	DELAY_1MS(10);
-	LCD_Set_Cursor(ROW1,5);
-	DELAY_1MS(10);
-	LCD_Print_Str((uint8_t *) "Oliver");
-	DELAY_1MS(1000);
-	LCD_Set_Cursor(ROW2,5);
-	DELAY_1MS(10);
-	LCD_Print_Str((uint8_t *) "Cabral");
-	DELAY_1MS(1000);
-}
-
-static void Test_Full_System(void){
-	/* Grab Accelerometer and Gyroscope Raw Data*/
-	MPU6050_Get_Accel(&Accel_Instance);
-	MPU6050_Get_Gyro(&Gyro_Instance);
-	
-		
-	/* Process Raw Accelerometer and Gyroscope Data */
-	MPU6050_Process_Accel(&Accel_Instance);
-	MPU6050_Process_Gyro(&Gyro_Instance);
-		
-	/* Calculate Tilt Angle */
-	MPU6050_Get_Angle(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
-		
-	/* Drive Servo Accordingly to Tilt Angle on X-Axis*/
-	Drive_Servo(Angle_Instance.ArX);
-		
-	/* Format buffer to print MPU6050 data and angle */
-	sprintf(printBuf, "X: %f\r\nY: %f\r\nY: %f\r\n", Accel_Instance.Ax, Accel_Instance.Ay, Accel_Instance.Az);
-	UART0_OutString(printBuf);
-  UART0_OutString("Gyro Instance\r\n");
-	sprintf(printBuf, "X: %f\r\nY: %f\r\nY: %f\r\n", Gyro_Instance.Gx, Gyro_Instance.Gy, Gyro_Instance.Gz);
-	UART0_OutString(printBuf);
-	UART0_OutString("Angle Instance\r\n");
-	sprintf(printBuf, "X: %f Y: %f Z: %f", Angle_Instance.ArX, Angle_Instance.ArY, Angle_Instance.ArZ);
-	UART0_OutString(printBuf);
-		
-	/* Grab Raw Color Data From Sensor */
-	RGB_COLOR.R_RAW = TCS34727_GET_RAW_RED();
-	RGB_COLOR.G_RAW = TCS34727_GET_RAW_GREEN();
-	RGB_COLOR.B_RAW = TCS34727_GET_RAW_BLUE();
-	RGB_COLOR.C_RAW = TCS34727_GET_RAW_CLEAR();
-		
-	/* Process Raw Color Data to RGB Value */
-	TCS34727_GET_RGB(&RGB_COLOR);
-		
-	/* Change Onboard RGB LED Color to Detected Color */
-	switch(Detect_Color(&RGB_COLOR)){
-		case RED_DETECT:
-			LEDs = RED;
-			strcpy(colorString, "RED");
-			break;
-		case GREEN_DETECT:
-			LEDs = GREEN;
-			strcpy(colorString, "GREEN");
-			break;
-		case BLUE_DETECT:
-			LEDs = BLUE;
-			strcpy(colorString, "BLUE");
-			break;
-		case NOTHING_DETECT:
-			LEDs = DARK;
-			strcpy(colorString, "NA");
-			break;
-	}
-		
-	/* Format String to Print RGB value*/
-	sprintf(printBuf,"RED RAW: %x\r\nGREEN RAW: %x\r\nBLUE RAW: %x\r\n",RGB_COLOR.R_RAW, RGB_COLOR.G_RAW, RGB_COLOR.B_RAW);
-		
-	/* Print String to Terminal through USB */
-	UART0_OutString(printBuf);
-		
-	/* Update LCD With Current Angle and Color Detected */
-	sprintf(angleBuf, "Angle:%0.2f", Angle_Instance.ArX);				//Format String to print angle to 2 Decimal Place
-	sprintf(colorBuf, "Color:%s", colorString);									//Format String to print color detected
-	
-	LCD_Clear();						//Clear LCD
-	DELAY_1MS(2);						//Safety Delay of 2ms
-	LCD_Set_Cursor(ROW1,0);						//Set Cursor to Row 1 Column 0
-	LCD_Print_Str((uint8_t*)angleBuf);						//Print angleBuf String on LCD
-	DELAY_1MS(2);					//Safety Delay of 2ms
-	LCD_Set_Cursor(ROW2,0);						
-	LCD_Print_Str((uint8_t*)colorString);
-		
-	DELAY_1MS(20);
-}
-
-void Module_Test(MODULE_TEST_NAME test){
-	
-	switch(test){
-		case DELAY_TEST:
-			Test_Delay();
-			break;
-		
-		case I2C_TEST:
-			Test_I2C();
-			break;
-		
-		case UART_TEST:
-			Test_UART();
-			break;
-		
-		case MPU6050_TEST:
-			Test_MPU6050();
-			break;
-		
-		case TCS34727_TEST:
-			Test_TCS34727();
-			break;
-		
-		case SERVO_TEST:
-			Test_Servo();
-			break;
-		
-		case LCD_TEST:
-			Test_LCD();
-			break;
-			
-		case FULL_SYSTEM_TEST:
-			Test_Full_System();
-			break;
-		
-		
-		default:
-			break;
-	}
-	
-}
-
- 
\ No newline at end of file
+/*
+ * ModuleTest.c
+ *
+ *	Provides the testing functions all of individual peripheral testing
+ *	and full system testing
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+ 
+#include "ModuleTest.h"
+#include "TCS34727.h"
+#include "MPU6050.h"
+#include "UART0.h"
+#include "Servo.h"
+#include "LCD.h"
+#include "I2C.h"
+#include "util.h"
+#include "ButtonLED.h"
+#include "Format.h"
+#include "Telemetry.h"
+#include "Param.h"
+#include "Time.h"
+#include "Sched.h"
+#include "Kernel.h"
+#include "Timer.h"
+#include "Profile.h"
+#include "Idle.h"
+#include "tm4c123gh6pm.h"
+#include <stdint.h>
+
+static char printBuf[100];
+static char angleBuf[LCD_ROW_SIZE+1];
+static char colorBuf[LCD_ROW_SIZE+1];
+
+/* Peripherals Brought Up by Module_Test_Set_Mode */
+#define NEED_WTIMER0			(0x01)
+#define NEED_I2C0					(0x02)
+#define NEED_TCS34727			(0x04)
+#define NEED_MPU6050			(0x08)
+#define NEED_SERVO				(0x10)
+#define NEED_LCD					(0x20)
+#define NEED_UART0_DMA		(0x40)
+
+#ifdef TELEMETRY_BINARY
+#define NEED_FULL_OUTPUT	(NEED_UART0_DMA)
+#else
+#define NEED_FULL_OUTPUT	(0)
+#endif
+
+static const uint8_t Test_Needs[MODULE_TEST_COUNT] = {
+	NEED_WTIMER0,																								//DELAY_TEST
+	NEED_WTIMER0,																								//UART_TEST
+	NEED_WTIMER0 | NEED_I2C0,																		//I2C_TEST
+	NEED_WTIMER0 | NEED_I2C0 | NEED_MPU6050,										//MPU6050_TEST
+	NEED_WTIMER0 | NEED_I2C0 | NEED_TCS34727,										//TCS34727_TEST
+	NEED_WTIMER0 | NEED_SERVO,																	//SERVO_TEST
+	NEED_WTIMER0 | NEED_I2C0 | NEED_LCD,												//LCD_TEST
+	NEED_WTIMER0 | NEED_I2C0 | NEED_TCS34727 | NEED_MPU6050 |
+		NEED_SERVO | NEED_LCD | NEED_FULL_OUTPUT										//FULL_SYSTEM_TEST
+};
+
+/* Period of the test task in ms, used when no period has been set */
+static const uint16_t Test_Default_Period[MODULE_TEST_COUNT] = {
+	500,			//DELAY_TEST
+	1000,			//UART_TEST
+	0,				//I2C_TEST
+	50,				//MPU6050_TEST
+	10,				//TCS34727_TEST
+	1000,			//SERVO_TEST
+	1000,			//LCD_TEST
+	0					//FULL_SYSTEM_TEST, unused, each stage has its own task
+};
+
+/* Tasks of the full system test, in SchedTable.h */
+static const SCHED_ID_t Full_Tasks[] = {
+#ifdef KERNEL_CONTROL
+	TASK_TELEMETRY
+#else
+	TASK_IMU, TASK_FUSION, TASK_SERVO, TASK_COLOR, TASK_TELEMETRY, TASK_LCD
+#endif
+};
+
+#ifdef KERNEL_CONTROL
+/* Kernel tasks of the full system test, the main loop task sits
+   below them at MODULE_TEST_MAIN_PRIO */
+#define CONTROL_PRIO					(1)				//Tilt to servo path
+#define SENSOR_PRIO						(2)				//Color sensor
+#define DISPLAY_PRIO					(4)				//LCD
+#define CONTROL_STACK_WORDS		(384)
+#define SENSOR_STACK_WORDS		(256)
+#define DISPLAY_STACK_WORDS		(256)
+
+static KERNEL_TASK_t Control_Task;
+static KERNEL_TASK_t Sensor_Task;
+static KERNEL_TASK_t Display_Task;
+static uint32_t Control_Stack[CONTROL_STACK_WORDS];
+static uint32_t Sensor_Stack[SENSOR_STACK_WORDS];
+static uint32_t Display_Stack[DISPLAY_STACK_WORDS];
+#endif
+
+static MODULE_TEST_NAME Test_Mode = DELAY_TEST;
+static uint8_t Test_Ready;										//NEED_ bits already initialized
+static uint32_t Test_Period;									//0 = Test_Default_Period
+
+/* Latest results of the full system stages. The control and sensor
+   stages write their own instances, then publish a copy here with
+   interrupts masked, so the LCD and telemetry tasks never read a
+   half updated sample */
+typedef struct{
+	MPU6050_ACCEL_t Accel;
+	MPU6050_GYRO_t Gyro;
+	MPU6050_ANGLE_t Angle;
+	RGB_COLOR_HANDLE_t RGB;
+	COLOR_DETECTED Color;
+} FULL_SAMPLE_t;
+
+static FULL_SAMPLE_t Full_Shared = {.Color = NOTHING_DETECT};
+
+/* LCD text of each COLOR_DETECTED */
+static const char* const Color_Names[] = {"RED", "GREEN", "BLUE", "NA"};
+
+#ifdef TELEMETRY_BINARY
+static uint8_t frameBuf[TLM_MAX_FRAME];
+static uint16_t frameSeq;
+#endif
+
+/* RGB Color Struct Instance */
+RGB_COLOR_HANDLE_t RGB_COLOR;
+	
+/* MPU6050 Struct Instance */
+MPU6050_ACCEL_t Accel_Instance;
+MPU6050_GYRO_t 	Gyro_Instance;
+MPU6050_ANGLE_t Angle_Instance;
+
+uint8_t Color[] = {RED, GREEN, BLUE};
+uint8_t Color_Idx = 0;
+
+/* SW1 must stay released this long after its edge to count */
+#define BUTTON_DEBOUNCE_US		(20000)
+
+static void Button_Debounced(void* arg);
+static TIMER_t Button_Timer;
+
+void GPIOPortF_Handler(){
+	if(SW1_PIN){
+		GPIO_PORTF_ICR_R = SW1_FLAG;
+		GPIO_PORTF_IM_R &= ~SW1_PIN;							//Ignore the bounces until the timer runs
+		Timer_Start(&Button_Timer, BUTTON_DEBOUNCE_US, 0);
+	}
+}
+
+/*
+ *	-----------------Button_Debounced----------------
+ *	Debounce timer of SW1, posts the button task if the switch is
+ *	still released and arms its edge interrupt again
+ *	Input: Unused
+ *	Output: None
+ */
+static void Button_Debounced(void* arg){
+	(void)arg;
+	GPIO_PORTF_ICR_R = SW1_PIN;
+	GPIO_PORTF_IM_R |= SW1_PIN;
+	if(GPIO_PORTF_DATA_R & SW1_PIN){
+		Sched_Post(TASK_BUTTON);									//Handled outside the interrupt
+		Idle_Notify();
+	}
+}
+
+/*
+ *	-------------------Task_Button-------------------
+ *	Event task posted by the SW1 debounce timer, steps the LED color
+ *	Input: None
+ *	Output: None
+ */
+void Task_Button(void){
+	Color_Idx = (Color_Idx+1)%3;
+	LEDs = Color[Color_Idx];
+}
+
+/*
+ *	--------------Print_Format_Triple--------------
+ *	Local helper to build a three axis line into printBuf with
+ *	6 decimal places (same output as "%f") without sprintf
+ *	Input: Labels and Values for the Three Axes, Separator
+ *	Output: None
+ */
+static void Print_Format_Triple(const char* l1, float v1, const char* l2, float v2, const char* l3, float v3, const char* sep){
+	char* p = printBuf;
+	p += Format_Str(p, l1);
+	p += Format_Float(p, v1, 6, 0);
+	p += Format_Str(p, sep);
+	p += Format_Str(p, l2);
+	p += Format_Float(p, v2, 6, 0);
+	p += Format_Str(p, sep);
+	p += Format_Str(p, l3);
+	p += Format_Float(p, v3, 6, 0);
+	UART0_OutString(printBuf);
+}
+
+/*
+ *	--------------Print_MPU6050_Data---------------
+ *	Local helper to print the accelerometer, gyroscope and
+ *	angle instances to the terminal
+ *	Input: Accelerometer, Gyroscope and Angle Instances
+ *	Output: None
+ */
+static void Print_MPU6050_Data(const MPU6050_ACCEL_t* accel, const MPU6050_GYRO_t* gyro, const MPU6050_ANGLE_t* angle){
+	Print_Format_Triple("X: ", accel->Ax, "Y: ", accel->Ay, "Z: ", accel->Az, "\r\n");
+	UART0_OutCRLF();
+	UART0_OutString("Gyro Instance\r\n");
+	Print_Format_Triple("X: ", gyro->Gx, "Y: ", gyro->Gy, "Z: ", gyro->Gz, "\r\n");
+	UART0_OutCRLF();
+	UART0_OutString("Angle Instance\r\n");
+	Print_Format_Triple("X: ", angle->ArX, "Y: ", angle->ArY, "Z: ", angle->ArZ, " ");
+}
+
+/*
+ *	----------------Print_RGB_Raw------------------
+ *	Local helper to print the raw red, green and blue readings
+ *	in hex to the terminal
+ *	Input: RGB Color Instance
+ *	Output: None
+ */
+static void Print_RGB_Raw(const RGB_COLOR_HANDLE_t* rgb){
+	UART0_OutString("RED RAW: ");
+	UART0_OutUHex(rgb->R_RAW);
+	UART0_OutString("\r\nGREEN RAW: ");
+	UART0_OutUHex(rgb->G_RAW);
+	UART0_OutString("\r\nBLUE RAW: ");
+	UART0_OutUHex(rgb->B_RAW);
+	UART0_OutCRLF();
+}
+
+/*
+ *	---------------Full_Sample_Get-----------------
+ *	Local helper to copy the latest published full system sample,
+ *	with interrupts masked so no stage task publishes halfway
+ *	Input: Sample to Fill
+ *	Output: None
+ */
+static void Full_Sample_Get(FULL_SAMPLE_t* sample){
+	long sr = StartCritical();
+	*sample = Full_Shared;
+	EndCritical(sr);
+}
+
+#ifdef TELEMETRY_BINARY
+/*
+ *	-------------Angle_To_Centidegree--------------
+ *	Local helper to convert an angle into the int16 0.01 degree
+ *	unit used by the telemetry frames, saturating out of range values
+ *	Input: Angle in Degrees
+ *	Output: Angle in 0.01 Degree
+ */
+static int16_t Angle_To_Centidegree(float angle){
+	float cdeg = angle * 100.0f;
+	if(cdeg > 32767.0f)
+		return 32767;
+	if(cdeg < -32768.0f)
+		return -32768;
+	return (int16_t)cdeg;
+}
+
+/*
+ *	------------Send_Telemetry_Frame---------------
+ *	Local helper to pack the latest IMU and color data into one
+ *	binary frame and hand it to the UART0 uDMA. The frame is dropped
+ *	if both ping-pong buffers are still busy
+ *	Input: Full System Sample
+ *	Output: None
+ */
+static void Send_Telemetry_Frame(const FULL_SAMPLE_t* full){
+	TELEMETRY_SAMPLE_t sample;
+	uint32_t len;
+	
+	sample.Timestamp = (uint32_t)Time_Now_US();				//Wraps every ~71 minutes, host unwraps
+	sample.Channels = TLM_CH_ALL;
+	sample.Accel_RAW[0] = full->Accel.Ax_RAW;
+	sample.Accel_RAW[1] = full->Accel.Ay_RAW;
+	sample.Accel_RAW[2] = full->Accel.Az_RAW;
+	sample.Gyro_RAW[0] = full->Gyro.Gx_RAW;
+	sample.Gyro_RAW[1] = full->Gyro.Gy_RAW;
+	sample.Gyro_RAW[2] = full->Gyro.Gz_RAW;
+	sample.Angle_cdeg[0] = Angle_To_Centidegree(full->Angle.ArX);
+	sample.Angle_cdeg[1] = Angle_To_Centidegree(full->Angle.ArY);
+	sample.Angle_cdeg[2] = Angle_To_Centidegree(full->Angle.ArZ);
+	sample.RGBC_RAW[0] = full->RGB.R_RAW;
+	sample.RGBC_RAW[1] = full->RGB.G_RAW;
+	sample.RGBC_RAW[2] = full->RGB.B_RAW;
+	sample.RGBC_RAW[3] = full->RGB.C_RAW;
+	sample.Color = (uint8_t)full->Color;
+	
+	len = Telemetry_Encode_Sample(&sample, frameSeq++, frameBuf);
+	if(UART0_DMA_Write(frameBuf, len))
+		UART0_DMA_Send();
+}
+#endif
+
+/*
+ *	----------------Tilt_To_Servo------------------
+ *	Local helper to map a tilt angle to a servo angle with
+ *	servo.gain and servo.offset, limited to the servo range
+ *	Input: Tilt Angle in Degrees
+ *	Output: Servo Angle in Degrees
+ */
+static int16_t Tilt_To_Servo(float angle){
+	float cmd = angle * Param_Get_Float(PARAM_SERVO_GAIN) + Param_Get_Float(PARAM_SERVO_OFFSET);
+	if(cmd > SERVO_MAX_ANGLE)
+		return SERVO_MAX_ANGLE;
+	if(cmd < SERVO_MIN_ANGLE)
+		return SERVO_MIN_ANGLE;
+	return (int16_t)cmd;
+}
+
+static void Test_Delay(void){
+	/*CODE_FILL*/				//Toggle Red Led
+	/*CODE_FILLor*/				//Delay for 0.5s using millisecond delay
+	LEDs ^= Color[Color_Idx];
+}
+
+float num = 0.0f;
+static void Test_UART(void){
+	/*CODE_FILL*/						
+	// 1. Construct a string with letters, decimal numbers and floats using sprintf
+	// 2. Send the string to PC serial terminal for display	
+	// 3. Delay for 1s using ms delay function
+	UART0_OutString("Floating Number: ");
+	UART0_OutFloat(num, 2);
+	UART0_OutCRLF();
+	num += 0.25f;
+}
+
+static void Test_I2C(void){
+	/*CODE_FILL*/						
+	uint8_t id, ret;
+	
+	/* Check if RGB Color Sensor has been detected and display the ret value on PC serial terminal. */
+		/* Check if RGB Color Sensor has been detected */	
+	//Print ID or Error to Terminal
+	ret = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR, &id);
+	
+	UART0_OutString(ret ? "Error: " : "ID: ");
+	UART0_OutUHex(ret ? ret : id);
+	UART0_OutCRLF();
+}
+
+
+static void Test_MPU6050(void){
+	/* Grab Accelerometer and Gyroscope Raw Data*/
+
+	
+	/*CODE_FILL*/
+	MPU6050_Get_Accel(&Accel_Instance);
+	MPU6050_Get_Gyro(&Gyro_Instance);
+		
+	/* Process Raw Accelerometer and Gyroscope Data */
+	/*CODE_FILL*/
+	MPU6050_Process_Accel(&Accel_Instance);
+	MPU6050_Process_Gyro(&Gyro_Instance);
+	
+	//Clear Terminal
+	UART0_OutString("\033[2J");
+			
+	/* Calculate Tilt Angle */
+	/*CODE_FILL*/
+	MPU6050_Get_Angle(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
+		
+	/* Format buffer to print data and angle */
+	/*CODE_FILL*/
+	//UART0_OutString("Accel Instance\r\n");
+	Print_MPU6050_Data(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
+	
+}
+
+static void Test_TCS34727(void){
+	/* Grab Raw Color Data From Sensor */
+	RGB_COLOR.R_RAW = TCS34727_GET_RAW_RED();
+	RGB_COLOR.G_RAW = TCS34727_GET_RAW_GREEN();
+	RGB_COLOR.B_RAW = TCS34727_GET_RAW_BLUE();
+	RGB_COLOR.C_RAW = TCS34727_GET_RAW_CLEAR();
+	
+	//Clear Terminal
+	UART0_OutChar(0x1B);
+	UART0_OutChar(0x5B);
+	UART0_OutChar(0x32);
+	UART0_OutChar(0x1B);
+	
+	Print_RGB_Raw(&RGB_COLOR);
+	
+	/* Process Raw Color Data to RGB Value */
+	/*CODE_FILL*/
+	TCS34727_GET_RGB(&RGB_COLOR);
+		
+	
+	/* Change Onboard RGB LED Color to Detected Color */
+	switch(Detect_Color(&RGB_COLOR)){
+		case RED_DETECT:
+			LEDs = RED;
+			break;
+		case GREEN_DETECT:
+			LEDs = GREEN;
+			break;
+		case BLUE_DETECT:
+			LEDs = BLUE;
+			break;
+		case NOTHING_DETECT:
+			LEDs = DARK;
+			break;
+		}
+		
+	/* Format String to Print */
+	/*CODE_FILL*/
+		
+	/* Print String to Terminal through USB */
+	/*CODE_FILL*/
+		
+}
+
+static const int16_t Servo_Steps[] = {0, -45, 0, 45, 0, -90, 0, 90};
+static uint8_t Servo_Step;
+
+static void Test_Servo(void){
+
+	/*
+	 * In this test, follow the series of steps below (each step requires a 1s delay after)
+	 * 1. Drive Servo to 0 degree
+	 * 2. Drive Servo to -45 degree
+	 * 3. Drive Servo to 0 degree
+	 * 4. Drive Servo to 45 degree
+	 * 5. Drive Servo to 0 degree
+	 * 6. Drive Servo to -90 degree
+	 * 7. Drive Servo to 0 degree
+	 * 8. Drive Servo to 90 degree
+	 *
+	 * One step is taken per pass so the shell stays responsive
+	 */ 
+	
+	int16_t angle = Servo_Steps[Servo_Step];
+	
+	UART0_OutString("Setting Angle to ");
+	UART0_OutDec(angle);
+	UART0_OutString(" Degree\r\n");
+	Drive_Servo(angle);
+	Servo_Step = (Servo_Step + 1) % (sizeof(Servo_Steps)/sizeof(Servo_Steps[0]));
+	
+}
+
+typedef struct{
+	uint8_t Row;
+	const char* Text;
+} LCD_STEP_t;
+
+static const LCD_STEP_t LCD_Steps[] = {{ROW1, "Oliver"}, {ROW2, "Cabral"}};
+static uint8_t LCD_Step;
+
+/* After the name, a line longer than the row scrolls for a few passes */
+#define LCD_NAME_STEPS			(sizeof(LCD_Steps)/sizeof(LCD_Steps[0]))
+#define LCD_MARQUEE_PASSES	(10)
+#define LCD_MARQUEE_STEP_MS	(250)
+static const char LCD_Marquee_Text[] = "Oliver Cabral and Jason Chan";
+
+static void Test_LCD(void){
+	/* Print Name to LCD at Center Location */
+	/*CODE_FILL*/
+	
+	/*
+	 * One row per pass, so the test period is the pause between the
+	 * rows and the shell stays responsive. The first row clears the
+	 * display. The next pass starts the marquee on row 2, TIMER1A
+	 * scrolls it while the following passes do nothing. The LCD
+	 * driver waits out each command itself
+	 */
+	const LCD_STEP_t* step;
+	
+	if(LCD_Step == 0){
+		LCD_Marquee_Stop();
+		LCD_Clear();
+	}
+	if(LCD_Step < LCD_NAME_STEPS){
+		step = &LCD_Steps[LCD_Step];
+		LCD_Set_Cursor(step->Row,5);
+		LCD_Print_Str((uint8_t *)step->Text);
+	}else if(LCD_Step == LCD_NAME_STEPS){
+		LCD_Marquee_Start(ROW2, LCD_Marquee_Text, LCD_MARQUEE_STEP_MS);
+	}
+	LCD_Step = (LCD_Step + 1) % (LCD_NAME_STEPS + LCD_MARQUEE_PASSES);
+}
+
+/*
+ *	---------------Full System Tasks---------------
+ *	One stage of the full system test each, released by the
+ *	scheduler at the rates in SchedTable.h
+ *	Input: None
+ *	Output: None
+ */
+void Task_IMU(void){
+	/* Grab Accelerometer and Gyroscope Raw Data*/
+	MPU6050_Get_Accel(&Accel_Instance);
+	MPU6050_Get_Gyro(&Gyro_Instance);
+}
+
+void Task_Fusion(void){
+	long sr;
+	
+	/* Process Raw Accelerometer and Gyroscope Data */
+	MPU6050_Process_Accel(&Accel_Instance);
+	MPU6050_Process_Gyro(&Gyro_Instance);
+		
+	/* Calculate Tilt Angle */
+	MPU6050_Get_Angle(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
+	
+	/* Publish for the LCD and telemetry tasks */
+	sr = StartCritical();
+	Full_Shared.Accel = Accel_Instance;
+	Full_Shared.Gyro = Gyro_Instance;
+	Full_Shared.Angle = Angle_Instance;
+	EndCritical(sr);
+}
+
+void Task_Servo(void){
+	/* Drive Servo Accordingly to Tilt Angle on X-Axis*/
+	Drive_Servo(Tilt_To_Servo(Angle_Instance.ArX));
+}
+
+void Task_Color(void){
+	COLOR_DETECTED color;
+	long sr;
+	
+	/* Grab Raw Color Data From Sensor */
+	RGB_COLOR.R_RAW = TCS34727_GET_RAW_RED();
+	RGB_COLOR.G_RAW = TCS34727_GET_RAW_GREEN();
+	RGB_COLOR.B_RAW = TCS34727_GET_RAW_BLUE();
+	RGB_COLOR.C_RAW = TCS34727_GET_RAW_CLEAR();
+		
+	/* Process Raw Color Data to RGB Value */
+	TCS34727_GET_RGB(&RGB_COLOR);
+	color = Detect_Color(&RGB_COLOR);
+	
+	/* Publish for the LCD and telemetry tasks */
+	sr = StartCritical();
+	Full_Shared.RGB = RGB_COLOR;
+	Full_Shared.Color = color;
+	EndCritical(sr);
+		
+	/* Change Onboard RGB LED Color to Detected Color */
+	switch(color){
+		case RED_DETECT:
+			LEDs = RED;
+			break;
+		case GREEN_DETECT:
+			LEDs = GREEN;
+			break;
+		case BLUE_DETECT:
+			LEDs = BLUE;
+			break;
+		case NOTHING_DETECT:
+			LEDs = DARK;
+			break;
+	}
+}
+
+void Task_Telemetry(void){
+	FULL_SAMPLE_t full;
+	
+	PROFILE_BEGIN(PROF_TELEMETRY);
+	Full_Sample_Get(&full);
+	
+	#ifdef TELEMETRY_BINARY
+	/* One binary frame carries everything printed in text mode */
+	Send_Telemetry_Frame(&full);
+	#else
+	/* Print MPU6050 data, angle and RGB value to Terminal through USB */
+	Print_MPU6050_Data(&full.Accel, &full.Gyro, &full.Angle);
+	Print_RGB_Raw(&full.RGB);
+	#endif
+	PROFILE_END(PROF_TELEMETRY);
+}
+
+void Task_LCD(void){
+	FULL_SAMPLE_t full;
+	
+	Full_Sample_Get(&full);
+	
+	/* Update LCD With Current Angle and Color Detected */
+	Format_Float(angleBuf + Format_Str(angleBuf, "Angle:"), full.Angle.ArX, 2, 0);			//Format String to print angle to 2 Decimal Place
+	Format_Str(colorBuf + Format_Str(colorBuf, "Color:"), Color_Names[full.Color]);		//Format String to print color detected
+	
+	LCD_Buf_Clear();									//Start from a blank frame
+	LCD_Buf_Write(ROW1, 0, angleBuf);					//Angle on Row 1
+	LCD_Buf_Write(ROW2, 0, colorBuf);					//Color on Row 2
+	LCD_Flush();											//Only changed characters are sent
+}
+
+#ifdef KERNEL_CONTROL
+/*
+ *	-------------------Stage_Wait--------------------
+ *	Local helper, block a stage task until its next release at the
+ *	period of its scheduler table entry ("sched <task> <hz>")
+ *	Input: Scheduler Task ID, Last Release in ms
+ *	Output: None
+ */
+static void Stage_Wait(SCHED_ID_t id, uint32_t* last){
+	uint32_t period = Sched_Get_Period(id) / 1000;
+	
+	Kernel_Delay_Until(last, period ? period : 1);
+}
+
+/*
+ *	----------------Control_Thread-----------------
+ *	Kernel task running IMU, fusion and servo at the "imu" task
+ *	rate while the full system test is selected
+ *	Input: None
+ *	Output: None
+ */
+static void Control_Thread(void){
+	uint32_t last = Time_Now_MS();
+	
+	while(1){
+		Stage_Wait(TASK_IMU, &last);
+		if(Test_Mode != FULL_SYSTEM_TEST)
+			continue;
+		Task_IMU();
+		Task_Fusion();
+		Task_Servo();
+	}
+}
+
+/*
+ *	-----------------Sensor_Thread-----------------
+ *	Kernel task reading the color sensor at the "color" task rate
+ *	while the full system test is selected
+ *	Input: None
+ *	Output: None
+ */
+static void Sensor_Thread(void){
+	uint32_t last = Time_Now_MS();
+	
+	while(1){
+		Stage_Wait(TASK_COLOR, &last);
+		if(Test_Mode == FULL_SYSTEM_TEST)
+			Task_Color();
+	}
+}
+
+/*
+ *	-----------------Display_Thread----------------
+ *	Kernel task redrawing the LCD at the "lcd" task rate while the
+ *	full system test is selected
+ *	Input: None
+ *	Output: None
+ */
+static void Display_Thread(void){
+	uint32_t last = Time_Now_MS();
+	
+	while(1){
+		Stage_Wait(TASK_LCD, &last);
+		if(Test_Mode == FULL_SYSTEM_TEST)
+			Task_LCD();
+	}
+}
+
+void Module_Test_Kernel_Init(void){
+	Kernel_Task_Create(&Control_Task, "control", Control_Thread, Control_Stack, CONTROL_STACK_WORDS, CONTROL_PRIO);
+	Kernel_Task_Create(&Sensor_Task, "sensor", Sensor_Thread, Sensor_Stack, SENSOR_STACK_WORDS, SENSOR_PRIO);
+	Kernel_Task_Create(&Display_Task, "display", Display_Thread, Display_Stack, DISPLAY_STACK_WORDS, DISPLAY_PRIO);
+}
+#endif
+
+/* Every stage once, in order, for a direct Module_Test call */
+static void Test_Full_System(void){
+	Task_IMU();
+	Task_Fusion();
+	Task_Servo();
+	Task_Color();
+	Task_Telemetry();
+	Task_LCD();
+}
+
+void Module_Test(MODULE_TEST_NAME test){
+	
+	switch(test){
+		case DELAY_TEST:
+			Test_Delay();
+			break;
+		
+		case I2C_TEST:
+			Test_I2C();
+			break;
+		
+		case UART_TEST:
+			Test_UART();
+			break;
+		
+		case MPU6050_TEST:
+			Test_MPU6050();
+			break;
+		
+		case TCS34727_TEST:
+			Test_TCS34727();
+			break;
+		
+		case SERVO_TEST:
+			Test_Servo();
+			break;
+		
+		case LCD_TEST:
+			Test_LCD();
+			break;
+			
+		case FULL_SYSTEM_TEST:
+			Test_Full_System();
+			break;
+		
+		
+		default:
+			break;
+	}
+	
+}
+
+ 
+
+/*
+ *	-------------------Task_Test---------------------
+ *	Periodic task running one pass of a single peripheral test
+ *	Input: None
+ *	Output: None
+ */
+void Task_Test(void){
+	Module_Test(Test_Mode);
+}
+
+/*
+ *	---------------Test_Schedule-------------------
+ *	Local helper to enable the tasks of the selected mode, the full
+ *	system test runs its stage tasks, every other test runs in
+ *	TASK_TEST at the test period
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Schedule(void){
+	uint8_t i;
+	uint8_t full = (Test_Mode == FULL_SYSTEM_TEST);
+	
+	for(i = 0; i < sizeof(Full_Tasks)/sizeof(Full_Tasks[0]); i++){
+		if(full)
+			Sched_Enable(Full_Tasks[i]);
+		else
+			Sched_Disable(Full_Tasks[i]);
+	}
+	
+	if(full){
+		Sched_Disable(TASK_TEST);
+	}else{
+		Sched_Set_Period(TASK_TEST, Module_Test_Get_Period()*1000UL);
+		Sched_Enable(TASK_TEST);
+	}
+	Sched_Enable(TASK_BUTTON);
+}
+
+/*
+ *	-----------------Module_Test_Init-----------------
+ *	Set up the SW1 debounce timer, call after Timer_Init and before
+ *	BTN_Init arms the button interrupt
+ *	Input: None
+ *	Output: None
+ */
+void Module_Test_Init(void){
+	Timer_Setup(&Button_Timer, Button_Debounced, 0);
+}
+
+/*
+ *	---------------Module_Test_Set_Mode---------------
+ *	Select the test and enable its scheduler tasks. Peripherals the
+ *	test needs are initialized the first time a mode uses them
+ *	Input: Test to Run
+ *	Output: None
+ */
+void Module_Test_Set_Mode(MODULE_TEST_NAME test){
+	uint8_t need;
+	
+	if(test >= MODULE_TEST_COUNT)
+		return;
+	need = Test_Needs[test] & ~Test_Ready;
+	
+	if(need & NEED_WTIMER0)
+		WTIMER0_Init();
+	if(need & NEED_UART0_DMA)
+		UART0_DMA_Init();
+	if(need & NEED_I2C0)
+		I2C0_Init();
+	if(need & NEED_TCS34727)
+		TCS34727_Init();
+	if(need & NEED_MPU6050)
+		MPU6050_Init();
+	if(need & NEED_SERVO)
+		Servo_Init();
+	if(need & NEED_LCD)
+		LCD_Init();
+	if(Test_Ready & NEED_LCD)
+		LCD_Marquee_Stop();									//Only the LCD test scrolls
+	
+	Test_Ready |= need;
+	Test_Mode = test;
+	LCD_Step = 0;														//Start from a cleared display
+	Test_Schedule();
+}
+
+MODULE_TEST_NAME Module_Test_Get_Mode(void){
+	return Test_Mode;
+}
+
+/*
+ *	--------------Module_Test_Set_Period--------------
+ *	Set the period between passes of the selected test
+ *	Input: Period in ms, 0 restores the default of each test
+ *	Output: None
+ */
+void Module_Test_Set_Period(uint32_t ms){
+	Test_Period = ms;
+	if(Test_Mode != FULL_SYSTEM_TEST)
+		Sched_Set_Period(TASK_TEST, Module_Test_Get_Period()*1000UL);
+}
+
+/*
+ *	--------------Module_Test_Get_Period--------------
+ *	Input: None
+ *	Output: Period in ms currently used by the selected test
+ */
+uint32_t Module_Test_Get_Period(void){
+	return Test_Period ? Test_Period : Test_Default_Period[Test_Mode];
+}
@@ -1,23 +1,96 @@
-/*
- * ModuleTest.h
- *
- *	Provides the testing functions all of individual peripheral testing
- *	and full system testing
- *
- * Created on: September 3rd, 2023
- *		Author: Jackie Huynh
- *
- */
- 
-typedef enum{
-	DELAY_TEST,
-	UART_TEST,
-	I2C_TEST,
-	MPU6050_TEST,
-	TCS34727_TEST,
-	SERVO_TEST,
-	LCD_TEST,
-	FULL_SYSTEM_TEST
-} MODULE_TEST_NAME;
- 
-void Module_Test(MODULE_TEST_NAME test);
\ No newline at end of file
+/*
+ * ModuleTest.h
+ *
+ *	Provides the testing functions all of individual peripheral testing
+ *	and full system testing
+ *
+ * Created on: September 3rd, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+#ifndef MODULETEST_H_
+#define MODULETEST_H_
+
+#include <stdint.h>
+
+/* Uncomment to send the full system test as binary telemetry frames
+   (see Telemetry.h) over uDMA instead of ASCII text */
+//#define TELEMETRY_BINARY
+
+/* Comment out to run the full system test as cooperative scheduler
+   tasks instead of kernel tasks: the tilt to servo path (IMU, fusion,
+   servo), the color sensor and the LCD each get their own task and
+   the main loop runs the scheduler, shell and telemetry in another */
+#define KERNEL_CONTROL
+
+typedef enum{
+	DELAY_TEST,
+	UART_TEST,
+	I2C_TEST,
+	MPU6050_TEST,
+	TCS34727_TEST,
+	SERVO_TEST,
+	LCD_TEST,
+	FULL_SYSTEM_TEST
+} MODULE_TEST_NAME;
+
+#define MODULE_TEST_COUNT		(FULL_SYSTEM_TEST + 1)
+ 
+void Module_Test(MODULE_TEST_NAME test);
+
+/*
+ *	-----------------Module_Test_Init-----------------
+ *	Set up the SW1 debounce timer, call after Timer_Init and before
+ *	BTN_Init arms the button interrupt
+ *	Input: None
+ *	Output: None
+ */
+void Module_Test_Init(void);
+
+/*
+ *	---------------Module_Test_Set_Mode---------------
+ *	Select the test and enable its scheduler tasks (SchedTable.h).
+ *	Peripherals the test needs are initialized the first time a
+ *	mode uses them
+ *	Input: Test to Run
+ *	Output: None
+ */
+void Module_Test_Set_Mode(MODULE_TEST_NAME test);
+MODULE_TEST_NAME Module_Test_Get_Mode(void);
+
+/*
+ *	--------------Module_Test_Set_Period--------------
+ *	Set the period between passes of the selected test
+ *	Input: Period in ms, 0 restores the default of each test
+ *	Output: None
+ */
+void Module_Test_Set_Period(uint32_t ms);
+
+/*
+ *	--------------Module_Test_Get_Period--------------
+ *	Input: None
+ *	Output: Period in ms currently used by the selected test
+ */
+uint32_t Module_Test_Get_Period(void);
+
+#ifdef KERNEL_CONTROL
+/* Kernel priority of the main loop task, below every test stage task.
+   The I2C bus lock has no priority inheritance, so a task that holds
+   it may only be kept off the CPU by tasks that wait for the bus too
+   or block (I2C and UART0 waits both pend on the kernel). The main
+   loop runs the longest CPU work (shell, telemetry, log) and takes
+   the bus itself, so it goes last */
+#define MODULE_TEST_MAIN_PRIO		(5)
+
+/*
+ *	-------------Module_Test_Kernel_Init--------------
+ *	Create the control, sensor and display tasks, call before
+ *	Kernel_Start
+ *	Input: None
+ *	Output: None
+ */
+void Module_Test_Kernel_Init(void);
+#endif
+
+#endif
@@ -0,0 +1,518 @@
+/*
+ * Param.c
+ *
+ *	Main implementation of the parameter registry. The values live
+ *	in one array of 32-bit words indexed by ID, the descriptors in a
+ *	constant table built from ParamTable.h. A setter clamps the new
+ *	value first and then stores it with a single word write, so the
+ *	control loop never sees a half written value.
+ *
+ *	The persistent values are kept in the last 1 KB page of the
+ *	256 KB flash, which the program never reaches.
+ *
+ * Created on: November 27, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Param.h"
+#include "Telemetry.h"
+#include "UART0.h"
+#include "Log.h"
+#include "Servo.h"
+#include "MPU6050.h"
+#include "tm4c123gh6pm.h"
+#include <string.h>
+
+/* Flash Page Holding the Saved Values, the build may override it */
+#ifndef PARAM_FLASH_ADDR
+#define PARAM_FLASH_ADDR				(0x0003FC00)
+#endif
+#define PARAM_FLASH_PAGE_SIZE		(1024)
+#define PARAM_FLASH_MAGIC				(0x314D5250UL)		//"PRM1"
+
+#define FLASH_FCRIS_ERRORS			(FLASH_FCRIS_ARIS | FLASH_FCRIS_VOLTRIS | FLASH_FCRIS_INVDRIS | \
+																 FLASH_FCRIS_ERRIS | FLASH_FCRIS_PROGRIS)
+
+#define INT32_MAX_VALUE					(2147483647L)
+#define INT32_MIN_VALUE					(-2147483647L - 1)
+
+/* Image of the flash page */
+typedef struct{
+	uint32_t Magic;
+	uint32_t Layout;
+	uint32_t Value[PARAM_COUNT];
+	uint32_t Check;
+} PARAM_FLASH_t;
+
+/* Fails to compile if the table outgrows the flash page */
+typedef char PARAM_FLASH_FITS[(sizeof(PARAM_FLASH_t) <= PARAM_FLASH_PAGE_SIZE) ? 1 : -1];
+
+#define PARAM_INT(id, name, unit, def, min, max, flags) \
+	{name, unit, PARAM_TYPE_INT, flags, {.i = (def)}, {.i = (min)}, {.i = (max)}},
+#define PARAM_FLOAT(id, name, unit, def, min, max, flags) \
+	{name, unit, PARAM_TYPE_FLOAT, flags, {.f = (def)}, {.f = (min)}, {.f = (max)}},
+#define PARAM_Q16(id, name, unit, def, min, max, flags) \
+	{name, unit, PARAM_TYPE_Q16, flags, {.i = PARAM_TO_Q16(def)}, {.i = PARAM_TO_Q16(min)}, {.i = PARAM_TO_Q16(max)}},
+static const PARAM_INFO_t ParamInfo[PARAM_COUNT] = {
+	PARAM_TABLE
+};
+#undef PARAM_INT
+#undef PARAM_FLOAT
+#undef PARAM_Q16
+
+static volatile PARAM_VALUE_t ParamValue[PARAM_COUNT];
+static uint32_t ParamLayout;									//Signature of the table, set by Param_Init
+
+/*
+ *	-----------------Param_Float_To_Int----------------
+ *	Local helper to round a float to the nearest int32, saturating
+ *	Input: Value
+ *	Output: Rounded Value
+ */
+static int32_t Param_Float_To_Int(float f){
+	if(f != f)
+		return 0;
+	if(f >= 2147483520.0f)
+		return INT32_MAX_VALUE;
+	if(f <= -2147483648.0f)
+		return INT32_MIN_VALUE;
+	return (int32_t)((f < 0.0f) ? (f - 0.5f) : (f + 0.5f));
+}
+
+/*
+ *	-----------------Param_Int_To_Q16------------------
+ *	Local helper to convert an integer to 16.16, saturating
+ *	Input: Value
+ *	Output: 16.16 Value
+ */
+static int32_t Param_Int_To_Q16(int32_t v){
+	if(v > 32767)
+		return INT32_MAX_VALUE;
+	if(v < -32768)
+		return INT32_MIN_VALUE;
+	return v * PARAM_Q16_ONE;
+}
+
+/*
+ *	--------------------Param_Store--------------------
+ *	Local helper to limit a value (in the type of the parameter) to
+ *	its range and publish it with one word write
+ *	Input: Parameter ID, Value
+ *	Output: PARAM_OK, PARAM_CLAMPED or PARAM_ERR_REQUEST for a NaN
+ */
+static PARAM_STATUS Param_Store(PARAM_ID_t id, PARAM_VALUE_t v){
+	const PARAM_INFO_t* info = &ParamInfo[id];
+	PARAM_STATUS status = PARAM_OK;
+
+	if(info->Type == PARAM_TYPE_FLOAT){
+		if(v.f != v.f)
+			return PARAM_ERR_REQUEST;
+		if(v.f < info->Min.f){
+			v.f = info->Min.f;
+			status = PARAM_CLAMPED;
+		}else if(v.f > info->Max.f){
+			v.f = info->Max.f;
+			status = PARAM_CLAMPED;
+		}
+	}else{
+		if(v.i < info->Min.i){
+			v.i = info->Min.i;
+			status = PARAM_CLAMPED;
+		}else if(v.i > info->Max.i){
+			v.i = info->Max.i;
+			status = PARAM_CLAMPED;
+		}
+	}
+
+	ParamValue[id].u = v.u;
+	return status;
+}
+
+/*
+ *	------------------Param_Layout_Hash----------------
+ *	Local helper to sign the table layout (count, names and types)
+ *	so flash written by a different table is never loaded
+ *	Input: none
+ *	Output: Layout Signature
+ */
+static uint32_t Param_Layout_Hash(void){
+	uint16_t crc = 0xFFFF;
+	uint8_t i;
+
+	for(i = 0; i < PARAM_COUNT; i++){
+		crc = Telemetry_CRC16((const uint8_t*)ParamInfo[i].Name, strlen(ParamInfo[i].Name) + 1, crc);
+		crc = Telemetry_CRC16(&ParamInfo[i].Type, 1, crc);
+	}
+	return ((uint32_t)PARAM_COUNT << 16) | crc;
+}
+
+/*
+ *	---------------------Param_Init--------------------
+ *	Load the defaults, then any valid values saved in flash
+ *	Input: none
+ *	Output: none
+ */
+void Param_Init(void){
+	uint8_t i;
+
+	ParamLayout = Param_Layout_Hash();
+	for(i = 0; i < PARAM_COUNT; i++)
+		ParamValue[i].u = ParamInfo[i].Default.u;
+	
+	if(Param_Load() == PARAM_OK)
+		LOG1(LOG_PARAM_LOADED, PARAM_COUNT);
+	else
+		LOG0(LOG_PARAM_DEFAULTS);
+}
+
+int32_t Param_Get_Int(PARAM_ID_t id){
+	PARAM_VALUE_t v;
+	v.u = ParamValue[id].u;
+	switch(ParamInfo[id].Type){
+		case PARAM_TYPE_FLOAT:
+			return Param_Float_To_Int(v.f);
+		case PARAM_TYPE_Q16:
+			return v.i / PARAM_Q16_ONE;
+		default:
+			return v.i;
+	}
+}
+
+float Param_Get_Float(PARAM_ID_t id){
+	PARAM_VALUE_t v;
+	v.u = ParamValue[id].u;
+	switch(ParamInfo[id].Type){
+		case PARAM_TYPE_FLOAT:
+			return v.f;
+		case PARAM_TYPE_Q16:
+			return (float)v.i * (1.0f / PARAM_Q16_ONE);
+		default:
+			return (float)v.i;
+	}
+}
+
+int32_t Param_Get_Q16(PARAM_ID_t id){
+	PARAM_VALUE_t v;
+	v.u = ParamValue[id].u;
+	switch(ParamInfo[id].Type){
+		case PARAM_TYPE_FLOAT:
+			return Param_Float_To_Int(v.f * PARAM_Q16_ONE);
+		case PARAM_TYPE_Q16:
+			return v.i;
+		default:
+			return Param_Int_To_Q16(v.i);
+	}
+}
+
+/*
+ *	--------------------Param_Get_Raw------------------
+ *	Read the stored word of a parameter, in its own type
+ *	Input: Parameter ID (must be valid)
+ *	Output: Raw 32-bit word
+ */
+uint32_t Param_Get_Raw(PARAM_ID_t id){
+	return ParamValue[id].u;
+}
+
+PARAM_STATUS Param_Set_Int(PARAM_ID_t id, int32_t value){
+	PARAM_VALUE_t v;
+
+	if(id >= PARAM_COUNT)
+		return PARAM_ERR_ID;
+	if(ParamInfo[id].Flags & PARAM_F_READONLY)
+		return PARAM_ERR_READONLY;
+
+	switch(ParamInfo[id].Type){
+		case PARAM_TYPE_FLOAT:
+			v.f = (float)value;
+			break;
+		case PARAM_TYPE_Q16:
+			v.i = Param_Int_To_Q16(value);
+			break;
+		default:
+			v.i = value;
+			break;
+	}
+	return Param_Store(id, v);
+}
+
+PARAM_STATUS Param_Set_Float(PARAM_ID_t id, float value){
+	PARAM_VALUE_t v;
+
+	if(id >= PARAM_COUNT)
+		return PARAM_ERR_ID;
+	if(ParamInfo[id].Flags & PARAM_F_READONLY)
+		return PARAM_ERR_READONLY;
+	if(value != value)
+		return PARAM_ERR_REQUEST;
+
+	switch(ParamInfo[id].Type){
+		case PARAM_TYPE_FLOAT:
+			v.f = value;
+			break;
+		case PARAM_TYPE_Q16:
+			v.i = Param_Float_To_Int(value * PARAM_Q16_ONE);
+			break;
+		default:
+			v.i = Param_Float_To_Int(value);
+			break;
+	}
+	return Param_Store(id, v);
+}
+
+/*
+ *	--------------------Param_Set_Raw------------------
+ *	Write the stored word of a parameter, in its own type
+ *	Input: Parameter ID, Raw 32-bit word
+ *	Output: PARAM_OK, PARAM_CLAMPED or the reason it was rejected
+ */
+PARAM_STATUS Param_Set_Raw(PARAM_ID_t id, uint32_t raw){
+	PARAM_VALUE_t v;
+
+	if(id >= PARAM_COUNT)
+		return PARAM_ERR_ID;
+	if(ParamInfo[id].Flags & PARAM_F_READONLY)
+		return PARAM_ERR_READONLY;
+
+	v.u = raw;
+	return Param_Store(id, v);
+}
+
+/*
+ *	--------------------Param_Info---------------------
+ *	Input: Parameter ID
+ *	Output: Descriptor, 0 if the ID is not valid
+ */
+const PARAM_INFO_t* Param_Info(PARAM_ID_t id){
+	if(id >= PARAM_COUNT)
+		return 0;
+	return &ParamInfo[id];
+}
+
+/*
+ *	--------------------Param_Find---------------------
+ *	Look a parameter up by name (linear, not for the control loop)
+ *	Input: Name
+ *	Output: Parameter ID, PARAM_COUNT if there is no such name
+ */
+PARAM_ID_t Param_Find(const char* name){
+	uint8_t i;
+
+	for(i = 0; i < PARAM_COUNT; i++){
+		if(strcmp(ParamInfo[i].Name, name) == 0)
+			return (PARAM_ID_t)i;
+	}
+	return PARAM_COUNT;
+}
+
+/*
+ *	-------------------Param_Defaults------------------
+ *	Restore every writable parameter to its default
+ *	Input: none
+ *	Output: none
+ */
+void Param_Defaults(void){
+	uint8_t i;
+
+	for(i = 0; i < PARAM_COUNT; i++){
+		if(!(ParamInfo[i].Flags & PARAM_F_READONLY))
+			ParamValue[i].u = ParamInfo[i].Default.u;
+	}
+}
+
+/*
+ *	--------------------Flash_Erase--------------------
+ *	Local helper to erase one 1 KB flash page
+ *	Input: Page Address
+ *	Output: 0 on success, 1 on a flash error
+ */
+static uint8_t Flash_Erase(uint32_t addr){
+	FLASH_FCMISC_R = FLASH_FCRIS_ERRORS;					//Clear old errors
+	FLASH_FMA_R = addr & FLASH_FMA_OFFSET_M;
+	FLASH_FMC_R = FLASH_FMC_WRKEY | FLASH_FMC_ERASE;
+	while(FLASH_FMC_R & FLASH_FMC_ERASE);
+	return (FLASH_FCRIS_R & FLASH_FCRIS_ERRORS) ? 1 : 0;
+}
+
+/*
+ *	--------------------Flash_Write--------------------
+ *	Local helper to program and verify one word of an erased page
+ *	Input: Word Address, Data
+ *	Output: 0 on success, 1 on a flash error
+ */
+static uint8_t Flash_Write(uint32_t addr, uint32_t data){
+	FLASH_FMD_R = data;
+	FLASH_FMA_R = addr & FLASH_FMA_OFFSET_M;
+	FLASH_FMC_R = FLASH_FMC_WRKEY | FLASH_FMC_WRITE;
+	while(FLASH_FMC_R & FLASH_FMC_WRITE);
+	if(FLASH_FCRIS_R & FLASH_FCRIS_ERRORS)
+		return 1;
+	return (*(volatile const uint32_t*)addr != data) ? 1 : 0;
+}
+
+/*
+ *	---------------------Param_Save--------------------
+ *	Erase the parameter flash page and write the persistent values.
+ *	Execution stalls for the erase (~10-20 ms), do not call it
+ *	while a timing critical test is running
+ *	Input: none
+ *	Output: PARAM_OK or PARAM_ERR_FLASH
+ */
+PARAM_STATUS Param_Save(void){
+	PARAM_FLASH_t image;
+	const uint32_t* word = (const uint32_t*)&image;
+	uint32_t i;
+
+	image.Magic = PARAM_FLASH_MAGIC;
+	image.Layout = ParamLayout;
+	for(i = 0; i < PARAM_COUNT; i++){
+		image.Value[i] = (ParamInfo[i].Flags & PARAM_F_PERSIST) ? ParamValue[i].u : ParamInfo[i].Default.u;
+	}
+	image.Check = Telemetry_CRC16((const uint8_t*)&image, sizeof(image) - sizeof(image.Check), 0xFFFF);
+
+	if(Flash_Erase(PARAM_FLASH_ADDR))
+		return PARAM_ERR_FLASH;
+	for(i = 0; i < sizeof(image)/sizeof(uint32_t); i++){
+		if(Flash_Write(PARAM_FLASH_ADDR + 4*i, word[i]))
+			return PARAM_ERR_FLASH;
+	}
+	return PARAM_OK;
+}
+
+/*
+ *	---------------------Param_Load--------------------
+ *	Restore the persistent values from flash if the page is valid
+ *	and was written with the current table layout
+ *	Input: none
+ *	Output: PARAM_OK or PARAM_ERR_FLASH if nothing was restored
+ */
+PARAM_STATUS Param_Load(void){
+	const PARAM_FLASH_t* image = (const PARAM_FLASH_t*)PARAM_FLASH_ADDR;
+	PARAM_VALUE_t v;
+	uint8_t i;
+
+	if(image->Magic != PARAM_FLASH_MAGIC || image->Layout != ParamLayout)
+		return PARAM_ERR_FLASH;
+	if(image->Check != Telemetry_CRC16((const uint8_t*)image, sizeof(*image) - sizeof(image->Check), 0xFFFF))
+		return PARAM_ERR_FLASH;
+
+	for(i = 0; i < PARAM_COUNT; i++){
+		if((ParamInfo[i].Flags & (PARAM_F_PERSIST | PARAM_F_READONLY)) == PARAM_F_PERSIST){
+			v.u = image->Value[i];
+			Param_Store((PARAM_ID_t)i, v);				//Still range checked
+		}
+	}
+	return PARAM_OK;
+}
+
+/*
+ *	-------------------Param_Put_U32-------------------
+ *	Local helper to append a little endian word to a reply
+ *	Input: Output Position, Value
+ *	Output: Position after the word
+ */
+static uint8_t* Param_Put_U32(uint8_t* p, uint32_t v){
+	*p++ = (uint8_t)v;
+	*p++ = (uint8_t)(v >> 8);
+	*p++ = (uint8_t)(v >> 16);
+	*p++ = (uint8_t)(v >> 24);
+	return p;
+}
+
+/*
+ *	-------------------Param_Put_Str-------------------
+ *	Local helper to append a NUL terminated string, cut to fit
+ *	Input: Output Position, End of the Buffer, String
+ *	Output: Position after the terminator
+ */
+static uint8_t* Param_Put_Str(uint8_t* p, const uint8_t* end, const char* s){
+	while(*s && p < end - 1)
+		*p++ = (uint8_t)*s++;
+	*p++ = '\0';
+	return p;
+}
+
+/*
+ *	-----------------Param_Handle_Frame----------------
+ *	Handle one TLM_TYPE_PARAM request and send the reply on UART0
+ *	Input: Request Sequence Number, Payload, Payload Length
+ *	Output: none
+ */
+void Param_Handle_Frame(uint16_t seq, const uint8_t* payload, uint32_t len){
+	uint8_t reply[TLM_MAX_PAYLOAD];
+	uint8_t frame[TLM_MAX_FRAME];
+	uint8_t* p = &reply[2];
+	const uint8_t* end = &reply[TLM_MAX_PAYLOAD];
+	PARAM_STATUS status = PARAM_OK;
+	PARAM_ID_t id;
+	uint32_t value;
+	uint8_t op;
+
+	if(len == 0)
+		return;
+	op = payload[0];
+	id = (len >= 2) ? (PARAM_ID_t)payload[1] : PARAM_COUNT;
+
+	switch(op){
+		case TLM_PARAM_OP_LIST:
+		case TLM_PARAM_OP_GET:
+			if(len != 2){
+				status = PARAM_ERR_REQUEST;
+				break;
+			}
+			if(id >= PARAM_COUNT){
+				status = PARAM_ERR_ID;
+				break;
+			}
+			if(op == TLM_PARAM_OP_LIST){
+				*p++ = PARAM_COUNT;
+				*p++ = (uint8_t)id;
+				*p++ = ParamInfo[id].Type;
+				*p++ = ParamInfo[id].Flags;
+				p = Param_Put_U32(p, ParamValue[id].u);
+				p = Param_Put_U32(p, ParamInfo[id].Min.u);
+				p = Param_Put_U32(p, ParamInfo[id].Max.u);
+				p = Param_Put_Str(p, end - 1, ParamInfo[id].Name);
+				p = Param_Put_Str(p, end, ParamInfo[id].Unit);
+			}else{
+				*p++ = (uint8_t)id;
+				p = Param_Put_U32(p, ParamValue[id].u);
+			}
+			break;
+
+		case TLM_PARAM_OP_SET:
+			if(len != 6){
+				status = PARAM_ERR_REQUEST;
+				break;
+			}
+			value = (uint32_t)payload[2] | ((uint32_t)payload[3] << 8) |
+							((uint32_t)payload[4] << 16) | ((uint32_t)payload[5] << 24);
+			status = Param_Set_Raw(id, value);
+			if(id < PARAM_COUNT){
+				*p++ = (uint8_t)id;
+				p = Param_Put_U32(p, ParamValue[id].u);
+			}
+			break;
+
+		case TLM_PARAM_OP_SAVE:
+			status = Param_Save();
+			break;
+
+		case TLM_PARAM_OP_LOAD:
+			status = Param_Load();
+			break;
+
+		case TLM_PARAM_OP_DEFAULTS:
+			Param_Defaults();
+			break;
+
+		default:
+			status = PARAM_ERR_REQUEST;
+			break;
+	}
+
+	reply[0] = op | TLM_PARAM_REPLY;
+	reply[1] = (uint8_t)status;
+	UART0_Write(frame, Telemetry_Pack(TLM_TYPE_PARAM, seq, reply, (uint32_t)(p - reply), frame));
+}
@@ -0,0 +1,175 @@
+/*
+ * Param.h
+ *
+ *	Provides the runtime parameter registry. Every parameter listed
+ *	in ParamTable.h is a single 32-bit word (int32, float or 16.16
+ *	fixed point) with a name, unit, range and flags. Values are read
+ *	and written by ID in constant time, and since each access is one
+ *	aligned word load or store it is atomic with respect to any
+ *	interrupt, no masking needed.
+ *
+ *	Parameters flagged PARAM_F_PERSIST are kept in the last page of
+ *	flash by Param_Save and restored by Param_Init.
+ *
+ *	The host reaches the registry with TLM_TYPE_PARAM frames (see
+ *	Telemetry.h), handled by Param_Handle_Frame.
+ *
+ * Created on: November 27, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef PARAM_H_
+#define PARAM_H_
+
+#include <stdint.h>
+#include "ParamTable.h"
+
+/* Parameter Flags */
+#define PARAM_F_PERSIST				(0x01)		//Saved to flash by Param_Save
+#define PARAM_F_READONLY			(0x02)		//Rejected by the setters
+
+/* Fixed Point Helpers, 16.16 */
+#define PARAM_Q16_ONE					(65536L)
+#define PARAM_TO_Q16(x)				((int32_t)((x) * PARAM_Q16_ONE))
+
+/* Parameter IDs, one per ParamTable.h entry */
+#define PARAM_INT(id, name, unit, def, min, max, flags)			id,
+#define PARAM_FLOAT(id, name, unit, def, min, max, flags)		id,
+#define PARAM_Q16(id, name, unit, def, min, max, flags)			id,
+typedef enum{
+	PARAM_TABLE
+	PARAM_COUNT
+} PARAM_ID_t;
+#undef PARAM_INT
+#undef PARAM_FLOAT
+#undef PARAM_Q16
+
+typedef enum{
+	PARAM_TYPE_INT		= 0,
+	PARAM_TYPE_FLOAT	= 1,
+	PARAM_TYPE_Q16		= 2
+} PARAM_TYPE_t;
+
+typedef enum{
+	PARAM_OK					= 0,
+	PARAM_CLAMPED			= 1,			//Stored, but limited to min/max
+	PARAM_ERR_ID			= 2,
+	PARAM_ERR_READONLY	= 3,
+	PARAM_ERR_FLASH		= 4,
+	PARAM_ERR_REQUEST	= 5
+} PARAM_STATUS;
+
+/* One stored word, .i for int32 and 16.16, .f for float */
+typedef union{
+	int32_t i;
+	float f;
+	uint32_t u;
+} PARAM_VALUE_t;
+
+/* Descriptor, min/max/default are in the type of the parameter */
+typedef struct{
+	const char* Name;
+	const char* Unit;
+	uint8_t Type;
+	uint8_t Flags;
+	PARAM_VALUE_t Default;
+	PARAM_VALUE_t Min;
+	PARAM_VALUE_t Max;
+} PARAM_INFO_t;
+
+/*
+ *	---------------------Param_Init--------------------
+ *	Load the defaults, then any valid values saved in flash
+ *	Input: none
+ *	Output: none
+ */
+void Param_Init(void);
+
+/*
+ *	--------------------Param_Get_xxx------------------
+ *	Read a parameter, converted to the requested type
+ *	Input: Parameter ID (must be valid)
+ *	Output: Value
+ */
+int32_t Param_Get_Int(PARAM_ID_t id);
+float Param_Get_Float(PARAM_ID_t id);
+int32_t Param_Get_Q16(PARAM_ID_t id);
+
+/*
+ *	--------------------Param_Get_Raw------------------
+ *	Read the stored word of a parameter, in its own type
+ *	Input: Parameter ID (must be valid)
+ *	Output: Raw 32-bit word
+ */
+uint32_t Param_Get_Raw(PARAM_ID_t id);
+
+/*
+ *	--------------------Param_Set_xxx------------------
+ *	Write a parameter, converted from the given type and limited
+ *	to its range
+ *	Input: Parameter ID, Value
+ *	Output: PARAM_OK, PARAM_CLAMPED or the reason it was rejected
+ */
+PARAM_STATUS Param_Set_Int(PARAM_ID_t id, int32_t value);
+PARAM_STATUS Param_Set_Float(PARAM_ID_t id, float value);
+
+/*
+ *	--------------------Param_Set_Raw------------------
+ *	Write the stored word of a parameter, in its own type
+ *	Input: Parameter ID, Raw 32-bit word
+ *	Output: PARAM_OK, PARAM_CLAMPED or the reason it was rejected
+ */
+PARAM_STATUS Param_Set_Raw(PARAM_ID_t id, uint32_t raw);
+
+/*
+ *	--------------------Param_Info---------------------
+ *	Input: Parameter ID
+ *	Output: Descriptor, 0 if the ID is not valid
+ */
+const PARAM_INFO_t* Param_Info(PARAM_ID_t id);
+
+/*
+ *	--------------------Param_Find---------------------
+ *	Look a parameter up by name (linear, not for the control loop)
+ *	Input: Name
+ *	Output: Parameter ID, PARAM_COUNT if there is no such name
+ */
+PARAM_ID_t Param_Find(const char* name);
+
+/*
+ *	-------------------Param_Defaults------------------
+ *	Restore every writable parameter to its default
+ *	Input: none
+ *	Output: none
+ */
+void Param_Defaults(void);
+
+/*
+ *	---------------------Param_Save--------------------
+ *	Erase the parameter flash page and write the persistent values.
+ *	Execution stalls for the erase (~10-20 ms), do not call it
+ *	while a timing critical test is running
+ *	Input: none
+ *	Output: PARAM_OK or PARAM_ERR_FLASH
+ */
+PARAM_STATUS Param_Save(void);
+
+/*
+ *	---------------------Param_Load--------------------
+ *	Restore the persistent values from flash if the page is valid
+ *	and was written with the current table layout
+ *	Input: none
+ *	Output: PARAM_OK or PARAM_ERR_FLASH if nothing was restored
+ */
+PARAM_STATUS Param_Load(void);
+
+/*
+ *	-----------------Param_Handle_Frame----------------
+ *	Handle one TLM_TYPE_PARAM request and send the reply on UART0
+ *	Input: Request Sequence Number, Payload, Payload Length
+ *	Output: none
+ */
+void Param_Handle_Frame(uint16_t seq, const uint8_t* payload, uint32_t len);
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * ParamTable.h
+ *
+ *	Table of every runtime tunable parameter. Included by Param.h to
+ *	build the ID enum and by Param.c to build the descriptors, so
+ *	the two always agree. Each entry is one of
+ *
+ *		PARAM_INT(id, name, unit, default, min, max, flags)			int32
+ *		PARAM_FLOAT(id, name, unit, default, min, max, flags)		float
+ *		PARAM_Q16(id, name, unit, default, min, max, flags)			16.16 fixed point
+ *
+ *	Defaults may name the driver macros (Servo.h, MPU6050.h), the
+ *	table is only expanded where those headers are included.
+ *
+ *	Only append to the end of the table. The values saved in flash
+ *	are discarded whenever the layout (names, types, order) changes.
+ *
+ * Created on: November 27, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef PARAMTABLE_H_
+#define PARAMTABLE_H_
+
+#define PARAM_TABLE \
+	PARAM_INT(PARAM_SERVO_MIN_US,			"servo.min_us",			"us",		SERVO_MIN_US,		200,		2800,		PARAM_F_PERSIST) \
+	PARAM_INT(PARAM_SERVO_MAX_US,			"servo.max_us",			"us",		SERVO_MAX_US,		200,		2800,		PARAM_F_PERSIST) \
+	PARAM_Q16(PARAM_SERVO_GAIN,				"servo.gain",				"",			1.0,		-4.0,		4.0,		PARAM_F_PERSIST) \
+	PARAM_Q16(PARAM_SERVO_OFFSET,			"servo.offset",			"deg",	0.0,		-90.0,	90.0,		PARAM_F_PERSIST) \
+	PARAM_FLOAT(PARAM_GYRO_DEADBAND,	"imu.deadband",			"dps",	MPU6050_GYRO_DEADBAND_DEFAULT,	0.0f,		250.0f,	PARAM_F_PERSIST) \
+	PARAM_FLOAT(PARAM_ANGLE_ALPHA,		"imu.alpha",				"",			MPU6050_ANGLE_ALPHA_DEFAULT,		0.01f,	1.0f,		PARAM_F_PERSIST) \
+	PARAM_INT(PARAM_COLOR_MIN_CLEAR,	"color.min_clear",	"cnt",	0,			0,			65535,	PARAM_F_PERSIST) \
+	PARAM_FLOAT(PARAM_COLOR_MARGIN,		"color.margin",			"",			0.0f,		0.0f,		1.0f,		PARAM_F_PERSIST)
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Profile.c
+ *
+ *	Main implementation of the region profiler. A run only updates
+ *	the statistics of its own region with interrupts masked for a
+ *	handful of instructions, so markers may be used in interrupts
+ *	and in preempting kernel tasks.
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Profile.h"
+
+#if PROFILE_ENABLE
+
+#include "tm4c123gh6pm.h"
+#include <string.h>
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+/* Local Macros */
+#define PROFILE_CAL_RUNS			(8)							//Shortest empty region is the marker cost
+
+#ifdef PROFILE_PORT_TARGET
+/* Data Watchpoint and Trace unit, shared with the Log.c timestamps */
+#define DWT_CTRL_R						(*((volatile unsigned long *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA		(0x00000001)
+#define DEMCR_TRCENA					(0x01000000)		//Bit 24 of NVIC_DBG_INT_R (DEMCR)
+#endif
+
+/* Region names, from ProfileTable.h */
+#define PROFILE_REGION(id, name)		name,
+static const char* const Profile_Names[PROFILE_REGION_COUNT] = {
+	PROFILE_REGION_TABLE
+};
+#undef PROFILE_REGION
+
+static PROFILE_STATS_t ProfileStats[PROFILE_REGION_COUNT];
+static uint32_t ProfileCost;									//Cycles of an empty BEGIN/END pair
+
+/*
+ *	------------------Profile_Bin----------------------
+ *	Local helper
+ *	Input: Cycles
+ *	Output: Histogram bin, the index of the highest set bit
+ */
+static uint32_t Profile_Bin(uint32_t cycles){
+	return 31 - (uint32_t)__builtin_clz(cycles | 1);
+}
+
+void Profile_Init(void){
+	uint32_t best = 0xFFFFFFFF, cycles;
+	uint8_t i;
+
+#ifdef PROFILE_PORT_TARGET
+	/* Log_Init may already run it, only enable (never clear) the counter */
+	NVIC_DBG_INT_R |= DEMCR_TRCENA;
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+#endif
+
+	for(i = 0; i < PROFILE_CAL_RUNS; i++){
+		uint32_t start = PROFILE_NOW();
+		cycles = PROFILE_NOW() - start;
+		if(cycles < best)
+			best = cycles;
+	}
+	ProfileCost = best;
+	Profile_Reset();
+}
+
+void Profile_Record(PROFILE_ID_t id, uint32_t cycles){
+	PROFILE_STATS_t* st = &ProfileStats[id];
+	uint32_t bin;
+	long sr;
+
+	cycles = (cycles > ProfileCost) ? cycles - ProfileCost : 0;
+	bin = Profile_Bin(cycles);
+
+	sr = StartCritical();
+	if(st->Count == 0 || cycles < st->Min)
+		st->Min = cycles;
+	if(cycles > st->Max)
+		st->Max = cycles;
+	st->Count++;
+	st->Sum += cycles;
+	st->Hist[bin]++;
+	EndCritical(sr);
+}
+
+void Profile_Reset(void){
+	long sr = StartCritical();
+
+	memset(ProfileStats, 0, sizeof(ProfileStats));
+	EndCritical(sr);
+}
+
+void Profile_Read(PROFILE_ID_t id, PROFILE_STATS_t* st){
+	long sr = StartCritical();
+
+	*st = ProfileStats[id];
+	EndCritical(sr);
+}
+
+const char* Profile_Name(PROFILE_ID_t id){
+	return Profile_Names[id];
+}
+
+#endif
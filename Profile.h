@@ -0,0 +1,129 @@
+/*
+ * Profile.h
+ *
+ *	Provides cycle accurate profiling of the code regions listed in
+ *	ProfileTable.h. A region is timed with the Cortex-M4 DWT cycle
+ *	counter between a PROFILE_BEGIN and PROFILE_END marker, which
+ *	cost two counter reads and one short masked update. Every region
+ *	keeps its count, min, max and mean and a log2 histogram of the
+ *	times in RAM, the shell "prof" command prints them.
+ *
+ *	Times are in core clock cycles. Bin b of the histogram counts the
+ *	runs that took 2^b to 2^(b+1)-1 cycles. A run that is preempted
+ *	or interrupted includes the time of the other code, which shows
+ *	up as a second group of bins far above the usual one.
+ *
+ *	Set PROFILE_ENABLE to 0 (here or in the project defines) and the
+ *	markers, Profile_Init and the shell command compile to nothing.
+ *
+ *	The cycle counter is a port macro, Host/profile_host_port.h
+ *	replaces it with the host's monotonic clock scaled to SYSCLK_HZ,
+ *	so host builds of the drivers print comparable numbers.
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+#include "ProfileTable.h"
+#include "SysClock.h"
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE				(1)
+#endif
+
+/* Histogram bins, one per bit of the 32-bit cycle count */
+#define PROFILE_BINS					(32)
+
+/* Cycle source, the build may override it (host clock) */
+#ifndef PROFILE_NOW
+#define PROFILE_DWT_CYCCNT_R	(*((volatile unsigned long *)0xE0001004))
+#define PROFILE_NOW()					((uint32_t)PROFILE_DWT_CYCCNT_R)
+#define PROFILE_PORT_TARGET
+#endif
+
+/* Region IDs, one per ProfileTable.h entry */
+#define PROFILE_REGION(id, name)		id,
+typedef enum{
+	PROFILE_REGION_TABLE
+	PROFILE_REGION_COUNT
+} PROFILE_ID_t;
+#undef PROFILE_REGION
+
+/* Statistics of one region, since Profile_Init or Profile_Reset */
+typedef struct{
+	uint32_t Count;
+	uint32_t Min;									//Cycles
+	uint32_t Max;
+	uint64_t Sum;
+	uint32_t Hist[PROFILE_BINS];
+} PROFILE_STATS_t;
+
+#if PROFILE_ENABLE
+
+/*
+ *	--------------------PROFILE_xxx--------------------
+ *	Time a region. BEGIN declares the start stamp, so it must be a
+ *	statement of its own in the block that also holds the matching
+ *	END, and a region can only be opened once per block
+ *	Input: Region ID
+ *	Output: none
+ */
+#define PROFILE_BEGIN(id)			uint32_t Profile_Start_##id = PROFILE_NOW()
+#define PROFILE_END(id)				Profile_Record(id, PROFILE_NOW() - Profile_Start_##id)
+
+/*
+ *	--------------------Profile_Init-------------------
+ *	Start the DWT cycle counter if Log_Init has not, measure the
+ *	marker cost and clear every region
+ *	Input: none
+ *	Output: none
+ */
+void Profile_Init(void);
+
+/*
+ *	-------------------Profile_Record------------------
+ *	Add one run to a region, the marker cost is taken off. Use
+ *	PROFILE_END instead of calling it directly. Safe from interrupts
+ *	Input: Region ID, Cycles
+ *	Output: none
+ */
+void Profile_Record(PROFILE_ID_t id, uint32_t cycles);
+
+/*
+ *	-------------------Profile_Reset-------------------
+ *	Clear the statistics of every region
+ *	Input: none
+ *	Output: none
+ */
+void Profile_Reset(void);
+
+/*
+ *	-------------------Profile_Read--------------------
+ *	Copy the statistics of a region, consistent even while it is
+ *	being recorded
+ *	Input: Region ID (must be valid), Copy (written)
+ *	Output: none
+ */
+void Profile_Read(PROFILE_ID_t id, PROFILE_STATS_t* st);
+
+/*
+ *	-------------------Profile_Name--------------------
+ *	Input: Region ID (must be valid)
+ *	Output: Name of the region
+ */
+const char* Profile_Name(PROFILE_ID_t id);
+
+#else
+
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#define Profile_Init()
+
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * ProfileTable.h
+ *
+ *	Table of every profiled code region. Included by Profile.h to
+ *	build the ID enum and by Profile.c to build the name list. Each
+ *	entry is
+ *
+ *		PROFILE_REGION(id, name)
+ *
+ *	The name is what the shell "prof" command prints. A region is
+ *	timed by a PROFILE_BEGIN(id) / PROFILE_END(id) pair in the module
+ *	that owns the code.
+ *
+ * Created on: December 3, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef PROFILETABLE_H_
+#define PROFILETABLE_H_
+
+#define PROFILE_REGION_TABLE \
+	PROFILE_REGION(PROF_I2C_RX,			"i2c_rx") \
+	PROFILE_REGION(PROF_I2C_TX,			"i2c_tx") \
+	PROFILE_REGION(PROF_MPU_READ,		"mpu_read") \
+	PROFILE_REGION(PROF_MPU_ANGLE,	"mpu_angle") \
+	PROFILE_REGION(PROF_TCS_READ,		"tcs_read") \
+	PROFILE_REGION(PROF_LCD_FLUSH,	"lcd_flush") \
+	PROFILE_REGION(PROF_TELEMETRY,	"telemetry")
+
+#endif
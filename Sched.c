@@ -0,0 +1,198 @@
+/*
+ * Sched.c
+ *
+ *	Main implementation of the cooperative scheduler. Tasks are
+ *	scanned in table order on every Sched_Run, the first ready one
+ *	runs. Event flags are single bytes, set by Sched_Post and cleared
+ *	only here, so posting from an interrupt needs no masking.
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Sched.h"
+#include "Time.h"
+#include <string.h>
+
+typedef void (*SCHED_FUNC_t)(void);
+
+typedef struct{
+	const char* Name;
+	SCHED_FUNC_t Func;
+	uint32_t Default_Period;
+} SCHED_TASK_t;
+
+typedef struct{
+	TIME_US_t Release;							//Next release of a periodic task
+	uint32_t Period;
+	uint8_t Enabled;
+	volatile uint8_t Pending;				//Event posted, set by Sched_Post
+} SCHED_STATE_t;
+
+/* Task functions, defined by the modules that own them */
+#define SCHED_TASK(id, name, func, period)		void func(void);
+SCHED_TASK_TABLE
+#undef SCHED_TASK
+
+#define SCHED_TASK(id, name, func, period)		{name, func, period},
+static const SCHED_TASK_t Tasks[SCHED_TASK_COUNT] = {
+	SCHED_TASK_TABLE
+};
+#undef SCHED_TASK
+
+static SCHED_STATE_t State[SCHED_TASK_COUNT];
+static SCHED_STATS_t Stats[SCHED_TASK_COUNT];
+
+void Sched_Init(void){
+	uint8_t i;
+
+	for(i = 0; i < SCHED_TASK_COUNT; i++){
+		State[i].Enabled = 0;
+		State[i].Pending = 0;
+		State[i].Period = Tasks[i].Default_Period;
+	}
+	Sched_Reset_Stats();
+}
+
+void Sched_Enable(SCHED_ID_t id){
+	if(id >= SCHED_TASK_COUNT)
+		return;
+	State[id].Release = Time_Now_US();
+	State[id].Enabled = 1;
+}
+
+void Sched_Disable(SCHED_ID_t id){
+	if(id >= SCHED_TASK_COUNT)
+		return;
+	State[id].Enabled = 0;
+}
+
+void Sched_Set_Period(SCHED_ID_t id, uint32_t period_us){
+	if(id >= SCHED_TASK_COUNT || Tasks[id].Default_Period == SCHED_EVENT)
+		return;
+	State[id].Period = period_us;
+	State[id].Release = Time_Now_US();
+}
+
+uint32_t Sched_Get_Period(SCHED_ID_t id){
+	return State[id].Period;
+}
+
+void Sched_Post(SCHED_ID_t id){
+	if(id >= SCHED_TASK_COUNT)
+		return;
+	if(State[id].Pending)
+		Stats[id].Overruns++;
+	State[id].Pending = 1;
+}
+
+/*
+ *	--------------------Sched_Release------------------
+ *	Local helper to check whether a task is ready, and if so take
+ *	its release (clear the event or advance the next release time)
+ *	Input: Task ID, Current Time, Release Time (written when ready)
+ *	Output: 1 if the task is ready, 0 otherwise
+ */
+static uint8_t Sched_Release(uint8_t id, TIME_US_t now, TIME_US_t* released){
+	SCHED_STATE_t* s = &State[id];
+
+	if(!s->Enabled)
+		return 0;
+
+	if(Tasks[id].Default_Period == SCHED_EVENT){
+		if(!s->Pending)
+			return 0;
+		s->Pending = 0;
+		*released = now;									//Post time is not kept, lateness is 0
+		return 1;
+	}
+
+	if(now < s->Release)
+		return 0;
+	if(s->Period == 0){										//Runs whenever nothing above it is ready
+		*released = now;
+		s->Release = now;
+		return 1;
+	}
+	*released = s->Release;
+	s->Release += s->Period;
+	if(s->Release <= now){								//Missed a whole period
+		Stats[id].Overruns++;
+		s->Release = now + s->Period;
+	}
+	return 1;
+}
+
+uint8_t Sched_Run(void){
+	TIME_US_t now = Time_Now_US();
+	TIME_US_t released;
+	uint64_t start;
+	uint32_t us;
+	uint8_t i;
+
+	for(i = 0; i < SCHED_TASK_COUNT; i++){
+		if(Sched_Release(i, now, &released))
+			break;
+	}
+	if(i == SCHED_TASK_COUNT)
+		return 0;
+
+	us = (uint32_t)(now - released);
+	if(us > Stats[i].Max_Late_US)
+		Stats[i].Max_Late_US = us;
+
+	start = Time_Now_Cycles();
+	Tasks[i].Func();
+	us = (uint32_t)((Time_Now_Cycles() - start) / SYSCLK_CYCLES_PER_US);
+
+	if(us > Stats[i].Max_Exec_US)
+		Stats[i].Max_Exec_US = us;
+	Stats[i].Runs++;
+	return 1;
+}
+
+TIME_US_t Sched_Next_Release(void){
+	TIME_US_t next = SCHED_NEVER;
+	uint8_t i;
+
+	for(i = 0; i < SCHED_TASK_COUNT; i++){
+		if(!State[i].Enabled)
+			continue;
+		if(Tasks[i].Default_Period == SCHED_EVENT){
+			if(State[i].Pending)
+				return 0;
+		}else if(State[i].Period == 0){
+			return 0;
+		}else if(State[i].Release < next){
+			next = State[i].Release;
+		}
+	}
+	return next;
+}
+
+const char* Sched_Name(SCHED_ID_t id){
+	return Tasks[id].Name;
+}
+
+uint8_t Sched_Enabled(SCHED_ID_t id){
+	return State[id].Enabled;
+}
+
+const SCHED_STATS_t* Sched_Stats(SCHED_ID_t id){
+	return &Stats[id];
+}
+
+SCHED_ID_t Sched_Find(const char* name){
+	uint8_t i;
+
+	for(i = 0; i < SCHED_TASK_COUNT; i++){
+		if(strcmp(Tasks[i].Name, name) == 0)
+			return (SCHED_ID_t)i;
+	}
+	return SCHED_TASK_COUNT;
+}
+
+void Sched_Reset_Stats(void){
+	memset(Stats, 0, sizeof(Stats));
+}
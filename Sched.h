@@ -0,0 +1,136 @@
+/*
+ * Sched.h
+ *
+ *	Provides the cooperative run-to-completion scheduler. Every task
+ *	in SchedTable.h is either periodic, released every period from
+ *	the Time.h clock, or an event task released by Sched_Post. The
+ *	main loop calls Sched_Run, which runs the highest priority ready
+ *	task to completion and returns.
+ *
+ *	A periodic task that is released again before it could run, or
+ *	an event posted while the last one is still pending, counts as an
+ *	overrun. The late release is dropped and the task continues
+ *	from the current time.
+ *
+ *	The scheduler only reads time through Time.h, so it runs the
+ *	same on the host against the Time.h virtual clock.
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include <stdint.h>
+#include "SchedTable.h"
+#include "Time.h"
+
+/* Period of an event task */
+#define SCHED_EVENT						(0)
+
+/* Sched_Next_Release when no task will ever be released */
+#define SCHED_NEVER						(0xFFFFFFFFFFFFFFFFULL)
+
+/* Task IDs, one per SchedTable.h entry */
+#define SCHED_TASK(id, name, func, period)		id,
+typedef enum{
+	SCHED_TASK_TABLE
+	SCHED_TASK_COUNT
+} SCHED_ID_t;
+#undef SCHED_TASK
+
+/* Run statistics of one task, since Sched_Init or Sched_Reset_Stats */
+typedef struct{
+	uint32_t Runs;
+	uint32_t Overruns;
+	uint32_t Max_Exec_US;					//Longest run
+	uint32_t Max_Late_US;					//Longest wait from release to start
+} SCHED_STATS_t;
+
+/*
+ *	---------------------Sched_Init--------------------
+ *	Disable every task, clear pending events and statistics
+ *	Input: none
+ *	Output: none
+ */
+void Sched_Init(void);
+
+/*
+ *	--------------------Sched_Enable-------------------
+ *	Start releasing a task, a periodic task is released right away
+ *	Input: Task ID
+ *	Output: none
+ */
+void Sched_Enable(SCHED_ID_t id);
+
+/*
+ *	--------------------Sched_Disable------------------
+ *	Stop releasing a task, a pending event is kept for later
+ *	Input: Task ID
+ *	Output: none
+ */
+void Sched_Disable(SCHED_ID_t id);
+
+/*
+ *	------------------Sched_Set_Period-----------------
+ *	Change the period of a periodic task, 0 runs it whenever no
+ *	higher priority task is ready. Ignored for event tasks
+ *	Input: Task ID, Period in us
+ *	Output: none
+ */
+void Sched_Set_Period(SCHED_ID_t id, uint32_t period_us);
+uint32_t Sched_Get_Period(SCHED_ID_t id);
+
+/*
+ *	---------------------Sched_Post--------------------
+ *	Release an event task, safe to call from an interrupt
+ *	Input: Task ID
+ *	Output: none
+ */
+void Sched_Post(SCHED_ID_t id);
+
+/*
+ *	---------------------Sched_Run---------------------
+ *	Run the highest priority ready task, called from the main loop
+ *	Input: none
+ *	Output: 1 if a task ran, 0 if none was ready
+ */
+uint8_t Sched_Run(void);
+
+/*
+ *	-----------------Sched_Next_Release----------------
+ *	Earliest time a task is ready, for the idle sleep. A posted
+ *	event or a period 0 task is ready now
+ *	Input: none
+ *	Output: Absolute time in us (0 if ready now), SCHED_NEVER if
+ *	only unposted event tasks are enabled
+ */
+TIME_US_t Sched_Next_Release(void);
+
+/*
+ *	--------------------Sched_xxx_Info-----------------
+ *	Input: Task ID (must be valid)
+ *	Output: Name, enabled flag or run statistics of the task
+ */
+const char* Sched_Name(SCHED_ID_t id);
+uint8_t Sched_Enabled(SCHED_ID_t id);
+const SCHED_STATS_t* Sched_Stats(SCHED_ID_t id);
+
+/*
+ *	---------------------Sched_Find--------------------
+ *	Input: Task Name
+ *	Output: Task ID, SCHED_TASK_COUNT if there is no such name
+ */
+SCHED_ID_t Sched_Find(const char* name);
+
+/*
+ *	------------------Sched_Reset_Stats----------------
+ *	Clear the run statistics of every task
+ *	Input: none
+ *	Output: none
+ */
+void Sched_Reset_Stats(void);
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * SchedTable.h
+ *
+ *	Table of every scheduler task. Included by Sched.h to build the
+ *	ID enum and by Sched.c to build the task list. Each entry is
+ *
+ *		SCHED_TASK(id, name, function, period_us)
+ *
+ *	Table order is priority order, when several tasks are ready the
+ *	one nearest the top runs first. A period of SCHED_EVENT makes an
+ *	event task that only runs when posted with Sched_Post (from an
+ *	interrupt or another task).
+ *
+ *	The IMU is read one register at a time over 400 kHz I2C (~1.2 ms
+ *	per sample), so it runs at 100 Hz rather than the 1 kHz the MPU6050
+ *	can produce. Use "sched <task> <hz>" to try other rates, overruns
+ *	show up in the "sched" listing. Text telemetry is ~250 bytes a
+ *	pass, which 115200 baud only carries at 10 Hz.
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SCHEDTABLE_H_
+#define SCHEDTABLE_H_
+
+#include "ModuleTest.h"
+
+#ifdef TELEMETRY_BINARY
+#define TASK_TELEMETRY_PERIOD		(10000)
+#else
+#define TASK_TELEMETRY_PERIOD		(100000)
+#endif
+
+#define SCHED_TASK_TABLE \
+	SCHED_TASK(TASK_BUTTON,			"button",			Task_Button,		SCHED_EVENT) \
+	SCHED_TASK(TASK_IMU,				"imu",				Task_IMU,				10000) \
+	SCHED_TASK(TASK_FUSION,			"fusion",			Task_Fusion,		10000) \
+	SCHED_TASK(TASK_SERVO,			"servo",			Task_Servo,			20000) \
+	SCHED_TASK(TASK_COLOR,			"color",			Task_Color,			10000) \
+	SCHED_TASK(TASK_TELEMETRY,	"telemetry",	Task_Telemetry,	TASK_TELEMETRY_PERIOD) \
+	SCHED_TASK(TASK_LCD,				"lcd",				Task_LCD,				100000) \
+	SCHED_TASK(TASK_TEST,				"test",				Task_Test,			500000)
+
+#endif
@@ -1,59 +1,84 @@
-/*
- * Servo.h
- *
- *	Provides functions to interact with a standard angular Servo Motor
- *
- * Created on: June 11th, 2023
- *		Author: Jackie Huynh
- *
- */
- 
- 
-#ifndef SERVO_H_
-#define SERVO_H_
-
-#include <stdint.h>
-#include "util.h"
-
-// USE HARDWARE PWM MODULE 0 GEN 0 CHANNEL 0 PB6
-
-/* List of Fill In Macros */
-#define EN_PWM0_GPIOB_CLOCK		(0x00000002)
-#define PWM0_PIN							(0x00000040)
-#define CLEAR_ALT_FUNCTION		(0x0F000000)
-#define PWM0_ALT_FUNCTION			(0x04000000)
-#define EN_PWM0_CLOCK					(0x00000001)
-#define EN_USE_PWM_DIV				(0x00100000)
-#define CLEAR_PWM_DIV					(0x000E0000)
-#define PWM0_DIV_VALUE				(0x00040000)
-#define PWM0_DEFAULT_CONFIG		(0x00000000)
-#define PWM0_GEN_CONFIG				(0x000000C8)
-#define PWM0_COUNTER					(40000)
-#define PWM0_START						(0x00000001)
-#define EN_PWM0_FUNCTION			(0x00000001)
-
-/* 0.5ms (2.5%) - 2.5ms (12.5%) Duty Cycle */
-#define SERVO_MIN_CNT					((int16_t)1000)					
-#define SERVO_MAX_CNT					((int16_t)5000)					
-
-/* Max Range of Either -90 to 90 or 0 to 180 */
-#define SERVO_MIN_ANGLE				((int16_t)-90)	
-#define SERVO_MAX_ANGLE				((int16_t)90)
-
-/*
- *	-------------------Servo_Init------------------
- *	Basic Servo Initialization function for PWM Generation
- *	Input: None
- *	Output: None
- */
-void Servo_Init(void);
-
-/*
- *	-------------------Drive_Servo------------------
- *	Drives the Servo Motor to a specified angle
- *	Input: Desired Angle
- *	Output: None
- */
-void Drive_Servo(int16_t angle);
-
+/*
+ * Servo.h
+ *
+ *	Provides functions to interact with a standard angular Servo Motor
+ *
+ * Created on: June 11th, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+ 
+#ifndef SERVO_H_
+#define SERVO_H_
+
+#include <stdint.h>
+#include "util.h"
+
+// USE HARDWARE PWM MODULE 0 GEN 0 CHANNEL 0 PB6
+
+/* List of Fill In Macros */
+#define EN_PWM0_GPIOB_CLOCK		(0x00000002)
+#define PWM0_PIN							(0x00000040)
+#define CLEAR_ALT_FUNCTION		(0x0F000000)
+#define PWM0_ALT_FUNCTION			(0x04000000)
+#define EN_PWM0_CLOCK					(0x00000001)
+#define EN_USE_PWM_DIV				(0x00100000)
+#define CLEAR_PWM_DIV					(0x000E0000)
+#define PWM0_DEFAULT_CONFIG		(0x00000000)
+#define PWM0_GEN_CONFIG				(0x000000C8)
+#define PWM0_START						(0x00000001)
+#define EN_PWM0_FUNCTION			(0x00000001)
+
+/* PWM Timing, derived from SYSCLK_HZ with the smallest divider that fits 16 bits */
+#define SERVO_PERIOD_HZ				(50UL)									//20ms Servo Frame
+#if (SYSCLK_HZ/2)/SERVO_PERIOD_HZ <= 65536
+#define PWM0_DIV_FIELD				(0)											//PWM Clock = System Clock / 2
+#elif (SYSCLK_HZ/4)/SERVO_PERIOD_HZ <= 65536
+#define PWM0_DIV_FIELD				(1)											// / 4
+#elif (SYSCLK_HZ/8)/SERVO_PERIOD_HZ <= 65536
+#define PWM0_DIV_FIELD				(2)											// / 8
+#elif (SYSCLK_HZ/16)/SERVO_PERIOD_HZ <= 65536
+#define PWM0_DIV_FIELD				(3)											// / 16
+#elif (SYSCLK_HZ/32)/SERVO_PERIOD_HZ <= 65536
+#define PWM0_DIV_FIELD				(4)											// / 32
+#else
+#define PWM0_DIV_FIELD				(5)											// / 64
+#endif
+#define PWM0_DIV							(2UL << PWM0_DIV_FIELD)
+#define PWM0_DIV_VALUE				(PWM0_DIV_FIELD << 17)	//RCC PWMDIV Field
+#define PWM0_CLOCK_HZ					(SYSCLK_HZ/PWM0_DIV)
+#define PWM0_COUNTER					(PWM0_CLOCK_HZ/SERVO_PERIOD_HZ)
+
+#if PWM0_COUNTER > 65536 || PWM0_CLOCK_HZ % SERVO_PERIOD_HZ != 0
+#error "PWM0 cannot produce a 20ms servo frame from SYSCLK_HZ"
+#endif
+
+/* Pulse Width in us to PWM Counts */
+#define SERVO_US_TO_CNT(us)		((int16_t)(((uint32_t)(us)*(PWM0_CLOCK_HZ/1000UL))/1000UL))
+
+/* 0.5ms (2.5%) - 2.5ms (12.5%) Duty Cycle, defaults of servo.min_us and servo.max_us */
+#define SERVO_MIN_US					(500)
+#define SERVO_MAX_US					(2500)
+
+/* Max Range of Either -90 to 90 or 0 to 180 */
+#define SERVO_MIN_ANGLE				((int16_t)-90)	
+#define SERVO_MAX_ANGLE				((int16_t)90)
+
+/*
+ *	-------------------Servo_Init------------------
+ *	Basic Servo Initialization function for PWM Generation
+ *	Input: None
+ *	Output: None
+ */
+void Servo_Init(void);
+
+/*
+ *	-------------------Drive_Servo------------------
+ *	Drives the Servo Motor to a specified angle
+ *	Input: Desired Angle
+ *	Output: None
+ */
+void Drive_Servo(int16_t angle);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,709 @@
+/*
+ * Shell.c
+ *
+ *	Main implementation of the UART0 command shell. Commands are
+ *	found through a small open addressing hash table built once by
+ *	Shell_Init from the constant command list, keyed by the FNV-1a
+ *	hash of the command name.
+ *
+ * Created on: November 26, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Shell.h"
+#include "UART0.h"
+#include "Log.h"
+#include "MPU6050.h"
+#include "ModuleTest.h"
+#include "Param.h"
+#include "Sched.h"
+#include "Idle.h"
+#include "Telemetry.h"
+#include "Profile.h"
+#include "I2C.h"
+#include <string.h>
+
+/* Local Macros */
+#define SHELL_HASH_SIZE			(16)							//Power of 2, at least twice the command count
+#define SHELL_HASH_MASK			(SHELL_HASH_SIZE - 1)
+#define SHELL_READ_CHUNK		(16)
+
+#define FNV_OFFSET_BASIS		(2166136261UL)
+#define FNV_PRIME						(16777619UL)
+
+#define CHAR_BELL						(0x07)
+#define CHAR_BACKSPACE			(0x08)
+#define CHAR_DELETE					(0x7F)
+#define CHAR_CTRL_C					(0x03)
+#define CHAR_CTRL_U					(0x15)
+
+#if (SHELL_HASH_SIZE & SHELL_HASH_MASK) != 0
+#error "SHELL_HASH_SIZE must be a power of 2"
+#endif
+
+typedef void (*SHELL_HANDLER_t)(uint8_t argc, char* argv[]);
+
+typedef struct{
+	const char* Name;
+	SHELL_HANDLER_t Handler;
+	const char* Help;
+} SHELL_COMMAND_t;
+
+static void Cmd_Help(uint8_t argc, char* argv[]);
+static void Cmd_Mode(uint8_t argc, char* argv[]);
+static void Cmd_Rate(uint8_t argc, char* argv[]);
+static void Cmd_Param(uint8_t argc, char* argv[]);
+static void Cmd_Stats(uint8_t argc, char* argv[]);
+static void Cmd_Sched(uint8_t argc, char* argv[]);
+static void Cmd_I2C(uint8_t argc, char* argv[]);
+#if PROFILE_ENABLE
+static void Cmd_Prof(uint8_t argc, char* argv[]);
+#endif
+
+static const SHELL_COMMAND_t Commands[] = {
+	{"help",		Cmd_Help,		"list commands"},
+	{"mode",		Cmd_Mode,		"<delay|uart|i2c|mpu6050|tcs34727|servo|lcd|full>"},
+	{"rate",		Cmd_Rate,		"<ms> | imu <hz>"},
+	{"param",		Cmd_Param,	"[<name> [value] | save | load | defaults]"},
+	{"stats",		Cmd_Stats,	"[reset] drop counters, time asleep"},
+	{"sched",		Cmd_Sched,	"[reset | <task> <hz>]"},
+	{"i2c",			Cmd_I2C,		"[reset|recover] bus use per device"},
+#if PROFILE_ENABLE
+	{"prof",		Cmd_Prof,		"[reset] region times in cycles"}
+#endif
+};
+
+#define SHELL_COMMAND_COUNT		(sizeof(Commands)/sizeof(Commands[0]))
+
+/* Names accepted by "mode", in MODULE_TEST_NAME order */
+static const char* const Mode_Names[MODULE_TEST_COUNT] = {
+	"delay", "uart", "i2c", "mpu6050", "tcs34727", "servo", "lcd", "full"
+};
+
+static uint8_t HashTable[SHELL_HASH_SIZE];		//Command index + 1, 0 = empty slot
+static char Line[SHELL_LINE_SIZE];
+static uint8_t LineLen;
+static uint8_t LastWasCR;
+static uint32_t Lines;
+
+/* Binary frame between two 0x00 bytes */
+static uint8_t Frame[TLM_MAX_FRAME];
+static uint8_t FrameLen;
+static uint8_t InFrame;
+static uint8_t FrameOverflow;
+static uint32_t FramesBad;
+
+/*
+ *	---------------------Shell_Hash--------------------
+ *	Local helper, 32-bit FNV-1a over a NUL terminated string
+ *	Input: String
+ *	Output: Hash
+ */
+static uint32_t Shell_Hash(const char* s){
+	uint32_t h = FNV_OFFSET_BASIS;
+	while(*s){
+		h ^= (uint8_t)*s++;
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+/*
+ *	--------------------Shell_Lookup-------------------
+ *	Local helper to find a command by name with linear probing
+ *	Input: Command Name
+ *	Output: Command, or 0 if the name is unknown
+ */
+static const SHELL_COMMAND_t* Shell_Lookup(const char* name){
+	uint32_t i = Shell_Hash(name) & SHELL_HASH_MASK;
+	uint8_t probe;
+
+	for(probe = 0; probe < SHELL_HASH_SIZE; probe++){
+		uint8_t slot = HashTable[i];
+		if(slot == 0)
+			return 0;
+		if(strcmp(Commands[slot - 1].Name, name) == 0)
+			return &Commands[slot - 1];
+		i = (i + 1) & SHELL_HASH_MASK;
+	}
+	return 0;
+}
+
+/*
+ *	------------------Shell_Parse_Uint-----------------
+ *	Local helper to parse a decimal unsigned integer
+ *	Input: String, Result
+ *	Output: 1 if the whole string was a number, 0 otherwise
+ */
+static uint8_t Shell_Parse_Uint(const char* s, uint32_t* out){
+	uint32_t v = 0;
+
+	if(*s == '\0')
+		return 0;
+	while(*s){
+		if(*s < '0' || *s > '9' || v > 429496728UL)
+			return 0;
+		v = v*10 + (uint32_t)(*s++ - '0');
+	}
+	*out = v;
+	return 1;
+}
+
+/*
+ *	-----------------Shell_Parse_Float-----------------
+ *	Local helper to parse [-]digits[.digits], no exponent
+ *	Input: String, Result
+ *	Output: 1 if the whole string was a number, 0 otherwise
+ */
+static uint8_t Shell_Parse_Float(const char* s, float* out){
+	float v = 0.0f;
+	float scale = 1.0f;
+	uint8_t neg = 0;
+	uint8_t digits = 0;
+
+	if(*s == '-' || *s == '+')
+		neg = (*s++ == '-');
+	while(*s >= '0' && *s <= '9'){
+		v = v*10.0f + (float)(*s++ - '0');
+		digits++;
+	}
+	if(*s == '.'){
+		s++;
+		while(*s >= '0' && *s <= '9'){
+			scale *= 0.1f;
+			v += scale * (float)(*s++ - '0');
+			digits++;
+		}
+	}
+	if(*s != '\0' || digits == 0)
+		return 0;
+	*out = neg ? -v : v;
+	return 1;
+}
+
+/*
+ *	-------------------Shell_Usage---------------------
+ *	Local helper to print the usage line of a command
+ *	Input: Command Name
+ *	Output: none
+ */
+static void Shell_Usage(const char* name){
+	const SHELL_COMMAND_t* cmd = Shell_Lookup(name);
+	UART0_OutString("usage: ");
+	UART0_OutString((char*)name);
+	UART0_OutChar(' ');
+	UART0_OutString((char*)cmd->Help);
+	UART0_OutCRLF();
+}
+
+static void Cmd_Help(uint8_t argc, char* argv[]){
+	uint8_t i;
+	(void)argc;
+	(void)argv;
+
+	for(i = 0; i < SHELL_COMMAND_COUNT; i++){
+		UART0_OutString((char*)Commands[i].Name);
+		UART0_OutString(" - ");
+		UART0_OutString((char*)Commands[i].Help);
+		UART0_OutCRLF();
+	}
+}
+
+static void Cmd_Mode(uint8_t argc, char* argv[]){
+	uint8_t i;
+
+	if(argc == 1){
+		UART0_OutString("mode ");
+		UART0_OutString((char*)Mode_Names[Module_Test_Get_Mode()]);
+		UART0_OutCRLF();
+		return;
+	}
+	for(i = 0; i < MODULE_TEST_COUNT; i++){
+		if(strcmp(argv[1], Mode_Names[i]) == 0){
+			Module_Test_Set_Mode((MODULE_TEST_NAME)i);
+			return;
+		}
+	}
+	Shell_Usage(argv[0]);
+}
+
+static void Cmd_Rate(uint8_t argc, char* argv[]){
+	uint32_t value;
+
+	if(argc == 1){
+		UART0_OutString("rate ");
+		UART0_OutDec((int32_t)Module_Test_Get_Period());
+		UART0_OutString(" ms\r\n");
+		return;
+	}
+	if(argc == 3 && strcmp(argv[1], "imu") == 0 && Shell_Parse_Uint(argv[2], &value) && value > 0 && value <= 8000){
+		if(MPU6050_Set_Sample_Rate((uint16_t)value))
+			UART0_OutString("i2c error\r\n");
+		return;
+	}
+	if(argc == 2 && Shell_Parse_Uint(argv[1], &value)){
+		Module_Test_Set_Period(value);
+		return;
+	}
+	Shell_Usage(argv[0]);
+}
+
+/*
+ *	--------------------Shell_Show_Param---------------
+ *	Local helper to print one parameter as name = value unit
+ *	Input: Parameter ID
+ *	Output: none
+ */
+static void Shell_Show_Param(PARAM_ID_t id){
+	const PARAM_INFO_t* info = Param_Info(id);
+
+	UART0_OutString((char*)info->Name);
+	UART0_OutString(" = ");
+	if(info->Type == PARAM_TYPE_INT)
+		UART0_OutDec(Param_Get_Int(id));
+	else
+		UART0_OutFloat(Param_Get_Float(id), 4);
+	UART0_OutChar(' ');
+	UART0_OutString((char*)info->Unit);
+	UART0_OutCRLF();
+}
+
+static void Cmd_Param(uint8_t argc, char* argv[]){
+	PARAM_ID_t id;
+	PARAM_STATUS status;
+	float value;
+	uint8_t i;
+
+	if(argc == 1){
+		for(i = 0; i < PARAM_COUNT; i++)
+			Shell_Show_Param((PARAM_ID_t)i);
+		return;
+	}
+	if(argc == 2 && strcmp(argv[1], "save") == 0){
+		UART0_OutString(Param_Save() == PARAM_OK ? "saved\r\n" : "flash error\r\n");
+		return;
+	}
+	if(argc == 2 && strcmp(argv[1], "load") == 0){
+		UART0_OutString(Param_Load() == PARAM_OK ? "loaded\r\n" : "nothing saved\r\n");
+		return;
+	}
+	if(argc == 2 && strcmp(argv[1], "defaults") == 0){
+		Param_Defaults();
+		return;
+	}
+
+	id = Param_Find(argv[1]);
+	if(id == PARAM_COUNT){
+		UART0_OutString("unknown parameter\r\n");
+		return;
+	}
+	if(argc == 3){
+		if(!Shell_Parse_Float(argv[2], &value)){
+			Shell_Usage(argv[0]);
+			return;
+		}
+		status = Param_Set_Float(id, value);
+		if(status == PARAM_CLAMPED){
+			UART0_OutString("clamped, ");
+		}else if(status != PARAM_OK){
+			UART0_OutString("rejected\r\n");
+			return;
+		}
+	}
+	Shell_Show_Param(id);
+}
+
+/*
+ *	------------------Shell_Show_Permille--------------
+ *	Local helper to print a share as a percentage, X.Y%
+ *	Input: Share in 1/1000
+ *	Output: none
+ */
+static void Shell_Show_Permille(uint32_t permille){
+	UART0_OutDec((int32_t)(permille / 10));
+	UART0_OutChar('.');
+	UART0_OutDec((int32_t)(permille % 10));
+	UART0_OutChar('%');
+}
+
+static void Cmd_Stats(uint8_t argc, char* argv[]){
+	uint16_t asleep;
+
+	if(argc == 2 && strcmp(argv[1], "reset") == 0){
+		Idle_Reset_Stats();
+		return;
+	}
+
+	UART0_OutString("tx dropped ");
+	UART0_OutDec((int32_t)UART0_TX_Dropped());
+	UART0_OutString("\r\nrx dropped ");
+	UART0_OutDec((int32_t)UART0_RX_Dropped());
+	UART0_OutString("\r\nlog dropped ");
+	UART0_OutDec((int32_t)Log_Dropped());
+	UART0_OutString("\r\ndma errors ");
+	UART0_OutDec((int32_t)UART0_DMA_Errors());
+	UART0_OutString("\r\nbad frames ");
+	UART0_OutDec((int32_t)FramesBad);
+	UART0_OutString("\r\nlines ");
+	UART0_OutDec((int32_t)Lines);
+	
+	/* Share of the time in WFI since the last "stats reset" */
+	asleep = Idle_Asleep_Permille();
+	UART0_OutString("\r\nasleep ");
+	Shell_Show_Permille(asleep);
+	UART0_OutCRLF();
+}
+
+/*
+ *	--------------------Shell_Show_Task----------------
+ *	Local helper to print one task as
+ *	name period runs overruns max-exec max-late (times in us)
+ *	Input: Task ID
+ *	Output: none
+ */
+static void Shell_Show_Task(SCHED_ID_t id){
+	const SCHED_STATS_t* st = Sched_Stats(id);
+
+	UART0_OutString((char*)Sched_Name(id));
+	UART0_OutString(Sched_Enabled(id) ? " on " : " off ");
+	UART0_OutDec((int32_t)Sched_Get_Period(id));
+	UART0_OutString("us runs ");
+	UART0_OutDec((int32_t)st->Runs);
+	UART0_OutString(" over ");
+	UART0_OutDec((int32_t)st->Overruns);
+	UART0_OutString(" exec ");
+	UART0_OutDec((int32_t)st->Max_Exec_US);
+	UART0_OutString(" late ");
+	UART0_OutDec((int32_t)st->Max_Late_US);
+	UART0_OutCRLF();
+}
+
+static void Cmd_Sched(uint8_t argc, char* argv[]){
+	SCHED_ID_t id;
+	uint32_t hz;
+	uint8_t i;
+
+	if(argc == 1){
+		for(i = 0; i < SCHED_TASK_COUNT; i++)
+			Shell_Show_Task((SCHED_ID_t)i);
+		return;
+	}
+	if(argc == 2 && strcmp(argv[1], "reset") == 0){
+		Sched_Reset_Stats();
+		return;
+	}
+	id = Sched_Find(argv[1]);
+	if(argc == 3 && id != SCHED_TASK_COUNT && Shell_Parse_Uint(argv[2], &hz) && hz > 0 && hz <= 10000){
+		Sched_Set_Period(id, 1000000UL / hz);
+		Shell_Show_Task(id);
+		return;
+	}
+	Shell_Usage(argv[0]);
+}
+
+#if PROFILE_ENABLE
+/*
+ *	-------------------Shell_Show_Region---------------
+ *	Local helper to print one region as
+ *	name runs min mean max (cycles), then the non-empty histogram
+ *	bins as log2:count
+ *	Input: Region ID
+ *	Output: none
+ */
+static void Shell_Show_Region(PROFILE_ID_t id){
+	PROFILE_STATS_t st;
+	uint8_t bin;
+
+	Profile_Read(id, &st);
+	UART0_OutString((char*)Profile_Name(id));
+	UART0_OutString(" runs ");
+	UART0_OutDec((int32_t)st.Count);
+	if(st.Count == 0){
+		UART0_OutCRLF();
+		return;
+	}
+	UART0_OutString(" min ");
+	UART0_OutDec((int32_t)st.Min);
+	UART0_OutString(" mean ");
+	UART0_OutDec((int32_t)(st.Sum / st.Count));
+	UART0_OutString(" max ");
+	UART0_OutDec((int32_t)st.Max);
+	UART0_OutString("\r\n ");
+	for(bin = 0; bin < PROFILE_BINS; bin++){
+		if(st.Hist[bin] == 0)
+			continue;
+		UART0_OutChar(' ');
+		UART0_OutDec((int32_t)bin);
+		UART0_OutChar(':');
+		UART0_OutDec((int32_t)st.Hist[bin]);
+	}
+	UART0_OutCRLF();
+}
+
+static void Cmd_Prof(uint8_t argc, char* argv[]){
+	uint8_t i;
+
+	if(argc == 2 && strcmp(argv[1], "reset") == 0){
+		Profile_Reset();
+		return;
+	}
+	if(argc != 1){
+		Shell_Usage(argv[0]);
+		return;
+	}
+	for(i = 0; i < PROFILE_REGION_COUNT; i++)
+		Shell_Show_Region((PROFILE_ID_t)i);
+}
+#endif
+
+/*
+ *	--------------------Shell_Show_I2C-----------------
+ *	Local helper to print one I2C statistics slot as
+ *	addr SCL-rate transfers bytes nacks arbitration-lost timeouts bus-share
+ *	max-latency, then the non-empty latency bins as log2(us):count
+ *	Input: Slot, Window in cycles
+ *	Output: none
+ */
+static void Shell_Show_I2C(uint8_t slot, uint64_t window){
+	I2C_STATS_t st;
+	uint8_t bin;
+
+	I2C0_Stats_Read(slot, &st);
+	if(st.Addr == I2C_STATS_OTHER){
+		UART0_OutString("other");
+	}else{
+		UART0_OutString("0x");
+		UART0_OutUHex(st.Addr);
+		UART0_OutChar(' ');
+		UART0_OutDec((int32_t)(I2C0_Speed_HZ(I2C0_Device_Speed(st.Addr))/1000));
+		UART0_OutString("kHz");
+		if(I2C0_Device_Prio(st.Addr) == I2C_PRIO_BULK)
+			UART0_OutString(" bulk");
+	}
+	UART0_OutString(" xfer ");
+	UART0_OutDec((int32_t)st.Transactions);
+	UART0_OutString(" bytes ");
+	UART0_OutDec((int32_t)st.Bytes);
+	UART0_OutString(" nack ");
+	UART0_OutDec((int32_t)st.Nacks);
+	UART0_OutString(" arb ");
+	UART0_OutDec((int32_t)st.Arb_Lost);
+	UART0_OutString(" tmo ");
+	UART0_OutDec((int32_t)st.Timeouts);
+	UART0_OutString(" busy ");
+	Shell_Show_Permille(window ? (uint32_t)(st.Busy_Cycles * 1000 / window) : 0);
+	UART0_OutString(" max ");
+	UART0_OutDec((int32_t)st.Max_Latency_US);
+	UART0_OutString("us\r\n ");
+	for(bin = 0; bin < I2C_HIST_BINS; bin++){
+		if(st.Hist[bin] == 0)
+			continue;
+		UART0_OutChar(' ');
+		UART0_OutDec((int32_t)bin);
+		UART0_OutChar(':');
+		UART0_OutDec((int32_t)st.Hist[bin]);
+	}
+	UART0_OutCRLF();
+}
+
+static void Cmd_I2C(uint8_t argc, char* argv[]){
+	I2C_STATS_t st;
+	uint64_t window = I2C0_Stats_Window(), busy = 0;
+	uint8_t i;
+
+	if(argc == 2 && strcmp(argv[1], "reset") == 0){
+		I2C0_Stats_Reset();
+		return;
+	}
+	if(argc == 2 && strcmp(argv[1], "recover") == 0){
+		UART0_OutString("recovered after ");
+		UART0_OutDec((int32_t)I2C0_Recover());
+		UART0_OutString(" clocks\r\n");
+		return;
+	}
+	if(argc != 1){
+		Shell_Usage(argv[0]);
+		return;
+	}
+	for(i = 0; i < I2C0_Stats_Count(); i++){
+		Shell_Show_I2C(i, window);
+		I2C0_Stats_Read(i, &st);
+		busy += st.Busy_Cycles;
+	}
+	UART0_OutString("bus busy ");
+	Shell_Show_Permille(window ? (uint32_t)(busy * 1000 / window) : 0);
+	UART0_OutCRLF();
+}
+
+/*
+ *	-------------------Shell_Execute-------------------
+ *	Local helper to split the line on spaces and run the command
+ *	Input: none
+ *	Output: none
+ */
+static void Shell_Execute(void){
+	char* argv[SHELL_MAX_ARGS];
+	uint8_t argc = 0;
+	char* p = Line;
+	const SHELL_COMMAND_t* cmd;
+
+	Line[LineLen] = '\0';
+	while(*p){
+		while(*p == ' ')
+			*p++ = '\0';
+		if(*p == '\0')
+			break;
+		if(argc == SHELL_MAX_ARGS){
+			UART0_OutString("too many arguments\r\n");
+			return;
+		}
+		argv[argc++] = p;
+		while(*p && *p != ' ')
+			p++;
+	}
+	if(argc == 0)
+		return;
+
+	Lines++;
+	cmd = Shell_Lookup(argv[0]);
+	if(cmd == 0){
+		UART0_OutString("unknown command, try help\r\n");
+		return;
+	}
+	cmd->Handler(argc, argv);
+}
+
+/*
+ *	--------------------Shell_Frame--------------------
+ *	Local helper to decode a received binary frame and pass
+ *	parameter requests on
+ *	Input: none
+ *	Output: none
+ */
+static void Shell_Frame(void){
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint32_t plen;
+	uint16_t seq;
+	uint8_t type;
+
+	if(Telemetry_Unpack(Frame, FrameLen, &type, &seq, payload, &plen) != TLM_OK || type != TLM_TYPE_PARAM){
+		FramesBad++;
+		return;
+	}
+	Param_Handle_Frame(seq, payload, plen);
+}
+
+/*
+ *	--------------------Shell_Binary-------------------
+ *	Local helper to collect the bytes of a binary frame. A frame is
+ *	sent as 0x00 frame 0x00, extra 0x00 bytes between frames are
+ *	ignored
+ *	Input: Received Byte
+ *	Output: none
+ */
+static void Shell_Binary(uint8_t c){
+	if(c != 0){
+		if(FrameLen < sizeof(Frame))
+			Frame[FrameLen++] = c;
+		else
+			FrameOverflow = 1;
+		return;
+	}
+	if(FrameLen == 0 && !FrameOverflow)
+		return;														//Opening delimiter
+	if(FrameOverflow)
+		FramesBad++;
+	else
+		Shell_Frame();
+	FrameLen = 0;
+	FrameOverflow = 0;
+	InFrame = 0;
+}
+
+/*
+ *	---------------------Shell_Init--------------------
+ *	Build the command lookup table and print the prompt. UART0
+ *	must already be initialized
+ *	Input: none
+ *	Output: none
+ */
+void Shell_Init(void){
+	uint8_t i;
+	uint32_t h;
+
+	memset(HashTable, 0, sizeof(HashTable));
+	for(i = 0; i < SHELL_COMMAND_COUNT; i++){
+		h = Shell_Hash(Commands[i].Name) & SHELL_HASH_MASK;
+		while(HashTable[h] != 0)
+			h = (h + 1) & SHELL_HASH_MASK;
+		HashTable[h] = i + 1;
+	}
+	LineLen = 0;
+	LastWasCR = 0;
+	UART0_OutString("\r\n> ");
+}
+
+/*
+ *	-------------------Shell_Service-------------------
+ *	Process the bytes received since the last call, running a
+ *	command when a line is completed. Returns without waiting
+ *	Input: none
+ *	Output: none
+ */
+void Shell_Service(void){
+	uint8_t buf[SHELL_READ_CHUNK];
+	uint32_t n, i;
+	uint8_t c;
+
+	while((n = UART0_Read(buf, sizeof(buf))) != 0){
+		for(i = 0; i < n; i++){
+			c = buf[i];
+
+			/* Binary frames never reach the line editor */
+			if(InFrame || c == 0){
+				InFrame = 1;
+				Shell_Binary(c);
+				continue;
+			}
+
+			/* CR, LF and CR LF all end a line exactly once */
+			if(c == '\n' && LastWasCR){
+				LastWasCR = 0;
+				continue;
+			}
+			LastWasCR = (c == '\r');
+
+			if(c == '\r' || c == '\n'){
+				UART0_OutCRLF();
+				Shell_Execute();
+				LineLen = 0;
+				UART0_OutString("> ");
+			}else if(c == CHAR_BACKSPACE || c == CHAR_DELETE){
+				if(LineLen > 0){
+					LineLen--;
+					UART0_OutString("\b \b");
+				}
+			}else if(c == CHAR_CTRL_C || c == CHAR_CTRL_U){
+				LineLen = 0;
+				UART0_OutString("^C\r\n> ");
+			}else if(c >= ' ' && c < CHAR_DELETE){
+				if(LineLen < SHELL_LINE_SIZE - 1){
+					Line[LineLen++] = (char)c;
+					UART0_OutChar((char)c);
+				}else{
+					UART0_OutChar(CHAR_BELL);					//Line full
+				}
+			}
+		}
+	}
+}
+
+/*
+ *	--------------------Shell_Lines--------------------
+ *	Input: none
+ *	Output: Number of command lines executed since reset
+ */
+uint32_t Shell_Lines(void){
+	return Lines;
+}
@@ -0,0 +1,67 @@
+/*
+ * Shell.h
+ *
+ *	Line editing command shell on UART0. Received bytes are taken
+ *	from the UART0 RX ring by Shell_Service, which never waits, so
+ *	it can be called once per main loop pass next to the tests.
+ *
+ *	A 0x00 byte switches to binary until the next 0x00, so a host
+ *	tool can send COBS telemetry frames (TLM_TYPE_PARAM requests)
+ *	on the same line as a person typing commands.
+ *
+ *	Commands (type "help" for the list):
+ *		mode <delay|uart|i2c|mpu6050|tcs34727|servo|lcd|full>
+ *		rate <ms>				test period, 0 = test default
+ *		rate imu <hz>			MPU6050 sample rate
+ *		param					list every parameter
+ *		param <name> [value]	show or set a parameter
+ *		param save|load|defaults
+ *		stats					drop counters
+ *		sched					task periods, runs, overruns and worst times
+ *		sched reset				clear the task statistics
+ *		sched <task> <hz>		change a task rate
+ *		i2c						I2C transfers, errors, timeouts, bus share and latency per device (bulk: split writes)
+ *		i2c reset				clear the I2C statistics
+ *		i2c recover				free a stuck bus by hand, prints the SCL clocks it took
+ *		prof					cycles per profiled region and log2 histogram
+ *		prof reset				clear the region statistics
+ *
+ * Created on: November 26, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+#include <stdint.h>
+
+#define SHELL_LINE_SIZE			(48)			//Longest line including the terminator
+#define SHELL_MAX_ARGS			(4)				//Command name included
+
+/*
+ *	---------------------Shell_Init--------------------
+ *	Build the command lookup table and print the prompt. UART0
+ *	must already be initialized
+ *	Input: none
+ *	Output: none
+ */
+void Shell_Init(void);
+
+/*
+ *	-------------------Shell_Service-------------------
+ *	Process the bytes received since the last call, running a
+ *	command when a line is completed. Returns without waiting
+ *	Input: none
+ *	Output: none
+ */
+void Shell_Service(void);
+
+/*
+ *	--------------------Shell_Lines--------------------
+ *	Input: none
+ *	Output: Number of command lines executed since reset
+ */
+uint32_t Shell_Lines(void);
+
+#endif
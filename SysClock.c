@@ -0,0 +1,48 @@
+/*
+ * SysClock.c
+ *
+ *	Main implementation of the system clock setup. The PLL runs
+ *	from the 16 MHz crystal and its 400 MHz output is divided down
+ *	to SYSCLK_HZ.
+ *
+ * Created on: November 28, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "SysClock.h"
+#include "tm4c123gh6pm.h"
+
+/* SYSDIV2 and SYSDIV2LSB together form the 7-bit divider with DIV400 */
+#define SYSCLK_SYSDIV_M				(SYSCTL_RCC2_SYSDIV2_M | SYSCTL_RCC2_SYSDIV2LSB)
+#define SYSCLK_SYSDIV_S				(22)
+
+/*
+ *	-------------------SysClock_Init-------------------
+ *	Run the core at SYSCLK_HZ. Call first in main, before any
+ *	peripheral is initialized
+ *	Input: none
+ *	Output: none
+ */
+void SysClock_Init(void){
+	
+	/* Start the main oscillator and wait for it to settle */
+	SYSCTL_RCC_R &= ~SYSCTL_RCC_MOSCDIS;
+	while((SYSCTL_RIS_R & SYSCTL_RIS_MOSCPUPRIS) == 0);
+	
+	SYSCTL_RCC2_R |= SYSCTL_RCC2_USERCC2;																	//Use RCC2 for the extended fields
+	SYSCTL_RCC2_R |= SYSCTL_RCC2_BYPASS2;																	//Run from the raw oscillator while configuring
+	
+	SYSCTL_RCC_R = (SYSCTL_RCC_R & ~SYSCTL_RCC_XTAL_M) | SYSCTL_RCC_XTAL_16MHZ;			//16 MHz crystal
+	SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_OSCSRC2_M) | SYSCTL_RCC2_OSCSRC2_MO;	//Main oscillator
+	
+#if SYSCLK_USE_PLL
+	SYSCTL_RCC2_R &= ~SYSCTL_RCC2_PWRDN2;																	//Power up the PLL
+	SYSCTL_RCC2_R |= SYSCTL_RCC2_DIV400;																	//Divide the 400 MHz output
+	SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCLK_SYSDIV_M) | (SYSCLK_SYSDIV << SYSCLK_SYSDIV_S);
+	
+	while((SYSCTL_RIS_R & SYSCTL_RIS_PLLLRIS) == 0);												//Wait for the PLL to lock
+	
+	SYSCTL_RCC2_R &= ~SYSCTL_RCC2_BYPASS2;																//Switch over to the PLL
+#endif
+}
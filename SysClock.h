@@ -0,0 +1,63 @@
+/*
+ * SysClock.h
+ *
+ *	Single definition of the system clock. Every module that needs
+ *	a timing constant (UART divisors, I2C TPR, PWM divider, timer
+ *	prescalers, log timestamps) derives it from SYSCLK_HZ at compile
+ *	time, so changing the clock here retimes the whole firmware.
+ *
+ *	The LaunchPad has a 16 MHz crystal. Any SYSCLK_HZ that divides
+ *	the 400 MHz PLL output evenly from 80 MHz down is supported, or
+ *	16 MHz to run straight from the crystal with the PLL off.
+ *
+ *	No hardware dependencies, so the host tools can include it.
+ *
+ * Created on: November 28, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef SYSCLOCK_H_
+#define SYSCLOCK_H_
+
+#define SYSCLK_XTAL_HZ					(16000000UL)
+#define SYSCLK_PLL_HZ						(400000000UL)
+
+/* Core and bus clock, may be set from the build (e.g. -DSYSCLK_HZ=50000000UL) */
+#ifndef SYSCLK_HZ
+#define SYSCLK_HZ								(80000000UL)
+#endif
+
+/* System clock divider, SYSDIV2 field with DIV400 set (PLL / (SYSDIV + 1)) */
+#define SYSCLK_SYSDIV						(SYSCLK_PLL_HZ / SYSCLK_HZ - 1)
+
+#if SYSCLK_HZ == SYSCLK_XTAL_HZ
+#define SYSCLK_USE_PLL					(0)
+#else
+#define SYSCLK_USE_PLL					(1)
+#if SYSCLK_HZ > 80000000UL
+#error "SYSCLK_HZ is above the 80 MHz maximum"
+#endif
+#if SYSCLK_PLL_HZ % SYSCLK_HZ != 0 || SYSCLK_SYSDIV > 127
+#error "SYSCLK_HZ must be 400 MHz divided by a whole number from 5 to 128"
+#endif
+#endif
+
+/* Clock conversions, evaluated at compile time for constant arguments */
+#define SYSCLK_CYCLES_PER_US		(SYSCLK_HZ / 1000000UL)
+#define SYSCLK_CYCLES_PER_MS		(SYSCLK_HZ / 1000UL)
+
+#if SYSCLK_HZ % 1000000UL != 0
+#error "SYSCLK_HZ must be a whole number of MHz"
+#endif
+
+/*
+ *	-------------------SysClock_Init-------------------
+ *	Run the core at SYSCLK_HZ. Call first in main, before any
+ *	peripheral is initialized
+ *	Input: none
+ *	Output: none
+ */
+void SysClock_Init(void);
+
+#endif
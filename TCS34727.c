@@ -1,225 +1,220 @@
-/*
- * TCS34727.c
- *
- *	Main implementation of the functions to interact with
- *	the TCS34727 RGB Color Sensor
- *
- * Created on: November 13, 2024
- *		Author: Oliver Cabral and Jason Chan
- *
- */
-
-#include "TCS34727.h"
-#include "I2C.h"
-#include "UART0.h"
-#include "util.h"
-#include <stdio.h>
-#include "tm4c123gh6pm.h"
-
-/*	-------------------TCS34727_Init------------------
- *	Basic Initialization Function for TCS34727 at default settings
- *	Input: none
- *	Output: none
- */
-void TCS34727_Init(void){
-	uint8_t ret;																//Temp Variable to hold return values
-	char printBuf[20];													//String buffer to print
-	
-	/* Check if RGB Color Sensor has been detected */
-	ret = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR);
-	
-	//Print ID or Error to Terminal
-	sprintf(printBuf, "ID: %x\r\n", ret);
-	UART0_OutString(printBuf);
-	
-	if(ret != TCS34727_ID){
-		UART0_OutString("TCS34727 has not been Detected\r\n");
-		return;
-	}
-	UART0_OutString("TCS34727 has been Detected\r\n");
-	
-	/* Set Integration Time to 2.4ms in timing register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_TIMING_R_ADDR, TCS34727_ATIME_2_4_MS);
-	sprintf(printBuf, "ERROR CODE: %x\r\n", ret);
-	UART0_OutString(printBuf);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 Integration Time Set\r\n");
-	
-	// Necessary Delay when setting integration time/wait time. 
-	// This varies for which integration time is choosen.
-	// This project chooses 2.4ms.
-	DELAY_1MS(3);
-	
-	/* Setting Gain to 1X gain */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_CTRL_R_ADDR, TCS34727_CTRL_AGAIN_1);
-	sprintf(printBuf, "ERROR CODE: %x\r\n", ret);
-	UART0_OutString(printBuf);	
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 Gain Set\r\n");
-	
-	/* Powering On Sensor at Enable register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON);
-	sprintf(printBuf, "ERROR CODE: %x\r\n", ret);
-	UART0_OutString(printBuf);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 Power On\r\n");
-
-	//Nessessary Delay When Powering On Module
-	DELAY_1MS(3);
-	
-	/* Enabling RGBC 2-Channel ADC at Enable register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON |TCS34727_ENABLE_AEN);
-	sprintf(printBuf, "ERROR CODE: %x\r\n", ret);
-	UART0_OutString(printBuf);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 RGBC On\r\n");
-	
-	//Integration Time Delay when Activating. Varies with Integration Time Choosen by User
-	DELAY_1MS(3);
-	
-	UART0_OutString("TCS34727 Color Sensor Initialized\r\n");
-	
-}
-
-/*	---------------TCS34727_GET_RAW_CLEAR-------------
- *	Receive RAW clear data reading from the sensor
- *	Input: none
- *	Output: Returns 16-bit RAW clear data
- */
-uint16_t TCS34727_GET_RAW_CLEAR(void){
-	uint8_t CLEAR_LOW;
-	uint8_t CLEAR_HIGH;
-	uint16_t CLEAR_DATA;
-	
-	/* Use I2C to grab both HIGH and LOW data */
-	CLEAR_LOW = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAL_R_ADDR);
-	CLEAR_HIGH = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAH_R_ADDR);
-	
-	/* Concatanate into 16-bit value */
-	CLEAR_DATA=((uint16_t)CLEAR_HIGH << 8) |	CLEAR_LOW;
-	
-	//Integration Time Delay
-	DELAY_1MS(3);
-	
-	return CLEAR_DATA;
-}
-
-/*	---------------TCS34727_GET_RAW_RED---------------
- *	Receive RAW red data reading from the sensor
- *	Input: none
- *	Output: Returns 16-bit RAW red data
- */
-uint16_t TCS34727_GET_RAW_RED(void){
-	uint8_t RED_LOW;
-	uint8_t RED_HIGH;
-	uint16_t RED_DATA;
-	
-	/* Use I2C to grab both HIGH and LOW data */
-	RED_LOW = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAL_R_ADDR);
-	RED_HIGH = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAH_R_ADDR);
-	
-	/* Concatanate into 16-bit value */
-	RED_DATA=((uint16_t)RED_HIGH << 8) | RED_LOW;
-	
-	//Integration Time Delay
-	DELAY_1MS(3);
-	
-	return RED_DATA;
-}
-
-/*	---------------TCS34727_GET_RAW_GREEN-------------
- *	Receive RAW green data reading from the sensor
- *	Input: none
- *	Output: Returns 16-bit RAW green data
- */
-uint16_t TCS34727_GET_RAW_GREEN(void){
-	uint8_t GREEN_LOW;
-	uint8_t GREEN_HIGH;
-	uint16_t GREEN_DATA;
-	
-	/* Use I2C to grab both HIGH and LOW data for Green */
-	GREEN_LOW = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_GDATAL_R_ADDR);
-	GREEN_HIGH = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_GDATAH_R_ADDR);
-
-	/* Concatenate into 16-bit value for Green */
-	GREEN_DATA = ((uint16_t)GREEN_HIGH << 8) | GREEN_LOW;
-
-	//Integration Time Delay
-	DELAY_1MS(3);
-	
-	return GREEN_DATA;
-}
-
-/*	---------------TCS34727_GET_RAW_BLUE-------------
- *	Receive RAW blue data reading from the sensor
- *	Input: none
- *	Output: Returns 16-bit RAW blue data
- */
-uint16_t TCS34727_GET_RAW_BLUE(void){
-	uint8_t BLUE_LOW;
-	uint8_t BLUE_HIGH;
-	uint16_t BLUE_DATA;
-	
-	/* Use I2C to grab both HIGH and LOW data for Green */
-	BLUE_LOW = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_BDATAL_R_ADDR);
-	BLUE_HIGH = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_BDATAH_R_ADDR);
-
-	/* Concatenate into 16-bit value for Green */
-	BLUE_DATA = ((uint16_t)BLUE_HIGH << 8) | BLUE_LOW;
-	
-	//Integration Time Delay
-	DELAY_1MS(3);
-	
-	return BLUE_DATA;
-}
-
-/*	---------------TCS34727_GET_RGB------------------
- *	Normalize RAW data into RGB range (0-255)
- *	Input: RGB Color Struct User Instance
- *	Output: none
- */
-void TCS34727_GET_RGB(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
-	
-	/* Prevent Dividing by 0 by checking if the C_RAW value from struct is equal to 0 */
-	if(RGB_COLOR_Instance->C_RAW == 0){
-		RGB_COLOR_Instance->R = RGB_COLOR_Instance->G = RGB_COLOR_Instance->B = 0;
-		return;
-	}
-	
-	/*
-	Divide all RGB value with their (RAW Value / (float)Clear Raw Value) and multiple everything with 255.0
-	Store in RGB Color Instance Struct
-	*/ 
-	RGB_COLOR_Instance->R = RGB_COLOR_Instance->R_RAW / (float)RGB_COLOR_Instance->C_RAW;
-	RGB_COLOR_Instance->G = RGB_COLOR_Instance->G_RAW / (float)RGB_COLOR_Instance->C_RAW;
-	RGB_COLOR_Instance->B = RGB_COLOR_Instance->B_RAW / (float)RGB_COLOR_Instance->C_RAW;
-
-}
-
-/*	-----------------Detect_Color--------------------
- *	Detect which color is more prominant and returns that color
- *	Input: RGB Color User Instance Struct
- *	Output: COLOR_DETECTED enum value
- */
-COLOR_DETECTED Detect_Color(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
-	
-	/* Compare all values with eachother and return which color is prominent using enum type */
-	if (RGB_COLOR_Instance->R >= RGB_COLOR_Instance->G && RGB_COLOR_Instance->R >= RGB_COLOR_Instance->B) {
-			return RED_DETECT;  // Red is the most prominent color
-	} else if (RGB_COLOR_Instance->G >= RGB_COLOR_Instance->R && RGB_COLOR_Instance->G >= RGB_COLOR_Instance->B) {
-			return GREEN_DETECT;  // Green is the most prominent color
-	} else if (RGB_COLOR_Instance->B >= RGB_COLOR_Instance->R && RGB_COLOR_Instance->B >= RGB_COLOR_Instance->G) {
-			return BLUE_DETECT;  // Blue is the most prominent color
-	}
-	
-	/* Otherwise no color is being detected */
-	return NOTHING_DETECT;
-}
+/*
+ * TCS34727.c
+ *
+ *	Main implementation of the functions to interact with
+ *	the TCS34727 RGB Color Sensor
+ *
+ * Created on: November 13, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "TCS34727.h"
+#include "I2C.h"
+#include "Log.h"
+#include "Param.h"
+#include "Profile.h"
+#include "util.h"
+#include "tm4c123gh6pm.h"
+
+/*	-------------------TCS34727_Init------------------
+ *	Basic Initialization Function for TCS34727 at default settings
+ *	Input: none
+ *	Output: none
+ */
+void TCS34727_Init(void){
+	uint8_t ret;																//Temp Variable to hold return values
+	uint8_t id;
+	
+	/* Check if RGB Color Sensor has been detected */
+	ret = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR, &id);
+	
+	//Log ID or Error, the host expands the message text
+	if(ret != 0){
+		LOG3(LOG_I2C_RX_ERROR, TCS34727_ADDR, TCS34727_ID_R_ADDR, ret);
+		return;
+	}
+	if(id != TCS34727_ID){
+		LOG1(LOG_TCS34727_NOT_DETECTED, id);
+		return;
+	}
+	LOG1(LOG_TCS34727_DETECTED, id);
+	
+	/* Set Integration Time to 2.4ms in timing register */
+	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_TIMING_R_ADDR, TCS34727_ATIME_2_4_MS);
+	if(ret != 0)
+		LOG3(LOG_I2C_TX_ERROR, TCS34727_ADDR, TCS34727_TIMING_R_ADDR, ret);
+	else
+		LOG0(LOG_TCS34727_ATIME_SET);
+	
+	// The integration time applies from the next cycle, the write itself needs no delay
+	
+	/* Setting Gain to 1X gain */
+	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_CTRL_R_ADDR, TCS34727_CTRL_AGAIN_1);
+	if(ret != 0)
+		LOG3(LOG_I2C_TX_ERROR, TCS34727_ADDR, TCS34727_CTRL_R_ADDR, ret);
+	else
+		LOG0(LOG_TCS34727_GAIN_SET);
+	
+	/* Powering On Sensor at Enable register */
+	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON);
+	if(ret != 0)
+		LOG3(LOG_I2C_TX_ERROR, TCS34727_ADDR, TCS34727_ENABLE_R_ADDR, ret);
+	else
+		LOG0(LOG_TCS34727_POWER_ON);
+
+	//Oscillator warm-up before the ADC may be enabled
+	DELAY_US(TCS34727_PON_WARMUP_US);
+	
+	/* Enabling RGBC 2-Channel ADC at Enable register */
+	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON |TCS34727_ENABLE_AEN);
+	if(ret != 0)
+		LOG3(LOG_I2C_TX_ERROR, TCS34727_ADDR, TCS34727_ENABLE_R_ADDR, ret);
+	else
+		LOG0(LOG_TCS34727_RGBC_ON);
+	
+	//First RGBC result is ready after one integration time
+	DELAY_US(TCS34727_ATIME_US);
+	
+	LOG0(LOG_TCS34727_INITIALIZED);
+	
+}
+
+/*	---------------TCS34727_GET_RAW_CLEAR-------------
+ *	Receive RAW clear data reading from the sensor
+ *	Input: none
+ *	Output: Returns 16-bit RAW clear data
+ */
+uint16_t TCS34727_GET_RAW_CLEAR(void){
+	uint8_t CLEAR_LOW;
+	uint8_t CLEAR_HIGH;
+	uint16_t CLEAR_DATA;
+	PROFILE_BEGIN(PROF_TCS_READ);
+	
+	/* Use I2C to grab both HIGH and LOW data, a failed read gives 0 */
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAL_R_ADDR, &CLEAR_LOW);
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAH_R_ADDR, &CLEAR_HIGH);
+	
+	/* Concatanate into 16-bit value */
+	CLEAR_DATA=((uint16_t)CLEAR_HIGH << 8) |	CLEAR_LOW;
+	PROFILE_END(PROF_TCS_READ);
+	
+	return CLEAR_DATA;
+}
+
+/*	---------------TCS34727_GET_RAW_RED---------------
+ *	Receive RAW red data reading from the sensor
+ *	Input: none
+ *	Output: Returns 16-bit RAW red data
+ */
+uint16_t TCS34727_GET_RAW_RED(void){
+	uint8_t RED_LOW;
+	uint8_t RED_HIGH;
+	uint16_t RED_DATA;
+	PROFILE_BEGIN(PROF_TCS_READ);
+	
+	/* Use I2C to grab both HIGH and LOW data, a failed read gives 0 */
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAL_R_ADDR, &RED_LOW);
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAH_R_ADDR, &RED_HIGH);
+	
+	/* Concatanate into 16-bit value */
+	RED_DATA=((uint16_t)RED_HIGH << 8) | RED_LOW;
+	PROFILE_END(PROF_TCS_READ);
+	
+	return RED_DATA;
+}
+
+/*	---------------TCS34727_GET_RAW_GREEN-------------
+ *	Receive RAW green data reading from the sensor
+ *	Input: none
+ *	Output: Returns 16-bit RAW green data
+ */
+uint16_t TCS34727_GET_RAW_GREEN(void){
+	uint8_t GREEN_LOW;
+	uint8_t GREEN_HIGH;
+	uint16_t GREEN_DATA;
+	PROFILE_BEGIN(PROF_TCS_READ);
+	
+	/* Use I2C to grab both HIGH and LOW data for Green, a failed read gives 0 */
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_GDATAL_R_ADDR, &GREEN_LOW);
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_GDATAH_R_ADDR, &GREEN_HIGH);
+
+	/* Concatenate into 16-bit value for Green */
+	GREEN_DATA = ((uint16_t)GREEN_HIGH << 8) | GREEN_LOW;
+	PROFILE_END(PROF_TCS_READ);
+
+	return GREEN_DATA;
+}
+
+/*	---------------TCS34727_GET_RAW_BLUE-------------
+ *	Receive RAW blue data reading from the sensor
+ *	Input: none
+ *	Output: Returns 16-bit RAW blue data
+ */
+uint16_t TCS34727_GET_RAW_BLUE(void){
+	uint8_t BLUE_LOW;
+	uint8_t BLUE_HIGH;
+	uint16_t BLUE_DATA;
+	PROFILE_BEGIN(PROF_TCS_READ);
+	
+	/* Use I2C to grab both HIGH and LOW data for Green, a failed read gives 0 */
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_BDATAL_R_ADDR, &BLUE_LOW);
+	I2C0_Receive(TCS34727_ADDR, TCS34727_CMD | TCS34727_BDATAH_R_ADDR, &BLUE_HIGH);
+
+	/* Concatenate into 16-bit value for Green */
+	BLUE_DATA = ((uint16_t)BLUE_HIGH << 8) | BLUE_LOW;
+	PROFILE_END(PROF_TCS_READ);
+	
+	return BLUE_DATA;
+}
+
+/*	---------------TCS34727_GET_RGB------------------
+ *	Normalize RAW data into RGB range (0-255)
+ *	Input: RGB Color Struct User Instance
+ *	Output: none
+ */
+void TCS34727_GET_RGB(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
+	
+	/* Prevent Dividing by 0 by checking if the C_RAW value from struct is equal to 0 */
+	if(RGB_COLOR_Instance->C_RAW == 0){
+		RGB_COLOR_Instance->R = RGB_COLOR_Instance->G = RGB_COLOR_Instance->B = 0;
+		return;
+	}
+	
+	/*
+	Divide all RGB value with their (RAW Value / (float)Clear Raw Value) and multiple everything with 255.0
+	Store in RGB Color Instance Struct
+	*/ 
+	RGB_COLOR_Instance->R = RGB_COLOR_Instance->R_RAW / (float)RGB_COLOR_Instance->C_RAW;
+	RGB_COLOR_Instance->G = RGB_COLOR_Instance->G_RAW / (float)RGB_COLOR_Instance->C_RAW;
+	RGB_COLOR_Instance->B = RGB_COLOR_Instance->B_RAW / (float)RGB_COLOR_Instance->C_RAW;
+
+}
+
+/*	-----------------Detect_Color--------------------
+ *	Detect which color is more prominant and returns that color.
+ *	Nothing is detected below color.min_clear, and the winner must
+ *	lead the other two by color.margin
+ *	Input: RGB Color User Instance Struct
+ *	Output: COLOR_DETECTED enum value
+ */
+COLOR_DETECTED Detect_Color(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
+	
+	float margin = Param_Get_Float(PARAM_COLOR_MARGIN);
+	
+	/* Too dark to tell */
+	if (RGB_COLOR_Instance->C_RAW < Param_Get_Int(PARAM_COLOR_MIN_CLEAR))
+		return NOTHING_DETECT;
+	
+	/* Compare all values with eachother and return which color is prominent using enum type */
+	if (RGB_COLOR_Instance->R >= RGB_COLOR_Instance->G + margin && RGB_COLOR_Instance->R >= RGB_COLOR_Instance->B + margin) {
+			return RED_DETECT;  // Red is the most prominent color
+	} else if (RGB_COLOR_Instance->G >= RGB_COLOR_Instance->R + margin && RGB_COLOR_Instance->G >= RGB_COLOR_Instance->B + margin) {
+			return GREEN_DETECT;  // Green is the most prominent color
+	} else if (RGB_COLOR_Instance->B >= RGB_COLOR_Instance->R + margin && RGB_COLOR_Instance->B >= RGB_COLOR_Instance->G + margin) {
+			return BLUE_DETECT;  // Blue is the most prominent color
+	}
+	
+	/* Otherwise no color is being detected */
+	return NOTHING_DETECT;
+}
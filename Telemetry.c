@@ -0,0 +1,292 @@
+/*
+ *	Telemetry.c
+ *
+ *	Main implementation of the binary telemetry format: CRC-16,
+ *	COBS framing and sample encoding/decoding. Shared with the host
+ *	tools, so nothing in here may touch hardware registers.
+ *
+ * Created on: November 20, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Telemetry.h"
+
+/* CRC-16/CCITT lookup table for polynomial 0x1021 */
+static const uint16_t CRC16_TABLE[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/* Little endian helpers */
+static uint8_t* Put_U16(uint8_t* p, uint16_t v){
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	return p + 2;
+}
+
+static uint8_t* Put_U32(uint8_t* p, uint32_t v){
+	p = Put_U16(p, (uint16_t)v);
+	return Put_U16(p, (uint16_t)(v >> 16));
+}
+
+static uint16_t Get_U16(const uint8_t* p){
+	return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t Get_U32(const uint8_t* p){
+	return Get_U16(p) | ((uint32_t)Get_U16(p + 2) << 16);
+}
+
+/*
+ *	-----------------Telemetry_CRC16-----------------
+ *	Table driven CRC-16/CCITT (poly 0x1021)
+ *	Input: Data, Length, Initial CRC (0xFFFF to start)
+ *	Output: Updated CRC
+ */
+uint16_t Telemetry_CRC16(const uint8_t* data, uint32_t len, uint16_t crc){
+	while(len--){
+		crc = (uint16_t)((crc << 8) ^ CRC16_TABLE[(uint8_t)(crc >> 8) ^ *data++]);
+	}
+	return crc;
+}
+
+/*
+ *	------------------COBS_Encode--------------------
+ *	Consistent Overhead Byte Stuffing, output has no 0x00 bytes.
+ *	The delimiter is not appended
+ *	Input: Data, Length, Output Buffer (len + len/254 + 1 bytes)
+ *	Output: Encoded Length
+ */
+uint32_t COBS_Encode(const uint8_t* in, uint32_t len, uint8_t* out){
+	uint32_t code_i = 0;								//Where the current code byte goes
+	uint32_t o = 1;
+	uint8_t code = 1;
+	
+	while(len--){
+		if(*in){
+			out[o++] = *in;
+			code++;
+		}
+		if(*in == 0 || code == 0xFF){
+			out[code_i] = code;
+			code = 1;
+			code_i = o++;
+		}
+		in++;
+	}
+	out[code_i] = code;
+	return o;
+}
+
+/*
+ *	------------------COBS_Decode--------------------
+ *	Reverse of COBS_Encode, input must not include the delimiter
+ *	Input: Encoded Data, Length, Output Buffer (len bytes)
+ *	Output: Decoded Length, 0 if the input is malformed
+ */
+uint32_t COBS_Decode(const uint8_t* in, uint32_t len, uint8_t* out){
+	uint32_t i = 0;
+	uint32_t o = 0;
+	uint8_t code, j;
+	
+	while(i < len){
+		code = in[i++];
+		if(code == 0 || (i + code - 1) > len)
+			return 0;
+		for(j = 1; j < code; j++){
+			if(in[i] == 0)
+				return 0;
+			out[o++] = in[i++];
+		}
+		if(code != 0xFF && i < len)
+			out[o++] = 0;
+	}
+	return o;
+}
+
+/*
+ *	-----------------Telemetry_Pack------------------
+ *	Build a complete delimited frame around a payload
+ *	Input: Frame Type, Sequence Number, Payload, Payload Length,
+ *				 Output Buffer (TLM_MAX_FRAME bytes)
+ *	Output: Frame Length including the 0x00 delimiter, 0 if the
+ *					payload is too long
+ */
+uint32_t Telemetry_Pack(uint8_t type, uint16_t seq, const uint8_t* payload, uint32_t len, uint8_t* out){
+	uint8_t raw[TLM_MAX_RAW];
+	uint8_t* p = raw;
+	uint32_t n;
+	
+	if(len > TLM_MAX_PAYLOAD)
+		return 0;
+	
+	*p++ = TELEMETRY_VERSION;
+	*p++ = type;
+	p = Put_U16(p, seq);
+	for(n = 0; n < len; n++)
+		*p++ = payload[n];
+	p = Put_U16(p, Telemetry_CRC16(raw, (uint32_t)(p - raw), 0xFFFF));
+	
+	n = COBS_Encode(raw, (uint32_t)(p - raw), out);
+	out[n++] = 0;
+	return n;
+}
+
+/*
+ *	----------------Telemetry_Unpack-----------------
+ *	Decode and check one frame (without the delimiter)
+ *	Input: Frame, Frame Length, Outputs for Type, Sequence Number,
+ *				 Payload (TLM_MAX_PAYLOAD bytes) and Payload Length
+ *	Output: TLM_OK or the reason the frame was rejected
+ */
+TLM_STATUS Telemetry_Unpack(const uint8_t* frame, uint32_t len, uint8_t* type, uint16_t* seq, uint8_t* payload, uint32_t* plen){
+	uint8_t raw[TLM_MAX_FRAME];
+	uint32_t n, i;
+	
+	if(len > TLM_MAX_FRAME)
+		return TLM_ERR_LENGTH;
+	
+	n = COBS_Decode(frame, len, raw);
+	if(n == 0)
+		return TLM_ERR_COBS;
+	if(n < TLM_HEADER_SIZE + TLM_CRC_SIZE || n > TLM_MAX_RAW)
+		return TLM_ERR_LENGTH;
+	if(Get_U16(&raw[n-TLM_CRC_SIZE]) != Telemetry_CRC16(raw, n - TLM_CRC_SIZE, 0xFFFF))
+		return TLM_ERR_CRC;
+	if(raw[0] != TELEMETRY_VERSION)
+		return TLM_ERR_VERSION;
+	
+	*type = raw[1];
+	*seq = Get_U16(&raw[2]);
+	*plen = n - TLM_HEADER_SIZE - TLM_CRC_SIZE;
+	for(i = 0; i < *plen; i++)
+		payload[i] = raw[TLM_HEADER_SIZE + i];
+	
+	return TLM_OK;
+}
+
+/*
+ *	-------------Telemetry_Encode_Sample-------------
+ *	Build a delimited sample frame holding the selected channels
+ *	Input: Sample, Sequence Number, Output Buffer (TLM_MAX_FRAME bytes)
+ *	Output: Frame Length including the 0x00 delimiter
+ */
+uint32_t Telemetry_Encode_Sample(const TELEMETRY_SAMPLE_t* sample, uint16_t seq, uint8_t* out){
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint8_t* p = payload;
+	uint8_t i;
+	
+	p = Put_U32(p, sample->Timestamp);
+	p = Put_U16(p, sample->Channels & TLM_CH_ALL);
+	
+	if(sample->Channels & TLM_CH_ACCEL_RAW){
+		for(i = 0; i < 3; i++)
+			p = Put_U16(p, (uint16_t)sample->Accel_RAW[i]);
+	}
+	if(sample->Channels & TLM_CH_GYRO_RAW){
+		for(i = 0; i < 3; i++)
+			p = Put_U16(p, (uint16_t)sample->Gyro_RAW[i]);
+	}
+	if(sample->Channels & TLM_CH_ANGLE){
+		for(i = 0; i < 3; i++)
+			p = Put_U16(p, (uint16_t)sample->Angle_cdeg[i]);
+	}
+	if(sample->Channels & TLM_CH_RGBC_RAW){
+		for(i = 0; i < 4; i++)
+			p = Put_U16(p, sample->RGBC_RAW[i]);
+	}
+	if(sample->Channels & TLM_CH_COLOR){
+		*p++ = sample->Color;
+	}
+	
+	return Telemetry_Pack(TLM_TYPE_SAMPLE, seq, payload, (uint32_t)(p - payload), out);
+}
+
+/*
+ *	-------------Telemetry_Decode_Sample-------------
+ *	Decode a sample frame (without the delimiter). Channels that
+ *	are not present are left at 0
+ *	Input: Frame, Frame Length, Output Sample, Output Sequence Number
+ *	Output: TLM_OK or the reason the frame was rejected
+ */
+TLM_STATUS Telemetry_Decode_Sample(const uint8_t* frame, uint32_t len, TELEMETRY_SAMPLE_t* sample, uint16_t* seq){
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint32_t plen;
+	uint8_t type;
+	const uint8_t* p = payload;
+	const uint8_t* end;
+	TLM_STATUS status;
+	uint8_t i;
+	
+	status = Telemetry_Unpack(frame, len, &type, seq, payload, &plen);
+	if(status != TLM_OK)
+		return status;
+	if(type != TLM_TYPE_SAMPLE)
+		return TLM_ERR_TYPE;
+	if(plen < 6)
+		return TLM_ERR_LENGTH;
+	end = payload + plen;
+	
+	*sample = (TELEMETRY_SAMPLE_t){0};
+	sample->Timestamp = Get_U32(p);
+	sample->Channels = Get_U16(p + 4);
+	p += 6;
+	
+	if(sample->Channels & TLM_CH_ACCEL_RAW){
+		if(end - p < 6) return TLM_ERR_LENGTH;
+		for(i = 0; i < 3; i++, p += 2)
+			sample->Accel_RAW[i] = (int16_t)Get_U16(p);
+	}
+	if(sample->Channels & TLM_CH_GYRO_RAW){
+		if(end - p < 6) return TLM_ERR_LENGTH;
+		for(i = 0; i < 3; i++, p += 2)
+			sample->Gyro_RAW[i] = (int16_t)Get_U16(p);
+	}
+	if(sample->Channels & TLM_CH_ANGLE){
+		if(end - p < 6) return TLM_ERR_LENGTH;
+		for(i = 0; i < 3; i++, p += 2)
+			sample->Angle_cdeg[i] = (int16_t)Get_U16(p);
+	}
+	if(sample->Channels & TLM_CH_RGBC_RAW){
+		if(end - p < 8) return TLM_ERR_LENGTH;
+		for(i = 0; i < 4; i++, p += 2)
+			sample->RGBC_RAW[i] = Get_U16(p);
+	}
+	if(sample->Channels & TLM_CH_COLOR){
+		if(end - p < 1) return TLM_ERR_LENGTH;
+		sample->Color = *p++;
+	}
+	
+	return TLM_OK;
+}
@@ -0,0 +1,158 @@
+/*
+ *	Telemetry.h
+ *
+ *	Provides the versioned binary telemetry format shared by the
+ *	firmware and the host tools. Frames are COBS encoded and
+ *	delimited by a 0x00 byte, and protected by a CRC-16.
+ *
+ *	Frame (before COBS, little endian):
+ *		version(1) type(1) seq(2) payload(n) crc16(2)
+ *
+ *	Sample payload (TLM_TYPE_SAMPLE):
+ *		timestamp(4) channels(2) followed by every channel whose bit
+ *		is set in channels, in bit order
+ *
+ *	Log payload (TLM_TYPE_LOG), one or more records of:
+ *		id(2) nargs(1) timestamp(4) args(4 * nargs)
+ *	with the message text looked up by id in LogMessages.h
+ *
+ *	Parameter payload (TLM_TYPE_PARAM), host requests are sent to
+ *	the board the same way, framed as 0x00 frame 0x00:
+ *		request		op(1) followed by
+ *					LIST/GET id(1), SET id(1) value(4), nothing otherwise
+ *		reply		op|TLM_PARAM_REPLY(1) status(1) followed by
+ *					LIST count(1) id(1) type(1) flags(1) value(4) min(4)
+ *						 max(4) name(NUL terminated) unit(NUL terminated)
+ *					GET/SET id(1) value(4) (as stored, after clamping)
+ *	The reply carries the sequence number of its request. Values
+ *	are in the type of the parameter (see Param.h)
+ *
+ *	This file has no hardware dependencies so it can be compiled
+ *	into the host side tools as is.
+ *
+ * Created on: November 20, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+
+#define TELEMETRY_VERSION				(1)
+
+/* Frame Types */
+#define TLM_TYPE_SAMPLE					(0x01)
+#define TLM_TYPE_LOG						(0x02)
+#define TLM_TYPE_PARAM					(0x03)
+
+/* Parameter Operations */
+#define TLM_PARAM_OP_LIST				(0x01)
+#define TLM_PARAM_OP_GET				(0x02)
+#define TLM_PARAM_OP_SET				(0x03)
+#define TLM_PARAM_OP_SAVE				(0x04)
+#define TLM_PARAM_OP_LOAD				(0x05)
+#define TLM_PARAM_OP_DEFAULTS		(0x06)
+#define TLM_PARAM_REPLY					(0x80)
+
+/* Sample Channels (bit in the channels field) */
+#define TLM_CH_ACCEL_RAW				(0x0001)		//3 x int16, Ax_RAW Ay_RAW Az_RAW
+#define TLM_CH_GYRO_RAW					(0x0002)		//3 x int16, Gx_RAW Gy_RAW Gz_RAW
+#define TLM_CH_ANGLE						(0x0004)		//3 x int16, ArX ArY ArZ in 0.01 degree
+#define TLM_CH_RGBC_RAW					(0x0008)		//4 x uint16, R_RAW G_RAW B_RAW C_RAW
+#define TLM_CH_COLOR						(0x0010)		//1 x uint8, COLOR_DETECTED value
+#define TLM_CH_ALL							(0x001F)
+
+/* Size Limits */
+#define TLM_HEADER_SIZE					(4)
+#define TLM_CRC_SIZE						(2)
+#define TLM_MAX_PAYLOAD					(64)
+#define TLM_MAX_RAW							(TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + TLM_CRC_SIZE)
+//COBS adds one byte per 254 plus the code byte, then the 0x00 delimiter
+#define TLM_MAX_FRAME						(TLM_MAX_RAW + (TLM_MAX_RAW/254) + 2)
+
+/* Decode Status */
+typedef enum{
+	TLM_OK						= 0,
+	TLM_ERR_COBS			= 1,
+	TLM_ERR_LENGTH		= 2,
+	TLM_ERR_CRC				= 3,
+	TLM_ERR_VERSION		= 4,
+	TLM_ERR_TYPE			= 5
+} TLM_STATUS;
+
+/* One sample of every sensor channel */
+typedef struct{
+	uint32_t Timestamp;
+	uint16_t Channels;
+
+	int16_t Accel_RAW[3];
+	int16_t Gyro_RAW[3];
+	int16_t Angle_cdeg[3];
+	uint16_t RGBC_RAW[4];
+	uint8_t Color;
+} TELEMETRY_SAMPLE_t;
+
+/*
+ *	-----------------Telemetry_CRC16-----------------
+ *	Table driven CRC-16/CCITT (poly 0x1021)
+ *	Input: Data, Length, Initial CRC (0xFFFF to start)
+ *	Output: Updated CRC
+ */
+uint16_t Telemetry_CRC16(const uint8_t* data, uint32_t len, uint16_t crc);
+
+/*
+ *	------------------COBS_Encode--------------------
+ *	Consistent Overhead Byte Stuffing, output has no 0x00 bytes.
+ *	The delimiter is not appended
+ *	Input: Data, Length, Output Buffer (len + len/254 + 1 bytes)
+ *	Output: Encoded Length
+ */
+uint32_t COBS_Encode(const uint8_t* in, uint32_t len, uint8_t* out);
+
+/*
+ *	------------------COBS_Decode--------------------
+ *	Reverse of COBS_Encode, input must not include the delimiter
+ *	Input: Encoded Data, Length, Output Buffer (len bytes)
+ *	Output: Decoded Length, 0 if the input is malformed
+ */
+uint32_t COBS_Decode(const uint8_t* in, uint32_t len, uint8_t* out);
+
+/*
+ *	-----------------Telemetry_Pack------------------
+ *	Build a complete delimited frame around a payload
+ *	Input: Frame Type, Sequence Number, Payload, Payload Length,
+ *				 Output Buffer (TLM_MAX_FRAME bytes)
+ *	Output: Frame Length including the 0x00 delimiter, 0 if the
+ *					payload is too long
+ */
+uint32_t Telemetry_Pack(uint8_t type, uint16_t seq, const uint8_t* payload, uint32_t len, uint8_t* out);
+
+/*
+ *	----------------Telemetry_Unpack-----------------
+ *	Decode and check one frame (without the delimiter)
+ *	Input: Frame, Frame Length, Outputs for Type, Sequence Number,
+ *				 Payload (TLM_MAX_PAYLOAD bytes) and Payload Length
+ *	Output: TLM_OK or the reason the frame was rejected
+ */
+TLM_STATUS Telemetry_Unpack(const uint8_t* frame, uint32_t len, uint8_t* type, uint16_t* seq, uint8_t* payload, uint32_t* plen);
+
+/*
+ *	-------------Telemetry_Encode_Sample-------------
+ *	Build a delimited sample frame holding the selected channels
+ *	Input: Sample, Sequence Number, Output Buffer (TLM_MAX_FRAME bytes)
+ *	Output: Frame Length including the 0x00 delimiter
+ */
+uint32_t Telemetry_Encode_Sample(const TELEMETRY_SAMPLE_t* sample, uint16_t seq, uint8_t* out);
+
+/*
+ *	-------------Telemetry_Decode_Sample-------------
+ *	Decode a sample frame (without the delimiter). Channels that
+ *	are not present are left at 0
+ *	Input: Frame, Frame Length, Output Sample, Output Sequence Number
+ *	Output: TLM_OK or the reason the frame was rejected
+ */
+TLM_STATUS Telemetry_Decode_Sample(const uint8_t* frame, uint32_t len, TELEMETRY_SAMPLE_t* sample, uint16_t* seq);
+
+#endif
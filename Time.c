@@ -0,0 +1,209 @@
+/*
+ * Time.c
+ *
+ *	Main implementation of the monotonic time base. WTIMER1 A and B
+ *	are concatenated into one 64-bit up counter that is started once
+ *	and only ever read, SysTick counts milliseconds.
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Time.h"
+#include "Kernel.h"
+#include "tm4c123gh6pm.h"
+
+/* Local Macros */
+#define TIME_TICK_PRI					(0x40000000)		//SysTick Priority 2
+#define TIME_WTIMER_MAX				(0xFFFFFFFF)
+#define TIME_SPIN_CAL_RUNS		(8)							//Shortest of these is the call cost
+
+static volatile uint32_t TimeTicks;						//Changed by SysTick_Handler and Time_Tick_Resume
+static uint32_t TimeSpinCost;									//Cycles of a Time_Spin_Cycles(0) call
+
+/* Cycle source, yield, tick hook and tick control, the build may override them (host virtual clock) */
+#ifndef TIME_CYCLES
+/*
+ *	-----------------Time_Read_WTIMER1-----------------
+ *	Local helper to read the 64-bit counter. The halves are separate
+ *	registers, so the high half is read again to catch a carry
+ *	between the two reads
+ *	Input: none
+ *	Output: Cycles since Time_Init
+ */
+static uint64_t Time_Read_WTIMER1(void){
+	uint32_t hi, lo;
+
+	do{
+		hi = WTIMER1_TBV_R;
+		lo = WTIMER1_TAV_R;
+	}while(hi != WTIMER1_TBV_R);
+
+	return ((uint64_t)hi << 32) | lo;
+}
+
+#define TIME_CYCLES()					(Time_Read_WTIMER1())
+#define TIME_STAMP()					(WTIMER1_TAV_R)
+#endif
+#ifndef TIME_YIELD
+#define TIME_YIELD()
+#endif
+#ifndef TIME_SPIN
+#define TIME_SPIN()
+#endif
+#ifndef TIME_TICK_HOOK
+#define TIME_TICK_HOOK()			Kernel_Tick()
+#endif
+#ifndef TIME_TICK_STOP
+#define TIME_TICK_STOP()			(NVIC_ST_CTRL_R &= ~NVIC_ST_CTRL_ENABLE, NVIC_INT_CTRL_R = NVIC_INT_CTRL_PENDSTCLR)
+#define TIME_TICK_START()			(NVIC_ST_CURRENT_R = 0, NVIC_ST_CTRL_R |= NVIC_ST_CTRL_ENABLE)
+#endif
+
+/*
+ *	-----------------Time_Spin_Calibrate---------------
+ *	Local helper to measure the cost of a Time_Spin_Cycles call that
+ *	has nothing to wait for, less the cost of the stamps around it.
+ *	The shortest run is kept, an interrupt can only make one longer
+ *	Input: none
+ *	Output: none
+ */
+static void Time_Spin_Calibrate(void){
+	uint32_t start, stamp, call, best_stamp = TIME_WTIMER_MAX, best_call = TIME_WTIMER_MAX;
+	uint8_t i;
+
+	TimeSpinCost = 0;
+	for(i = 0; i < TIME_SPIN_CAL_RUNS; i++){
+		start = Time_Stamp();
+		stamp = Time_Stamp() - start;
+		start = Time_Stamp();
+		Time_Spin_Cycles(0);
+		call = Time_Stamp() - start;
+
+		if(stamp < best_stamp)
+			best_stamp = stamp;
+		if(call < best_call)
+			best_call = call;
+	}
+	TimeSpinCost = (best_call > best_stamp) ? best_call - best_stamp : 0;
+}
+
+/*
+ *	---------------------Time_Init---------------------
+ *	Start SysTick and the WTIMER1 64-bit counter. Call right after
+ *	SysClock_Init
+ *	Input: none
+ *	Output: none
+ */
+void Time_Init(void){
+
+	/* WTIMER1, 64-bit periodic up counter at the core clock */
+	SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R1;
+	while((SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R1) == 0);
+
+	WTIMER1_CTL_R = 0;																		//Disable while configuring
+	WTIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;								//A and B concatenated (64-bit on a wide timer)
+	WTIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD | TIMER_TAMR_TACDIR	//Periodic, count up from 0
+								 | TIMER_TAMR_TAMIE;										//Match interrupt for Timer.c, masked until Timer_Init
+	WTIMER1_TAILR_R = TIME_WTIMER_MAX;										//Lower half of the 64-bit reload
+	WTIMER1_TBILR_R = TIME_WTIMER_MAX;										//Upper half
+	WTIMER1_CTL_R = TIMER_CTL_TAEN;
+	Time_Spin_Calibrate();
+
+	/* SysTick, 1 ms interrupt from the core clock */
+	TimeTicks = 0;
+	NVIC_ST_CTRL_R = 0;
+	NVIC_ST_RELOAD_R = TIME_TICK_RELOAD;
+	NVIC_ST_CURRENT_R = 0;
+	NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~NVIC_SYS_PRI3_TICK_M) | TIME_TICK_PRI;
+	NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN | NVIC_ST_CTRL_ENABLE;
+}
+
+/*
+ *	-----------------SysTick_Handler-------------------
+ *	1 ms tick, counts Time_Now_MS and wakes kernel tasks
+ *	whose timeout expired
+ *	Input: none
+ *	Output: none
+ */
+void SysTick_Handler(void){
+	TimeTicks++;
+	TIME_TICK_HOOK();
+}
+
+void Time_Tick_Suspend(void){
+	TIME_TICK_STOP();
+}
+
+void Time_Tick_Resume(void){
+	uint32_t ticks = (uint32_t)(TIME_CYCLES() / SYSCLK_CYCLES_PER_MS);
+
+	if((int32_t)(ticks - TimeTicks) > 0)									//Never step back
+		TimeTicks = ticks;
+	TIME_TICK_START();
+	TIME_TICK_HOOK();
+}
+
+uint64_t Time_Now_Cycles(void){
+	return TIME_CYCLES();
+}
+
+TIME_US_t Time_Now_US(void){
+	return TIME_CYCLES() / SYSCLK_CYCLES_PER_US;
+}
+
+uint32_t Time_Now_MS(void){
+	return TimeTicks;
+}
+
+TIME_US_t Time_Deadline(uint32_t us){
+	return Time_Now_US() + us;
+}
+
+uint8_t Time_Elapsed(TIME_US_t deadline){
+	return Time_Now_US() >= deadline;
+}
+
+TIME_US_t Time_Remaining(TIME_US_t deadline){
+	TIME_US_t now = Time_Now_US();
+	return (now >= deadline) ? 0 : deadline - now;
+}
+
+uint8_t Time_Period_Elapsed(TIME_US_t* next, uint32_t period_us){
+	TIME_US_t now = Time_Now_US();
+
+	if(now < *next)
+		return 0;
+
+	*next += period_us;
+	if(*next <= now)																			//Overran, restart from now
+		*next = now + period_us;
+	return 1;
+}
+
+void Time_Delay_Until(TIME_US_t* next, uint32_t period_us){
+	while(!Time_Period_Elapsed(next, period_us))
+		TIME_YIELD();
+}
+
+void Time_Delay_US(uint32_t us){
+	TIME_US_t deadline = Time_Deadline(us);
+
+	while(!Time_Elapsed(deadline))
+		TIME_YIELD();
+}
+
+uint32_t Time_Stamp(void){
+	return (uint32_t)TIME_STAMP();
+}
+
+void Time_Spin_Until(uint32_t stamp, uint32_t cycles){
+	while(Time_Stamp() - stamp < cycles)
+		TIME_SPIN();
+}
+
+void Time_Spin_Cycles(uint32_t cycles){
+	uint32_t start = Time_Stamp();
+
+	Time_Spin_Until(start, (cycles > TimeSpinCost) ? cycles - TimeSpinCost : 0);
+}
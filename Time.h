@@ -0,0 +1,169 @@
+/*
+ * Time.h
+ *
+ *	Provides the monotonic time base. SysTick interrupts every 1 ms
+ *	and counts Time_Now_MS, WTIMER1 runs as a free 64-bit counter at
+ *	the core clock for Time_Now_US and Time_Now_Cycles. Neither is
+ *	ever reprogrammed after Time_Init, so any number of drivers and
+ *	loops can hold their own deadlines at once.
+ *
+ *	Microsecond time is 64 bits and does not wrap (the counter lasts
+ *	thousands of years), deadlines are plain absolute times. The 32-bit
+ *	millisecond count wraps after ~49 days, compare it by difference.
+ *
+ *	Waits shorter than the sleep wake-up latency (datasheet command
+ *	and setup times) use the Time_Spin functions instead. They busy
+ *	wait on the low half of the same counter, one register read per
+ *	pass, so they end within a few cycles of the requested time at
+ *	any SYSCLK_HZ. The fixed cost of the call is measured in Time_Init
+ *	and taken off the wait.
+ *
+ *	The cycle source and the yield hook may be overridden by the build
+ *	(see Host/time_host_port.h) so Time.c runs on the host against a
+ *	virtual clock.
+ *
+ * Created on: November 29, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef TIME_H_
+#define TIME_H_
+
+#include <stdint.h>
+#include "SysClock.h"
+
+/* SysTick Rate */
+#define TIME_TICK_HZ					(1000UL)
+#define TIME_TICK_RELOAD			(SYSCLK_HZ/TIME_TICK_HZ - 1)
+
+#if TIME_TICK_RELOAD > 0x00FFFFFF || SYSCLK_HZ % TIME_TICK_HZ != 0
+#error "SysTick cannot produce TIME_TICK_HZ from SYSCLK_HZ"
+#endif
+
+/* Absolute time in microseconds since Time_Init */
+typedef uint64_t TIME_US_t;
+
+/* Cycle conversions, exact for any whole MHz SYSCLK_HZ. ns round up so a wait is never short */
+#define TIME_US_TO_CYCLES(us)	((uint64_t)(us)*SYSCLK_CYCLES_PER_US)
+#define TIME_NS_TO_CYCLES(ns)	(((uint64_t)(ns)*SYSCLK_CYCLES_PER_US + 999)/1000)
+#define TIME_CYCLES_TO_NS(cycles)	((uint64_t)(cycles)*1000/SYSCLK_CYCLES_PER_US)
+
+/* Time_Spin waits compare 32-bit stamps by difference, ~53 s at 80 MHz */
+#define TIME_SPIN_MAX_US			(0xFFFFFFFFUL/SYSCLK_CYCLES_PER_US)
+
+/*
+ *	---------------------Time_Init---------------------
+ *	Start SysTick and the WTIMER1 64-bit counter. Call right after
+ *	SysClock_Init
+ *	Input: none
+ *	Output: none
+ */
+void Time_Init(void);
+
+/*
+ *	-----------------Time_Tick_xxx---------------------
+ *	Stop SysTick for a tickless sleep and start it again. Resume
+ *	catches Time_Now_MS up from the 64-bit counter and runs the
+ *	tick hook once for kernel timeouts that expired meanwhile. Call
+ *	both with interrupts masked
+ *	Input: none
+ *	Output: none
+ */
+void Time_Tick_Suspend(void);
+void Time_Tick_Resume(void);
+
+/*
+ *	--------------------Time_Now_xxx-------------------
+ *	Read the current time
+ *	Input: none
+ *	Output: Time since Time_Init (cycles, us or ms)
+ */
+uint64_t Time_Now_Cycles(void);
+TIME_US_t Time_Now_US(void);
+uint32_t Time_Now_MS(void);
+
+/*
+ *	--------------------Time_Deadline------------------
+ *	Input: Timeout in us
+ *	Output: Absolute time the timeout expires
+ */
+TIME_US_t Time_Deadline(uint32_t us);
+
+/*
+ *	--------------------Time_Elapsed-------------------
+ *	Input: Absolute deadline
+ *	Output: 1 once the deadline has been reached, 0 before
+ */
+uint8_t Time_Elapsed(TIME_US_t deadline);
+
+/*
+ *	-------------------Time_Remaining------------------
+ *	Input: Absolute deadline
+ *	Output: us left until the deadline, 0 once it has been reached
+ */
+TIME_US_t Time_Remaining(TIME_US_t deadline);
+
+/*
+ *	-----------------Time_Period_Elapsed---------------
+ *	Non-blocking fixed rate check. When *next has been reached it is
+ *	advanced by one period and 1 is returned. A caller that fell more
+ *	than a period behind is restarted from now instead of running
+ *	the missed periods back to back
+ *	Input: Next due time (updated), Period in us
+ *	Output: 1 if the period is due, 0 otherwise
+ */
+uint8_t Time_Period_Elapsed(TIME_US_t* next, uint32_t period_us);
+
+/*
+ *	-----------------Time_Delay_Until------------------
+ *	Cooperative fixed rate delay. Yields (TIME_YIELD) until *next,
+ *	then advances it by one period like Time_Period_Elapsed
+ *	Input: Next due time (updated), Period in us
+ *	Output: none
+ */
+void Time_Delay_Until(TIME_US_t* next, uint32_t period_us);
+
+/*
+ *	--------------------Time_Delay_US------------------
+ *	Cooperative delay from now
+ *	Input: Delay in us
+ *	Output: none
+ */
+void Time_Delay_US(uint32_t us);
+
+/*
+ *	---------------------Time_Stamp--------------------
+ *	Input: none
+ *	Output: Low 32 bits of the cycle counter, for Time_Spin_Until
+ */
+uint32_t Time_Stamp(void);
+
+/*
+ *	-------------------Time_Spin_Until-----------------
+ *	Busy wait until a number of cycles after a stamp, returns at once
+ *	if they have already passed. Interrupts only make it longer
+ *	Input: Time_Stamp, Cycles after it
+ *	Output: none
+ */
+void Time_Spin_Until(uint32_t stamp, uint32_t cycles);
+
+/*
+ *	-------------------Time_Spin_Cycles----------------
+ *	Busy wait from now, the calibrated call cost included
+ *	Input: Cycles
+ *	Output: none
+ */
+void Time_Spin_Cycles(uint32_t cycles);
+
+/*
+ *	---------------------TIME_SPIN_xx------------------
+ *	Busy wait of a datasheet time, the conversion is done at compile
+ *	time for a constant argument. At most TIME_SPIN_MAX_US
+ *	Input: Time in us or ns
+ *	Output: none
+ */
+#define TIME_SPIN_US(us)			Time_Spin_Cycles((uint32_t)TIME_US_TO_CYCLES(us))
+#define TIME_SPIN_NS(ns)			Time_Spin_Cycles((uint32_t)TIME_NS_TO_CYCLES(ns))
+
+#endif
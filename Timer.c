@@ -0,0 +1,340 @@
+/*
+ * Timer.c
+ *
+ *	Main implementation of the software timer wheel. Level 0 has one
+ *	slot per tick, each level above has slots 64 times as long. A
+ *	timer goes on the lowest level that can still tell its expiry
+ *	from the current tick, and is moved down a level when the wheel
+ *	reaches its slot. Every level keeps a 64-bit word with one bit
+ *	per non-empty slot, so the next tick anything is due is found
+ *	with a count of trailing zeros per level instead of stepping
+ *	through empty ticks.
+ *
+ *	TimerNow is the last tick the wheel has processed. It moves
+ *	forward in the match interrupt, or in Timer_Start while the wheel
+ *	is empty.
+ *
+ * Created on: December 1, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#include "Timer.h"
+#include "tm4c123gh6pm.h"
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+/* Local Macros */
+#define TIMER_SLOT_MASK				(TIMER_SLOTS - 1)
+#define TIMER_SHIFT(level)		(TIMER_SLOT_BITS*(level))
+#define TIMER_NONE						(0xFFFFFFFFFFFFFFFFULL)
+#define TIMER_CYCLES_PER_TICK	(SYSCLK_CYCLES_PER_US*TIMER_TICK_US)
+
+/* Match register port, the build may override it (host tests) */
+#ifndef TIMER_PORT_SET_MATCH
+#define TIMER_PRI							(0x00000060)			//WTIMER1A Priority 3, below SysTick
+#define TIMER_NVIC_EN3_WTIMER1A	(0x00000001)		//Interrupt 96
+
+#define TIMER_PORT_SET_MATCH(cycles)	Timer_Set_Match(cycles)
+#define TIMER_PORT_TRIGGER()	(NVIC_SW_TRIG_R = INT_WTIMER1A - 16)
+#define TIMER_PORT_ACK()			(WTIMER1_ICR_R = TIMER_ICR_TAMCINT)
+#define TIMER_PORT_TARGET
+#endif
+
+static TIMER_t* TimerWheel[TIMER_LEVELS][TIMER_SLOTS];
+static uint64_t TimerUsed[TIMER_LEVELS];			//Bit per non-empty slot
+static uint64_t TimerNow;											//Last tick processed
+static uint64_t TimerMatch;										//Tick the match is set for, TIMER_NONE if off
+static uint32_t TimerCount;
+
+#ifdef TIMER_PORT_TARGET
+/*
+ *	-------------------Timer_Set_Match-----------------
+ *	Local helper to load the 64-bit WTIMER1 match. A spurious match
+ *	between the two writes only runs the interrupt early, which
+ *	finds nothing due and sets the match again
+ *	Input: Match in Cycles
+ *	Output: none
+ */
+static void Timer_Set_Match(uint64_t cycles){
+	WTIMER1_TBMATCHR_R = (uint32_t)(cycles >> 32);
+	WTIMER1_TAMATCHR_R = (uint32_t)cycles;
+}
+#endif
+
+/*
+ *	-------------------Timer_Now_Tick------------------
+ *	Local helper
+ *	Input: none
+ *	Output: Current tick, rounded down
+ */
+static uint64_t Timer_Now_Tick(void){
+	return Time_Now_Cycles() / TIMER_CYCLES_PER_TICK;
+}
+
+/*
+ *	--------------------Timer_Insert-------------------
+ *	Local helper to put a timer on its slot. An expiry at or before
+ *	TimerNow goes on the level 0 slot being processed, which only
+ *	happens while moving timers down in Timer_Advance. Expiries past
+ *	the top level are parked on its farthest slot and placed again
+ *	when it is reached. Call with interrupts masked
+ *	Input: Timer
+ *	Output: none
+ */
+static void Timer_Insert(TIMER_t* t){
+	TIMER_t** head;
+	uint64_t ahead = 0;
+	uint32_t level = 0, idx;
+
+	if(t->Expiry <= TimerNow){
+		idx = (uint32_t)TimerNow & TIMER_SLOT_MASK;
+	}else{
+		for(level = 0; level < TIMER_LEVELS; level++){
+			ahead = (t->Expiry >> TIMER_SHIFT(level)) - (TimerNow >> TIMER_SHIFT(level));
+			if(ahead < TIMER_SLOTS)
+				break;
+		}
+		if(level == TIMER_LEVELS){
+			level = TIMER_LEVELS - 1;
+			ahead = TIMER_SLOTS - 1;
+		}
+		idx = (uint32_t)((TimerNow >> TIMER_SHIFT(level)) + ahead) & TIMER_SLOT_MASK;
+	}
+
+	head = &TimerWheel[level][idx];
+	t->Prev = 0;
+	t->Next = *head;
+	if(*head)
+		(*head)->Prev = t;
+	*head = t;
+	t->Slot = head;
+	TimerUsed[level] |= 1ULL << idx;
+	TimerCount++;
+}
+
+/*
+ *	--------------------Timer_Remove-------------------
+ *	Local helper to take a pending timer off its slot. Call with
+ *	interrupts masked
+ *	Input: Timer
+ *	Output: none
+ */
+static void Timer_Remove(TIMER_t* t){
+	uint32_t idx;
+
+	if(t->Prev)
+		t->Prev->Next = t->Next;
+	else
+		*t->Slot = t->Next;
+	if(t->Next)
+		t->Next->Prev = t->Prev;
+
+	if(*t->Slot == 0){
+		idx = (uint32_t)(t->Slot - &TimerWheel[0][0]);
+		TimerUsed[idx >> TIMER_SLOT_BITS] &= ~(1ULL << (idx & TIMER_SLOT_MASK));
+	}
+	t->Slot = 0;
+	TimerCount--;
+}
+
+/*
+ *	-------------------Timer_Next_Tick-----------------
+ *	Local helper to find the next tick after TimerNow that has work,
+ *	the earliest non-empty slot over all levels. A level above 0 has
+ *	work at the first tick of its slot. Call with interrupts masked
+ *	Input: none
+ *	Output: Tick, TIMER_NONE if the wheel is empty
+ */
+static uint64_t Timer_Next_Tick(void){
+	uint64_t best = TIMER_NONE, used, at, base;
+	uint32_t level, from;
+
+	for(level = 0; level < TIMER_LEVELS; level++){
+		used = TimerUsed[level];
+		if(used == 0)
+			continue;
+
+		base = TimerNow >> TIMER_SHIFT(level);
+		from = (uint32_t)(base + 1) & TIMER_SLOT_MASK;
+		if(from)																							//Rotate so the slot after the current one is bit 0
+			used = (used >> from) | (used << (TIMER_SLOTS - from));
+		at = (base + 1 + (uint32_t)__builtin_ctzll(used)) << TIMER_SHIFT(level);
+		if(at < best)
+			best = at;
+	}
+	return best;
+}
+
+/*
+ *	-------------------Timer_Program-------------------
+ *	Local helper to set the match to the next tick with work. If it
+ *	has already passed the interrupt is triggered by software, an
+ *	equal match would only come round again when the counter wraps.
+ *	Call with interrupts masked
+ *	Input: none
+ *	Output: none
+ */
+static void Timer_Program(void){
+	uint64_t next = Timer_Next_Tick();
+
+	if(next == TimerMatch)
+		return;
+	TimerMatch = next;
+	if(next == TIMER_NONE)
+		return;																								//Old match has passed, no interrupt until the wrap
+
+	TIMER_PORT_SET_MATCH(next*TIMER_CYCLES_PER_TICK);
+	if(Time_Now_Cycles() >= next*TIMER_CYCLES_PER_TICK)
+		TIMER_PORT_TRIGGER();
+}
+
+/*
+ *	-------------------Timer_Advance-------------------
+ *	Local helper to process every tick with work up to now. At each
+ *	one the higher level slots starting there are moved down (top
+ *	level first, so a timer can drop several levels at once), then
+ *	the level 0 slot runs. Timer functions run with interrupts
+ *	unmasked and may start or stop any timer, a periodic timer is
+ *	placed again before its function runs
+ *	Input: Current Tick
+ *	Output: none
+ */
+static void Timer_Advance(uint64_t now){
+	TIMER_t* t;
+	TIMER_t* list;
+	uint64_t next;
+	uint32_t level, idx;
+	long sr = StartCritical();
+
+	while((next = Timer_Next_Tick()) <= now){
+		TimerNow = next;
+
+		for(level = TIMER_LEVELS - 1; level > 0; level--){
+			if(TimerNow & ((1ULL << TIMER_SHIFT(level)) - 1))
+				continue;
+			idx = (uint32_t)(TimerNow >> TIMER_SHIFT(level)) & TIMER_SLOT_MASK;
+			list = TimerWheel[level][idx];
+			while(list){
+				t = list;
+				list = t->Next;
+				Timer_Remove(t);
+				Timer_Insert(t);
+			}
+		}
+
+		idx = (uint32_t)TimerNow & TIMER_SLOT_MASK;
+		while((t = TimerWheel[0][idx]) != 0){
+			Timer_Remove(t);
+			if(t->Period){
+				t->Expiry += t->Period;
+				if(t->Expiry <= now)															//A whole period behind, restart from now
+					t->Expiry = now + t->Period;
+				Timer_Insert(t);
+			}
+			EndCritical(sr);
+			t->Func(t->Arg);
+			sr = StartCritical();
+		}
+	}
+
+	/* Nothing is due up to now, skip the empty ticks */
+	if(now > TimerNow)
+		TimerNow = now;
+	EndCritical(sr);
+}
+
+/*
+ *	---------------------Timer_Init--------------------
+ *	Empty the wheel and enable the WTIMER1 match interrupt. Call
+ *	after Time_Init
+ *	Input: none
+ *	Output: none
+ */
+void Timer_Init(void){
+	uint32_t level, idx;
+
+	for(level = 0; level < TIMER_LEVELS; level++){
+		for(idx = 0; idx < TIMER_SLOTS; idx++)
+			TimerWheel[level][idx] = 0;
+		TimerUsed[level] = 0;
+	}
+	TimerCount = 0;
+	TimerMatch = TIMER_NONE;
+	TimerNow = Timer_Now_Tick();
+
+#ifdef TIMER_PORT_TARGET
+	/* Time_Init set the match interrupt enable (TAMIE), unmask it */
+	TIMER_PORT_ACK();
+	WTIMER1_IMR_R |= TIMER_IMR_TAMIM;
+	NVIC_PRI24_R = (NVIC_PRI24_R & 0xFFFFFF1F) | TIMER_PRI;
+	NVIC_EN3_R = TIMER_NVIC_EN3_WTIMER1A;
+#endif
+}
+
+void Timer_Setup(TIMER_t* t, void (*func)(void* arg), void* arg){
+	t->Next = 0;
+	t->Prev = 0;
+	t->Slot = 0;
+	t->Period = 0;
+	t->Func = func;
+	t->Arg = arg;
+}
+
+void Timer_Start(TIMER_t* t, uint32_t delay_us, uint32_t period_us){
+	uint64_t cycles = Time_Now_Cycles();
+	long sr = StartCritical();
+
+	if(t->Slot)
+		Timer_Remove(t);
+
+	/* An empty wheel is not advanced by the interrupt, catch it up */
+	if(TimerCount == 0)
+		TimerNow = cycles/TIMER_CYCLES_PER_TICK;
+
+	/* Round up, a timer never fires early */
+	t->Expiry = (cycles + (uint64_t)delay_us*SYSCLK_CYCLES_PER_US + TIMER_CYCLES_PER_TICK - 1)/TIMER_CYCLES_PER_TICK;
+	if(t->Expiry <= TimerNow)
+		t->Expiry = TimerNow + 1;
+	t->Period = (period_us + TIMER_TICK_US - 1)/TIMER_TICK_US;
+
+	Timer_Insert(t);
+	Timer_Program();
+	EndCritical(sr);
+}
+
+void Timer_Stop(TIMER_t* t){
+	long sr = StartCritical();
+
+	if(t->Slot)
+		Timer_Remove(t);
+	EndCritical(sr);
+}
+
+uint8_t Timer_Pending(const TIMER_t* t){
+	return t->Slot != 0;
+}
+
+uint32_t Timer_Count(void){
+	return TimerCount;
+}
+
+/*
+ *	-------------WideTimer1A_Handler-------------------
+ *	WTIMER1 match interrupt, runs every timer that is due and sets
+ *	the match to the next tick something is due
+ *	Input: none
+ *	Output: none
+ */
+void WideTimer1A_Handler(void){
+	long sr;
+
+	TIMER_PORT_ACK();
+	Timer_Advance(Timer_Now_Tick());
+
+	sr = StartCritical();
+	TimerMatch = TIMER_NONE;															//Match has passed, always set it again
+	Timer_Program();
+	EndCritical(sr);
+}
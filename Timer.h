@@ -0,0 +1,114 @@
+/*
+ * Timer.h
+ *
+ *	Provides software timers on a hierarchical timer wheel. Any
+ *	number of one-shot and periodic timers can run at once, each
+ *	calls its function from the WTIMER1 match interrupt when it
+ *	expires. Start and Stop are O(1) and safe from interrupts.
+ *
+ *	The wheel is tickless: no interrupt runs while nothing is due.
+ *	The WTIMER1 64-bit match (the Time.h counter) is always set to
+ *	the next tick something has to happen, a timer expiry or moving
+ *	a far timer down a level. Time is kept in TIMER_TICK_US ticks,
+ *	a timer never fires early and at most one tick late (plus
+ *	interrupt latency).
+ *
+ *	Timer functions run in interrupt context and must be short, hand
+ *	longer work over with Sched_Post or Kernel_Sem_Post.
+ *
+ *	The match register and interrupt trigger are port macros,
+ *	Host/timer_host_port.h replaces them so the wheel runs on the
+ *	host against the Time.h virtual clock.
+ *
+ * Created on: December 1, 2024
+ *		Author: Oliver Cabral and Jason Chan
+ *
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+#include "Time.h"
+
+/* Wheel Resolution and Size */
+#define TIMER_TICK_US					(100UL)
+#define TIMER_SLOT_BITS				(6)														//64 slots, one 64-bit occupancy word per level
+#define TIMER_SLOTS						(1UL << TIMER_SLOT_BITS)
+#define TIMER_LEVELS					(4)														//64^4 ticks, ~28 min at 100 us
+
+#if SYSCLK_HZ % (1000000UL/TIMER_TICK_US) != 0
+#error "TIMER_TICK_US is not a whole number of core clock cycles"
+#endif
+
+/* Software Timer, owned by the caller, Setup before the first Start */
+typedef struct TIMER_s{
+	struct TIMER_s* Next;
+	struct TIMER_s* Prev;
+	struct TIMER_s** Slot;				//List the timer is on, 0 when not pending
+	uint64_t Expiry;							//Tick it is due
+	uint32_t Period;							//Ticks between periodic runs, 0 = one-shot
+	void (*Func)(void* arg);
+	void* Arg;
+} TIMER_t;
+
+/*
+ *	---------------------Timer_Init--------------------
+ *	Empty the wheel and enable the WTIMER1 match interrupt. Call
+ *	after Time_Init
+ *	Input: none
+ *	Output: none
+ */
+void Timer_Init(void);
+
+/*
+ *	--------------------Timer_Setup--------------------
+ *	Set the function a timer calls, the timer is left stopped
+ *	Input: Timer, Function, Argument passed to the function
+ *	Output: none
+ */
+void Timer_Setup(TIMER_t* t, void (*func)(void* arg), void* arg);
+
+/*
+ *	--------------------Timer_Start--------------------
+ *	(Re)start a timer, a pending timer is moved to the new time.
+ *	A periodic timer runs at a fixed rate from its first expiry,
+ *	if it falls a whole period behind it restarts from now
+ *	Input: Timer, Delay in us, Period in us (0 = one-shot)
+ *	Output: none
+ */
+void Timer_Start(TIMER_t* t, uint32_t delay_us, uint32_t period_us);
+
+/*
+ *	---------------------Timer_Stop--------------------
+ *	Cancel a timer, does nothing if it is not pending. A periodic
+ *	timer may stop itself from its own function
+ *	Input: Timer
+ *	Output: none
+ */
+void Timer_Stop(TIMER_t* t);
+
+/*
+ *	-------------------Timer_Pending-------------------
+ *	Input: Timer
+ *	Output: 1 if the timer will still fire, 0 otherwise
+ */
+uint8_t Timer_Pending(const TIMER_t* t);
+
+/*
+ *	-----------------Timer_Count-----------------------
+ *	Input: none
+ *	Output: Number of pending timers
+ */
+uint32_t Timer_Count(void);
+
+/*
+ *	-------------WideTimer1A_Handler-------------------
+ *	WTIMER1 match interrupt, runs every timer that is due and sets
+ *	the match to the next tick something is due
+ *	Input: none
+ *	Output: none
+ */
+void WideTimer1A_Handler(void);
+
+#endif
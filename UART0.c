@@ -1,108 +1,535 @@
-// UART.c
-// Runs on TM4C123
-
-// U0Rx (VCP receive) connected to PA0
-// U0Tx (VCP transmit) connected to PA1
-
-#include "UART0.h"
-#include "tm4c123gh6pm.h"
-#include "util.h"
-
-//------------UART_Init------------
-// Initialize the UART for 57600 baud rate (assuming 16 MHz UART clock),
-// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
-// Input: none
-// Output: none
-void UART0_Init(void){
-  SYSCTL_RCGC1_R |= SYSCTL_RCGC1_UART0; // activate UART0
-  SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOA; // activate port A
-  UART0_CTL_R = 0;                      // disable UART
-  UART0_IBRD_R = 17;            // IBRD = ?
-  UART0_FBRD_R = 18;            // FBRD = ?
-                                        // 8 bit word length (no parity bits, one stop bit, FIFOs)
-  UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN);
-  UART0_CTL_R |= UART_CTL_RXE|UART_CTL_TXE|UART_CTL_UARTEN;// enable Tx, RX and UART
-  GPIO_PORTA_AFSEL_R |= 0x03;           // enable alt funct on PA1-0
-  GPIO_PORTA_DEN_R |= 0x03;             // enable digital I/O on PA1-0
-                                        // configure PA1-0 as UART
-  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFFFFFF00)+0x00000011;
-  GPIO_PORTA_AMSEL_R &= ~0x03;          // disable analog functionality on PA
-}
-
-
-//---------------------OutCRLF---------------------
-// Output a CR,LF to UART to go to a new line
-// Input: none
-// Output: none
-
-void UART0_OutCRLF(void){
-  UART0_OutChar(CR);
-  UART0_OutChar(LF);
-}
-
-//------------UART_InChar------------
-// Wait for new serial port input
-// Input: none
-// Output: ASCII code for key typed
-unsigned char UART0_InChar(void){
-  while((UART0_FR_R&UART_FR_RXFE) != 0); // wait until the receiving FIFO is not empty
-  return((unsigned char)(UART0_DR_R&0xFF));
-}
-//------------UART_OutChar------------
-// Output 8-bit to serial port
-// Input: letter is an 8-bit ASCII character to be transferred
-// Output: none
-void UART0_OutChar(char data){
-  while((UART0_FR_R&UART_FR_TXFF) != 0);
-  UART0_DR_R = data;
-}
-
-
-//------------UART_OutString------------
-// Output String (NULL termination)
-// Input: pointer to a NULL-terminated string to be transferred
-// Output: none
-void UART0_OutString(char *pt){
-  while(*pt){
-    UART0_OutChar(*pt);
-    pt++;
-  }
-	//UART0_OutChar(0); // add the null terminator
-}
-
-//------------UART_InString------------
-// Accepts ASCII characters from the serial port
-//    and adds them to a string until <enter> is typed
-//    or until max length of the string is reached.
-//    when max length is reach, no more input will be accepted
-//    the display will wait for the <enter> key to be pressed.
-// It echoes each character as it is inputted.
-// If a backspace is inputted, the string is modified
-//    and the backspace is echoed
-// terminates the string with a null character
-// uses busy-waiting synchronization on RDRF
-// Input: pointer to empty buffer, size of buffer
-// Output: Null terminated string
-// -- Modified by Agustinus Darmawan + Mingjie Qiu --
-void UART0_InString(char *bufPt, unsigned short max) {
-int length=0;
-char character;
-  character = UART0_InChar();
-  while(character != CR){
-    if(character == BS){ // back space
-      if(length){
-        bufPt--;
-        length--;
-        UART0_OutChar(BS);
-      }
-    }
-    else if(length < max){
-      *bufPt = character;
-      bufPt++;
-      length++;
-      UART0_OutChar(character);
-    }
-    character = UART0_InChar();
-  }
-  *bufPt = 0; // adding null terminator to the end of the string.
-}
+// UART.c
+// Runs on TM4C123
+
+// U0Rx (VCP receive) connected to PA0
+// U0Tx (VCP transmit) connected to PA1
+
+#include "UART0.h"
+#include "tm4c123gh6pm.h"
+#include "util.h"
+#include "Format.h"
+#include "Idle.h"
+#include "Kernel.h"
+
+#define UART0_TX_MASK       (UART0_TX_BUF_SIZE-1)
+#define UART0_RX_MASK       (UART0_RX_BUF_SIZE-1)
+#define NVIC_EN0_UART0      0x00000020  // interrupt 5
+#define UART0_PRI_MSK       0xFFFF1FFF
+#define UART0_PRI           0x00006000  // priority 3
+#define NVIC_EN1_UDMA_ERR   0x00008000  // interrupt 47
+#define UDMA_ERR_PRI_MSK    0x1FFFFFFF
+#define UDMA_ERR_PRI        0x60000000  // priority 3, as UART0, neither preempts the other
+
+#if (UART0_TX_BUF_SIZE & UART0_TX_MASK) != 0
+#error "UART0_TX_BUF_SIZE must be a power of 2"
+#endif
+#if (UART0_RX_BUF_SIZE & UART0_RX_MASK) != 0
+#error "UART0_RX_BUF_SIZE must be a power of 2"
+#endif
+
+#if (UART0_DMA_BUF_SIZE < 1) || (UART0_DMA_BUF_SIZE > 1024)
+#error "UART0_DMA_BUF_SIZE must be between 1 and 1024"
+#endif
+
+// Data register access, the build may override it (host UART model)
+#ifndef UART0_TX_PUT
+#define UART0_TX_PUT(data)  (UART0_DR_R = (data))
+#define UART0_RX_GET()      ((uint8_t)(UART0_DR_R&0xFF))
+#define UART0_PORT_TARGET
+#endif
+
+// Bus address of a buffer as the uDMA sees it, the host model
+// hands out its own handles in place of 64 bit pointers
+#ifndef UART0_DMA_ADDR
+#define UART0_DMA_ADDR(p)   ((uint32_t)(p))
+#endif
+
+#define UART0_TX_DMA_CH     9           // uDMA channel 9, encoding 0 is UART0 TX
+#define UART0_TX_DMA_BIT    (1UL<<UART0_TX_DMA_CH)
+#define DMA_NONE            0xFF
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+// Transmit ring: written by UART0_Write, read by the FIFO copy routine
+static uint8_t TxBuf[UART0_TX_BUF_SIZE];
+static volatile uint32_t TxPutI;      // free running, only written by producer
+static volatile uint32_t TxGetI;      // free running, only written by consumer
+static volatile uint32_t TxDropped;
+static UART0_TX_POLICY TxPolicy = UART0_TX_BLOCK;
+
+// Receive ring: written by UART0_Handler, read by UART0_Read/InChar
+static uint8_t RxBuf[UART0_RX_BUF_SIZE];
+static volatile uint32_t RxPutI;      // free running, only written by the ISR
+static volatile uint32_t RxGetI;      // free running, only written by main
+static volatile uint32_t RxDropped;
+
+// uDMA control table, must be 1024 byte aligned. Only channel 9 is used
+static uint32_t DmaTable[256] __attribute__((aligned(1024)));
+
+// Ping-pong transmit buffers, owned by the application while filling
+static uint8_t DmaBuf[2][UART0_DMA_BUF_SIZE];
+static uint32_t DmaLen[2];
+static uint8_t DmaFillI;                      // buffer the application fills
+static volatile uint8_t DmaActiveI = DMA_NONE; // buffer owned by the uDMA
+static volatile uint8_t DmaQueuedI = DMA_NONE; // filled, waiting for the line
+static volatile uint32_t DmaErrors;
+
+// Posted by the interrupts that make room for the writer once the
+// kernel runs, kept at 0 or 1
+static KERNEL_SEM_t TxRoom = {0, 0};
+
+// Program channel 9 for a basic byte transfer from a buffer into the
+// UART data register and enable it. Called with interrupts masked
+static void UART0_DMA_Start(uint8_t i){
+  uint32_t *ch = &DmaTable[UART0_TX_DMA_CH*4];
+  ch[0] = UART0_DMA_ADDR(&DmaBuf[i][DmaLen[i]-1]); // source end pointer
+  ch[1] = UART0_DMA_ADDR(&UART0_DR_R);        // destination end pointer
+  ch[2] = UDMA_CHCTL_DSTINC_NONE|UDMA_CHCTL_DSTSIZE_8|
+          UDMA_CHCTL_SRCINC_8|UDMA_CHCTL_SRCSIZE_8|
+          UDMA_CHCTL_ARBSIZE_4|
+          ((DmaLen[i]-1)<<UDMA_CHCTL_XFERSIZE_S)|
+          UDMA_CHCTL_XFERMODE_BASIC;
+  DmaActiveI = i;
+  UDMA_ENASET_R = UART0_TX_DMA_BIT;
+}
+
+// Start the queued buffer once nothing else is using the TX FIFO
+static void UART0_DMA_Start_Queued(void){
+  if((DmaActiveI == DMA_NONE) && (DmaQueuedI != DMA_NONE) && (TxGetI == TxPutI)){
+    UART0_DMA_Start(DmaQueuedI);
+    DmaQueuedI = DMA_NONE;
+  }
+}
+
+// Move bytes from the ring into the hardware FIFO until one runs out.
+// Runs either in UART0_Handler or in main with TXIM masked, never both
+static void UART0_Copy_To_FIFO(void){
+  if(DmaActiveI != DMA_NONE){
+    return;                             // frames are never interleaved with text
+  }
+  while((TxGetI != TxPutI) && ((UART0_FR_R&UART_FR_TXFF) == 0)){
+    UART0_TX_PUT(TxBuf[TxGetI&UART0_TX_MASK]);
+    TxGetI++;
+  }
+}
+
+// Move every received byte from the hardware FIFO into the ring.
+// Bytes that do not fit are read anyway (to clear the FIFO) and counted
+static void UART0_Copy_From_FIFO(void){
+  uint8_t data;
+  while((UART0_FR_R&UART_FR_RXFE) == 0){
+    data = UART0_RX_GET();
+    if((RxPutI - RxGetI) < UART0_RX_BUF_SIZE){
+      RxBuf[RxPutI&UART0_RX_MASK] = data;
+      RxPutI++;
+    }else{
+      RxDropped++;
+    }
+  }
+}
+
+// Prime the FIFO from main and arm the TX interrupt if bytes remain.
+// The FIFO interrupt only fires when the level drops through 1/8,
+// so an idle FIFO has to be started by software
+static void UART0_TX_Kick(void){
+  UART0_IM_R &= ~UART_IM_TXIM;          // keep the ISR from draining concurrently
+  UART0_Copy_To_FIFO();
+  if(TxGetI != TxPutI){
+    UART0_IM_R |= UART_IM_TXIM;
+  }
+}
+
+// Wake a task blocked in UART0_TX_Wait, called by the interrupts
+// that take bytes off the ring or free the uDMA channel
+static void UART0_TX_Notify(void){
+  if(Kernel_Running() && (TxRoom.Count == 0)){
+    Kernel_Sem_Post(&TxRoom);
+  }
+}
+
+// Wait until the TX interrupt or the uDMA completion has made
+// progress: the FIFO is full (its level interrupt is armed by the
+// kick while the ring has data) or a frame owns the line. Once the
+// kernel runs a task pends on TxRoom, so lower priority tasks get
+// the CPU. Otherwise, or with interrupts masked by the caller, the
+// core sleeps. The pending interrupt still ends the WFI when they
+// are masked and the next kick makes the progress
+static void UART0_TX_Wait(void){
+  long sr;
+  if(Kernel_Running()){
+    while(Kernel_Sem_Pend(&TxRoom, 0));      // wake-ups of earlier waits
+  }
+  sr = StartCritical();
+  if(((UART0_FR_R&UART_FR_TXFF) == 0) && (DmaActiveI == DMA_NONE)){
+    EndCritical(sr);
+    return;
+  }
+  if(Kernel_Running() && (sr == 0)){
+    EndCritical(sr);
+    Kernel_Sem_Pend(&TxRoom, KERNEL_WAIT_FOREVER);
+    return;
+  }
+  Idle_Sleep();
+  EndCritical(sr);
+}
+
+//------------UART_Init------------
+// Initialize the UART for UART0_BAUD (divisors from UART0_CLOCK_HZ),
+// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
+// Transmit and receive are interrupt driven through ring buffers
+// Input: none
+// Output: none
+void UART0_Init(void){
+  SYSCTL_RCGC1_R |= SYSCTL_RCGC1_UART0; // activate UART0
+  SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOA; // activate port A
+  UART0_CTL_R = 0;                      // disable UART
+  UART0_CC_R = UART_CC_CS_SYSCLK;       // clocked from the system clock
+  UART0_IBRD_R = UART0_IBRD;            // IBRD = int(clock/(div*baud))
+  UART0_FBRD_R = UART0_FBRD;            // FBRD = round(frac*64)
+#if UART0_HSE
+  UART0_CTL_R |= UART_CTL_HSE;          // sample at clock/8
+#endif
+                                        // 8 bit word length (no parity bits, one stop bit, FIFOs)
+  UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN);
+  TxPutI = TxGetI = 0;                  // empty transmit ring
+  TxDropped = 0;
+  RxPutI = RxGetI = 0;                  // empty receive ring
+  RxDropped = 0;
+  UART0_IFLS_R = (UART0_IFLS_R&~0x3F)|UART_IFLS_TX1_8|UART_IFLS_RX4_8; // TX at <= 1/8, RX at >= 1/2
+  UART0_IM_R &= ~UART_IM_TXIM;          // armed only while the ring has data
+  UART0_IM_R |= UART_IM_RXIM|UART_IM_RTIM; // RX level and time-out (short lines) always armed
+  NVIC_PRI1_R = (NVIC_PRI1_R&UART0_PRI_MSK)|UART0_PRI;
+  NVIC_EN0_R = NVIC_EN0_UART0;          // enable interrupt 5 in NVIC
+  UART0_CTL_R |= UART_CTL_RXE|UART_CTL_TXE|UART_CTL_UARTEN;// enable Tx, RX and UART
+  GPIO_PORTA_AFSEL_R |= 0x03;           // enable alt funct on PA1-0
+  GPIO_PORTA_DEN_R |= 0x03;             // enable digital I/O on PA1-0
+                                        // configure PA1-0 as UART
+  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFFFFFF00)+0x00000011;
+  GPIO_PORTA_AMSEL_R &= ~0x03;          // disable analog functionality on PA
+}
+
+
+//---------------------OutCRLF---------------------
+// Output a CR,LF to UART to go to a new line
+// Input: none
+// Output: none
+
+void UART0_OutCRLF(void){
+  UART0_OutChar(CR);
+  UART0_OutChar(LF);
+}
+
+//------------UART_InChar------------
+// Wait for new serial port input
+// Input: none
+// Output: ASCII code for key typed
+unsigned char UART0_InChar(void){
+  unsigned char data;
+  IDLE_WAIT(RxGetI == RxPutI);          // sleep until the receive ring is not empty
+  data = RxBuf[RxGetI&UART0_RX_MASK];
+  RxGetI++;
+  return data;
+}
+
+//------------UART_Read------------
+// Take received bytes out of the receive ring without waiting
+// Input: pointer to buffer, size of buffer
+// Output: number of bytes copied (0 if nothing has arrived)
+uint32_t UART0_Read(uint8_t *data, uint32_t len){
+  uint32_t count = 0;
+  while((count < len) && (RxGetI != RxPutI)){
+    data[count++] = RxBuf[RxGetI&UART0_RX_MASK];
+    RxGetI++;
+  }
+  return count;
+}
+
+//------------UART_RX_Pending------------
+// Check for received bytes without taking them
+// Input: none
+// Output: 1 if the receive ring is not empty
+uint8_t UART0_RX_Pending(void){
+  return RxGetI != RxPutI;
+}
+
+//------------UART_RX_Dropped------------
+// Number of received bytes lost because the receive ring was full
+// Input: none
+// Output: dropped byte count since init
+uint32_t UART0_RX_Dropped(void){
+  return RxDropped;
+}
+//------------UART_OutChar------------
+// Output 8-bit to serial port
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART0_OutChar(char data){
+  uint8_t byte = (uint8_t)data;
+  UART0_Write(&byte, 1);
+}
+
+//------------UART_Write------------
+// Queue bytes for transmission and return right away. The ring is
+// drained into the TX FIFO by UART0_Handler. When the ring is full
+// the TX policy decides whether to wait or to drop the rest. Once
+// the kernel runs a task waits blocked, lower priority tasks run.
+// Call from one context only (main loop or a single task)
+// Input: pointer to data, number of bytes
+// Output: number of bytes queued
+uint32_t UART0_Write(const uint8_t *data, uint32_t len){
+  uint32_t count = 0;
+  while(count < len){
+    if((TxPutI - TxGetI) >= UART0_TX_BUF_SIZE){  // ring is full
+      if(TxPolicy == UART0_TX_DROP){
+        TxDropped += len - count;
+        break;
+      }
+      UART0_TX_Kick();                  // progress even with interrupts masked
+      UART0_TX_Wait();
+      continue;
+    }
+    TxBuf[TxPutI&UART0_TX_MASK] = data[count++];
+    TxPutI++;
+  }
+  UART0_TX_Kick();
+  return count;
+}
+
+//------------UART_Set_TX_Policy------------
+// Select block or drop behavior when the transmit ring is full
+// Input: UART0_TX_BLOCK or UART0_TX_DROP
+// Output: none
+void UART0_Set_TX_Policy(UART0_TX_POLICY policy){
+  TxPolicy = policy;
+}
+
+//------------UART_TX_Dropped------------
+// Number of bytes discarded because the transmit ring was full
+// Input: none
+// Output: dropped byte count since init
+uint32_t UART0_TX_Dropped(void){
+  return TxDropped;
+}
+
+//------------UART_Flush------------
+// Wait until every queued byte has left the UART
+// Input: none
+// Output: none
+void UART0_Flush(void){
+  while(TxGetI != TxPutI){
+    UART0_TX_Kick();
+    UART0_TX_Wait();
+  }
+  while((UART0_FR_R&UART_FR_BUSY) != 0);
+}
+
+//------------UART0_Handler------------
+// Refill the TX FIFO from the ring each time it drains to 1/8 full,
+// and disarm the interrupt once the ring is empty. Empty the RX FIFO
+// into the receive ring when it reaches 1/2 full or goes idle
+//    On the TM4C123 a finished uDMA transfer for a peripheral channel
+//    is also signaled here (not on uDMA_Handler, which only serves the
+//    software channel), so the ping-pong bookkeeping lives here too
+void UART0_Handler(void){
+  if(UDMA_CHIS_R&UART0_TX_DMA_BIT){
+    UDMA_CHIS_R = UART0_TX_DMA_BIT;     // acknowledge channel 9 completion
+    DmaActiveI = DMA_NONE;
+    UART0_DMA_Start_Queued();
+    if(DmaActiveI == DMA_NONE){
+      UART0_Copy_To_FIFO();             // text waited behind the frame
+      if(TxGetI != TxPutI){
+        UART0_IM_R |= UART_IM_TXIM;
+      }
+    }
+    UART0_TX_Notify();
+  }
+  if(UART0_MIS_R&(UART_MIS_RXMIS|UART_MIS_RTMIS)){
+    UART0_ICR_R = UART_ICR_RXIC|UART_ICR_RTIC;
+    UART0_Copy_From_FIFO();
+    Idle_Notify();                      // the shell runs in the main loop task
+  }
+  if(UART0_MIS_R&UART_MIS_TXMIS){
+    UART0_ICR_R = UART_ICR_TXIC;
+    UART0_Copy_To_FIFO();
+    if(TxGetI == TxPutI){
+      UART0_IM_R &= ~UART_IM_TXIM;
+      UART0_DMA_Start_Queued();         // frame waited behind the text
+    }
+    UART0_TX_Notify();
+  }
+}
+
+//------------uDMA_Error------------
+// A bus error stops the channel. Drop the frame in flight and move on
+void uDMA_Error(void){
+  UDMA_ERRCLR_R = UDMA_ERRCLR_ERRCLR;
+  DmaErrors++;
+  if(DmaActiveI != DMA_NONE){
+    UDMA_ENACLR_R = UART0_TX_DMA_BIT;
+    DmaActiveI = DMA_NONE;
+    UART0_DMA_Start_Queued();
+    UART0_TX_Notify();
+  }
+}
+
+//------------UART_DMA_Init------------
+// Enable uDMA channel 9 (UART0 TX) for telemetry transmission. Frames
+// are built in one of two ping-pong buffers while the other one is in
+// flight, so a whole frame leaves with no per-byte CPU work.
+// Call after UART0_Init
+// Input: none
+// Output: none
+void UART0_DMA_Init(void){
+  SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;      // activate uDMA
+  while((SYSCTL_RCGCDMA_R&SYSCTL_RCGCDMA_R0) == 0);
+  UDMA_CFG_R = UDMA_CFG_MASTEN;               // enable controller
+  UDMA_CTLBASE_R = UART0_DMA_ADDR(DmaTable);
+  UDMA_CHMAP1_R &= ~UDMA_CHMAP1_CH9SEL_M;     // channel 9 = UART0 TX
+  UDMA_PRIOCLR_R = UART0_TX_DMA_BIT;          // default priority
+  UDMA_ALTCLR_R = UART0_TX_DMA_BIT;           // primary control structure
+  UDMA_USEBURSTCLR_R = UART0_TX_DMA_BIT;      // single and burst requests
+  UDMA_REQMASKCLR_R = UART0_TX_DMA_BIT;       // allow UART0 requests
+  DmaLen[0] = DmaLen[1] = 0;
+  DmaFillI = 0;
+  DmaActiveI = DmaQueuedI = DMA_NONE;
+  DmaErrors = 0;
+  UDMA_ERRCLR_R = UDMA_ERRCLR_ERRCLR;         // clear a stale bus error
+  NVIC_PRI11_R = (NVIC_PRI11_R&UDMA_ERR_PRI_MSK)|UDMA_ERR_PRI;
+  NVIC_EN1_R = NVIC_EN1_UDMA_ERR;             // enable interrupt 47, uDMA_Error
+  UART0_DMACTL_R |= UART_DMACTL_TXDMAE;       // UART0 TX requests uDMA
+}
+
+//------------UART_DMA_Write------------
+// Append bytes to the buffer currently being filled. Nothing is sent
+// until UART0_DMA_Send. Fails if the bytes do not fit or if both
+// buffers are still owned by the uDMA
+// Input: pointer to data, number of bytes
+// Output: 1 if the bytes were appended, 0 otherwise
+uint8_t UART0_DMA_Write(const uint8_t *data, uint32_t len){
+  uint8_t *dst;
+  if((DmaFillI == DmaActiveI) || (DmaFillI == DmaQueuedI)){
+    return 0;                           // fill buffer still on its way out
+  }
+  if(len > (UART0_DMA_BUF_SIZE - DmaLen[DmaFillI])){
+    return 0;
+  }
+  dst = &DmaBuf[DmaFillI][DmaLen[DmaFillI]];
+  DmaLen[DmaFillI] += len;
+  while(len--){
+    *dst++ = *data++;
+  }
+  return 1;
+}
+
+//------------UART_DMA_Send------------
+// Hand the filled buffer to the uDMA and switch to the other buffer.
+// The transfer starts right away if the line is free, otherwise it
+// is queued behind the transfer in flight
+// Input: none
+// Output: 1 if the buffer was handed off, 0 if both buffers are busy
+uint8_t UART0_DMA_Send(void){
+  long sr;
+  if(DmaLen[DmaFillI] == 0){
+    return 1;                           // nothing to send
+  }
+  sr = StartCritical();
+  if((DmaQueuedI != DMA_NONE) || (DmaFillI == DmaActiveI)){
+    EndCritical(sr);
+    return 0;
+  }
+  DmaQueuedI = DmaFillI;
+  DmaFillI ^= 1;
+  DmaLen[DmaFillI] = 0;                 // only reused once the uDMA is done with it
+  UART0_DMA_Start_Queued();
+  EndCritical(sr);
+  return 1;
+}
+
+//------------UART_DMA_Errors------------
+// Number of uDMA bus errors seen on the transmit channel
+// Input: none
+// Output: error count since UART0_DMA_Init
+uint32_t UART0_DMA_Errors(void){
+  return DmaErrors;
+}
+
+
+//------------UART_OutString------------
+// Output String (NULL termination)
+// Input: pointer to a NULL-terminated string to be transferred
+// Output: none
+void UART0_OutString(char *pt){
+  while(*pt){
+    UART0_OutChar(*pt);
+    pt++;
+  }
+	//UART0_OutChar(0); // add the null terminator
+}
+
+//------------UART_InString------------
+// Accepts ASCII characters from the serial port
+//    and adds them to a string until <enter> is typed
+//    or until max length of the string is reached.
+//    when max length is reach, no more input will be accepted
+//    the display will wait for the <enter> key to be pressed.
+// It echoes each character as it is inputted.
+// If a backspace is inputted, the string is modified
+//    and the backspace is echoed
+// terminates the string with a null character
+// waits on the receive ring, so it blocks the caller until <enter>
+// Input: pointer to empty buffer, size of buffer
+// Output: Null terminated string
+// -- Modified by Agustinus Darmawan + Mingjie Qiu --
+void UART0_InString(char *bufPt, unsigned short max) {
+int length=0;
+char character;
+  character = UART0_InChar();
+  while(character != CR){
+    if(character == BS){ // back space
+      if(length){
+        bufPt--;
+        length--;
+        UART0_OutChar(BS);
+      }
+    }
+    else if(length < max){
+      *bufPt = character;
+      bufPt++;
+      length++;
+      UART0_OutChar(character);
+    }
+    character = UART0_InChar();
+  }
+  *bufPt = 0; // adding null terminator to the end of the string.
+}
+
+//-----------------------UART_OutDec-----------------------
+// Output a 32-bit signed number in decimal format
+// Input: 32-bit number to be transferred
+// Output: none
+void UART0_OutDec(int32_t n){
+  char buf[FORMAT_MAX_LEN+1];
+  Format_Dec(buf, n, 0);
+  UART0_OutString(buf);
+}
+
+//-----------------------UART_OutUHex----------------------
+// Output a 32-bit number in lowercase hex format (like %x)
+// Input: 32-bit number to be transferred
+// Output: none
+void UART0_OutUHex(uint32_t n){
+  char buf[FORMAT_MAX_LEN+1];
+  Format_Hex(buf, n, 0);
+  UART0_OutString(buf);
+}
+
+//----------------------UART_OutFloat----------------------
+// Output a float with a fixed number of decimals (like %.*f)
+// Input: number to be transferred, digits after the decimal point
+// Output: none
+void UART0_OutFloat(float n, uint8_t prec){
+  char buf[FORMAT_MAX_LEN+1];
+  Format_Float(buf, n, prec, 0);
+  UART0_OutString(buf);
+}
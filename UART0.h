@@ -1,81 +1,245 @@
-// UART.h
-// Runs on LM3S811, LM3S1968, LM3S8962, LM4F120, TM4C123
-// Simple device driver for the UART.
-// Daniel Valvano
-// September 11, 2013
-// Modified by EE345L students Charlie Gough && Matt Hawk
-// Modified by EE345M students Agustinus Darmawan && Mingjie Qiu
-// Modified by CECS497 student Jackie Huynh
-
-/* This example accompanies the book
-   "Embedded Systems: Real Time Interfacing to Arm Cortex M Microcontrollers",
-   ISBN: 978-1463590154, Jonathan Valvano, copyright (c) 2013
-   Program 4.12, Section 4.9.4, Figures 4.26 and 4.40
-
- Copyright 2013 by Jonathan W. Valvano, valvano@mail.utexas.edu
-    You may use, edit, run or distribute this file
-    as long as the above copyright notice remains
- THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
- OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
- MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
- VALVANO SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL,
- OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
- For more information about my classes, my research, and my books, see
- http://users.ece.utexas.edu/~valvano/
- */
-
-// U0Rx (VCP receive) connected to PA0
-// U0Tx (VCP transmit) connected to PA1
-
-// standard ASCII symbols
-#define CR   0x0D
-#define LF   0x0A
-#define BS   0x08
-#define ESC  0x1B
-#define SP   0x20
-#define DEL  0x7F
-
-//------------UART_Init------------
-// Initialize the UART for 115,200 baud rate (assuming 50 MHz clock),
-// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
-// Input: none
-// Output: none
-void UART0_Init(void);
-
-//---------------------OutCRLF---------------------
-// Output a CR,LF to UART to go to a new line
-// Input: none
-// Output: none
-void UART0_OutCRLF(void);
-
-//------------UART_InChar------------
-// Wait for new serial port input
-// Input: none
-// Output: ASCII code for key typed
-unsigned char UART0_InChar(void);
-
-//------------UART_OutChar------------
-// Output 8-bit to serial port
-// Input: letter is an 8-bit ASCII character to be transferred
-// Output: none
-void UART0_OutChar(char data);
-
-//------------UART_OutString------------
-// Output String (NULL termination)
-// Input: pointer to a NULL-terminated string to be transferred
-// Output: none
-void UART0_OutString(char *pt);
-
-//------------UART_InString------------
-// Accepts ASCII characters from the serial port
-//    and adds them to a string until <enter> is typed
-//    or until max length of the string is reached.
-// It echoes each character as it is inputted.
-// If a backspace is inputted, the string is modified
-//    and the backspace is echoed
-// terminates the string with a null character
-// uses busy-waiting synchronization on RDRF
-// Input: pointer to empty buffer, size of buffer
-// Output: Null terminated string
-// -- Modified by Agustinus Darmawan + Mingjie Qiu --
-void UART0_InString(char *bufPt, unsigned short max);
+// UART.h
+// Runs on LM3S811, LM3S1968, LM3S8962, LM4F120, TM4C123
+// Simple device driver for the UART.
+// Daniel Valvano
+// September 11, 2013
+// Modified by EE345L students Charlie Gough && Matt Hawk
+// Modified by EE345M students Agustinus Darmawan && Mingjie Qiu
+// Modified by CECS497 student Jackie Huynh
+
+/* This example accompanies the book
+   "Embedded Systems: Real Time Interfacing to Arm Cortex M Microcontrollers",
+   ISBN: 978-1463590154, Jonathan Valvano, copyright (c) 2013
+   Program 4.12, Section 4.9.4, Figures 4.26 and 4.40
+
+ Copyright 2013 by Jonathan W. Valvano, valvano@mail.utexas.edu
+    You may use, edit, run or distribute this file
+    as long as the above copyright notice remains
+ THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ VALVANO SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL,
+ OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+ */
+
+// U0Rx (VCP receive) connected to PA0
+// U0Tx (VCP transmit) connected to PA1
+
+#ifndef UART0_H_
+#define UART0_H_
+
+#include <stdint.h>
+#include "SysClock.h"
+
+// standard ASCII symbols
+#define CR   0x0D
+#define LF   0x0A
+#define BS   0x08
+#define ESC  0x1B
+#define SP   0x20
+#define DEL  0x7F
+
+// UART clock, the system clock
+#ifndef UART0_CLOCK_HZ
+#define UART0_CLOCK_HZ      SYSCLK_HZ
+#endif
+
+// line rate, may be set from the build (e.g. -DUART0_BAUD=921600UL)
+#ifndef UART0_BAUD
+#define UART0_BAUD          115200UL
+#endif
+
+// largest allowed baud rate error in ppm, the receiver has to match
+// within about 2% in total so each side gets well under half of that
+#ifndef UART0_BAUD_TOL_PPM
+#define UART0_BAUD_TOL_PPM  10000
+#endif
+
+// high speed mode samples at clock/8 instead of clock/16, used
+// automatically once the rate no longer fits the /16 divider
+#ifndef UART0_HSE
+#if UART0_BAUD > (UART0_CLOCK_HZ/16)
+#define UART0_HSE           1
+#else
+#define UART0_HSE           0
+#endif
+#endif
+
+// baud rate divisor in 1/64 steps, rounded: clock/(div*baud)*64
+#define UART_BRD64(clk, baud, div)        ((((clk)*(64/(div))) + (baud)/2)/(baud))
+// baud rate a divisor actually gives
+#define UART_BAUD_ACTUAL(clk, brd64, div) (((clk)*(64/(div)))/(brd64))
+
+#define UART0_CLKDIV        (UART0_HSE ? 8 : 16)
+#define UART0_BRD64         UART_BRD64(UART0_CLOCK_HZ, UART0_BAUD, UART0_CLKDIV)
+#define UART0_IBRD          (UART0_BRD64 >> 6)     // integer part
+#define UART0_FBRD          (UART0_BRD64 & 0x3F)   // fraction in 1/64
+#define UART0_BAUD_ACTUAL   UART_BAUD_ACTUAL(UART0_CLOCK_HZ, UART0_BRD64, UART0_CLKDIV)
+
+#if UART0_BRD64 < 64 || UART0_IBRD > 0xFFFF
+#error "UART0_BAUD is out of range for UART0_CLOCK_HZ"
+#endif
+#if (UART0_BAUD_ACTUAL > UART0_BAUD ? UART0_BAUD_ACTUAL - UART0_BAUD : UART0_BAUD - UART0_BAUD_ACTUAL)*1000000 > UART0_BAUD*UART0_BAUD_TOL_PPM
+#error "UART0_BAUD cannot be generated from UART0_CLOCK_HZ within UART0_BAUD_TOL_PPM"
+#endif
+
+// transmit ring buffer, must be a power of 2
+#define UART0_TX_BUF_SIZE   256
+
+// receive ring buffer, must be a power of 2
+#define UART0_RX_BUF_SIZE   64
+
+// what UART0_Write does when the transmit ring is full
+typedef enum{
+  UART0_TX_BLOCK,   // wait for room (default, nothing is lost)
+  UART0_TX_DROP     // discard what does not fit and count it
+} UART0_TX_POLICY;
+
+// size of each of the two uDMA ping-pong transmit buffers (max 1024)
+#define UART0_DMA_BUF_SIZE  128
+
+//------------UART_Init------------
+// Initialize the UART for UART0_BAUD (divisors from UART0_CLOCK_HZ),
+// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
+// Transmit and receive are interrupt driven through ring buffers
+// Input: none
+// Output: none
+void UART0_Init(void);
+
+//------------UART_Write------------
+// Queue bytes for transmission and return right away. The ring is
+// drained into the TX FIFO by UART0_Handler. When the ring is full
+// the TX policy decides whether to wait or to drop the rest. Once
+// the kernel runs a task waits blocked, lower priority tasks run.
+// Call from one context only (main loop or a single task)
+// Input: pointer to data, number of bytes
+// Output: number of bytes queued
+uint32_t UART0_Write(const uint8_t *data, uint32_t len);
+
+//------------UART_Set_TX_Policy------------
+// Select block or drop behavior when the transmit ring is full
+// Input: UART0_TX_BLOCK or UART0_TX_DROP
+// Output: none
+void UART0_Set_TX_Policy(UART0_TX_POLICY policy);
+
+//------------UART_TX_Dropped------------
+// Number of bytes discarded because the transmit ring was full
+// Input: none
+// Output: dropped byte count since init
+uint32_t UART0_TX_Dropped(void);
+
+//------------UART_Flush------------
+// Wait until every queued byte has left the UART
+// Input: none
+// Output: none
+void UART0_Flush(void);
+
+//---------------------OutCRLF---------------------
+// Output a CR,LF to UART to go to a new line
+// Input: none
+// Output: none
+void UART0_OutCRLF(void);
+
+//------------UART_InChar------------
+// Wait for new serial port input
+// Input: none
+// Output: ASCII code for key typed
+unsigned char UART0_InChar(void);
+
+//------------UART_Read------------
+// Take received bytes out of the receive ring without waiting
+// Input: pointer to buffer, size of buffer
+// Output: number of bytes copied (0 if nothing has arrived)
+uint32_t UART0_Read(uint8_t *data, uint32_t len);
+
+//------------UART_RX_Pending------------
+// Check for received bytes without taking them
+// Input: none
+// Output: 1 if the receive ring is not empty
+uint8_t UART0_RX_Pending(void);
+
+//------------UART_RX_Dropped------------
+// Number of received bytes lost because the receive ring was full
+// Input: none
+// Output: dropped byte count since init
+uint32_t UART0_RX_Dropped(void);
+
+//------------UART_OutChar------------
+// Output 8-bit to serial port through the transmit ring
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART0_OutChar(char data);
+
+//------------UART_OutString------------
+// Output String (NULL termination)
+// Input: pointer to a NULL-terminated string to be transferred
+// Output: none
+void UART0_OutString(char *pt);
+
+//------------UART_InString------------
+// Accepts ASCII characters from the serial port
+//    and adds them to a string until <enter> is typed
+//    or until max length of the string is reached.
+// It echoes each character as it is inputted.
+// If a backspace is inputted, the string is modified
+//    and the backspace is echoed
+// terminates the string with a null character
+// waits on the receive ring, so it blocks the caller until <enter>
+// Input: pointer to empty buffer, size of buffer
+// Output: Null terminated string
+// -- Modified by Agustinus Darmawan + Mingjie Qiu --
+void UART0_InString(char *bufPt, unsigned short max);
+
+//-----------------------UART_OutDec-----------------------
+// Output a 32-bit signed number in decimal format
+// Input: 32-bit number to be transferred
+// Output: none
+// Uses Format_Dec so no printf code is required
+void UART0_OutDec(int32_t n);
+
+//-----------------------UART_OutUHex----------------------
+// Output a 32-bit number in lowercase hex format (like %x)
+// Input: 32-bit number to be transferred
+// Output: none
+void UART0_OutUHex(uint32_t n);
+
+//----------------------UART_OutFloat----------------------
+// Output a float with a fixed number of decimals (like %.*f)
+// Input: number to be transferred, digits after the decimal point
+// Output: none
+void UART0_OutFloat(float n, uint8_t prec);
+
+//------------UART_DMA_Init------------
+// Enable uDMA channel 9 (UART0 TX) for telemetry transmission. Frames
+// are built in one of two ping-pong buffers while the other one is in
+// flight, so a whole frame leaves with no per-byte CPU work.
+// Call after UART0_Init
+// Input: none
+// Output: none
+void UART0_DMA_Init(void);
+
+//------------UART_DMA_Write------------
+// Append bytes to the buffer currently being filled. Nothing is sent
+// until UART0_DMA_Send. Fails if the bytes do not fit or if both
+// buffers are still owned by the uDMA
+// Input: pointer to data, number of bytes
+// Output: 1 if the bytes were appended, 0 otherwise
+uint8_t UART0_DMA_Write(const uint8_t *data, uint32_t len);
+
+//------------UART_DMA_Send------------
+// Hand the filled buffer to the uDMA and switch to the other buffer.
+// The transfer starts right away if the line is free, otherwise it
+// is queued behind the transfer in flight
+// Input: none
+// Output: 1 if the buffer was handed off, 0 if both buffers are busy
+uint8_t UART0_DMA_Send(void);
+
+//------------UART_DMA_Errors------------
+// Number of uDMA bus errors seen on the transmit channel
+// Input: none
+// Output: error count since UART0_DMA_Init
+uint32_t UART0_DMA_Errors(void);
+
+#endif
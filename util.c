@@ -1,52 +1,81 @@
-/*
- * util.c
- *
- *	Main implementation of basic utility function such as
- *	delay and value mapping
- *
- * Created on: May 30th, 2023
- *		Author: Jackie Huynh
- *
- */
- 
-#include "util.h"
-#include "tm4c123gh6pm.h"
-
-/* Local Macros */
-#define TIMER_32_MAX_RELOAD		(4294967295)	
- 
-/* The reason why Wide Timer is used instead of regular time is because
-	 of the prescaler option */
-void WTIMER0_Init(void){
-	SYSCTL_RCGCWTIMER_R |= EN_WTIMER0_CLOCK;						//Enable WTIMER0 Clock
-	
-	//Wait Until WTIMER0 Clock has be activated
-	//while((SYSCTL_RCGCWTIMER_R&EN_WTIMER0_CLOCK)!=EN_WTIMER0_CLOCK);
-	
-	WTIMER0_CTL_R &= ~(WTIMER0_TAEN_BIT);									//Disable WTIMER0 Timer A
-	WTIMER0_CFG_R |= WTIMER0_32_BIT_CFG;								//Set WTIMER0 to be 32-bit config mode
-	WTIMER0_TAMR_R |= WTIMER0_PERIOD_MODE;							//Set WTIMER0 to be in periodic mode
-	
-	/* Prescale down to 1MHz or 1us period */
-	// Frequency = System Clock / Prescaler
-	// Frequency = 40MHz / 40000 = 0.001MHz = 1kHz
-	// Tick Length = Period = 1 / 1kHz = 1ms
-	WTIMER0_TAPR_R = PRESCALER_VALUE;										//Set prescaler to get 1kHz frequency or 1ms period
-}
-
-void DELAY_1MS(uint32_t delay){
-	WTIMER0_TAILR_R = delay - 1;
-	WTIMER0_CTL_R |= WTIMER0_TAEN_BIT;
-	while(WTIMER0_TAR_R != 0);
-	WTIMER0_CTL_R &= ~(WTIMER0_TAEN_BIT);
-}
-
-int16_t map(int16_t x, int16_t x_min, int16_t x_max, int16_t out_min, int16_t out_max){
-	if(x < x_min){
-		return x_min;
-	}
-	if(x > x_max){
-		return x_max;
-	}
-	return (x - x_min) * (out_max - out_min) / (x_max - x_min) + out_min;
-}
+/*
+ * util.c
+ *
+ *	Main implementation of basic utility function such as
+ *	delay and value mapping
+ *
+ * Created on: May 30th, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+#include "util.h"
+#include "tm4c123gh6pm.h"
+#include "Idle.h"
+
+/* Local Macros */
+#define TIMER_32_MAX_RELOAD		(4294967295)	
+#define WTIMER0_PRI						(0x00A00000)		//WTIMER0A Priority 5
+#define WTIMER0_PRI_MSK				(0xFF1FFFFF)
+#define NVIC_EN2_WTIMER0A			(0x40000000)		//Interrupt 94
+
+static volatile uint8_t Delay_Done;					//Set by WideTimer0A_Handler
+ 
+/* The reason why Wide Timer is used instead of regular time is because
+	 of the prescaler option */
+void WTIMER0_Init(void){
+	SYSCTL_RCGCWTIMER_R |= EN_WTIMER0_CLOCK;						//Enable WTIMER0 Clock
+	
+	//Wait Until WTIMER0 Clock has be activated
+	//while((SYSCTL_RCGCWTIMER_R&EN_WTIMER0_CLOCK)!=EN_WTIMER0_CLOCK);
+	
+	WTIMER0_CTL_R &= ~(WTIMER0_TAEN_BIT);									//Disable WTIMER0 Timer A
+	WTIMER0_CFG_R |= WTIMER0_32_BIT_CFG;								//Set WTIMER0 to be 32-bit config mode
+	WTIMER0_TAMR_R |= WTIMER0_PERIOD_MODE;							//Set WTIMER0 to be in periodic mode
+	
+	/* Prescale down to 1MHz or 1us period */
+	// Frequency = System Clock / (Prescaler + 1)
+	// Frequency = 80MHz / 80 = 1MHz
+	// Tick Length = Period = 1 / 1MHz = 1us
+	// The wide timer prescaler is only 16 bits, too small for 1ms ticks at 80MHz
+	WTIMER0_TAPR_R = PRESCALER_VALUE;										//Set prescaler to get 1MHz frequency or 1us period
+	
+	/* Time-out interrupt wakes the core from the delay */
+	WTIMER0_IMR_R |= TIMER_IMR_TATOIM;
+	NVIC_PRI23_R = (NVIC_PRI23_R&WTIMER0_PRI_MSK)|WTIMER0_PRI;
+	NVIC_EN2_R = NVIC_EN2_WTIMER0A;
+}
+
+void WideTimer0A_Handler(void){
+	WTIMER0_ICR_R = TIMER_ICR_TATOCINT;
+	Delay_Done = 1;
+}
+
+void DELAY_1MS(uint32_t delay){
+	DELAY_US(delay*WTIMER0_TICKS_PER_MS);
+}
+
+/* WTIMER0 already counts microseconds, the delay sleeps the same way for any length.
+	 Waits of a few tens of us are shorter than the wake-up, busy wait them with TIME_SPIN_US */
+void DELAY_US(uint32_t delay){
+	if(delay == 0)
+		return;
+	WTIMER0_TAILR_R = delay - 1;
+	WTIMER0_ICR_R = TIMER_ICR_TATOCINT;									//Clear an old time-out
+	Delay_Done = 0;
+	WTIMER0_CTL_R |= WTIMER0_TAEN_BIT;
+	//Sleep until the time-out, the raw flag ends the wait when the caller masked interrupts
+	IDLE_WAIT(!Delay_Done && (WTIMER0_RIS_R & TIMER_RIS_TATORIS) == 0);
+	WTIMER0_CTL_R &= ~(WTIMER0_TAEN_BIT);
+	WTIMER0_ICR_R = TIMER_ICR_TATOCINT;
+}
+
+int16_t map(int16_t x, int16_t x_min, int16_t x_max, int16_t out_min, int16_t out_max){
+	if(x < x_min){
+		return x_min;
+	}
+	if(x > x_max){
+		return x_max;
+	}
+	return (x - x_min) * (out_max - out_min) / (x_max - x_min) + out_min;
+}
@@ -1,32 +1,41 @@
-/*
- * util.h
- *
- *	Provides basic utility function such as delay and 
- *	value mapping
- *
- * Created on: May 30th, 2023
- *		Author: Jackie Huynh
- *
- */
- 
-
-#ifndef UTIL_H_
-#define UTIL_H_
-
-#include <stdint.h>
-
-#define CONSTANT_FILL	(50)     // a place holder for all constants needs to be defined by students
-#define CODE_FILL	(0)     // a place holder for code needs to be defined by students
-
-/* List of Fill In Macros */
-#define EN_WTIMER0_CLOCK			(0x01)
-#define WTIMER0_TAEN_BIT			(0x01)
-#define WTIMER0_32_BIT_CFG		(0x04)
-#define WTIMER0_PERIOD_MODE		(0x02)
-#define PRESCALER_VALUE				(16000-1)
-
-void WTIMER0_Init(void);
-void DELAY_1MS(uint32_t);
-int16_t map(int16_t, int16_t, int16_t, int16_t, int16_t);
-
+/*
+ * util.h
+ *
+ *	Provides basic utility function such as delay and 
+ *	value mapping
+ *
+ * Created on: May 30th, 2023
+ *		Author: Jackie Huynh
+ *
+ */
+ 
+
+#ifndef UTIL_H_
+#define UTIL_H_
+
+#include <stdint.h>
+#include "SysClock.h"
+
+#define CONSTANT_FILL	(50)     // a place holder for all constants needs to be defined by students
+#define CODE_FILL	(0)     // a place holder for code needs to be defined by students
+
+/* List of Fill In Macros */
+#define EN_WTIMER0_CLOCK			(0x01)
+#define WTIMER0_TAEN_BIT			(0x01)
+#define WTIMER0_32_BIT_CFG		(0x04)
+#define WTIMER0_PERIOD_MODE		(0x02)
+#define WTIMER0_TICK_HZ				(1000000UL)												//1us per tick
+#define PRESCALER_VALUE				(SYSCLK_HZ/WTIMER0_TICK_HZ - 1)
+#define WTIMER0_TICKS_PER_MS	(WTIMER0_TICK_HZ/1000UL)
+
+#if SYSCLK_HZ % WTIMER0_TICK_HZ != 0 || PRESCALER_VALUE > 0xFFFF
+#error "WTIMER0 prescaler cannot produce WTIMER0_TICK_HZ from SYSCLK_HZ"
+#endif
+
+void WTIMER0_Init(void);
+void DELAY_1MS(uint32_t);
+void DELAY_US(uint32_t);
+void WideTimer0A_Handler(void);
+int16_t map(int16_t, int16_t, int16_t, int16_t, int16_t);
+
 #endif
\ No newline at end of file